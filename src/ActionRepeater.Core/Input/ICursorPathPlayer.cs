@@ -0,0 +1,19 @@
+﻿using System;
+using System.Threading;
+using ActionRepeater.Core.Action;
+
+namespace ActionRepeater.Core.Input;
+
+/// <summary>
+/// Moves the cursor along a path, each movement after its delay.
+/// </summary>
+public interface ICursorPathPlayer
+{
+    /// <summary>
+    /// Blocks until the whole path was played, or <paramref name="token"/> is cancelled.
+    /// </summary>
+    /// <param name="isPathRelative">Whether the path is made of deltas, otherwise of positions relative to the primary monitor.</param>
+    /// <param name="convertToAbsolute">Like in <see cref="InputSimulator.MoveMouse"/>, for a path of positions.</param>
+    /// <returns>false if it was cancelled before the end of the path.</returns>
+    bool Play(ReadOnlySpan<MouseMovement> path, bool isPathRelative, bool convertToAbsolute, CancellationToken token);
+}
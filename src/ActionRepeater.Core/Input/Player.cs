@@ -55,16 +55,14 @@ public sealed class Player
     private readonly ActionCollection _actionCollection;
 
     private readonly HighResolutionWaiter _actionsWaiter;
-    private readonly HighResolutionWaiter _cursorMovementWaiter;
+    private readonly ICursorPathPlayer _cursorPathPlayer;
 
-    public Player(CoreOptions options, ActionCollection actionCollection, HighResolutionWaiter actionsWaiter, HighResolutionWaiter cursorMovementWaiter)
+    public Player(CoreOptions options, ActionCollection actionCollection, HighResolutionWaiter actionsWaiter, ICursorPathPlayer cursorPathPlayer)
     {
-        if (ReferenceEquals(actionsWaiter, cursorMovementWaiter)) throw new ArgumentException($"{nameof(actionsWaiter)} must be a different instance than {nameof(cursorMovementWaiter)}");
-
         _options = options;
         _actionCollection = actionCollection;
         _actionsWaiter = actionsWaiter;
-        _cursorMovementWaiter = cursorMovementWaiter;
+        _cursorPathPlayer = cursorPathPlayer;
 
         _playInputActions = static (state) =>
         {
@@ -183,7 +181,6 @@ public sealed class Player
         Debug.WriteLine($"[{nameof(Player)}] Cancelling play task...");
         _tokenSource!.Cancel();
         _actionsWaiter.Cancel();
-        _cursorMovementWaiter.Cancel();
     }
 
     public void RefreshIsPlaying() => IsPlayingChanged?.Invoke(this, _isPlaying);
@@ -199,13 +196,7 @@ public sealed class Player
 
         InputSimulator.MoveMouse(p._actionCollection.CursorPathStart!.Value.Delta, relativePos: false);
 
-        foreach (MouseMovement mouseMovement in cursorPathSpan)
-        {
-            if (p._tokenSource!.IsCancellationRequested) return;
-
-            p._cursorMovementWaiter.WaitNS(mouseMovement.DelayDurationNS);
-            InputSimulator.MoveMouse(mouseMovement.Delta, relativePos: true);
-        }
+        p._cursorPathPlayer.Play(cursorPathSpan, isPathRelative: true, convertToAbsolute: false, p._tokenSource.Token);
     }
     : static (state) =>
     {
@@ -213,15 +204,7 @@ public sealed class Player
 
         ReadOnlySpan<MouseMovement> cursorPathSpan = CollectionsMarshal.AsSpan((List<MouseMovement>)p._cursorPath!);
 
-        bool convertToAbsolute = p._options.SendAbsoluteCursorCoords;
-
-        foreach (MouseMovement mouseMovement in cursorPathSpan)
-        {
-            if (p._tokenSource!.IsCancellationRequested) return;
-
-            p._cursorMovementWaiter.WaitNS(mouseMovement.DelayDurationNS);
-            InputSimulator.MoveMouse(mouseMovement.Delta, relativePos: false, convertToAbsolute: convertToAbsolute);
-        }
+        p._cursorPathPlayer.Play(cursorPathSpan, isPathRelative: false, p._options.SendAbsoluteCursorCoords, p._tokenSource!.Token);
     };
 
 }
@@ -10,6 +10,7 @@ using ActionRepeater.Core.Helpers;
 using ActionRepeater.Core.Input;
 using ActionRepeater.UI.Factories;
 using ActionRepeater.UI.Services;
+using ActionRepeater.UI.Services.Interop;
 using ActionRepeater.UI.Utilities;
 using ActionRepeater.UI.ViewModels;
 using ActionRepeater.UI.Views;
@@ -106,6 +107,7 @@ public partial class App : Application
         services.AddSingleton(_options);
 
         services.AddTransient<HighResolutionWaiter>();
+        services.AddSingleton<ICursorPathPlayer, NativeCursorPathPlayer>();
 
         services.AddSingleton<ActionCollection>();
         services.AddSingleton<Recorder>((s) =>
@@ -161,6 +163,19 @@ public partial class App : Application
 
         _mainWindow.Closed += MainWindow_Closed;
 
+        // the path windows open faster once the thread they live on is running
+        Task.Run(static () =>
+        {
+            try
+            {
+                WindowHostWrapper.WarmUp();
+            }
+            catch (Exception ex)
+            {
+                Debug.WriteLine($"Could not warm up the path window host: {ex}");
+            }
+        });
+
         _mainWindow.Activate();
     }
 
@@ -168,6 +183,16 @@ public partial class App : Application
     {
         if (Services.GetService<PathWindowService>() is { IsPathWindowOpen: true } pathWindowService) pathWindowService.CloseWindow();
 
+        try
+        {
+            WindowHostWrapper.Shutdown();
+        }
+        catch (Exception ex)
+        {
+            // a drawable path window is still open, it goes away with the process
+            Debug.WriteLine($"Could not shut down the path window host: {ex}");
+        }
+
         if (!_saveOnExit) return;
 
         await SaveOptions();
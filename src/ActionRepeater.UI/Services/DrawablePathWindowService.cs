@@ -1,11 +1,9 @@
 ﻿using System;
 using System.Diagnostics;
-using System.Linq;
 using ActionRepeater.Core.Action;
 using ActionRepeater.Core.Input;
 using ActionRepeater.UI.Services.Interop;
 using ActionRepeater.Win32;
-using ActionRepeater.Win32.Utilities;
 
 namespace ActionRepeater.UI.Services;
 
@@ -19,7 +17,8 @@ public sealed class DrawablePathWindowService : IDisposable
     private ActionCollection _actionCollection;
     private WindowHostWrapper _windowHost;
 
-    private int _cursorSpeedFactor;
+    // the longest step between two movements of a drawn path, in pixels
+    private const float MaxStepLength = 4f;
 
     private bool _disposed;
 
@@ -28,43 +27,46 @@ public sealed class DrawablePathWindowService : IDisposable
         _actionCollection = actionCollection;
     }
 
+    /// <param name="cursorSpeedFactor">How long the cursor takes to move one pixel along a drawn path, in nanoseconds.</param>
     public unsafe void OpenWindow(int cursorSpeedFactor)
     {
-        _cursorSpeedFactor = cursorSpeedFactor;
-        _windowHost.OpenDrawablePathWindow(
-            _actionCollection.GetAbsoluteCursorPath().Select(x => new MouseMovement(ScreenCoordsConverter.GetVirtScreenPosFromPosRelToPrimary(x.Delta), x.DelayDurationNS)).ToArray(),
-            OnWindowClosing
-        );
+        var absPath = CursorPathConverter.GetAbsoluteVirtScreenPath(_actionCollection);
+
+        // the window may have closed itself, which leaves its host behind
+        _windowHost.Dispose();
+        _windowHost.OpenDrawablePathWindow(absPath, OnWindowClosing);
+        _windowHost.SetDrawnPathResampling(MaxStepLength, cursorSpeedFactor, WindowHostWrapper.Interpolation.CatmullRom, WindowHostWrapper.Easing.Constant);
 
         WindowOpened?.Invoke();
     }
 
-    private unsafe void OnWindowClosing(MouseMovement* points, int length)
+    private unsafe void OnWindowClosing(MouseMovement* points, int length, int preloadedLength)
     {
-        if (length == 0)
+        try
         {
-            WindowClosed?.Invoke();
-            return;
-        }
-
-        Span<MouseMovement> cursorPath = new(points, length);
+            if (preloadedLength < 0)
+            {
+                // erasing changed the path the window was opened with, so what is left of it is handed back too
+                _actionCollection.ClearCursorPath();
+                preloadedLength = 0;
+            }
 
-        for (int i = 0; i < cursorPath.Length; i++)
+            if (length > 0) AddDrawnPath(new(points, length), preloadedLength);
+        }
+        finally
         {
-            var mov = cursorPath[i];
+            WindowHostWrapper.ReleaseDrawnPath(points);
+        }
 
-            MouseMovement newMov = new(
-                ScreenCoordsConverter.GetPosRelToPrimaryFromVirtScreenPoint(mov.Delta),
-                mov.DelayDurationNS
-            );
+        WindowClosed?.Invoke();
+    }
 
-            cursorPath[i] = newMov;
-        }
+    private void AddDrawnPath(Span<MouseMovement> cursorPath, int preloadedLength)
+    {
+        CursorPathConverter.ToRelativePath(cursorPath);
 
         Debug.Assert(cursorPath[0] == _actionCollection.CursorPathStart || _actionCollection.CursorPathStart is null);
 
-        ToRelativePath(cursorPath);
-
         int lastPointIndex;
 
         if (_actionCollection.CursorPathStart is null)
@@ -72,6 +74,11 @@ public sealed class DrawablePathWindowService : IDisposable
             lastPointIndex = 0;
             _actionCollection.CursorPathStart = cursorPath[0];
         }
+        else if (preloadedLength > 0 && cursorPath.Length >= preloadedLength && cursorPath[0] == _actionCollection.CursorPathStart)
+        {
+            // the window hands back the path it was opened with unchanged, followed by the drawn (and already timed) movements
+            lastPointIndex = preloadedLength - 1;
+        }
         else
         {
             lastPointIndex = cursorPath.LastIndexOf(_actionCollection.CursorPath[^1]);
@@ -79,21 +86,8 @@ public sealed class DrawablePathWindowService : IDisposable
 
         var newPoints = cursorPath[(lastPointIndex + 1)..];
 
-        foreach (var mov in newPoints) _actionCollection.CursorPath.Add(new(mov.Delta, mov.DelayDurationNS * _cursorSpeedFactor));
-
-        WindowClosed?.Invoke();
-
-        static void ToRelativePath(Span<MouseMovement> absolutePath)
-        {
-            for (int i = absolutePath.Length - 1; i >= 1; i--)
-            {
-                var cur = absolutePath[i].Delta;
-                var prev = absolutePath[i - 1].Delta;
-                POINT rel = new(cur.x - prev.x, cur.y - prev.y);
-
-                absolutePath[i] = new(rel, absolutePath[i].DelayDurationNS);
-            }
-        }
+        _actionCollection.CursorPath.EnsureCapacity(_actionCollection.CursorPath.Count + newPoints.Length);
+        foreach (var mov in newPoints) _actionCollection.CursorPath.Add(mov);
     }
 
     private void DisposeCore()
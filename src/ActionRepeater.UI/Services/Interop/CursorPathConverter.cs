@@ -0,0 +1,79 @@
+﻿using System;
+using System.Runtime.CompilerServices;
+using System.Runtime.InteropServices;
+using ActionRepeater.Core.Action;
+using ActionRepeater.Core.Input;
+using ActionRepeater.Win32;
+using static ActionRepeater.Win32.Utilities.ScreenCoordsConverter;
+
+namespace ActionRepeater.UI.Services.Interop;
+
+/// <summary>
+/// Converts whole cursor paths between relative and absolute (virtual screen) positions in native code.
+/// </summary>
+public static partial class CursorPathConverter
+{
+    /// <summary>
+    /// Like <see cref="ActionCollection.GetAbsoluteCursorPath"/> with every position converted to virtual screen coordinates,
+    /// except that the delay of movements that don't move the cursor is added to the previous movement instead of dropped.
+    /// </summary>
+    public static unsafe MouseMovement[] GetAbsoluteVirtScreenPath(ActionCollection actionCollection)
+    {
+        if (actionCollection.CursorPathStart is null) return Array.Empty<MouseMovement>();
+
+        ReadOnlySpan<MouseMovement> deltas = CollectionsMarshal.AsSpan(actionCollection.CursorPath);
+
+        var monitorRects = SystemInformation.MonitorRects;
+        RECT[] monitors = new RECT[monitorRects.Count];
+        for (int i = 0; i < monitors.Length; i++)
+        {
+            var r = monitorRects[i];
+            monitors[i] = new(r.Left, r.Top, r.Right, r.Bottom);
+        }
+
+        MouseMovement[] path = new MouseMovement[deltas.Length + 1];
+        int length = 0;
+
+        fixed (MouseMovement* pDeltas = deltas)
+        fixed (RECT* pMonitors = monitors)
+        fixed (MouseMovement* pPath = path)
+        {
+            VerifyHR(ToAbsoluteCursorPath(actionCollection.CursorPathStart.Value, pDeltas, deltas.Length, pMonitors, monitors.Length, GetVirtScreenOrigin(), pPath, &length));
+        }
+
+        Array.Resize(ref path, length);
+        return path;
+    }
+
+    /// <summary>
+    /// Converts a path of virtual screen positions in place, into its first position relative to the primary monitor followed by the deltas between positions.
+    /// </summary>
+    public static unsafe void ToRelativePath(Span<MouseMovement> virtScreenPath)
+    {
+        fixed (MouseMovement* pPath = virtScreenPath)
+        {
+            VerifyHR(ToRelativeCursorPath(pPath, virtScreenPath.Length, GetVirtScreenOrigin()));
+        }
+    }
+
+    // where the primary monitor's origin is in virtual screen coordinates
+    private static POINT GetVirtScreenOrigin() => GetVirtScreenPosFromPosRelToPrimary(new POINT(0, 0));
+
+    private static void VerifyHR(HResult hr)
+    {
+        if (MACROS.FAILED(hr))
+        {
+            throw new COMException($"{hr} ({WindowHostWrapper.PathWindowsDll}).", (int)hr);
+        }
+    }
+
+    [LibraryImport(WindowHostWrapper.PathWindowsDll)]
+    [DefaultDllImportSearchPaths(DllImportSearchPath.AssemblyDirectory)]
+    [UnmanagedCallConv(CallConvs = new[] { typeof(CallConvCdecl) })]
+    private static unsafe partial HResult ToAbsoluteCursorPath(MouseMovement start, MouseMovement* deltas, int length, RECT* monitors, int monitorCount, POINT origin, MouseMovement* path, int* pathLength);
+
+    [LibraryImport(WindowHostWrapper.PathWindowsDll)]
+    [DefaultDllImportSearchPaths(DllImportSearchPath.AssemblyDirectory)]
+    [UnmanagedCallConv(CallConvs = new[] { typeof(CallConvCdecl) })]
+    private static unsafe partial HResult ToRelativeCursorPath(MouseMovement* path, int length, POINT origin);
+}
@@ -0,0 +1,106 @@
+﻿using System;
+using System.Runtime.CompilerServices;
+using System.Runtime.InteropServices;
+using System.Threading;
+using ActionRepeater.Core.Action;
+using ActionRepeater.Core.Input;
+using ActionRepeater.Win32;
+using static ActionRepeater.Win32.Utilities.ScreenCoordsConverter;
+
+namespace ActionRepeater.UI.Services.Interop;
+
+/// <summary>
+/// Plays cursor paths on a native thread that waits for absolute deadlines, so late wake ups and GC pauses
+/// are caught up with instead of adding up over the path.
+/// </summary>
+public sealed partial class NativeCursorPathPlayer : ICursorPathPlayer, IDisposable
+{
+    // SendInputSink::Mode
+    private const int ModeRelative = 0;
+    private const int ModeAbsolute = 1;
+    private const int ModeFromCursor = 2;
+
+    private nint _pPlayback;
+
+    public unsafe NativeCursorPathPlayer()
+    {
+        nint pPlayback;
+        VerifyHR(CreateCursorPlayback(&pPlayback));
+        _pPlayback = pPlayback;
+    }
+
+    public unsafe bool Play(ReadOnlySpan<MouseMovement> path, bool isPathRelative, bool convertToAbsolute, CancellationToken token)
+    {
+        if (token.IsCancellationRequested) return false;
+
+        int mode = isPathRelative ? ModeRelative : (convertToAbsolute ? ModeAbsolute : ModeFromCursor);
+
+        if (mode == ModeAbsolute)
+        {
+            // converted here, the native side sends the coordinates as they are
+            MouseMovement[] absolutePath = new MouseMovement[path.Length];
+            for (int i = 0; i < path.Length; ++i)
+            {
+                absolutePath[i] = new(GetAbsCoordFromPosRelToPrimary(path[i].Delta), path[i].DelayDurationNS);
+            }
+            path = absolutePath;
+        }
+
+        fixed (MouseMovement* pPath = path)
+        {
+            VerifyHR(StartCursorPlayback(_pPlayback, pPath, path.Length, mode));
+        }
+
+        bool completed;
+        // registered after starting, so a cancellation that came in before is not reset by the start
+        using (token.Register(static (p) => ((NativeCursorPathPlayer)p!).Cancel(), this))
+        {
+            VerifyHR(WaitCursorPlayback(_pPlayback, &completed));
+        }
+
+        return completed;
+    }
+
+    private void Cancel() => VerifyHR(CancelCursorPlayback(_pPlayback));
+
+    public void Dispose()
+    {
+        if (_pPlayback == 0) return;
+
+        DestroyCursorPlayback(_pPlayback);
+        _pPlayback = 0;
+    }
+
+    private static void VerifyHR(HResult hr)
+    {
+        if (MACROS.FAILED(hr))
+        {
+            throw new COMException($"{hr} ({WindowHostWrapper.PathWindowsDll}).", (int)hr);
+        }
+    }
+
+    [LibraryImport(WindowHostWrapper.PathWindowsDll)]
+    [DefaultDllImportSearchPaths(DllImportSearchPath.AssemblyDirectory)]
+    [UnmanagedCallConv(CallConvs = new[] { typeof(CallConvCdecl) })]
+    private static unsafe partial HResult CreateCursorPlayback(nint* ppPlayback);
+
+    [LibraryImport(WindowHostWrapper.PathWindowsDll)]
+    [DefaultDllImportSearchPaths(DllImportSearchPath.AssemblyDirectory)]
+    [UnmanagedCallConv(CallConvs = new[] { typeof(CallConvCdecl) })]
+    private static partial void DestroyCursorPlayback(nint pPlayback);
+
+    [LibraryImport(WindowHostWrapper.PathWindowsDll)]
+    [DefaultDllImportSearchPaths(DllImportSearchPath.AssemblyDirectory)]
+    [UnmanagedCallConv(CallConvs = new[] { typeof(CallConvCdecl) })]
+    private static unsafe partial HResult StartCursorPlayback(nint pPlayback, MouseMovement* movements, int length, int mode);
+
+    [LibraryImport(WindowHostWrapper.PathWindowsDll)]
+    [DefaultDllImportSearchPaths(DllImportSearchPath.AssemblyDirectory)]
+    [UnmanagedCallConv(CallConvs = new[] { typeof(CallConvCdecl) })]
+    private static unsafe partial HResult WaitCursorPlayback(nint pPlayback, bool* pCompleted);
+
+    [LibraryImport(WindowHostWrapper.PathWindowsDll)]
+    [DefaultDllImportSearchPaths(DllImportSearchPath.AssemblyDirectory)]
+    [UnmanagedCallConv(CallConvs = new[] { typeof(CallConvCdecl) })]
+    private static partial HResult CancelCursorPlayback(nint pPlayback);
+}
@@ -1,10 +1,18 @@
 ﻿using System;
 using System.Runtime.CompilerServices;
 using System.Runtime.InteropServices;
+using ActionRepeater.Core.Action;
 using ActionRepeater.Win32;
 
 namespace ActionRepeater.UI.Services.Interop;
 
+public enum PathColoring
+{
+    None,
+    Speed,
+    ElapsedTime
+}
+
 public partial struct PathWindowWrapper : IDisposable
 {
     public readonly bool IsWindowOpen => _windowHost.IsWindowOpen;
@@ -27,10 +35,82 @@ public partial struct PathWindowWrapper : IDisposable
         }
     }
 
+    /// <param name="figureStarts">The indices into <paramref name="points"/> where new figures start, in ascending order.</param>
+    public readonly unsafe void AddPoints(ReadOnlySpan<POINT> points, ReadOnlySpan<int> figureStarts)
+    {
+        fixed (POINT* pPoints = points)
+        fixed (int* pFigureStarts = figureStarts)
+        {
+            VerifyHR(AddPathBatch(_windowHost.GetPWindow(), pPoints, points.Length, pFigureStarts, figureStarts.Length));
+        }
+    }
+
+    /// <param name="movements">The virtual screen positions to add, with how long it took to get to each of them.</param>
+    /// <param name="figureStarts">The indices into <paramref name="movements"/> where new figures start, in ascending order.</param>
+    public readonly unsafe void AddPoints(ReadOnlySpan<MouseMovement> movements, ReadOnlySpan<int> figureStarts)
+    {
+        fixed (MouseMovement* pMovements = movements)
+        fixed (int* pFigureStarts = figureStarts)
+        {
+            VerifyHR(AddTimedPathBatch(_windowHost.GetPWindow(), pMovements, movements.Length, pFigureStarts, figureStarts.Length));
+        }
+    }
+
     public readonly void ClearPath() => VerifyHR(ClearPoints(_windowHost.GetPWindow()));
 
     public readonly void RenderPath() => VerifyHR(Render(_windowHost.GetPWindow()));
 
+    /// <summary>
+    /// Makes the window keep only the newest points of the path, so it takes constant memory however long it gets. Clears the path.
+    /// </summary>
+    /// <param name="maxPoints">How many points are kept at most, 0 shows the whole path again.</param>
+    /// <param name="maxAge">How long points are kept, <see cref="TimeSpan.Zero"/> keeps them until newer ones push them out.</param>
+    /// <param name="fadeBuckets">How many steps older segments fade out in, 1 does not fade.</param>
+    public readonly void SetTrail(int maxPoints, TimeSpan maxAge, int fadeBuckets)
+        => VerifyHR(SetPathTrail(_windowHost.GetPWindow(), maxPoints, (int)maxAge.TotalMilliseconds, fadeBuckets));
+
+    /// <summary>
+    /// Makes the window show how often the path passed through each part of it instead of the path itself,
+    /// which stays readable and cheap to draw however long the path gets. Turns the trail off. Clears the path.
+    /// </summary>
+    public readonly void SetHeatmap(bool enabled) => VerifyHR(SetPathHeatmap(_windowHost.GetPWindow(), enabled));
+
+    /// <summary>
+    /// Colors every segment of the path by how fast the cursor moved along it, or by when it got there, from blue to red.
+    /// Only points added with their delays are colored by them. Turns the trail and the heatmap off. Clears the path.
+    /// </summary>
+    /// <param name="bucketCount">How many steps the colors go through, from 1 to 32.</param>
+    public readonly void SetColoring(PathColoring coloring, int bucketCount)
+        => VerifyHR(SetPathColoring(_windowHost.GetPWindow(), (int)coloring, bucketCount));
+
+    /// <summary>
+    /// Moves a marker along the movements as fast as replaying them would move the cursor, without moving it.
+    /// Nothing else is shown until <see cref="StopReplay"/>, points added in the meantime are shown after it.
+    /// </summary>
+    /// <param name="movements">The virtual screen positions to replay, a movement without a delay starts a new figure.</param>
+    /// <param name="speed">How many times faster than recorded, from 0.01 to 100.</param>
+    /// <param name="showTrail">Whether to draw the path only as far as the marker got.</param>
+    public readonly unsafe void StartReplay(ReadOnlySpan<MouseMovement> movements, float speed, bool showTrail)
+    {
+        fixed (MouseMovement* pMovements = movements)
+        {
+            VerifyHR(StartPathReplay(_windowHost.GetPWindow(), pMovements, movements.Length, speed, showTrail));
+        }
+    }
+
+    public readonly void StopReplay() => VerifyHR(StopPathReplay(_windowHost.GetPWindow()));
+
+    /// <param name="speed">How many times faster than recorded, from 0.01 to 100.</param>
+    public readonly void SetReplaySpeed(float speed) => VerifyHR(SetPathReplaySpeed(_windowHost.GetPWindow(), speed));
+
+    /// <summary>
+    /// Pauses or resumes the replay, resuming one that ended starts it over.
+    /// </summary>
+    public readonly void SetReplayPaused(bool paused) => VerifyHR(SetPathReplayPaused(_windowHost.GetPWindow(), paused));
+
+    /// <param name="time">How far into the recording, regardless of the speed.</param>
+    public readonly void SeekReplay(TimeSpan time) => VerifyHR(SeekPathReplay(_windowHost.GetPWindow(), (int)time.TotalMilliseconds));
+
     public void Dispose() => _windowHost.Dispose();
 
     private static void VerifyHR(HResult hr)
@@ -53,13 +133,63 @@ public partial struct PathWindowWrapper : IDisposable
     [UnmanagedCallConv(CallConvs = new[] { typeof(CallConvCdecl) })]
     private static unsafe partial HResult AddPointsToPath(nint pPathWindow, POINT* points, int length);
 
+    [LibraryImport(WindowHostWrapper.PathWindowsDll)]
+    [DefaultDllImportSearchPaths(DllImportSearchPath.AssemblyDirectory)]
+    [UnmanagedCallConv(CallConvs = new[] { typeof(CallConvCdecl) })]
+    private static unsafe partial HResult AddPathBatch(nint pPathWindow, POINT* points, int length, int* figureStarts, int figureCount);
+
     [LibraryImport(WindowHostWrapper.PathWindowsDll)]
     [DefaultDllImportSearchPaths(DllImportSearchPath.AssemblyDirectory)]
     [UnmanagedCallConv(CallConvs = new[] { typeof(CallConvCdecl) })]
     private static partial HResult ClearPoints(nint pPathWindow);
 
+    [LibraryImport(WindowHostWrapper.PathWindowsDll)]
+    [DefaultDllImportSearchPaths(DllImportSearchPath.AssemblyDirectory)]
+    [UnmanagedCallConv(CallConvs = new[] { typeof(CallConvCdecl) })]
+    private static unsafe partial HResult AddTimedPathBatch(nint pPathWindow, MouseMovement* movements, int length, int* figureStarts, int figureCount);
+
     [LibraryImport(WindowHostWrapper.PathWindowsDll)]
     [DefaultDllImportSearchPaths(DllImportSearchPath.AssemblyDirectory)]
     [UnmanagedCallConv(CallConvs = new[] { typeof(CallConvCdecl) })]
     private static partial HResult Render(nint pPathWindow);
+
+    [LibraryImport(WindowHostWrapper.PathWindowsDll)]
+    [DefaultDllImportSearchPaths(DllImportSearchPath.AssemblyDirectory)]
+    [UnmanagedCallConv(CallConvs = new[] { typeof(CallConvCdecl) })]
+    private static partial HResult SetPathTrail(nint pPathWindow, int maxPoints, int maxAgeMS, int fadeBuckets);
+
+    [LibraryImport(WindowHostWrapper.PathWindowsDll)]
+    [DefaultDllImportSearchPaths(DllImportSearchPath.AssemblyDirectory)]
+    [UnmanagedCallConv(CallConvs = new[] { typeof(CallConvCdecl) })]
+    private static partial HResult SetPathHeatmap(nint pPathWindow, [MarshalAs(UnmanagedType.I1)] bool enabled);
+
+    [LibraryImport(WindowHostWrapper.PathWindowsDll)]
+    [DefaultDllImportSearchPaths(DllImportSearchPath.AssemblyDirectory)]
+    [UnmanagedCallConv(CallConvs = new[] { typeof(CallConvCdecl) })]
+    private static partial HResult SetPathColoring(nint pPathWindow, int coloring, int bucketCount);
+
+    [LibraryImport(WindowHostWrapper.PathWindowsDll)]
+    [DefaultDllImportSearchPaths(DllImportSearchPath.AssemblyDirectory)]
+    [UnmanagedCallConv(CallConvs = new[] { typeof(CallConvCdecl) })]
+    private static unsafe partial HResult StartPathReplay(nint pPathWindow, MouseMovement* movements, int length, float speed, [MarshalAs(UnmanagedType.I1)] bool showTrail);
+
+    [LibraryImport(WindowHostWrapper.PathWindowsDll)]
+    [DefaultDllImportSearchPaths(DllImportSearchPath.AssemblyDirectory)]
+    [UnmanagedCallConv(CallConvs = new[] { typeof(CallConvCdecl) })]
+    private static partial HResult StopPathReplay(nint pPathWindow);
+
+    [LibraryImport(WindowHostWrapper.PathWindowsDll)]
+    [DefaultDllImportSearchPaths(DllImportSearchPath.AssemblyDirectory)]
+    [UnmanagedCallConv(CallConvs = new[] { typeof(CallConvCdecl) })]
+    private static partial HResult SetPathReplaySpeed(nint pPathWindow, float speed);
+
+    [LibraryImport(WindowHostWrapper.PathWindowsDll)]
+    [DefaultDllImportSearchPaths(DllImportSearchPath.AssemblyDirectory)]
+    [UnmanagedCallConv(CallConvs = new[] { typeof(CallConvCdecl) })]
+    private static partial HResult SetPathReplayPaused(nint pPathWindow, [MarshalAs(UnmanagedType.I1)] bool paused);
+
+    [LibraryImport(WindowHostWrapper.PathWindowsDll)]
+    [DefaultDllImportSearchPaths(DllImportSearchPath.AssemblyDirectory)]
+    [UnmanagedCallConv(CallConvs = new[] { typeof(CallConvCdecl) })]
+    private static partial HResult SeekPathReplay(nint pPathWindow, int timeMS);
 }
@@ -25,6 +25,57 @@ public partial struct WindowHostWrapper : IDisposable
 
     public readonly nint GetPWindow() => GetPWindow(_pWindowHost);
 
+    /// <summary>
+    /// How long it took from opening the window until it showed its first frame, or <see langword="null"/> if it did not open.
+    /// </summary>
+    public readonly unsafe TimeSpan? GetOpenLatency()
+    {
+        long latencyNS = -1;
+        VerifyHRAndWin32Err(GetPathWindowOpenLatency(_pWindowHost, &latencyNS));
+
+        return latencyNS < 0 ? null : TimeSpan.FromTicks(latencyNS / 100);
+    }
+
+    /// <summary>
+    /// Starts the thread the path windows live on ahead of time, so that opening the first one is as fast as opening the rest.
+    /// </summary>
+    public static void WarmUp() => VerifyHRAndWin32Err(WarmUpWindowHost());
+
+    /// <summary>
+    /// Stops the thread the path windows live on. Fails while any of them is open.
+    /// </summary>
+    public static void Shutdown() => VerifyHRAndWin32Err(ShutdownWindowHost());
+
+    /// <summary>
+    /// Makes the open drawable path window turn the drawn strokes into timed movements when it closes.
+    /// </summary>
+    /// <param name="maxStepLength">The longest step between two movements, in pixels (at least 1).</param>
+    /// <param name="nsPerPixel">How long the cursor takes to move one pixel.</param>
+    public readonly void SetDrawnPathResampling(float maxStepLength, double nsPerPixel, Interpolation interpolation, Easing easing)
+        => VerifyHRAndWin32Err(SetDrawnPathResampling(GetPWindow(_pWindowHost), maxStepLength, nsPerPixel, interpolation, easing));
+
+    /// <summary>
+    /// Copies the movements of the strokes drawn in the open drawable path window that were finished since the last call.
+    /// </summary>
+    /// <param name="cleared">Set if the path was cleared since the last call, everything copied before is stale then.</param>
+    /// <returns>The number of movements copied into <paramref name="destination"/>.</returns>
+    public readonly unsafe int PullDrawnStrokes(Span<MouseMovement> destination, out bool cleared)
+    {
+        int count = 0;
+        bool pathCleared = false;
+        HResult hr;
+
+        fixed (MouseMovement* pDestination = destination)
+        {
+            hr = PullDrawnStrokes(GetPWindow(_pWindowHost), pDestination, destination.Length, &count, &pathCleared);
+        }
+
+        VerifyHRAndWin32Err(hr);
+
+        cleared = pathCleared;
+        return count;
+    }
+
     public void CloseWindow()
     {
         if (_pWindowHost == 0) return;
@@ -101,8 +152,32 @@ public partial struct WindowHostWrapper : IDisposable
         }
     }
 
+    public enum Interpolation : uint
+    {
+        Linear,
+        CatmullRom,
+    }
+
+    public enum Easing : uint
+    {
+        Constant,
+        EaseInOut,
+    }
+
+    /// <param name="preloadedLength">
+    /// The length of the path the window was opened with, which <paramref name="points"/> starts with,
+    /// or -1 if erasing changed it, in which case <paramref name="points"/> replaces it.
+    /// </param>
+    /// <remarks>
+    /// The callback owns <paramref name="points"/> and must release it with <see cref="ReleaseDrawnPath"/>.
+    /// </remarks>
     [UnmanagedFunctionPointer(CallingConvention.Cdecl)]
-    public unsafe delegate void WindowClosingCallback(MouseMovement* points, int length);
+    public unsafe delegate void WindowClosingCallback(MouseMovement* points, int length, int preloadedLength);
+
+    [LibraryImport(PathWindowsDll)]
+    [DefaultDllImportSearchPaths(DllImportSearchPath.AssemblyDirectory)]
+    [UnmanagedCallConv(CallConvs = new[] { typeof(CallConvCdecl) })]
+    public static unsafe partial void ReleaseDrawnPath(MouseMovement* path);
 
     [LibraryImport(PathWindowsDll, SetLastError = true)]
     [DefaultDllImportSearchPaths(DllImportSearchPath.AssemblyDirectory)]
@@ -119,6 +194,16 @@ public partial struct WindowHostWrapper : IDisposable
     [UnmanagedCallConv(CallConvs = new[] { typeof(CallConvCdecl) })]
     private static partial nint GetPWindow(nint pWrapper);
 
+    [LibraryImport(PathWindowsDll)]
+    [DefaultDllImportSearchPaths(DllImportSearchPath.AssemblyDirectory)]
+    [UnmanagedCallConv(CallConvs = new[] { typeof(CallConvCdecl) })]
+    private static partial HResult SetDrawnPathResampling(nint pDrawablePathWindow, float maxStepLength, double nsPerPixel, Interpolation interpolation, Easing easing);
+
+    [LibraryImport(PathWindowsDll)]
+    [DefaultDllImportSearchPaths(DllImportSearchPath.AssemblyDirectory)]
+    [UnmanagedCallConv(CallConvs = new[] { typeof(CallConvCdecl) })]
+    private static unsafe partial HResult PullDrawnStrokes(nint pDrawablePathWindow, MouseMovement* destination, int capacity, int* pCount, bool* pCleared);
+
     [LibraryImport(PathWindowsDll, SetLastError = true)]
     [DefaultDllImportSearchPaths(DllImportSearchPath.AssemblyDirectory)]
     [UnmanagedCallConv(CallConvs = new[] { typeof(CallConvCdecl) })]
@@ -128,4 +213,19 @@ public partial struct WindowHostWrapper : IDisposable
     [DefaultDllImportSearchPaths(DllImportSearchPath.AssemblyDirectory)]
     [UnmanagedCallConv(CallConvs = new[] { typeof(CallConvCdecl) })]
     private static partial void DisposeDangerous(nint pWrapper);
+
+    [LibraryImport(PathWindowsDll)]
+    [DefaultDllImportSearchPaths(DllImportSearchPath.AssemblyDirectory)]
+    [UnmanagedCallConv(CallConvs = new[] { typeof(CallConvCdecl) })]
+    private static unsafe partial HResult GetPathWindowOpenLatency(nint pWrapper, long* pLatencyNS);
+
+    [LibraryImport(PathWindowsDll)]
+    [DefaultDllImportSearchPaths(DllImportSearchPath.AssemblyDirectory)]
+    [UnmanagedCallConv(CallConvs = new[] { typeof(CallConvCdecl) })]
+    private static partial HResult WarmUpWindowHost();
+
+    [LibraryImport(PathWindowsDll)]
+    [DefaultDllImportSearchPaths(DllImportSearchPath.AssemblyDirectory)]
+    [UnmanagedCallConv(CallConvs = new[] { typeof(CallConvCdecl) })]
+    private static partial HResult ShutdownWindowHost();
 }
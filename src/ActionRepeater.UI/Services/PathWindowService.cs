@@ -1,6 +1,5 @@
 ﻿using System;
 using System.Diagnostics;
-using System.Linq;
 using System.Threading;
 using System.Threading.Tasks;
 using ActionRepeater.Core.Action;
@@ -17,18 +16,30 @@ public sealed class PathWindowService : IDisposable
     public bool IsPathWindowOpen => _pathWindowWrapper.IsWindowOpen;
 
     private ActionCollection _actionCollection;
+    private readonly UIOptions _uiOptions;
     private PathWindowWrapper _pathWindowWrapper;
 
+    // how many steps the older parts of a trail fade out in
+    private const int TrailFadeBuckets = 8;
+    // how many colors a colored path goes through
+    private const int ColorBuckets = 16;
+
     private readonly PeriodicTimer _timer = new(TimeSpan.FromMilliseconds(20));
     private int _lastCount;
     private POINT? _lastAbsPoint;
+    private MouseMovement[] _newMovements = new MouseMovement[64];
+    // how long it has been since the last point that was added, movements that do not move the cursor only add to it
+    private long _pendingDelayNS;
     private Func<ValueTask>? _updatePathWindowTask;
+    // a replay hides points added in the meantime, so recording stops it
+    private volatile bool _isReplaying;
 
     private bool _disposed;
 
-    public PathWindowService(ActionCollection actionCollection)
+    public PathWindowService(ActionCollection actionCollection, UIOptions uiOptions)
     {
         _actionCollection = actionCollection;
+        _uiOptions = uiOptions;
     }
 
     public void OpenWindow()
@@ -42,17 +53,26 @@ public sealed class PathWindowService : IDisposable
             Debug.Assert(_actionCollection.CursorPath.Count == 0, $"{nameof(_actionCollection.CursorPath)} is not empty.");
 
             _pathWindowWrapper.OpenWindow();
+            ApplyDisplayOptions();
 
             _lastAbsPoint = null;
         }
         else
         {
-            var absCursorPts = _actionCollection.GetAbsoluteCursorPath().Select(p => GetVirtScreenPosFromPosRelToPrimary(p.Delta)).ToArray();
-            _lastAbsPoint = absCursorPts[^1];
+            var absCursorPath = CursorPathConverter.GetAbsoluteVirtScreenPath(_actionCollection);
+
+            // _lastAbsPoint is relative to the primary monitor
+            _lastAbsPoint = GetPosRelToPrimaryFromVirtScreenPoint(absCursorPath[^1].Delta);
 
-            _pathWindowWrapper.OpenWindow(absCursorPts);
+            // added with the delays, so the path can be colored by them
+            _pathWindowWrapper.OpenWindow();
+            ApplyDisplayOptions();
+            _pathWindowWrapper.AddPoints(absCursorPath, ReadOnlySpan<int>.Empty);
         }
 
+        _pendingDelayNS = 0;
+        _isReplaying = false;
+
         RunUpdatePathWindowTask();
     }
 
@@ -63,6 +83,44 @@ public sealed class PathWindowService : IDisposable
         _pathWindowWrapper.CloseWindow();
     }
 
+    /// <summary>
+    /// Moves a marker along the cursor path as fast as playing it moves the cursor, drawing the path as far as the marker got.
+    /// </summary>
+    public void ReplayPath()
+    {
+        Debug.Assert(_pathWindowWrapper.IsWindowOpen);
+
+        var absCursorPath = CursorPathConverter.GetAbsoluteVirtScreenPath(_actionCollection);
+        if (absCursorPath.Length == 0) return;
+
+        _pathWindowWrapper.StartReplay(absCursorPath, 1f, showTrail: true);
+        _isReplaying = true;
+    }
+
+    // set before the path is added, each of them clears it
+    private void ApplyDisplayOptions()
+    {
+        switch (_uiOptions.PathDisplay)
+        {
+            case PathDisplay.Heatmap:
+                _pathWindowWrapper.SetHeatmap(true);
+                break;
+
+            case PathDisplay.ColoredBySpeed:
+                _pathWindowWrapper.SetColoring(PathColoring.Speed, ColorBuckets);
+                break;
+
+            case PathDisplay.ColoredByTime:
+                _pathWindowWrapper.SetColoring(PathColoring.ElapsedTime, ColorBuckets);
+                break;
+
+            default:
+                // a long recording only shows its newest points, which keeps the window cheap to draw while recording
+                if (_uiOptions.PathTrailLength > 0) _pathWindowWrapper.SetTrail(_uiOptions.PathTrailLength, TimeSpan.Zero, TrailFadeBuckets);
+                break;
+        }
+    }
+
     // TODO: Fix cursor path being inaccurate while path window is open
     private void RunUpdatePathWindowTask()
     {
@@ -83,6 +141,12 @@ public sealed class PathWindowService : IDisposable
 
                 if (!_pathWindowWrapper.IsWindowOpen) break;
 
+                if (_isReplaying)
+                {
+                    _isReplaying = false;
+                    _pathWindowWrapper.StopReplay();
+                }
+
                 if (cursorPath.Count == 0)
                 {
                     _lastCount = 0;
@@ -99,17 +163,22 @@ public sealed class PathWindowService : IDisposable
 
                 int count = cursorPath.Count;
 
+                // collect everything new and hand it over in one call
+                int newPointCount = 0;
                 for (int i = _lastCount; i < count; i++)
                 {
                     POINT newPoint = MouseMovement.OffsetPointWithinScreens(_lastAbsPoint.Value, cursorPath[i].Delta);
+                    _pendingDelayNS += cursorPath[i].DelayDurationNS;
                     if (_lastAbsPoint == newPoint) continue;
 
-                    _pathWindowWrapper.AddPoint(GetVirtScreenPosFromPosRelToPrimary(newPoint), render: false);
+                    if (newPointCount == _newMovements.Length) Array.Resize(ref _newMovements, _newMovements.Length * 2);
+                    _newMovements[newPointCount++] = new MouseMovement(GetVirtScreenPosFromPosRelToPrimary(newPoint), _pendingDelayNS);
 
                     _lastAbsPoint = newPoint;
+                    _pendingDelayNS = 0;
                 }
 
-                _pathWindowWrapper.RenderPath();
+                if (newPointCount > 0) _pathWindowWrapper.AddPoints(_newMovements.AsSpan(0, newPointCount), ReadOnlySpan<int>.Empty);
 
                 _lastCount = count;
             }
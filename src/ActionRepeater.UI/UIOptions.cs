@@ -14,6 +14,21 @@ public sealed class UIOptions : ObservableObject
         set => SetProperty(ref _theme, value);
     }
 
+    private PathDisplay _pathDisplay = PathDisplay.Path;
+    public PathDisplay PathDisplay
+    {
+        get => _pathDisplay;
+        set => SetProperty(ref _pathDisplay, value);
+    }
+
+    // how many of the newest points the cursor path window shows, 0 shows the whole path
+    private int _pathTrailLength;
+    public int PathTrailLength
+    {
+        get => _pathTrailLength;
+        set => SetProperty(ref _pathTrailLength, value);
+    }
+
     private OptionsFileLocation _optionsFileLocation = OptionsFileLocation.None;
     public OptionsFileLocation OptionsFileLocation
     {
@@ -29,6 +44,15 @@ public enum Theme
     Dark,
 }
 
+// what the cursor path window shows
+public enum PathDisplay
+{
+    Path = 0,
+    Heatmap,
+    ColoredBySpeed,
+    ColoredByTime,
+}
+
 public enum OptionsFileLocation
 {
     None,
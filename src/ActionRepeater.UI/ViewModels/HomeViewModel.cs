@@ -79,6 +79,7 @@ public sealed partial class HomeViewModel : ObservableObject
         _recorder.IsRecordingChanged += (_, _) =>
         {
             PlayActionsCommand.NotifyCanExecuteChanged();
+            ReplayCursorPathCommand.NotifyCanExecuteChanged();
             OnPropertyChanged(nameof(CanAddAction));
         };
         _actionCollection.ActionsCountChanged += (_, _) => PlayActionsCommand.NotifyCanExecuteChanged();
@@ -120,19 +121,26 @@ public sealed partial class HomeViewModel : ObservableObject
         if (_pathWindowService.IsPathWindowOpen)
         {
             _pathWindowService.CloseWindow();
-            return;
+        }
+        else
+        {
+            _pathWindowService.OpenWindow();
         }
 
-        _pathWindowService.OpenWindow();
+        ReplayCursorPathCommand.NotifyCanExecuteChanged();
     }
 
+    [RelayCommand(CanExecute = nameof(CanReplayCursorPath))]
+    private void ReplayCursorPath() => _pathWindowService.ReplayPath();
+    private bool CanReplayCursorPath() => _pathWindowService.IsPathWindowOpen && !_recorder.IsRecording && _actionCollection.CursorPathStart is not null;
+
     [RelayCommand(CanExecute = nameof(CanAddAction))]
     private Task AddAction(ActionType actionType) => _dialogService.ShowEditActionDialog(actionType);
 
     [RelayCommand]
     private void OpenCursorPathDrawingWindow()
     {
-        _drawablePathWindowService.OpenWindow(5_000_000);
+        _drawablePathWindowService.OpenWindow(1_000_000);
         IsDrawablePathWindowOpen = true;
     }
 }
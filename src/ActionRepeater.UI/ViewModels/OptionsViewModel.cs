@@ -49,6 +49,20 @@ public sealed class OptionsViewModel : ObservableObject
         set => _options.UI.Theme = (Theme)value;
     }
 
+    public int PathDisplay
+    {
+        get => (int)_options.UI.PathDisplay;
+        set => _options.UI.PathDisplay = (PathDisplay)value;
+    }
+
+    public bool IsPathDisplayPath => _options.UI.PathDisplay == UI.PathDisplay.Path;
+
+    public int PathTrailLength
+    {
+        get => _options.UI.PathTrailLength;
+        set => _options.UI.PathTrailLength = value;
+    }
+
     public int OptionsFileLocation
     {
         get => (int)_options.UI.OptionsFileLocation;
@@ -57,11 +71,14 @@ public sealed class OptionsViewModel : ObservableObject
 
     public IEnumerable<string> CursorMovementCBItems => Enum.GetNames<CursorMovementMode>().Select(x => x.AddSpacesBetweenWords());
 
+    public IEnumerable<string> PathDisplayCBItems => Enum.GetNames<PathDisplay>().Select(x => x.AddSpacesBetweenWords());
+
     public IEnumerable<string> ThemeCBItems => Enum.GetNames<Theme>().Select(x => x.AddSpacesBetweenWords());
 
 
     private readonly PropertyChangedEventArgs _isCursorMovementModeChangedArgs = new(nameof(IsCursorMovementMode));
     private readonly PropertyChangedEventArgs _displayAccelerationWarningChangedArgs = new(nameof(DisplayAccelerationWarning));
+    private readonly PropertyChangedEventArgs _isPathDisplayPathChangedArgs = new(nameof(IsPathDisplayPath));
 
     private readonly AppOptions _options;
 
@@ -77,6 +94,10 @@ public sealed class OptionsViewModel : ObservableObject
                 OnPropertyChanged(_isCursorMovementModeChangedArgs);
                 OnPropertyChanged(_displayAccelerationWarningChangedArgs);
             }
+            else if (nameof(PathDisplay).Equals(e.PropertyName, StringComparison.Ordinal))
+            {
+                OnPropertyChanged(_isPathDisplayPathChangedArgs);
+            }
         };
         _options.Core.PropertyChanged += callPropChange;
         _options.UI.PropertyChanged += callPropChange;
@@ -0,0 +1,183 @@
+#include "ColorBuckets.h"
+#include <algorithm>
+#include <cmath>
+
+using namespace PathWindows;
+
+namespace
+{
+    // from slow (or old) to fast (or new), spaced evenly, as opaque as the single color path
+    constexpr ColorF GRADIENT_STOPS[] = {
+        { 0.0f, 0.3f, 1.0f, 0.7f },
+        { 0.0f, 0.9f, 0.9f, 0.7f },
+        { 0.2f, 1.0f, 0.2f, 0.7f },
+        { 1.0f, 0.9f, 0.0f, 0.7f },
+        { 1.0f, 0.0f, 0.0f, 0.7f }
+    };
+}
+
+ColorBuckets::ColorBuckets(Scale scale, size_t bucketCount) :
+    m_scale(scale),
+    m_bucketCount(std::max<size_t>(bucketCount, 1)),
+    m_timeScale(INITIAL_TIME_SCALE_NS),
+    m_committedPoints(0),
+    m_fullRedraw(true),
+    m_bucketStarts(m_bucketCount + 1),
+    m_batchCount(0)
+{}
+
+void ColorBuckets::Append(PointF point, int64_t delayNS, bool newFigure)
+{
+    bool startsFigure = newFigure || m_points.empty();
+    int64_t time = m_times.empty() ? 0 : m_times.back() + std::max<int64_t>(delayNS, 0);
+
+    m_points.push_back(point);
+    m_times.push_back(time);
+    m_figureStarts.push_back(startsFigure);
+
+    // every segment changes color when the scale does, which happens less and less often as the path gets longer
+    if (m_scale == Scale::ELAPSED_TIME && time >= m_timeScale)
+    {
+        while (time >= m_timeScale) m_timeScale *= 2;
+        m_fullRedraw = true;
+    }
+}
+
+void ColorBuckets::Clear()
+{
+    m_points.clear();
+    m_times.clear();
+    m_figureStarts.clear();
+
+    m_timeScale = INITIAL_TIME_SCALE_NS;
+    m_committedPoints = 0;
+    m_fullRedraw = true;
+
+    m_runs.clear();
+    m_sortedRuns.clear();
+    m_batchCount = 0;
+}
+
+void ColorBuckets::Invalidate()
+{
+    m_fullRedraw = true;
+}
+
+bool ColorBuckets::NeedsFullRedraw() const
+{
+    return m_fullRedraw;
+}
+
+bool ColorBuckets::HasPending() const
+{
+    return m_fullRedraw || m_committedPoints < m_points.size();
+}
+
+size_t ColorBuckets::GetBucket(size_t index) const
+{
+    size_t last = m_bucketCount - 1;
+
+    if (m_scale == Scale::ELAPSED_TIME)
+    {
+        double t = static_cast<double>(m_times[index]) / static_cast<double>(m_timeScale);
+        return std::min(static_cast<size_t>(t * m_bucketCount), last);
+    }
+
+    float dx = m_points[index].x - m_points[index - 1].x;
+    float dy = m_points[index].y - m_points[index - 1].y;
+    float distance = std::sqrt(dx * dx + dy * dy);
+    int64_t duration = m_times[index] - m_times[index - 1];
+
+    // points that came without a delay moved instantly
+    if (duration <= 0) return distance > 0.0f ? last : 0;
+
+    // the square root spreads out the slow speeds, which most segments have
+    float t = std::sqrt(distance / static_cast<float>(duration) / SPEED_SCALE);
+    return t >= 1.0f ? last : std::min(static_cast<size_t>(t * m_bucketCount), last);
+}
+
+void ColorBuckets::Build()
+{
+    m_runs.clear();
+
+    // a pending segment that continues a drawn figure starts at the last drawn point, so they join up
+    size_t first = m_fullRedraw ? 1 : std::max<size_t>(m_committedPoints, 1);
+    bool open = false;
+
+    for (size_t i = first; i < m_points.size(); ++i)
+    {
+        if (m_figureStarts[i])
+        {
+            open = false;
+            continue;
+        }
+
+        uint32_t bucket = static_cast<uint32_t>(GetBucket(i));
+        if (open && m_runs.back().bucket == bucket)
+        {
+            ++m_runs.back().count;
+            continue;
+        }
+
+        m_runs.push_back(Run{ static_cast<uint32_t>(i - 1), 2, bucket });
+        open = true;
+    }
+
+    // sorted by counting the runs of each bucket, which keeps them in path order within it
+    std::fill(m_bucketStarts.begin(), m_bucketStarts.end(), 0u);
+    for (const Run& run : m_runs) ++m_bucketStarts[run.bucket + 1];
+
+    m_batchCount = 0;
+    for (size_t b = 0; b < m_bucketCount; ++b)
+    {
+        if (m_bucketStarts[b + 1] > 0) ++m_batchCount;
+        m_bucketStarts[b + 1] += m_bucketStarts[b];
+    }
+
+    m_sortedRuns.resize(m_runs.size());
+    for (const Run& run : m_runs) m_sortedRuns[m_bucketStarts[run.bucket]++] = run;
+}
+
+size_t ColorBuckets::GetBatchCount() const
+{
+    return m_batchCount;
+}
+
+size_t ColorBuckets::GetRunCount() const
+{
+    return m_sortedRuns.size();
+}
+
+void ColorBuckets::Commit()
+{
+    m_committedPoints = m_points.size();
+    m_fullRedraw = false;
+}
+
+size_t ColorBuckets::GetBucketCount() const
+{
+    return m_bucketCount;
+}
+
+size_t ColorBuckets::GetPointCount() const
+{
+    return m_points.size();
+}
+
+int64_t ColorBuckets::GetTimeScale() const
+{
+    return m_timeScale;
+}
+
+ColorF ColorBuckets::GetColor(size_t bucket) const
+{
+    constexpr size_t lastStop = sizeof(GRADIENT_STOPS) / sizeof(GRADIENT_STOPS[0]) - 1;
+
+    float t = m_bucketCount > 1 ? static_cast<float>(bucket) / static_cast<float>(m_bucketCount - 1) * lastStop : static_cast<float>(lastStop);
+    size_t stop = std::min(static_cast<size_t>(t), lastStop - 1);
+    float f = t - static_cast<float>(stop);
+
+    const ColorF& from = GRADIENT_STOPS[stop];
+    const ColorF& to = GRADIENT_STOPS[stop + 1];
+    return ColorF{ from.r + (to.r - from.r) * f, from.g + (to.g - from.g) * f, from.b + (to.b - from.b) * f, from.a + (to.a - from.a) * f };
+}
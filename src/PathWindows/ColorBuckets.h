@@ -0,0 +1,96 @@
+#pragma once
+#include "PathTypes.h"
+#include <vector>
+#include <cstdint>
+#include <cstddef>
+
+namespace PathWindows
+{
+    // Colors a path by how fast the cursor moved along each segment, or by when it got there, through a gradient
+    // quantized into a small number of buckets. The segments to draw are sorted into one list of runs per bucket, so a
+    // frame strokes one geometry per bucket instead of one per segment. Remembers how much of the path was drawn, like
+    // StrokeAccumulator, so only new segments have to be drawn unless the colors of old ones changed.
+    class ColorBuckets
+    {
+    public:
+        enum class Scale
+        {
+            // from slow to fast, up to SPEED_SCALE
+            SPEED,
+            // from the start of the path to its end, the time it covers doubles whenever the path gets longer than it
+            ELAPSED_TIME
+        };
+
+        // Pixels per nanosecond, a segment this fast or faster gets the last bucket.
+        static constexpr float SPEED_SCALE = 4.0f / 1'000'000.0f;
+        // The time the elapsed time scale starts with.
+        static constexpr int64_t INITIAL_TIME_SCALE_NS = 1'000'000'000;
+
+        ColorBuckets(Scale scale, size_t bucketCount);
+
+        // Adds the segment from the last point to this one, which took delayNS, or starts a new figure with it.
+        void Append(PointF point, int64_t delayNS, bool newFigure);
+
+        void Clear();
+
+        // Forces the next frame to draw everything, e.g. after the surface it was drawn on was lost.
+        void Invalidate();
+
+        bool NeedsFullRedraw() const;
+        bool HasPending() const;
+
+        // Sorts the segments that were not drawn yet (all of them if everything has to be drawn) into their buckets.
+        void Build();
+
+        // Calls fn(size_t bucket, const PointF* points, size_t count) for every run of segments of the same figure in the
+        // same bucket that Build sorted, bucket by bucket.
+        template<class Fn>
+        void ForEachRun(Fn&& fn) const
+        {
+            for (const Run& run : m_sortedRuns) fn(run.bucket, m_points.data() + run.first, run.count);
+        }
+
+        // How many buckets Build put any runs in, which is how many strokes drawing them takes.
+        size_t GetBatchCount() const;
+        size_t GetRunCount() const;
+
+        // Marks everything as drawn.
+        void Commit();
+
+        size_t GetBucketCount() const;
+        size_t GetPointCount() const;
+        int64_t GetTimeScale() const;
+
+        // The bucket of the segment that ends at the index-th point, which must not start a figure.
+        size_t GetBucket(size_t index) const;
+        // Straight alpha, the gradient runs from blue (slow or old) to red (fast or new).
+        ColorF GetColor(size_t bucket) const;
+
+    private:
+        struct Run
+        {
+            uint32_t first;
+            uint32_t count;
+            uint32_t bucket;
+        };
+
+        Scale m_scale;
+        size_t m_bucketCount;
+
+        std::vector<PointF> m_points;
+        // from the start of the path
+        std::vector<int64_t> m_times;
+        std::vector<uint8_t> m_figureStarts;
+
+        int64_t m_timeScale;
+
+        size_t m_committedPoints;
+        bool m_fullRedraw;
+
+        // reused for every build, the runs in path order and then sorted by bucket
+        std::vector<Run> m_runs;
+        std::vector<Run> m_sortedRuns;
+        std::vector<uint32_t> m_bucketStarts;
+        size_t m_batchCount;
+    };
+}
@@ -0,0 +1,153 @@
+#include "CursorPath.h"
+#include <cstdint>
+
+using namespace PathWindows;
+using namespace PathWindows::CursorPath;
+
+namespace
+{
+    inline bool ContainsInclusive(const RectI& rect, int32_t x, int32_t y)
+    {
+        return x >= rect.left && x <= rect.right && y >= rect.top && y <= rect.bottom;
+    }
+
+    // int arithmetic in C# wraps around instead of overflowing
+    inline int32_t WrappingAdd(int32_t a, int32_t b)
+    {
+        return static_cast<int32_t>(static_cast<uint32_t>(a) + static_cast<uint32_t>(b));
+    }
+
+    inline int32_t WrappingSub(int32_t a, int32_t b)
+    {
+        return static_cast<int32_t>(static_cast<uint32_t>(a) - static_cast<uint32_t>(b));
+    }
+
+    // Whether any monitor contains the point. Which one does not matter, so the one that matched last time is tried first.
+    class MonitorLookup
+    {
+    public:
+        MonitorLookup(const RectI* monitors, size_t count) :
+            m_monitors(monitors),
+            m_count(count),
+            m_lastHit(0)
+        {}
+
+        bool AnyContains(int32_t x, int32_t y)
+        {
+            if (m_lastHit < m_count && ContainsInclusive(m_monitors[m_lastHit], x, y)) return true;
+
+            for (size_t i = 0; i < m_count; ++i)
+            {
+                if (ContainsInclusive(m_monitors[i], x, y))
+                {
+                    m_lastHit = i;
+                    return true;
+                }
+            }
+
+            return false;
+        }
+
+        // Monitors share their edges, so unlike AnyContains this has to respect the order.
+        const RectI* FirstContaining(int32_t x, int32_t y) const
+        {
+            for (size_t i = 0; i < m_count; ++i)
+            {
+                if (ContainsInclusive(m_monitors[i], x, y)) return &m_monitors[i];
+            }
+
+            return nullptr;
+        }
+
+    private:
+        const RectI* m_monitors;
+        size_t m_count;
+        size_t m_lastHit;
+    };
+
+    Result Offset(PointI point, PointI offset, MonitorLookup& lookup, PointI& result)
+    {
+        // the monitor the point started on is only needed when clamping, but it has to be on one either way
+        if (!lookup.AnyContains(point.x, point.y)) return Result::OFF_SCREEN;
+
+        PointI moved{ WrappingAdd(point.x, offset.x), point.y };
+        if (!lookup.AnyContains(moved.x, moved.y))
+        {
+            const RectI* pOrigin = lookup.FirstContaining(point.x, point.y);
+            moved.x = offset.x < 0 ? pOrigin->left : pOrigin->right;
+        }
+
+        moved.y = WrappingAdd(point.y, offset.y);
+        if (!lookup.AnyContains(moved.x, moved.y))
+        {
+            const RectI* pOrigin = lookup.FirstContaining(point.x, point.y);
+            moved.y = offset.y < 0 ? pOrigin->top : pOrigin->bottom;
+        }
+
+        result = moved;
+        return Result::OK;
+    }
+}
+
+Result CursorPath::OffsetWithinMonitors(PointI point, PointI offset, const RectI* monitors, size_t monitorCount, PointI& result)
+{
+    MonitorLookup lookup(monitors, monitorCount);
+    return Offset(point, offset, lookup, result);
+}
+
+Result CursorPath::ToAbsolute(Movement start, const Movement* deltas, size_t count, const RectI* monitors, size_t monitorCount,
+    PointI origin, Movement* out, size_t& outCount)
+{
+    MonitorLookup lookup(monitors, monitorCount);
+
+    PointI last = start.delta;
+    out[0] = start;
+    size_t written = 1;
+
+    for (size_t i = 0; i < count; ++i)
+    {
+        PointI next;
+        Result result = Offset(last, deltas[i].delta, lookup, next);
+        if (result != Result::OK)
+        {
+            outCount = 0;
+            return result;
+        }
+
+        if (next.x == last.x && next.y == last.y)
+        {
+            out[written - 1].delayDurationNS += deltas[i].delayDurationNS;
+            continue;
+        }
+
+        out[written++] = Movement{ next, deltas[i].delayDurationNS };
+        last = next;
+    }
+
+    // done separately so the loop above compares untranslated positions
+    if (origin.x != 0 || origin.y != 0)
+    {
+        for (size_t i = 0; i < written; ++i)
+        {
+            out[i].delta.x = WrappingAdd(out[i].delta.x, origin.x);
+            out[i].delta.y = WrappingAdd(out[i].delta.y, origin.y);
+        }
+    }
+
+    outCount = written;
+    return Result::OK;
+}
+
+void CursorPath::ToRelative(Movement* path, size_t count, PointI origin)
+{
+    if (count == 0) return;
+
+    for (size_t i = count - 1; i >= 1; --i)
+    {
+        path[i].delta.x = WrappingSub(path[i].delta.x, path[i - 1].delta.x);
+        path[i].delta.y = WrappingSub(path[i].delta.y, path[i - 1].delta.y);
+    }
+
+    path[0].delta.x = WrappingSub(path[0].delta.x, origin.x);
+    path[0].delta.y = WrappingSub(path[0].delta.y, origin.y);
+}
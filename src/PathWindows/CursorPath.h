@@ -0,0 +1,34 @@
+#pragma once
+#include "PathTypes.h"
+#include <cstddef>
+
+namespace PathWindows
+{
+    // Bulk conversion of recorded cursor paths between relative movements (deltas) and absolute positions, with the
+    // positions kept on the monitors the same way the app does it (MouseMovement.OffsetPointWithinScreens).
+    // Monitor rects include their right and bottom edges here.
+    namespace CursorPath
+    {
+        enum class Result
+        {
+            OK,
+            // a position was not on any monitor
+            OFF_SCREEN
+        };
+
+        // Moves point by offset, one axis at a time. If moving along an axis leaves every monitor, the position on that
+        // axis snaps to the edge (in the direction of movement) of the first monitor that contained point.
+        Result OffsetWithinMonitors(PointI point, PointI offset, const RectI* monitors, size_t monitorCount, PointI& result);
+
+        // Writes start, then the position after each delta in turn. Deltas that do not move the cursor are not written,
+        // their delay is added to the last written movement instead.
+        // out needs room for count + 1 movements, outCount receives how many were written. origin is added to every
+        // written position (after clamping), e.g. to convert from primary monitor to virtual screen coordinates.
+        Result ToAbsolute(Movement start, const Movement* deltas, size_t count, const RectI* monitors, size_t monitorCount,
+            PointI origin, Movement* out, size_t& outCount);
+
+        // The inverse of ToAbsolute, in place: every position but the first becomes the delta from the one before it,
+        // and origin is subtracted from the first.
+        void ToRelative(Movement* path, size_t count, PointI origin);
+    }
+}
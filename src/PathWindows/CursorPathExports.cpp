@@ -0,0 +1,41 @@
+#include "pch.h"
+#include "CursorPath.h"
+#include "DrawablePathWindow.h"
+
+using namespace PathWindows;
+
+static_assert(sizeof(PointI) == sizeof(POINT), "PointI must be layout compatible with POINT.");
+static_assert(sizeof(RectI) == sizeof(RECT), "RectI must be layout compatible with RECT.");
+
+// out needs room for length + 1 movements, see CursorPath::ToAbsolute.
+extern "C" __declspec(dllexport) HRESULT __cdecl ToAbsoluteCursorPath(MouseMovement start, const MouseMovement* deltas, int length, const RECT* monitors, int monitorCount, POINT origin, MouseMovement* out, int* pOutLength)
+{
+    if (!out || !pOutLength) return E_POINTER;
+    if (length < 0 || (length > 0 && !deltas)) return E_INVALIDARG;
+    if (monitorCount < 1 || !monitors) return E_INVALIDARG;
+
+    size_t outCount = 0;
+    CursorPath::Result result = CursorPath::ToAbsolute(
+        reinterpret_cast<const Movement&>(start),
+        reinterpret_cast<const Movement*>(deltas),
+        length,
+        reinterpret_cast<const RectI*>(monitors),
+        monitorCount,
+        PointI{ origin.x, origin.y },
+        reinterpret_cast<Movement*>(out),
+        outCount);
+
+    if (result == CursorPath::Result::OFF_SCREEN) return HRESULT_FROM_WIN32(ERROR_INVALID_DATA);
+
+    *pOutLength = static_cast<int>(outCount);
+    return S_OK;
+}
+
+extern "C" __declspec(dllexport) HRESULT __cdecl ToRelativeCursorPath(MouseMovement* path, int length, POINT origin)
+{
+    if (length < 0 || (length > 0 && !path)) return E_INVALIDARG;
+
+    CursorPath::ToRelative(reinterpret_cast<Movement*>(path), length, PointI{ origin.x, origin.y });
+
+    return S_OK;
+}
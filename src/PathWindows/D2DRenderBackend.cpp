@@ -0,0 +1,267 @@
+#include "pch.h"
+#include "D2DRenderBackend.h"
+#include <algorithm>
+
+#define HR(rval) {\
+                     hr = rval;\
+                     if (FAILED(hr)) return hr;\
+                 }
+
+using namespace PathWindows;
+using Microsoft::WRL::ComPtr;
+
+static_assert(sizeof(PointF) == sizeof(D2D1_POINT_2F), "PointF must be layout compatible with D2D1_POINT_2F.");
+static_assert(sizeof(ColorF) == sizeof(D2D1_COLOR_F), "ColorF must be layout compatible with D2D1_COLOR_F.");
+
+namespace
+{
+    struct SharedResources
+    {
+        ComPtr<ID2D1Factory> pD2Factory;
+        ComPtr<IWICImagingFactory> pWICFactory;
+        ComPtr<ID2D1StrokeStyle> pStrokeStyle;
+    };
+
+    // the factory is single threaded, so it can only be shared by the backends of one thread
+    thread_local SharedResources t_shared;
+}
+
+D2DRenderBackend::D2DRenderBackend(float strokeWidth, ColorF strokeColor) :
+    STROKE_WIDTH(strokeWidth),
+    m_strokeColor(strokeColor),
+
+    m_pD2Factory(nullptr),
+    m_pWICFactory(nullptr),
+    m_pStrokeStyle(nullptr),
+
+    m_pRenderTarget(nullptr),
+    m_pInteropTarget(nullptr),
+    m_pPathBrush(nullptr),
+    m_pPixelBitmap(nullptr),
+
+    m_pGeometry(nullptr),
+    m_pSink(nullptr),
+
+    m_clipPushed(false)
+{}
+
+D2DRenderBackend::~D2DRenderBackend()
+{
+    SafeRelease(&m_pD2Factory);
+    SafeRelease(&m_pWICFactory);
+    SafeRelease(&m_pStrokeStyle);
+
+    DiscardResources();
+}
+
+HRESULT D2DRenderBackend::Initialize()
+{
+    HRESULT hr = S_OK;
+
+    HR(CreateSharedResources());
+
+    m_pD2Factory = t_shared.pD2Factory.Get();
+    m_pD2Factory->AddRef();
+    m_pWICFactory = t_shared.pWICFactory.Get();
+    m_pWICFactory->AddRef();
+    m_pStrokeStyle = t_shared.pStrokeStyle.Get();
+    m_pStrokeStyle->AddRef();
+
+    return hr;
+}
+
+HRESULT D2DRenderBackend::CreateSharedResources()
+{
+    HRESULT hr = S_OK;
+
+    if (t_shared.pStrokeStyle) return hr;
+
+    SharedResources shared;
+    HR(D2D1CreateFactory(D2D1_FACTORY_TYPE_SINGLE_THREADED, shared.pD2Factory.GetAddressOf()));
+    HR(CoCreateInstance(CLSID_WICImagingFactory, NULL, CLSCTX_INPROC_SERVER, IID_PPV_ARGS(shared.pWICFactory.GetAddressOf())));
+    HR(shared.pD2Factory->CreateStrokeStyle(D2D1::StrokeStyleProperties(D2D1_CAP_STYLE_FLAT, D2D1_CAP_STYLE_FLAT, D2D1_CAP_STYLE_FLAT, D2D1_LINE_JOIN_ROUND), nullptr, 0, shared.pStrokeStyle.GetAddressOf()));
+
+    t_shared = shared;
+
+    return hr;
+}
+
+void D2DRenderBackend::ReleaseSharedResources()
+{
+    t_shared = SharedResources();
+}
+
+bool D2DRenderBackend::HasResources()
+{
+    return m_pRenderTarget != nullptr;
+}
+
+HRESULT D2DRenderBackend::CreateResources(int width, int height)
+{
+    HRESULT hr = S_OK;
+
+    if (m_pRenderTarget) return hr;
+    if (!m_pD2Factory || !m_pWICFactory) return E_UNEXPECTED;
+
+    ComPtr<IWICBitmap> pBitmap;
+    HR(m_pWICFactory->CreateBitmap(width, height, GUID_WICPixelFormat32bppPBGRA, WICBitmapCacheOnLoad, pBitmap.GetAddressOf()));
+
+    D2D1_RENDER_TARGET_PROPERTIES renderTargetProps{};
+    renderTargetProps.type = D2D1_RENDER_TARGET_TYPE_DEFAULT;
+    renderTargetProps.pixelFormat = D2D1::PixelFormat(DXGI_FORMAT_B8G8R8A8_UNORM, D2D1_ALPHA_MODE_PREMULTIPLIED);
+    renderTargetProps.dpiX = 0.0f;
+    renderTargetProps.dpiY = 0.0f;
+    renderTargetProps.usage = D2D1_RENDER_TARGET_USAGE_GDI_COMPATIBLE;
+    renderTargetProps.minLevel = D2D1_FEATURE_LEVEL_DEFAULT;
+
+    HR(m_pD2Factory->CreateWicBitmapRenderTarget(pBitmap.Get(), renderTargetProps, &m_pRenderTarget));
+
+    m_pRenderTarget->SetAntialiasMode(D2D1_ANTIALIAS_MODE_PER_PRIMITIVE);
+
+    HR(m_pRenderTarget->CreateSolidColorBrush(reinterpret_cast<const D2D1_COLOR_F&>(m_strokeColor), &m_pPathBrush));
+
+    hr = m_pRenderTarget->QueryInterface(&m_pInteropTarget);
+    if (FAILED(hr)) DiscardResources();
+
+    return hr;
+}
+
+void D2DRenderBackend::DiscardResources()
+{
+    SafeRelease(&m_pSink);
+    SafeRelease(&m_pGeometry);
+
+    SafeRelease(&m_pRenderTarget);
+    SafeRelease(&m_pInteropTarget);
+    SafeRelease(&m_pPathBrush);
+    SafeRelease(&m_pPixelBitmap);
+}
+
+void D2DRenderBackend::BeginDraw()
+{
+    m_pRenderTarget->BeginDraw();
+    m_pRenderTarget->SetTransform(D2D1::Matrix3x2F::Identity());
+}
+
+void D2DRenderBackend::Clear(ColorF color)
+{
+    m_pRenderTarget->Clear(reinterpret_cast<const D2D1_COLOR_F&>(color));
+}
+
+void D2DRenderBackend::Clear(RectI rect, ColorF color)
+{
+    m_pRenderTarget->PushAxisAlignedClip(
+        D2D1::RectF(static_cast<float>(rect.left), static_cast<float>(rect.top), static_cast<float>(rect.right), static_cast<float>(rect.bottom)),
+        D2D1_ANTIALIAS_MODE_ALIASED);
+    m_pRenderTarget->Clear(reinterpret_cast<const D2D1_COLOR_F&>(color));
+    m_pRenderTarget->PopAxisAlignedClip();
+}
+
+HRESULT D2DRenderBackend::BeginStroke()
+{
+    HRESULT hr = S_OK;
+
+    // left over if the last stroke failed half way
+    SafeRelease(&m_pSink);
+    SafeRelease(&m_pGeometry);
+
+    HR(m_pD2Factory->CreatePathGeometry(&m_pGeometry));
+    HR(m_pGeometry->Open(&m_pSink));
+
+    return hr;
+}
+
+void D2DRenderBackend::AddPolyline(const PointF* points, size_t count)
+{
+    if (count < 2) return;
+
+    m_pSink->BeginFigure(D2D1::Point2F(points[0].x, points[0].y), D2D1_FIGURE_BEGIN_HOLLOW);
+    m_pSink->AddLines(reinterpret_cast<const D2D1_POINT_2F*>(points + 1), static_cast<UINT32>(count - 1));
+    m_pSink->EndFigure(D2D1_FIGURE_END_OPEN);
+}
+
+HRESULT D2DRenderBackend::EndStroke()
+{
+    HRESULT hr = m_pSink->Close();
+    SafeRelease(&m_pSink);
+
+    if (SUCCEEDED(hr)) m_pRenderTarget->DrawGeometry(m_pGeometry, m_pPathBrush, STROKE_WIDTH, m_pStrokeStyle);
+    SafeRelease(&m_pGeometry);
+
+    return hr;
+}
+
+void D2DRenderBackend::SetStrokeColor(ColorF color)
+{
+    m_strokeColor = color;
+
+    // a brush created later starts out with the new color
+    if (m_pPathBrush) m_pPathBrush->SetColor(reinterpret_cast<const D2D1_COLOR_F&>(color));
+}
+
+void D2DRenderBackend::PushClip(RectI rect)
+{
+    m_pRenderTarget->PushAxisAlignedClip(
+        D2D1::RectF(static_cast<float>(rect.left), static_cast<float>(rect.top), static_cast<float>(rect.right), static_cast<float>(rect.bottom)),
+        D2D1_ANTIALIAS_MODE_ALIASED);
+    m_clipPushed = true;
+}
+
+void D2DRenderBackend::PopClip()
+{
+    m_pRenderTarget->PopAxisAlignedClip();
+    m_clipPushed = false;
+}
+
+HRESULT D2DRenderBackend::CopyPixels(RectI rect, const uint32_t* pPixels, size_t stride)
+{
+    HRESULT hr = S_OK;
+
+    UINT32 width = static_cast<UINT32>(rect.right - rect.left);
+    UINT32 height = static_cast<UINT32>(rect.bottom - rect.top);
+    if (width == 0 || height == 0) return hr;
+
+    // only as large as the largest rect copied so far, the pixels go to its top left corner
+    D2D1_SIZE_U size = m_pPixelBitmap ? m_pPixelBitmap->GetPixelSize() : D2D1::SizeU(0, 0);
+    if (width > size.width || height > size.height)
+    {
+        SafeRelease(&m_pPixelBitmap);
+
+        D2D1_BITMAP_PROPERTIES props = D2D1::BitmapProperties(D2D1::PixelFormat(DXGI_FORMAT_B8G8R8A8_UNORM, D2D1_ALPHA_MODE_PREMULTIPLIED));
+        HR(m_pRenderTarget->CreateBitmap(D2D1::SizeU(std::max(width, size.width), std::max(height, size.height)), props, &m_pPixelBitmap));
+    }
+
+    D2D1_RECT_U source = D2D1::RectU(0, 0, width, height);
+    HR(m_pPixelBitmap->CopyFromMemory(&source, pPixels, static_cast<UINT32>(stride * sizeof(uint32_t))));
+
+    // drawing blends, onto a cleared rect that is the same as copying
+    D2D1_RECT_F dest = D2D1::RectF(static_cast<float>(rect.left), static_cast<float>(rect.top), static_cast<float>(rect.right), static_cast<float>(rect.bottom));
+    D2D1_RECT_F sourceF = D2D1::RectF(0.0f, 0.0f, static_cast<float>(width), static_cast<float>(height));
+    m_pRenderTarget->PushAxisAlignedClip(dest, D2D1_ANTIALIAS_MODE_ALIASED);
+    m_pRenderTarget->Clear(D2D1::ColorF(0.0f, 0.0f, 0.0f, 0.0f));
+    m_pRenderTarget->DrawBitmap(m_pPixelBitmap, dest, 1.0f, D2D1_BITMAP_INTERPOLATION_MODE_NEAREST_NEIGHBOR, sourceF);
+    m_pRenderTarget->PopAxisAlignedClip();
+
+    return hr;
+}
+
+HRESULT D2DRenderBackend::GetDC(HDC* pDC)
+{
+    return m_pInteropTarget->GetDC(D2D1_DC_INITIALIZE_MODE_COPY, pDC);
+}
+
+void D2DRenderBackend::ReleaseDC()
+{
+    RECT r{};
+    m_pInteropTarget->ReleaseDC(&r);
+}
+
+HRESULT D2DRenderBackend::EndDraw()
+{
+    if (m_clipPushed) PopClip();
+
+    SafeRelease(&m_pSink);
+    SafeRelease(&m_pGeometry);
+
+    return m_pRenderTarget->EndDraw();
+}
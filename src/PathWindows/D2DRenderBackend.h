@@ -0,0 +1,77 @@
+#pragma once
+#include "pch.h"
+#include "RenderBackend.h"
+
+template<class T>
+inline void SafeRelease(T** ppT)
+{
+    if (*ppT)
+    {
+        (*ppT)->Release();
+        (*ppT) = NULL;
+    }
+}
+
+namespace PathWindows
+{
+    // Draws with Direct2D into a WIC bitmap.
+    class D2DRenderBackend : public RenderBackend
+    {
+    public:
+        D2DRenderBackend(float strokeWidth, ColorF strokeColor);
+        ~D2DRenderBackend();
+
+        HRESULT Initialize();
+
+        // The factories and stroke style are created once per thread and shared by every backend on it.
+        // CreateSharedResources creates them ahead of time, ReleaseSharedResources must be called before the thread
+        // uninitializes COM. Backends that exist keep their own references.
+        static HRESULT CreateSharedResources();
+        static void ReleaseSharedResources();
+
+        bool HasResources();
+        HRESULT CreateResources(int width, int height);
+        void DiscardResources();
+
+        void BeginDraw();
+
+        void Clear(ColorF color);
+        void Clear(RectI rect, ColorF color);
+
+        HRESULT BeginStroke();
+        void AddPolyline(const PointF* points, size_t count);
+        HRESULT EndStroke();
+
+        void SetStrokeColor(ColorF color);
+
+        void PushClip(RectI rect);
+        void PopClip();
+
+        HRESULT CopyPixels(RectI rect, const uint32_t* pPixels, size_t stride);
+
+        HRESULT GetDC(HDC* pDC);
+        void ReleaseDC();
+
+        HRESULT EndDraw();
+
+    private:
+        const float STROKE_WIDTH;
+        ColorF m_strokeColor;
+
+        ID2D1Factory* m_pD2Factory;
+        IWICImagingFactory* m_pWICFactory;
+        ID2D1StrokeStyle* m_pStrokeStyle;
+
+        ID2D1RenderTarget* m_pRenderTarget;
+        ID2D1GdiInteropRenderTarget* m_pInteropTarget;
+        ID2D1SolidColorBrush* m_pPathBrush;
+        // what CopyPixels uploads to, created the first time it is needed and only as large as the rects copied
+        ID2D1Bitmap* m_pPixelBitmap;
+
+        ID2D1PathGeometry* m_pGeometry;
+        ID2D1GeometrySink* m_pSink;
+
+        // a clip left pushed makes EndDraw fail
+        bool m_clipPushed;
+    };
+}
@@ -0,0 +1,158 @@
+#include "DirtyRegion.h"
+#include <algorithm>
+#include <cmath>
+#include <limits>
+
+using namespace PathWindows;
+
+namespace
+{
+    inline bool IsEmptyRect(const RectI& r)
+    {
+        return r.right <= r.left || r.bottom <= r.top;
+    }
+
+    // overlapping rects and ones that share an edge or just a corner are merged, even though their union can cover
+    // more than both (e.g. an L shape), since a few extra pixels cost less than another rect to present
+    inline bool Touches(const RectI& a, const RectI& b)
+    {
+        return a.left <= b.right && b.left <= a.right && a.top <= b.bottom && b.top <= a.bottom;
+    }
+
+    inline bool Contains(const RectI& outer, const RectI& inner)
+    {
+        return outer.left <= inner.left && outer.top <= inner.top && outer.right >= inner.right && outer.bottom >= inner.bottom;
+    }
+
+    inline RectI Union(const RectI& a, const RectI& b)
+    {
+        return RectI{ std::min(a.left, b.left), std::min(a.top, b.top), std::max(a.right, b.right), std::max(a.bottom, b.bottom) };
+    }
+
+    inline int64_t Area(const RectI& r)
+    {
+        return static_cast<int64_t>(r.right - r.left) * (r.bottom - r.top);
+    }
+}
+
+DirtyRegion::DirtyRegion(size_t maxRects) :
+    m_rects(),
+    m_maxRects(maxRects < 1 ? 1 : maxRects)
+{
+    m_rects.reserve(m_maxRects + 1);
+}
+
+void DirtyRegion::Add(RectI rect)
+{
+    if (IsEmptyRect(rect)) return;
+
+    // absorb every rect the new one touches, repeating since the grown rect may now touch others
+    bool merged = true;
+    while (merged)
+    {
+        merged = false;
+        for (size_t i = 0; i < m_rects.size(); ++i)
+        {
+            if (Contains(m_rects[i], rect)) return;
+            if (!Touches(m_rects[i], rect)) continue;
+
+            rect = Union(rect, m_rects[i]);
+            m_rects[i] = m_rects.back();
+            m_rects.pop_back();
+            merged = true;
+            break;
+        }
+    }
+
+    m_rects.push_back(rect);
+
+    if (m_rects.size() > m_maxRects) MergeCheapestPair();
+}
+
+void DirtyRegion::AddSegment(PointF a, PointF b, float inflate)
+{
+    Add(RectI{
+        static_cast<int32_t>(std::floor(std::min(a.x, b.x) - inflate)),
+        static_cast<int32_t>(std::floor(std::min(a.y, b.y) - inflate)),
+        static_cast<int32_t>(std::ceil(std::max(a.x, b.x) + inflate)),
+        static_cast<int32_t>(std::ceil(std::max(a.y, b.y) + inflate))
+    });
+}
+
+void DirtyRegion::ClipTo(RectI bounds)
+{
+    size_t count = 0;
+    for (size_t i = 0; i < m_rects.size(); ++i)
+    {
+        RectI r = m_rects[i];
+        r.left = std::max(r.left, bounds.left);
+        r.top = std::max(r.top, bounds.top);
+        r.right = std::min(r.right, bounds.right);
+        r.bottom = std::min(r.bottom, bounds.bottom);
+
+        if (!IsEmptyRect(r)) m_rects[count++] = r;
+    }
+
+    m_rects.resize(count);
+}
+
+void DirtyRegion::Clear()
+{
+    m_rects.clear();
+}
+
+bool DirtyRegion::IsEmpty() const
+{
+    return m_rects.empty();
+}
+
+size_t DirtyRegion::GetCount() const
+{
+    return m_rects.size();
+}
+
+const RectI* DirtyRegion::GetRects() const
+{
+    return m_rects.data();
+}
+
+RectI DirtyRegion::GetBounds() const
+{
+    if (m_rects.empty()) return RectI{};
+
+    RectI bounds = m_rects[0];
+    for (size_t i = 1; i < m_rects.size(); ++i) bounds = Union(bounds, m_rects[i]);
+
+    return bounds;
+}
+
+void DirtyRegion::MergeCheapestPair()
+{
+    size_t bestA = 0;
+    size_t bestB = 1;
+    int64_t bestWaste = std::numeric_limits<int64_t>::max();
+
+    for (size_t i = 0; i < m_rects.size(); ++i)
+    {
+        for (size_t j = i + 1; j < m_rects.size(); ++j)
+        {
+            int64_t waste = Area(Union(m_rects[i], m_rects[j])) - Area(m_rects[i]) - Area(m_rects[j]);
+            if (waste < bestWaste)
+            {
+                bestWaste = waste;
+                bestA = i;
+                bestB = j;
+            }
+        }
+    }
+
+    // bestA < bestB, so removing bestB first cannot move bestA
+    RectI merged = Union(m_rects[bestA], m_rects[bestB]);
+    m_rects[bestB] = m_rects.back();
+    m_rects.pop_back();
+    m_rects[bestA] = m_rects.back();
+    m_rects.pop_back();
+
+    // re-adding lets the merged rect swallow anything it now overlaps
+    Add(merged);
+}
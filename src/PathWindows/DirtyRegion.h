@@ -0,0 +1,38 @@
+#pragma once
+#include "PathTypes.h"
+#include <vector>
+#include <cstddef>
+
+namespace PathWindows
+{
+    // Collects the areas of a surface that changed since it was last presented, as a small set of rectangles.
+    // Overlapping or touching rectangles are coalesced as they are added, and once there are more than the
+    // maximum allowed the pair whose union wastes the least area is merged.
+    class DirtyRegion
+    {
+    public:
+        explicit DirtyRegion(size_t maxRects = 4);
+
+        void Add(RectI rect);
+
+        // Adds the bounding box of the segment from a to b, grown by inflate on every side.
+        void AddSegment(PointF a, PointF b, float inflate);
+
+        void ClipTo(RectI bounds);
+
+        void Clear();
+
+        bool IsEmpty() const;
+
+        size_t GetCount() const;
+        const RectI* GetRects() const;
+
+        RectI GetBounds() const;
+
+    private:
+        std::vector<RectI> m_rects;
+        size_t m_maxRects;
+
+        void MergeCheapestPair();
+    };
+}
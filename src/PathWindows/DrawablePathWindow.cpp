@@ -12,18 +12,37 @@ using namespace std::placeholders;
 using namespace PathWindows;
 
 DrawablePathWindow::DrawablePathWindow(WindowClosingCallback windowClosingCallback) :
-	m_pathWindow(std::bind(&DrawablePathWindow::HandleUnhandledMsg, this, _1, _2, _3, _4), true),
-	m_windowClosingCallback(windowClosingCallback)
+	m_pathWindow(std::bind(&DrawablePathWindow::HandleUnhandledMsg, this, _1, _2, _3, _4), true, true),
+	m_preloadedLength(0),
+	m_erasable(GetSystemMetrics(SM_CXVIRTUALSCREEN), GetSystemMetrics(SM_CYVIRTUALSCREEN)),
+	m_preloadedErasableLength(0),
+	m_windowClosingCallback(windowClosingCallback),
+	m_newPath(true),
+	m_erasing(false),
+	m_lastErasePos{},
+	m_erased(false),
+	m_pathBehind(false)
 {}
 
 DrawablePathWindow::DrawablePathWindow(MouseMovement* movs, int length, WindowClosingCallback windowClosingCallback) : DrawablePathWindow(windowClosingCallback)
 {
+	m_path.Reserve(length);
+
 	for (int i = 0; i < length; ++i)
 	{
 		MouseMovement mov = movs[i];
-		m_path.push_back(mov);
+		m_path.Append(reinterpret_cast<const Movement&>(mov));
+		m_erasable.Append(reinterpret_cast<const Movement&>(mov));
 		m_pathWindow.AddPoint(mov.Delta, false, mov.DelayDurationNS == 0);
 	}
+
+	// the host already has the preloaded path
+	m_path.MarkAllPulled();
+	m_preloadedLength = length;
+	m_preloadedErasableLength = length;
+
+	// the preloaded path is where undoing stops
+	m_log.Reset(reinterpret_cast<const Movement*>(movs), length);
 }
 
 HWND DrawablePathWindow::GetHandle()
@@ -36,40 +55,205 @@ HRESULT DrawablePathWindow::Initialize()
 	return m_pathWindow.Initialize();
 }
 
-HRESULT DrawablePathWindow::RunMessageLoop()
+void DrawablePathWindow::SetOnDestroyed(const std::function<void()>& onDestroyed)
 {
-	return m_pathWindow.RunMessageLoop();
+	m_pathWindow.SetOnDestroyed(onDestroyed);
 }
 
-std::vector<MouseMovement> DrawablePathWindow::GetPath()
+MouseMovement* DrawablePathWindow::DetachPath(size_t& length)
 {
-	return m_path;
+	return reinterpret_cast<MouseMovement*>(m_path.Detach(length));
 }
 
 void DrawablePathWindow::ClearPath()
 {
-	m_path.clear();
-	m_pathWindow.ClearPoints();
+	m_erasedSegments.clear();
+	m_erasedPoints.clear();
+	if (m_erasable.EraseAll(m_erasedSegments, m_erasedPoints) == 0) return;
+
+	// everything is erased, so that clearing can be undone like erasing
+	m_pathWindow.EraseSegments(m_erasedSegments.data(), m_erasedSegments.size(), true);
+	m_log.Erase(m_erasedSegments, m_erasedPoints, false);
+
+	m_path.Clear();
+	m_preloadedLength = 0;
+	m_pathBehind = false;
+}
+
+size_t DrawablePathWindow::PullFinishedStrokes(MouseMovement* dst, size_t capacity, bool& cleared)
+{
+	return m_path.PullFinished(reinterpret_cast<Movement*>(dst), capacity, cleared);
+}
+
+void DrawablePathWindow::SetResampling(const ResampleOptions& options)
+{
+	std::lock_guard<std::mutex> lock(m_resampleMutex);
+	m_resampleOptions = options;
+}
+
+void DrawablePathWindow::ResampleDrawnStrokes()
+{
+	std::optional<ResampleOptions> options;
+	{
+		std::lock_guard<std::mutex> lock(m_resampleMutex);
+		options = m_resampleOptions;
+	}
+
+	if (!options) return;
+
+	std::vector<Movement> resampled;
+	m_path.Visit([&](const Movement* path, size_t size)
+	{
+		if (size <= m_preloadedLength) return;
+
+		// strokes drawn with shift held continue from the end of the preloaded path
+		const PointI* anchor = m_preloadedLength > 0 ? &path[m_preloadedLength - 1].delta : nullptr;
+		StrokeResampler(*options).Resample(path + m_preloadedLength, size - m_preloadedLength, anchor, resampled);
+	});
+
+	if (!resampled.empty()) m_path.ReplaceTail(m_preloadedLength, resampled.data(), resampled.size());
 }
 
 void DrawablePathWindow::AddPoint(POINT pos, bool newPath)
 {
-	// mouse movement delay duration will be set (multiplied by a factor that is set by the user (which is basically the cursor speed)) in the app after the window closes
-	m_path.push_back(MouseMovement{ pos, newPath ? 0 : 1 });
+	// a stroke continued from a point that was erased starts a new figure instead
+	newPath = !m_erasable.Append(Movement{ PointI{ pos.x, pos.y }, newPath ? 0 : 1 });
+
+	// placeholder delays that only mark where strokes start, the real ones are set by ResampleDrawnStrokes when the window closes
+	Movement movement{ PointI{ pos.x, pos.y }, newPath ? 0 : 1 };
+	m_path.Append(movement);
+	m_log.Append(movement);
 	m_pathWindow.AddPoint(pos, !newPath, newPath);
 }
 
+void DrawablePathWindow::EraseAt(POINT from, POINT to)
+{
+	PointF fromF{ static_cast<float>(from.x), static_cast<float>(from.y) };
+	PointF toF{ static_cast<float>(to.x), static_cast<float>(to.y) };
+
+	m_erasedSegments.clear();
+	m_erasedPoints.clear();
+	if (m_erasable.Erase(fromF, toF, ERASER_RADIUS, m_erasedSegments, m_erasedPoints) == 0) return;
+
+	// the window holds every point m_erasable does, at the same indices, dropped points are never drawn on their own
+	m_pathWindow.EraseSegments(m_erasedSegments.data(), m_erasedSegments.size(), true);
+	m_log.Erase(m_erasedSegments, m_erasedPoints, m_erased);
+
+	m_erased = true;
+	m_pathBehind = true;
+}
+
+void DrawablePathWindow::EndErase()
+{
+	m_erasing = false;
+	m_erased = false;
+	CatchUpPath();
+}
+
+void DrawablePathWindow::CatchUpPath()
+{
+	if (!m_pathBehind) return;
+	m_pathBehind = false;
+
+	std::vector<Movement> path;
+	m_erasable.CopyTo(path);
+
+	m_path.ReplaceAll(path.data(), path.size());
+	m_preloadedLength = m_erasable.CountLeftBefore(m_preloadedErasableLength);
+}
+
+void DrawablePathWindow::Undo()
+{
+	StrokeLog::Change change;
+	if (!m_log.Undo(change)) return;
+
+	size_t strokeLength = change.strokeEnd - change.strokeBegin;
+	if (strokeLength > 0)
+	{
+		// the stroke is the last thing that was added, and nothing of it is erased, so it is all at the end of the path
+		// (a path that is behind is rebuilt from m_erasable anyway)
+		if (!m_pathBehind) m_path.ReplaceTail(m_path.GetSize() - strokeLength, nullptr, 0);
+
+		m_erasable.Truncate(change.strokeBegin);
+		m_pathWindow.DropPointsFrom(change.strokeBegin, true);
+		return;
+	}
+
+	ExpandRanges(change);
+	m_erasable.Restore(m_erasedSegments.data(), m_erasedSegments.size(), m_erasedPoints.data(), m_erasedPoints.size());
+	m_pathWindow.RestoreSegments(m_erasedSegments.data(), m_erasedSegments.size(), true);
+
+	// like erasing, m_path catches up when the next stroke starts or the window closes, so undoing stays cheap
+	m_pathBehind = true;
+}
+
+void DrawablePathWindow::Redo()
+{
+	StrokeLog::Change change;
+	if (!m_log.Redo(change)) return;
+
+	size_t strokeLength = change.strokeEnd - change.strokeBegin;
+	if (strokeLength > 0)
+	{
+		// a redone stroke only adds to the end of the path, like drawing it again does
+		const Movement* stroke = m_log.GetMovements() + change.strokeBegin;
+		for (size_t i = 0; i < strokeLength; ++i)
+		{
+			if (!m_pathBehind) m_path.Append(stroke[i]);
+
+			// only renders once everything is in
+			bool continues = m_erasable.Append(stroke[i]);
+			m_pathWindow.AddPoint(POINT{ stroke[i].delta.x, stroke[i].delta.y }, i + 1 == strokeLength, !continues);
+		}
+		if (!m_pathBehind) m_path.FinishStroke();
+		return;
+	}
+
+	ExpandRanges(change);
+	m_erasable.Remove(m_erasedSegments.data(), m_erasedSegments.size(), m_erasedPoints.data(), m_erasedPoints.size());
+	m_pathWindow.EraseSegments(m_erasedSegments.data(), m_erasedSegments.size(), true);
+
+	m_pathBehind = true;
+}
+
+void DrawablePathWindow::ExpandRanges(const StrokeLog::Change& change)
+{
+	m_erasedSegments.clear();
+	for (size_t i = 0; i < change.segmentRangeCount; ++i)
+	{
+		for (uint32_t index = change.segments[i].first; index < change.segments[i].end; ++index) m_erasedSegments.push_back(index);
+	}
+
+	m_erasedPoints.clear();
+	for (size_t i = 0; i < change.pointRangeCount; ++i)
+	{
+		for (uint32_t index = change.points[i].first; index < change.points[i].end; ++index) m_erasedPoints.push_back(index);
+	}
+}
+
 inline void DrawablePathWindow::Close()
 {
-	auto path = GetPath();
-	auto size = path.size();
-	m_windowClosingCallback(size == 0 ? nullptr : &path[0], static_cast<int>(size));
+	CatchUpPath();
+	ResampleDrawnStrokes();
+
+	size_t length = 0;
+	MouseMovement* path = DetachPath(length);
+	if (length == 0)
+	{
+		MovementBuffer::Release(reinterpret_cast<Movement*>(path));
+		path = nullptr;
+	}
+
+	// undoing an erase puts back what it took, so only what is erased now counts
+	int preloadedLength = m_erasable.IsIntactBefore(m_preloadedErasableLength) ? static_cast<int>(m_preloadedErasableLength) : -1;
+
+	// the callback takes ownership of the path
+	m_windowClosingCallback(path, static_cast<int>(length), preloadedLength);
 	auto ret = PostMessage(m_pathWindow.GetHandle(), WM_CLOSE, 0, 0);
 }
 
 void DrawablePathWindow::HandleUnhandledMsg(HWND hWnd, UINT message, WPARAM wParam, LPARAM lParam)
 {
-	static bool newPath = true;
 	POINT pos{};
 
 	switch (message)
@@ -78,27 +262,63 @@ void DrawablePathWindow::HandleUnhandledMsg(HWND hWnd, UINT message, WPARAM wPar
 		pos.x = GET_X_LPARAM(lParam);
 		pos.y = GET_Y_LPARAM(lParam);
 
-		newPath = (wParam & MK_SHIFT) == 0;
-		AddPoint(pos, newPath);
+		// the stroke goes after what was erased before it
+		CatchUpPath();
+
+		m_newPath = (wParam & MK_SHIFT) == 0;
+		m_log.BeginStroke();
+		AddPoint(pos, m_newPath);
 		break;
 
 	case WM_LBUTTONUP:
-		newPath = true;
+		m_newPath = true;
+		m_path.FinishStroke();
 		break;
 
 	case WM_MOUSEMOVE:
+		// the button may have been let go outside of the window
+		if (m_erasing && (wParam & MK_RBUTTON) == 0) EndErase();
+
+		if (m_erasing)
+		{
+			pos.x = GET_X_LPARAM(lParam);
+			pos.y = GET_Y_LPARAM(lParam);
+
+			EraseAt(m_lastErasePos, pos);
+			m_lastErasePos = pos;
+			break;
+		}
+
 		if ((wParam & MK_LBUTTON) == 0) break;
 		if (wParam & MK_SHIFT) break;
 
 		pos.x = GET_X_LPARAM(lParam);
 		pos.y = GET_Y_LPARAM(lParam);
 
-		AddPoint(pos, newPath);
-		newPath = false;
+		AddPoint(pos, m_newPath);
+		m_newPath = false;
 		break;
 
 	case WM_RBUTTONDOWN:
-		ClearPath();
+		// ctrl clears everything, otherwise the right button erases what it is dragged over
+		if (wParam & MK_CONTROL)
+		{
+			ClearPath();
+			break;
+		}
+
+		pos.x = GET_X_LPARAM(lParam);
+		pos.y = GET_Y_LPARAM(lParam);
+
+		// everything one drag erases is undone at once
+		EndErase();
+		m_erasing = true;
+		EraseAt(pos, pos);
+		m_lastErasePos = pos;
+		break;
+
+	case WM_RBUTTONUP:
+		EndErase();
 		break;
 
 	case WM_KEYUP:
@@ -107,6 +327,22 @@ void DrawablePathWindow::HandleUnhandledMsg(HWND hWnd, UINT message, WPARAM wPar
 		case VK_ESCAPE:
 			Close();
 			break;
+
+		// ctrl+z undoes, ctrl+y and ctrl+shift+z redo
+		case 'Z':
+			if (GetKeyState(VK_CONTROL) >= 0) break;
+
+			if (GetKeyState(VK_SHIFT) < 0) Redo();
+			else Undo();
+			m_newPath = true;
+			break;
+
+		case 'Y':
+			if (GetKeyState(VK_CONTROL) >= 0) break;
+
+			Redo();
+			m_newPath = true;
+			break;
 		}
 		break;
 	}
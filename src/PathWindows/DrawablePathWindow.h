@@ -1,7 +1,12 @@
 #pragma once
 #include "pch.h"
 #include "PathWindow.h"
-#include <vector>
+#include "PathHandoff.h"
+#include "ErasablePath.h"
+#include "StrokeLog.h"
+#include "StrokeResampler.h"
+#include <mutex>
+#include <optional>
 
 struct MouseMovement
 {
@@ -9,7 +14,12 @@ struct MouseMovement
 	int64_t DelayDurationNS;
 };
 
-typedef void(__cdecl *WindowClosingCallback)(MouseMovement*, int);
+static_assert(sizeof(MouseMovement) == sizeof(PathWindows::Movement), "MouseMovement must be layout compatible with Movement.");
+
+// The callback owns the path it is given (nullptr if the path is empty), and must release it with ReleaseDrawnPath.
+// The path starts with the one the window was opened with, and preloadedLength is its length, unless erasing changed
+// it, in which case preloadedLength is -1 and the whole path replaces the one the window was opened with.
+typedef void(__cdecl *WindowClosingCallback)(MouseMovement* path, int length, int preloadedLength);
 
 namespace PathWindows
 {
@@ -23,20 +33,74 @@ namespace PathWindows
 
 		HRESULT Initialize();
 
-		HRESULT RunMessageLoop();
+		void SetOnDestroyed(const std::function<void()>& onDestroyed);
 
-		std::vector<MouseMovement> GetPath();
+		// Gives up ownership of the drawn path, see PathHandoff::Detach.
+		MouseMovement* DetachPath(size_t& length);
 		void ClearPath();
 
+		// Copies movements of strokes that were finished but not pulled yet, see PathHandoff::PullFinished. What an
+		// eraser drag erases only counts once the drag ends. Can be called from any thread.
+		size_t PullFinishedStrokes(MouseMovement* dst, size_t capacity, bool& cleared);
+
+		// When set, the strokes drawn in the window are resampled into timed movements before the path is handed over
+		// on close, see StrokeResampler. Otherwise their delays are 0 where a stroke starts and 1 everywhere else.
+		// Can be called from any thread.
+		void SetResampling(const ResampleOptions& options);
+
 	private:
+		static constexpr float ERASER_RADIUS = 12.0f;
+
 		PathWindow m_pathWindow;
 
-		std::vector<MouseMovement> m_path;
+		PathHandoff m_path;
+		// how much of the path was there when the window opened (and is already timed)
+		size_t m_preloadedLength;
+
+		// the same path, for erasing parts of it
+		ErasablePath m_erasable;
+		// how much of m_erasable was preloaded, counting erased points
+		size_t m_preloadedErasableLength;
+
+		// the same path again, as steps that can be undone
+		StrokeLog m_log;
+
+		std::mutex m_resampleMutex;
+		std::optional<ResampleOptions> m_resampleOptions;
 
 		WindowClosingCallback m_windowClosingCallback;
 
+		// whether the next point drawn starts a new figure
+		bool m_newPath;
+
+		// set while the right button is held down after it was pressed in this window
+		bool m_erasing;
+		POINT m_lastErasePos;
+		// whether the current drag erased anything yet, everything it erases is undone at once
+		bool m_erased;
+		// whether m_path is out of date with m_erasable since something was erased, or an erase undone or redone, in
+		// which case changes to it are skipped until CatchUpPath rebuilds it
+		bool m_pathBehind;
+		// what was last erased or restored, reused
+		std::vector<uint32_t> m_erasedSegments;
+		std::vector<uint32_t> m_erasedPoints;
+
 		void AddPoint(POINT pos, bool newPath);
 
+		// Erases the segments that pass within ERASER_RADIUS of the line from "from" to "to", and takes only those off the
+		// window and the log. m_path catches up in CatchUpPath.
+		void EraseAt(POINT from, POINT to);
+		void EndErase();
+		// Gives m_path the path that is left, if erasing or undoing changed it since the last call.
+		void CatchUpPath();
+
+		void Undo();
+		void Redo();
+		// Writes the indices in the ranges of the change to m_erasedSegments and m_erasedPoints.
+		void ExpandRanges(const StrokeLog::Change& change);
+
+		void ResampleDrawnStrokes();
+
 		void Close();
 
 		void HandleUnhandledMsg(HWND hWnd, UINT message, WPARAM wParam, LPARAM lParam);
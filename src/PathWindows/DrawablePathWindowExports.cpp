@@ -0,0 +1,35 @@
+#include "pch.h"
+#include "DrawablePathWindow.h"
+#include <cmath>
+
+using namespace PathWindows;
+
+// Releases the path given to the WindowClosingCallback.
+extern "C" __declspec(dllexport) void __cdecl ReleaseDrawnPath(MouseMovement* path)
+{
+    MovementBuffer::Release(reinterpret_cast<Movement*>(path));
+}
+
+// Copies up to capacity movements of the strokes finished since the last call into dst, while the user keeps drawing.
+// *pCleared is set if the path was cleared since the last call, which makes everything copied before stale.
+extern "C" __declspec(dllexport) HRESULT __cdecl PullDrawnStrokes(DrawablePathWindow* pDrawablePathWindow, MouseMovement* dst, int capacity, int* pCount, bool* pCleared)
+{
+    if (!pDrawablePathWindow || !pCount || !pCleared) return E_POINTER;
+    if (capacity < 0 || (capacity > 0 && !dst)) return E_INVALIDARG;
+
+    *pCount = static_cast<int>(pDrawablePathWindow->PullFinishedStrokes(dst, capacity, *pCleared));
+
+    return S_OK;
+}
+
+// Makes the window resample the drawn strokes into timed movements when it closes, see StrokeResampler.
+extern "C" __declspec(dllexport) HRESULT __cdecl SetDrawnPathResampling(DrawablePathWindow* pDrawablePathWindow, float maxStepLength, double nsPerPixel, Interpolation interpolation, Easing easing)
+{
+    if (!pDrawablePathWindow) return E_POINTER;
+    if (!(maxStepLength >= 1.0f) || !(nsPerPixel >= 0.0) || std::isinf(nsPerPixel)) return E_INVALIDARG;
+    if (interpolation > Interpolation::CATMULL_ROM || easing > Easing::EASE_IN_OUT) return E_INVALIDARG;
+
+    pDrawablePathWindow->SetResampling(ResampleOptions{ maxStepLength, nsPerPixel, interpolation, easing });
+
+    return S_OK;
+}
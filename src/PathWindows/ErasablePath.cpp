@@ -0,0 +1,289 @@
+#include "ErasablePath.h"
+#include <algorithm>
+
+using namespace PathWindows;
+
+namespace
+{
+    inline float Cross(PointF o, PointF a, PointF b)
+    {
+        return (a.x - o.x) * (b.y - o.y) - (a.y - o.y) * (b.x - o.x);
+    }
+
+    inline float DistanceSq(PointF p, PointF a, PointF b)
+    {
+        float dx = b.x - a.x;
+        float dy = b.y - a.y;
+        float lengthSq = dx * dx + dy * dy;
+
+        float t = lengthSq > 0.0f ? ((p.x - a.x) * dx + (p.y - a.y) * dy) / lengthSq : 0.0f;
+        t = std::clamp(t, 0.0f, 1.0f);
+
+        float ex = a.x + dx * t - p.x;
+        float ey = a.y + dy * t - p.y;
+        return ex * ex + ey * ey;
+    }
+
+    // between the segments a-b and c-d
+    inline float DistanceSq(PointF a, PointF b, PointF c, PointF d)
+    {
+        // if they cross, otherwise the closest points are at an end of one of them
+        float abc = Cross(a, b, c);
+        float abd = Cross(a, b, d);
+        float cda = Cross(c, d, a);
+        float cdb = Cross(c, d, b);
+        if (((abc < 0.0f && abd > 0.0f) || (abc > 0.0f && abd < 0.0f)) && ((cda < 0.0f && cdb > 0.0f) || (cda > 0.0f && cdb < 0.0f))) return 0.0f;
+
+        return (std::min)({ DistanceSq(a, c, d), DistanceSq(b, c, d), DistanceSq(c, a, b), DistanceSq(d, a, b) });
+    }
+}
+
+ErasablePath::ErasablePath(int32_t width, int32_t height) :
+    m_segmentCount(0),
+    m_index(width, height)
+{}
+
+PointF ErasablePath::GetPosition(size_t index) const
+{
+    const PointI& position = m_points[index].delta;
+    return PointF{ static_cast<float>(position.x), static_cast<float>(position.y) };
+}
+
+bool ErasablePath::HasSegment(size_t index) const
+{
+    return (m_flags[index] & HAS_SEGMENT) != 0;
+}
+
+bool ErasablePath::Append(const Movement& movement)
+{
+    size_t index = m_points.size();
+    bool continues = movement.delayDurationNS != 0 && index > 0 && (m_flags[index - 1] & ALIVE);
+
+    m_points.push_back(movement);
+    m_flags.push_back(ALIVE);
+
+    uint32_t id = static_cast<uint32_t>(index);
+    PointF position = GetPosition(index);
+
+    if (continues)
+    {
+        // the point before is covered by the new segment now
+        if (m_flags[index - 1] & INDEXED_POINT)
+        {
+            m_index.Remove(id - 1, GetPosition(index - 1), GetPosition(index - 1));
+            m_flags[index - 1] &= ~INDEXED_POINT;
+        }
+
+        m_index.Insert(id, GetPosition(index - 1), position);
+        m_flags[index] |= HAS_SEGMENT;
+        ++m_segmentCount;
+    }
+    else
+    {
+        m_index.Insert(id, position, position);
+        m_flags[index] |= INDEXED_POINT;
+    }
+
+    return continues;
+}
+
+void ErasablePath::Clear()
+{
+    m_points.clear();
+    m_flags.clear();
+    m_segmentCount = 0;
+    m_index.Clear();
+}
+
+size_t ErasablePath::Erase(PointF from, PointF to, float radius, std::vector<uint32_t>& segments, std::vector<uint32_t>& points)
+{
+    PointF min{ (std::min)(from.x, to.x) - radius, (std::min)(from.y, to.y) - radius };
+    PointF max{ (std::max)(from.x, to.x) + radius, (std::max)(from.y, to.y) + radius };
+
+    m_hits.clear();
+    m_index.ForEachCandidate(min, max, [this](uint32_t id) { m_hits.push_back(id); });
+
+    std::sort(m_hits.begin(), m_hits.end());
+    m_hits.erase(std::unique(m_hits.begin(), m_hits.end()), m_hits.end());
+
+    float radiusSq = radius * radius;
+    size_t erased = 0;
+
+    // erasing one candidate can drop points that are candidates too, so the flags are checked again for each
+    for (uint32_t id : m_hits)
+    {
+        if (HasSegment(id))
+        {
+            if (DistanceSq(GetPosition(id - 1), GetPosition(id), from, to) > radiusSq) continue;
+
+            RemoveSegment(id);
+            segments.push_back(id);
+            if (DropIfLone(id - 1)) points.push_back(id - 1);
+            if (DropIfLone(id)) points.push_back(id);
+            ++erased;
+        }
+        else if (m_flags[id] & INDEXED_POINT)
+        {
+            if (DistanceSq(GetPosition(id), from, to) > radiusSq) continue;
+
+            RemovePoint(id);
+            points.push_back(id);
+            ++erased;
+        }
+    }
+
+    return erased;
+}
+
+size_t ErasablePath::EraseAll(std::vector<uint32_t>& segments, std::vector<uint32_t>& points)
+{
+    size_t erased = 0;
+
+    for (size_t i = 0; i < m_points.size(); ++i)
+    {
+        if (HasSegment(i))
+        {
+            RemoveSegment(i);
+            segments.push_back(static_cast<uint32_t>(i));
+            ++erased;
+        }
+    }
+
+    // every point is lone now
+    for (size_t i = 0; i < m_points.size(); ++i)
+    {
+        if (!(m_flags[i] & ALIVE)) continue;
+
+        // a point that was lone before counts as erased on its own, like in Erase
+        if (m_flags[i] & INDEXED_POINT) ++erased;
+
+        RemovePoint(i);
+        points.push_back(static_cast<uint32_t>(i));
+    }
+
+    return erased;
+}
+
+void ErasablePath::Remove(const uint32_t* segments, size_t segmentCount, const uint32_t* points, size_t pointCount)
+{
+    for (size_t i = 0; i < segmentCount; ++i)
+    {
+        if (HasSegment(segments[i])) RemoveSegment(segments[i]);
+    }
+
+    for (size_t i = 0; i < pointCount; ++i)
+    {
+        if (m_flags[points[i]] & ALIVE) RemovePoint(points[i]);
+    }
+}
+
+void ErasablePath::Restore(const uint32_t* segments, size_t segmentCount, const uint32_t* points, size_t pointCount)
+{
+    for (size_t i = 0; i < pointCount; ++i) m_flags[points[i]] = ALIVE;
+
+    // the ends of a segment that was there were never lone points
+    for (size_t i = 0; i < segmentCount; ++i)
+    {
+        size_t index = segments[i];
+        if (HasSegment(index)) continue;
+
+        m_index.Insert(static_cast<uint32_t>(index), GetPosition(index - 1), GetPosition(index));
+        m_flags[index] |= HAS_SEGMENT;
+        ++m_segmentCount;
+    }
+
+    // only points that were lone before are left without a segment
+    for (size_t i = 0; i < pointCount; ++i)
+    {
+        size_t index = points[i];
+        if (HasSegment(index) || (index + 1 < m_points.size() && HasSegment(index + 1)) || (m_flags[index] & INDEXED_POINT)) continue;
+
+        m_index.Insert(points[i], GetPosition(index), GetPosition(index));
+        m_flags[index] |= INDEXED_POINT;
+    }
+}
+
+void ErasablePath::Truncate(size_t size)
+{
+    if (size >= m_points.size()) return;
+
+    for (size_t i = size; i < m_points.size(); ++i)
+    {
+        if (HasSegment(i)) RemoveSegment(i);
+        else if (m_flags[i] & INDEXED_POINT) RemovePoint(i);
+    }
+
+    m_points.resize(size);
+    m_flags.resize(size);
+
+    // the point before lost the segment that was appended to it, and is indexed as a lone point again like before
+    size_t last = size - 1;
+    if (size > 0 && (m_flags[last] & ALIVE) && !HasSegment(last) && !(m_flags[last] & INDEXED_POINT))
+    {
+        m_index.Insert(static_cast<uint32_t>(last), GetPosition(last), GetPosition(last));
+        m_flags[last] |= INDEXED_POINT;
+    }
+}
+
+void ErasablePath::RemoveSegment(size_t index)
+{
+    m_index.Remove(static_cast<uint32_t>(index), GetPosition(index - 1), GetPosition(index));
+    m_flags[index] &= ~HAS_SEGMENT;
+    --m_segmentCount;
+}
+
+void ErasablePath::RemovePoint(size_t index)
+{
+    if (m_flags[index] & INDEXED_POINT) m_index.Remove(static_cast<uint32_t>(index), GetPosition(index), GetPosition(index));
+    m_flags[index] = 0;
+}
+
+bool ErasablePath::DropIfLone(size_t index)
+{
+    if (!(m_flags[index] & ALIVE) || HasSegment(index)) return false;
+    if (index + 1 < m_points.size() && HasSegment(index + 1)) return false;
+
+    RemovePoint(index);
+    return true;
+}
+
+void ErasablePath::CopyTo(std::vector<Movement>& out) const
+{
+    out.clear();
+
+    for (size_t i = 0; i < m_points.size(); ++i)
+    {
+        if (!(m_flags[i] & ALIVE)) continue;
+
+        out.push_back(Movement{ m_points[i].delta, HasSegment(i) ? m_points[i].delayDurationNS : 0 });
+    }
+}
+
+size_t ErasablePath::CountLeftBefore(size_t index) const
+{
+    index = (std::min)(index, m_points.size());
+    return static_cast<size_t>(std::count_if(m_flags.begin(), m_flags.begin() + index, [](uint8_t flags) { return (flags & ALIVE) != 0; }));
+}
+
+bool ErasablePath::IsIntactBefore(size_t index) const
+{
+    index = (std::min)(index, m_points.size());
+    for (size_t i = 0; i < index; ++i)
+    {
+        // a point that starts a figure never had a segment ending at it
+        bool startsFigure = i == 0 || m_points[i].delayDurationNS == 0;
+        if (!(m_flags[i] & ALIVE) || HasSegment(i) == startsFigure) return false;
+    }
+
+    return true;
+}
+
+size_t ErasablePath::GetSize() const
+{
+    return m_points.size();
+}
+
+size_t ErasablePath::GetSegmentCount() const
+{
+    return m_segmentCount;
+}
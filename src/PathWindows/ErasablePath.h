@@ -0,0 +1,80 @@
+#pragma once
+#include "PathTypes.h"
+#include "SegmentIndex.h"
+#include <vector>
+#include <cstdint>
+#include <cstddef>
+
+namespace PathWindows
+{
+    // A drawn path (absolute positions, a delay of 0 starts a new figure) that parts of can be erased.
+    // Erasing removes the segments near the eraser, which splits figures where they were cut, and drops points that
+    // are left without any segment. Erased points stay behind as gaps, so the indices of the others never change.
+    // Every point is indexed through the segment that ends at it, the one that starts at it, or itself if it has neither.
+    class ErasablePath
+    {
+    public:
+        ErasablePath(int32_t width, int32_t height);
+
+        // Returns whether the movement continues the figure before it, which it does not if that ended with an erased point.
+        bool Append(const Movement& movement);
+        void Clear();
+
+        // Erases everything that passes within radius of the line from "from" to "to" (a point if they are the same),
+        // and returns how many segments and lone points were erased. The indices of the points the erased segments
+        // ended at are added to segments, and those of the points that were dropped to points.
+        size_t Erase(PointF from, PointF to, float radius, std::vector<uint32_t>& segments, std::vector<uint32_t>& points);
+
+        // Erases everything that is left, adding what was erased to segments and points like Erase does.
+        size_t EraseAll(std::vector<uint32_t>& segments, std::vector<uint32_t>& points);
+
+        // Erases again what Erase or EraseAll erased (e.g. redoing it), the segments before the points.
+        void Remove(const uint32_t* segments, size_t segmentCount, const uint32_t* points, size_t pointCount);
+        // Puts back what Erase or EraseAll erased, which has to be the last thing that changed the path that is not
+        // undone yet (e.g. undoing it).
+        void Restore(const uint32_t* segments, size_t segmentCount, const uint32_t* points, size_t pointCount);
+        // Drops the points from index size on, which have to be as they were appended (e.g. undoing appending them).
+        void Truncate(size_t size);
+
+        // Writes the path that is left to out (replacing its contents), with a delay of 0 where a figure starts,
+        // including where erasing split one. Other delays are kept.
+        void CopyTo(std::vector<Movement>& out) const;
+
+        // How many of the points before index (counting erased ones) are left.
+        size_t CountLeftBefore(size_t index) const;
+        // Whether none of the points before index, nor the segments ending at them, are erased.
+        bool IsIntactBefore(size_t index) const;
+
+        // The number of points ever appended, including erased ones.
+        size_t GetSize() const;
+        size_t GetSegmentCount() const;
+
+    private:
+        enum Flags : uint8_t
+        {
+            // not erased
+            ALIVE = 1,
+            // the segment from the point before ends here
+            HAS_SEGMENT = 2,
+            // indexed as a lone point
+            INDEXED_POINT = 4
+        };
+
+        std::vector<Movement> m_points;
+        std::vector<uint8_t> m_flags;
+        size_t m_segmentCount;
+
+        SegmentIndex m_index;
+
+        // the candidates of the current erase, reused
+        std::vector<uint32_t> m_hits;
+
+        PointF GetPosition(size_t index) const;
+        bool HasSegment(size_t index) const;
+
+        void RemoveSegment(size_t index);
+        void RemovePoint(size_t index);
+        // Returns whether the point was dropped.
+        bool DropIfLone(size_t index);
+    };
+}
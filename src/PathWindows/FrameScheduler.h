@@ -0,0 +1,81 @@
+#pragma once
+#include <cstdint>
+#include <limits>
+
+namespace PathWindows
+{
+    // Decides when a frame should be rendered so that any number of invalidations between two frames collapse into one,
+    // frames are at least one frame interval apart, and nothing is rendered while nothing changed.
+    // It does not read a clock itself, the current time (in nanoseconds, from any monotonic clock) is passed to it.
+    class FrameScheduler
+    {
+    public:
+        static constexpr int64_t NO_DEADLINE = std::numeric_limits<int64_t>::max();
+
+        explicit FrameScheduler(int maxFps = 60) :
+            m_frameIntervalNS(0),
+            m_lastFrameNS(0),
+            m_hasRendered(false),
+            m_invalidated(false)
+        {
+            SetMaxFps(maxFps);
+        }
+
+        // A value of 0 or less removes the limit.
+        void SetMaxFps(int maxFps)
+        {
+            m_frameIntervalNS = maxFps > 0 ? 1'000'000'000 / maxFps : 0;
+        }
+
+        int64_t GetFrameInterval() const
+        {
+            return m_frameIntervalNS;
+        }
+
+        void Invalidate()
+        {
+            m_invalidated = true;
+        }
+
+        bool IsInvalidated() const
+        {
+            return m_invalidated;
+        }
+
+        // The earliest time the next frame may be rendered, or NO_DEADLINE if there is nothing to render.
+        int64_t GetDeadline() const
+        {
+            if (!m_invalidated) return NO_DEADLINE;
+            if (!m_hasRendered) return std::numeric_limits<int64_t>::min();
+
+            return m_lastFrameNS + m_frameIntervalNS;
+        }
+
+        bool IsDue(int64_t nowNS) const
+        {
+            return m_invalidated && nowNS >= GetDeadline();
+        }
+
+        // How long to wait from now until the next frame is due, or NO_DEADLINE if there is nothing to render.
+        int64_t GetTimeUntilDeadline(int64_t nowNS) const
+        {
+            int64_t deadline = GetDeadline();
+            if (deadline == NO_DEADLINE) return NO_DEADLINE;
+
+            return deadline > nowNS ? deadline - nowNS : 0;
+        }
+
+        void OnFrameRendered(int64_t nowNS)
+        {
+            m_lastFrameNS = nowNS;
+            m_hasRendered = true;
+            m_invalidated = false;
+        }
+
+    private:
+        int64_t m_frameIntervalNS;
+        int64_t m_lastFrameNS;
+        bool m_hasRendered;
+        bool m_invalidated;
+    };
+}
@@ -0,0 +1,285 @@
+#include "HeatmapGrid.h"
+#include "PixelKernels.h"
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+
+using namespace PathWindows;
+
+namespace
+{
+    inline int32_t ToCell(float position, int32_t cellCount)
+    {
+        // compared as floats first, a position far off the surface does not fit in an int
+        float cell = std::floor(position);
+        if (!(cell > 0.0f)) return 0;
+        if (cell >= static_cast<float>(cellCount - 1)) return cellCount - 1;
+
+        return static_cast<int32_t>(cell);
+    }
+
+    inline uint32_t ToPremultipliedBGRA(float r, float g, float b, float a)
+    {
+        auto channel = [](float value) { return static_cast<uint32_t>(std::clamp(value, 0.0f, 1.0f) * 255.0f + 0.5f); };
+
+        return channel(b) | (channel(g) << 8) | (channel(r) << 16) | (channel(a) << 24);
+    }
+
+    // the heat colors from cold to hot, spaced evenly
+    constexpr ColorF HEAT_STOPS[] = {
+        { 0.0f, 0.2f, 1.0f, 0.35f },
+        { 0.0f, 0.9f, 0.9f, 0.5f },
+        { 0.2f, 1.0f, 0.2f, 0.6f },
+        { 1.0f, 0.9f, 0.0f, 0.75f },
+        { 1.0f, 0.1f, 0.0f, 0.85f }
+    };
+}
+
+HeatmapGrid::HeatmapGrid(int32_t width, int32_t height, int32_t cellSize, ColorF background) :
+    m_width(std::max(width, 1)),
+    m_height(std::max(height, 1)),
+    m_cellSize(std::max(cellSize, 1)),
+    m_columns((m_width + m_cellSize - 1) / m_cellSize),
+    m_rows((m_height + m_cellSize - 1) / m_cellSize),
+    m_blockColumns((m_columns + BLOCK_CELLS - 1) / BLOCK_CELLS),
+    m_blockRows((m_rows + BLOCK_CELLS - 1) / BLOCK_CELLS),
+    m_counts(static_cast<size_t>(m_columns) * m_rows, 0),
+    m_maxCount(0),
+    m_shift(0),
+    m_blockOccupied(static_cast<size_t>(m_blockColumns) * m_blockRows, 0),
+    m_blockChanged(m_blockOccupied.size(), 0),
+    m_fullRedraw(true),
+    m_last{ 0.0f, 0.0f },
+    m_hasLast(false),
+    m_palette(),
+    m_rowColors(BLOCK_CELLS)
+{
+    BuildPalette(background);
+}
+
+void HeatmapGrid::BuildPalette(ColorF background)
+{
+    constexpr size_t lastStop = sizeof(HEAT_STOPS) / sizeof(HEAT_STOPS[0]) - 1;
+
+    m_palette[0] = ToPremultipliedBGRA(background.r * background.a, background.g * background.a, background.b * background.a, background.a);
+
+    for (size_t i = 1; i < PALETTE_SIZE; ++i)
+    {
+        // the square root spreads out the low counts, which most cells have
+        float t = std::sqrt(static_cast<float>(i - 1) / static_cast<float>(PALETTE_SIZE - 2)) * lastStop;
+        size_t stop = std::min(static_cast<size_t>(t), lastStop - 1);
+        float f = t - static_cast<float>(stop);
+
+        const ColorF& from = HEAT_STOPS[stop];
+        const ColorF& to = HEAT_STOPS[stop + 1];
+        float r = from.r + (to.r - from.r) * f;
+        float g = from.g + (to.g - from.g) * f;
+        float b = from.b + (to.b - from.b) * f;
+        float a = from.a + (to.a - from.a) * f;
+
+        // blended over the background once here, so drawing only copies
+        float under = background.a * (1.0f - a);
+        m_palette[i] = ToPremultipliedBGRA(r * a + background.r * under, g * a + background.g * under, b * a + background.b * under, a + under);
+    }
+}
+
+void HeatmapGrid::Append(PointF point, bool newFigure)
+{
+    if (newFigure || !m_hasLast)
+    {
+        if (IsOnSurface(point)) AddCell(ToCell(point.x / m_cellSize, m_columns), ToCell(point.y / m_cellSize, m_rows));
+    }
+    else
+    {
+        AddSegment(m_last, point);
+    }
+
+    m_last = point;
+    m_hasLast = true;
+}
+
+bool HeatmapGrid::IsOnSurface(PointF point) const
+{
+    return point.x >= 0.0f && point.y >= 0.0f && point.x < static_cast<float>(m_width) && point.y < static_cast<float>(m_height);
+}
+
+void HeatmapGrid::AddCell(int32_t column, int32_t row)
+{
+    uint16_t& count = m_counts[static_cast<size_t>(row) * m_columns + column];
+    if (count == UINT16_MAX) return;
+
+    ++count;
+
+    // counts only go up one at a time, so the bit length grows by at most one
+    if (count > m_maxCount)
+    {
+        m_maxCount = count;
+        if ((m_maxCount >> m_shift) != 0)
+        {
+            ++m_shift;
+            m_fullRedraw = true;
+        }
+    }
+
+    uint32_t block = static_cast<uint32_t>((row / BLOCK_CELLS) * m_blockColumns + column / BLOCK_CELLS);
+    m_blockOccupied[block] = 1;
+    if (!m_blockChanged[block])
+    {
+        m_blockChanged[block] = 1;
+        m_changedBlocks.push_back(block);
+    }
+}
+
+void HeatmapGrid::AddSegment(PointF a, PointF b)
+{
+    float dx = b.x - a.x;
+    float dy = b.y - a.y;
+
+    // clipped to the surface first (Liang-Barsky), so the part of a segment off the surface costs nothing
+    float t0 = 0.0f;
+    float t1 = 1.0f;
+    auto clip = [&t0, &t1](float p, float q)
+    {
+        if (p == 0.0f) return q >= 0.0f;
+
+        float t = q / p;
+        if (p < 0.0f)
+        {
+            if (t > t1) return false;
+            t0 = std::max(t0, t);
+        }
+        else
+        {
+            if (t < t0) return false;
+            t1 = std::min(t1, t);
+        }
+        return true;
+    };
+
+    if (!clip(-dx, a.x) || !clip(dx, m_width - a.x) || !clip(-dy, a.y) || !clip(dy, m_height - a.y)) return;
+
+    float x0 = (a.x + dx * t0) / m_cellSize;
+    float y0 = (a.y + dy * t0) / m_cellSize;
+    float x1 = (a.x + dx * t1) / m_cellSize;
+    float y1 = (a.y + dy * t1) / m_cellSize;
+
+    int32_t column = ToCell(x0, m_columns);
+    int32_t row = ToCell(y0, m_rows);
+    int32_t lastColumn = ToCell(x1, m_columns);
+    int32_t lastRow = ToCell(y1, m_rows);
+
+    // the cell the segment starts in was counted with the point before, unless that was off the surface
+    if (t0 > 0.0f || !IsOnSurface(a)) AddCell(column, row);
+
+    // walk the cells the segment passes through, stepping to whichever cell border it crosses next
+    float cellDx = std::abs(x1 - x0);
+    float cellDy = std::abs(y1 - y0);
+    float tDeltaX = cellDx > 0.0f ? 1.0f / cellDx : INFINITY;
+    float tDeltaY = cellDy > 0.0f ? 1.0f / cellDy : INFINITY;
+    float tMaxX = cellDx > 0.0f ? (x1 > x0 ? column + 1 - x0 : x0 - column) * tDeltaX : INFINITY;
+    float tMaxY = cellDy > 0.0f ? (y1 > y0 ? row + 1 - y0 : y0 - row) * tDeltaY : INFINITY;
+
+    int32_t stepX = lastColumn > column ? 1 : -1;
+    int32_t stepY = lastRow > row ? 1 : -1;
+
+    // every step goes towards the last cell, so rounding can never walk past it
+    while (column != lastColumn || row != lastRow)
+    {
+        if (column != lastColumn && (row == lastRow || tMaxX < tMaxY))
+        {
+            column += stepX;
+            tMaxX += tDeltaX;
+        }
+        else
+        {
+            row += stepY;
+            tMaxY += tDeltaY;
+        }
+
+        AddCell(column, row);
+    }
+}
+
+void HeatmapGrid::Clear()
+{
+    std::fill(m_counts.begin(), m_counts.end(), static_cast<uint16_t>(0));
+    std::fill(m_blockOccupied.begin(), m_blockOccupied.end(), static_cast<uint8_t>(0));
+    std::fill(m_blockChanged.begin(), m_blockChanged.end(), static_cast<uint8_t>(0));
+    m_changedBlocks.clear();
+
+    m_maxCount = 0;
+    m_shift = 0;
+    m_fullRedraw = true;
+    m_hasLast = false;
+}
+
+void HeatmapGrid::Invalidate()
+{
+    m_fullRedraw = true;
+}
+
+bool HeatmapGrid::NeedsFullRedraw() const
+{
+    return m_fullRedraw;
+}
+
+bool HeatmapGrid::HasChanges() const
+{
+    return m_fullRedraw || !m_changedBlocks.empty();
+}
+
+RectI HeatmapGrid::GetBlockRect(size_t block) const
+{
+    int32_t blockPixels = BLOCK_CELLS * m_cellSize;
+    int32_t left = static_cast<int32_t>(block % m_blockColumns) * blockPixels;
+    int32_t top = static_cast<int32_t>(block / m_blockColumns) * blockPixels;
+
+    return RectI{ left, top, std::min(left + blockPixels, m_width), std::min(top + blockPixels, m_height) };
+}
+
+void HeatmapGrid::Colorize(RectI rect, uint32_t* pDst, size_t stride)
+{
+    int32_t width = rect.right - rect.left;
+    int32_t height = rect.bottom - rect.top;
+    if (width <= 0 || height <= 0) return;
+
+    int32_t firstColumn = rect.left / m_cellSize;
+    int32_t columnCount = (rect.right + m_cellSize - 1) / m_cellSize - firstColumn;
+    if (m_rowColors.size() < static_cast<size_t>(columnCount)) m_rowColors.resize(columnCount);
+
+    for (int32_t y = 0; y < height;)
+    {
+        int32_t row = (rect.top + y) / m_cellSize;
+        PixelKernels::MapCounts(m_counts.data() + static_cast<size_t>(row) * m_columns + firstColumn, m_rowColors.data(), columnCount, m_palette, m_shift);
+
+        // every cell is a square of cellSize pixels, the first row of them is filled in and copied down
+        uint32_t* pFirst = pDst + static_cast<size_t>(y) * stride;
+        for (int32_t x = 0; x < width; ++x) pFirst[x] = m_rowColors[(rect.left + x) / m_cellSize - firstColumn];
+
+        int32_t rowEnd = std::min((row + 1) * m_cellSize - rect.top, height);
+        for (++y; y < rowEnd; ++y) std::memcpy(pDst + static_cast<size_t>(y) * stride, pFirst, width * sizeof(uint32_t));
+    }
+}
+
+void HeatmapGrid::Commit()
+{
+    for (uint32_t block : m_changedBlocks) m_blockChanged[block] = 0;
+    m_changedBlocks.clear();
+
+    m_fullRedraw = false;
+}
+
+int32_t HeatmapGrid::GetBlockSize() const
+{
+    return BLOCK_CELLS * m_cellSize;
+}
+
+uint32_t HeatmapGrid::GetMaxCount() const
+{
+    return m_maxCount;
+}
+
+uint32_t HeatmapGrid::GetCount(int32_t column, int32_t row) const
+{
+    return m_counts[static_cast<size_t>(row) * m_columns + column];
+}
@@ -0,0 +1,94 @@
+#pragma once
+#include "PathTypes.h"
+#include <vector>
+#include <cstdint>
+#include <cstddef>
+
+namespace PathWindows
+{
+    // Shows how often a path passed through each part of a surface instead of the path itself: a grid of counts at
+    // a reduced resolution that every new segment adds to along its length, colored through a palette when drawn.
+    // Only the blocks of cells that changed since the last Commit have to be drawn again, unless the scale of the
+    // colors changed (which happens each time the highest count doubles).
+    class HeatmapGrid
+    {
+    public:
+        // background is what cells that were never passed through are drawn as, the heat is blended over it.
+        HeatmapGrid(int32_t width, int32_t height, int32_t cellSize, ColorF background);
+
+        // Adds the segment from the last point to this one, or only the cell of this one if it starts a new figure.
+        void Append(PointF point, bool newFigure);
+
+        void Clear();
+
+        // Forces the next frame to draw everything, e.g. after the surface it was drawn on was lost.
+        void Invalidate();
+
+        bool NeedsFullRedraw() const;
+        bool HasChanges() const;
+
+        // Calls fn(RectI rect) with the pixels of every block that has to be drawn, clipped to the surface.
+        // All blocks that were ever passed through if everything has to be drawn, otherwise the changed ones.
+        template<class Fn>
+        void ForEachChangedBlock(Fn&& fn) const
+        {
+            if (m_fullRedraw)
+            {
+                for (size_t i = 0; i < m_blockOccupied.size(); ++i)
+                {
+                    if (m_blockOccupied[i]) fn(GetBlockRect(i));
+                }
+                return;
+            }
+
+            for (uint32_t block : m_changedBlocks) fn(GetBlockRect(block));
+        }
+
+        // Writes the pixels of rect (one that ForEachChangedBlock passed) as premultiplied BGRA to pDst, stride is in pixels.
+        void Colorize(RectI rect, uint32_t* pDst, size_t stride);
+
+        // Marks everything as drawn.
+        void Commit();
+
+        int32_t GetBlockSize() const;
+        uint32_t GetMaxCount() const;
+        uint32_t GetCount(int32_t column, int32_t row) const;
+
+    private:
+        static constexpr int32_t BLOCK_CELLS = 16;
+        static constexpr size_t PALETTE_SIZE = 256;
+
+        int32_t m_width;
+        int32_t m_height;
+        int32_t m_cellSize;
+        int32_t m_columns;
+        int32_t m_rows;
+        int32_t m_blockColumns;
+        int32_t m_blockRows;
+
+        // saturate at 65535, by then the scale has long stopped telling such cells apart
+        std::vector<uint16_t> m_counts;
+        uint32_t m_maxCount;
+        // how far counts are shifted to index the palette, the bit length of m_maxCount
+        uint32_t m_shift;
+
+        std::vector<uint8_t> m_blockOccupied;
+        std::vector<uint8_t> m_blockChanged;
+        std::vector<uint32_t> m_changedBlocks;
+        bool m_fullRedraw;
+
+        PointF m_last;
+        bool m_hasLast;
+
+        uint32_t m_palette[PALETTE_SIZE];
+        std::vector<uint32_t> m_rowColors;
+
+        bool IsOnSurface(PointF point) const;
+        void AddCell(int32_t column, int32_t row);
+        void AddSegment(PointF a, PointF b);
+
+        RectI GetBlockRect(size_t block) const;
+
+        void BuildPalette(ColorF background);
+    };
+}
@@ -0,0 +1,146 @@
+#pragma once
+#include "WorkDispatcher.h"
+#include <atomic>
+#include <condition_variable>
+#include <functional>
+#include <mutex>
+#include <thread>
+#include <utility>
+
+namespace PathWindows
+{
+    // A long-lived thread that runs work items posted to it, for things (like windows) that have to live on one thread.
+    // What the thread does besides running work comes from Platform, which must have:
+    //   bool Enter(WorkDispatcher&)  on the thread, before anything runs. Returning false ends the thread.
+    //   void Run()                   on the thread, until Quit is called. Calls RunPending on the dispatcher when woken,
+    //                                and once when it starts, since work may have been posted before.
+    //   void Wake()                  from any thread, makes Run call RunPending.
+    //   void Quit()                  on the thread, makes Run return.
+    //   void Leave()                 on the thread, after Run returned.
+    template<class Platform>
+    class HostThread
+    {
+    public:
+        explicit HostThread(Platform& platform) :
+            m_platform(platform),
+            m_threadId(std::thread::id()),
+            m_running(false),
+            m_entered(false),
+            m_enterSucceeded(false)
+        {
+            m_dispatcher.SetWake([this] { m_platform.Wake(); });
+        }
+
+        ~HostThread()
+        {
+            Stop();
+        }
+
+        HostThread(const HostThread&) = delete;
+        HostThread& operator=(const HostThread&) = delete;
+
+        // Starts the thread unless it is running already, and waits until it is ready for work.
+        // Returns false if it could not be started.
+        bool Start()
+        {
+            std::lock_guard<std::mutex> startLock(m_startMutex);
+            if (m_running) return true;
+
+            {
+                std::lock_guard<std::mutex> lock(m_enterMutex);
+                m_entered = false;
+                m_enterSucceeded = false;
+            }
+
+            m_thread = std::thread(&HostThread::ThreadProc, this);
+
+            std::unique_lock<std::mutex> lock(m_enterMutex);
+            m_enterChanged.wait(lock, [this] { return m_entered; });
+
+            if (!m_enterSucceeded)
+            {
+                lock.unlock();
+                m_thread.join();
+                return false;
+            }
+
+            m_running = true;
+            return true;
+        }
+
+        // Ends the thread once everything posted before has run. Must not be called on the thread itself.
+        void Stop()
+        {
+            std::lock_guard<std::mutex> startLock(m_startMutex);
+            if (!m_running) return;
+
+            m_dispatcher.Post([this] { m_platform.Quit(); });
+            m_thread.join();
+
+            m_running = false;
+        }
+
+        bool IsRunning()
+        {
+            std::lock_guard<std::mutex> startLock(m_startMutex);
+            return m_running;
+        }
+
+        bool IsHostThread() const
+        {
+            return std::this_thread::get_id() == m_threadId;
+        }
+
+        // The thread must have been started.
+        void Post(std::function<void()> work)
+        {
+            m_dispatcher.Post(std::move(work));
+        }
+
+        // Runs fn on the thread and waits for its result. Runs it right away if called on the thread, which would
+        // otherwise wait for itself.
+        template<class Fn>
+        auto Invoke(Fn&& fn) -> decltype(fn())
+        {
+            if (IsHostThread()) return fn();
+
+            return m_dispatcher.PostForResult(std::forward<Fn>(fn)).get();
+        }
+
+    private:
+        Platform& m_platform;
+        WorkDispatcher m_dispatcher;
+
+        // serializes Start and Stop
+        std::mutex m_startMutex;
+        std::thread m_thread;
+        std::atomic<std::thread::id> m_threadId;
+        bool m_running;
+
+        std::mutex m_enterMutex;
+        std::condition_variable m_enterChanged;
+        bool m_entered;
+        bool m_enterSucceeded;
+
+        void ThreadProc()
+        {
+            m_threadId = std::this_thread::get_id();
+
+            bool succeeded = m_platform.Enter(m_dispatcher);
+            {
+                std::lock_guard<std::mutex> lock(m_enterMutex);
+                m_entered = true;
+                m_enterSucceeded = succeeded;
+                m_enterChanged.notify_all();
+            }
+
+            if (succeeded)
+            {
+                m_platform.Run();
+                m_platform.Leave();
+            }
+
+            m_threadId = std::thread::id();
+        }
+    };
+}
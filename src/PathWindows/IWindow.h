@@ -1,5 +1,6 @@
 #pragma once
 #include "pch.h"
+#include <functional>
 
 class IWindow
 {
@@ -9,5 +10,7 @@ public:
 	virtual HWND GetHandle() = 0;
 
 	virtual HRESULT Initialize() = 0;
-	virtual HRESULT RunMessageLoop() = 0;
+	// Called on the window's thread when its window is destroyed, whether it was asked to close or closed on its own.
+	// The window object must not be deleted from inside the callback.
+	virtual void SetOnDestroyed(const std::function<void()>& onDestroyed) = 0;
 };
@@ -19,12 +19,14 @@ LayeredWindowInfo::LayeredWindowInfo(LONG width, LONG height) :
 	m_info.pptDst = nullptr;
 	m_info.psize = &m_size;
 	m_info.pblend = &m_blend;
+	m_info.prcDirty = nullptr;
 	m_info.dwFlags = ULW_ALPHA;
 }
 
-HRESULT LayeredWindowInfo::Update(HWND hWnd, HDC source)
+HRESULT LayeredWindowInfo::Update(HWND hWnd, HDC source, const RECT* pDirty)
 {
 	m_info.hdcSrc = source;
+	m_info.prcDirty = pDirty;
 	if (UpdateLayeredWindowIndirect(hWnd, &m_info) == 0)
 	{
 		return E_FAIL;
@@ -8,7 +8,8 @@ namespace PathWindows
 	public:
 		LayeredWindowInfo(LONG width, LONG height);
 
-		HRESULT Update(HWND hWnd, HDC source);
+		// pDirty limits the update to the part of the source that changed, nullptr updates the whole window.
+		HRESULT Update(HWND hWnd, HDC source, const RECT* pDirty = nullptr);
 
 	private:
 		const POINT m_sourcePos;
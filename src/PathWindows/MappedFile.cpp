@@ -0,0 +1,199 @@
+#include "MappedFile.h"
+
+#ifdef _WIN32
+#define WIN32_LEAN_AND_MEAN
+#define NOMINMAX
+#include <windows.h>
+#else
+#include <cerrno>
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+using namespace PathWindows;
+
+MappedFile::MappedFile() :
+#ifdef _WIN32
+    m_hFile(INVALID_HANDLE_VALUE),
+    m_hMapping(nullptr),
+#else
+    m_fd(-1),
+#endif
+    m_size(0),
+    m_error(0)
+{}
+
+MappedFile::~MappedFile()
+{
+    Close();
+}
+
+uint64_t MappedFile::GetSize() const
+{
+    return m_size;
+}
+
+uint32_t MappedFile::GetError() const
+{
+    return m_error;
+}
+
+bool MappedFile::ForEachView(size_t viewSize, const std::function<bool(const uint8_t*, size_t)>& fn)
+{
+    size_t granularity = GetGranularity();
+    viewSize = (viewSize + granularity - 1) / granularity * granularity;
+    if (viewSize == 0) viewSize = granularity;
+
+    for (uint64_t offset = 0; offset < m_size; offset += viewSize)
+    {
+        size_t size = static_cast<size_t>(m_size - offset < viewSize ? m_size - offset : viewSize);
+
+        const uint8_t* view = MapView(offset, size);
+        if (!view) return false;
+
+        bool proceed = fn(view, size);
+        UnmapView(view, size);
+
+        if (!proceed) break;
+    }
+
+    return true;
+}
+
+#ifdef _WIN32
+
+bool MappedFile::Open(const FileNameChar* fileName)
+{
+    Close();
+
+    m_hFile = CreateFileW(fileName, GENERIC_READ, FILE_SHARE_READ, nullptr, OPEN_EXISTING, FILE_FLAG_SEQUENTIAL_SCAN, nullptr);
+    if (m_hFile == INVALID_HANDLE_VALUE)
+    {
+        m_error = GetLastError();
+        return false;
+    }
+
+    LARGE_INTEGER size;
+    if (!GetFileSizeEx(m_hFile, &size))
+    {
+        m_error = GetLastError();
+        Close();
+        return false;
+    }
+    m_size = static_cast<uint64_t>(size.QuadPart);
+
+    // an empty file cannot be mapped, and has nothing to read anyway
+    if (m_size == 0) return true;
+
+    m_hMapping = CreateFileMappingW(m_hFile, nullptr, PAGE_READONLY, 0, 0, nullptr);
+    if (!m_hMapping)
+    {
+        m_error = GetLastError();
+        Close();
+        return false;
+    }
+
+    return true;
+}
+
+void MappedFile::Close()
+{
+    if (m_hMapping)
+    {
+        CloseHandle(m_hMapping);
+        m_hMapping = nullptr;
+    }
+
+    if (m_hFile != INVALID_HANDLE_VALUE)
+    {
+        CloseHandle(m_hFile);
+        m_hFile = INVALID_HANDLE_VALUE;
+    }
+
+    m_size = 0;
+}
+
+const uint8_t* MappedFile::MapView(uint64_t offset, size_t size)
+{
+    void* view = MapViewOfFile(m_hMapping, FILE_MAP_READ, static_cast<DWORD>(offset >> 32), static_cast<DWORD>(offset), size);
+    if (!view) m_error = GetLastError();
+
+    return static_cast<const uint8_t*>(view);
+}
+
+void MappedFile::UnmapView(const uint8_t* view, size_t)
+{
+    UnmapViewOfFile(view);
+}
+
+size_t MappedFile::GetGranularity()
+{
+    SYSTEM_INFO info;
+    GetSystemInfo(&info);
+    return info.dwAllocationGranularity;
+}
+
+#else
+
+bool MappedFile::Open(const FileNameChar* fileName)
+{
+    Close();
+
+    m_fd = open(fileName, O_RDONLY | O_CLOEXEC);
+    if (m_fd < 0)
+    {
+        m_error = errno;
+        return false;
+    }
+
+    struct stat info;
+    if (fstat(m_fd, &info) != 0)
+    {
+        m_error = errno;
+        Close();
+        return false;
+    }
+    m_size = static_cast<uint64_t>(info.st_size);
+
+    return true;
+}
+
+void MappedFile::Close()
+{
+    if (m_fd >= 0)
+    {
+        close(m_fd);
+        m_fd = -1;
+    }
+
+    m_size = 0;
+}
+
+const uint8_t* MappedFile::MapView(uint64_t offset, size_t size)
+{
+    void* view = mmap(nullptr, size, PROT_READ, MAP_SHARED, m_fd, static_cast<off_t>(offset));
+    if (view == MAP_FAILED)
+    {
+        m_error = errno;
+        return nullptr;
+    }
+
+    // the view is read front to back once
+    madvise(view, size, MADV_SEQUENTIAL);
+
+    return static_cast<const uint8_t*>(view);
+}
+
+void MappedFile::UnmapView(const uint8_t* view, size_t size)
+{
+    munmap(const_cast<uint8_t*>(view), size);
+}
+
+size_t MappedFile::GetGranularity()
+{
+    return static_cast<size_t>(sysconf(_SC_PAGESIZE));
+}
+
+#endif
@@ -0,0 +1,55 @@
+#pragma once
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+
+namespace PathWindows
+{
+#ifdef _WIN32
+    using FileNameChar = wchar_t;
+#else
+    using FileNameChar = char;
+#endif
+
+    // A read-only file that is mapped into memory one view at a time, so that reading through a file of any size
+    // only ever keeps one view's worth of its pages mapped.
+    class MappedFile
+    {
+    public:
+        MappedFile();
+        ~MappedFile();
+
+        MappedFile(const MappedFile&) = delete;
+        MappedFile& operator=(const MappedFile&) = delete;
+
+        // Returns false if the file could not be opened or mapped, see GetError.
+        bool Open(const FileNameChar* fileName);
+        void Close();
+
+        uint64_t GetSize() const;
+
+        // GetLastError on Windows, errno elsewhere, from the call that failed last.
+        uint32_t GetError() const;
+
+        // Calls fn(const uint8_t* data, size_t size) for consecutive views of up to viewSize bytes (rounded up to the
+        // mapping granularity) until the end of the file, or until fn returns false.
+        // Every view is unmapped before the next one is mapped. Returns false if a view could not be mapped.
+        bool ForEachView(size_t viewSize, const std::function<bool(const uint8_t*, size_t)>& fn);
+
+        // Views have to start at multiples of this.
+        static size_t GetGranularity();
+
+    private:
+#ifdef _WIN32
+        void* m_hFile;
+        void* m_hMapping;
+#else
+        int m_fd;
+#endif
+        uint64_t m_size;
+        uint32_t m_error;
+
+        const uint8_t* MapView(uint64_t offset, size_t size);
+        void UnmapView(const uint8_t* view, size_t size);
+    };
+}
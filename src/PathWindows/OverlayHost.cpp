@@ -0,0 +1,172 @@
+#include "pch.h"
+#include "OverlayHost.h"
+#include "D2DRenderBackend.h"
+
+#ifndef HINST_THISCOMPONENT
+EXTERN_C IMAGE_DOS_HEADER __ImageBase;
+#define HINST_THISCOMPONENT ((HINSTANCE)&__ImageBase)
+#endif
+
+using namespace PathWindows;
+
+OverlayHost& OverlayHost::Get()
+{
+    // never destroyed, joining a thread while the DLL unloads would deadlock
+    static OverlayHost* pHost = new OverlayHost();
+    return *pHost;
+}
+
+OverlayHost::OverlayHost() :
+    m_loop(),
+    m_thread(m_loop),
+    m_windowCount(0)
+{}
+
+HRESULT OverlayHost::Start()
+{
+    if (m_thread.Start()) return S_OK;
+
+    HRESULT hr = m_loop.GetEnterHR();
+    return FAILED(hr) ? hr : E_FAIL;
+}
+
+HRESULT OverlayHost::WarmUp()
+{
+    HRESULT hr = Start();
+    if (FAILED(hr)) return hr;
+
+    return m_thread.Invoke([] { return D2DRenderBackend::CreateSharedResources(); });
+}
+
+HRESULT OverlayHost::Shutdown()
+{
+    if (m_thread.IsHostThread()) return RPC_E_WRONG_THREAD;
+    if (m_windowCount > 0) return HRESULT_FROM_WIN32(ERROR_BUSY);
+
+    m_thread.Stop();
+
+    return S_OK;
+}
+
+bool OverlayHost::IsHostThread() const
+{
+    return m_thread.IsHostThread();
+}
+
+void OverlayHost::Post(std::function<void()> work)
+{
+    m_thread.Post(std::move(work));
+}
+
+void OverlayHost::OnWindowOpened()
+{
+    ++m_windowCount;
+}
+
+void OverlayHost::OnWindowClosed()
+{
+    --m_windowCount;
+}
+
+OverlayHost::MessageLoop::MessageLoop() :
+    m_hWnd(nullptr),
+    m_pDispatcher(nullptr),
+    m_enterHR(S_OK)
+{}
+
+bool OverlayHost::MessageLoop::Enter(WorkDispatcher& dispatcher)
+{
+    m_pDispatcher = &dispatcher;
+
+    m_enterHR = CoInitializeEx(NULL, COINIT_APARTMENTTHREADED);
+    if (FAILED(m_enterHR)) return false;
+
+    WNDCLASSEX wcex{};
+    wcex.cbSize = sizeof(WNDCLASSEX);
+    wcex.lpfnWndProc = MessageLoop::WndProc;
+    wcex.hInstance = HINST_THISCOMPONENT;
+    wcex.lpszClassName = L"PathWindowsOverlayHost";
+
+    // the class stays registered after the thread stops, and is reused when it starts again
+    if (RegisterClassEx(&wcex) == 0 && GetLastError() != ERROR_CLASS_ALREADY_EXISTS)
+    {
+        m_enterHR = HRESULT_FROM_WIN32(GetLastError());
+        CoUninitialize();
+        return false;
+    }
+
+    HWND hWnd = CreateWindowEx(0, wcex.lpszClassName, L"", 0, 0, 0, 0, 0, HWND_MESSAGE, nullptr, HINST_THISCOMPONENT, this);
+    if (!hWnd)
+    {
+        m_enterHR = HRESULT_FROM_WIN32(GetLastError());
+        CoUninitialize();
+        return false;
+    }
+
+    m_hWnd = hWnd;
+    return true;
+}
+
+void OverlayHost::MessageLoop::Run()
+{
+    // anything posted before the window existed could not wake the thread
+    m_pDispatcher->RunPending();
+
+    MSG msg{};
+    BOOL bRet;
+    while ((bRet = GetMessage(&msg, NULL, 0, 0)) != 0)
+    {
+        if (bRet == -1) break;
+
+        DispatchMessage(&msg);
+    }
+}
+
+void OverlayHost::MessageLoop::Wake()
+{
+    HWND hWnd = m_hWnd;
+    if (hWnd) PostMessage(hWnd, WM_RUNWORK, 0, 0);
+}
+
+void OverlayHost::MessageLoop::Quit()
+{
+    PostQuitMessage(0);
+}
+
+void OverlayHost::MessageLoop::Leave()
+{
+    // released before COM is
+    D2DRenderBackend::ReleaseSharedResources();
+
+    HWND hWnd = m_hWnd.exchange(nullptr);
+    DestroyWindow(hWnd);
+
+    // work posted from now on runs when the thread starts again
+    CoUninitialize();
+}
+
+HRESULT OverlayHost::MessageLoop::GetEnterHR() const
+{
+    return m_enterHR;
+}
+
+LRESULT CALLBACK OverlayHost::MessageLoop::WndProc(HWND hWnd, UINT message, WPARAM wParam, LPARAM lParam)
+{
+    if (message == WM_CREATE)
+    {
+        auto pcs = (LPCREATESTRUCT)lParam;
+        SetWindowLongPtr(hWnd, GWLP_USERDATA, reinterpret_cast<LONG_PTR>(pcs->lpCreateParams));
+
+        return 0;
+    }
+
+    auto pLoop = reinterpret_cast<MessageLoop*>(static_cast<LONG_PTR>(GetWindowLongPtr(hWnd, GWLP_USERDATA)));
+
+    if (pLoop && message == WM_RUNWORK)
+    {
+        pLoop->m_pDispatcher->RunPending();
+        return 0;
+    }
+
+    return DefWindowProc(hWnd, message, wParam, lParam);
+}
@@ -0,0 +1,70 @@
+#pragma once
+#include "pch.h"
+#include "HostThread.h"
+#include <atomic>
+#include <functional>
+
+namespace PathWindows
+{
+    // The thread every overlay window lives on. It is started by the first window (or WarmUp) and kept running until
+    // Shutdown, so opening a window does not pay for a new thread, COM and the Direct2D factories each time.
+    // Work is posted to it through a message-only window.
+    class OverlayHost
+    {
+    public:
+        static OverlayHost& Get();
+
+        // Starts the thread unless it is running.
+        HRESULT Start();
+
+        // Starts the thread and creates the device independent resources windows share on it.
+        HRESULT WarmUp();
+
+        // Stops the thread, which fails while any window is open. Must not be called on the thread.
+        HRESULT Shutdown();
+
+        bool IsHostThread() const;
+
+        void Post(std::function<void()> work);
+
+        template<class Fn>
+        auto Invoke(Fn&& fn) -> decltype(fn())
+        {
+            return m_thread.Invoke(std::forward<Fn>(fn));
+        }
+
+        void OnWindowOpened();
+        void OnWindowClosed();
+
+    private:
+        class MessageLoop
+        {
+        public:
+            MessageLoop();
+
+            bool Enter(WorkDispatcher& dispatcher);
+            void Run();
+            void Wake();
+            void Quit();
+            void Leave();
+
+            HRESULT GetEnterHR() const;
+
+        private:
+            static constexpr UINT WM_RUNWORK = WM_APP + 1;
+
+            std::atomic<HWND> m_hWnd;
+            WorkDispatcher* m_pDispatcher;
+            HRESULT m_enterHR;
+
+            static LRESULT CALLBACK WndProc(HWND hWnd, UINT message, WPARAM wParam, LPARAM lParam);
+        };
+
+        MessageLoop m_loop;
+        HostThread<MessageLoop> m_thread;
+
+        std::atomic<int> m_windowCount;
+
+        OverlayHost();
+    };
+}
@@ -0,0 +1,108 @@
+#pragma once
+#include <condition_variable>
+#include <cstdint>
+#include <mutex>
+
+namespace PathWindows
+{
+    enum class OverlayState
+    {
+        CREATING,
+        OPEN,
+        // a close was requested and the window has not been destroyed yet
+        CLOSING,
+        CLOSED
+    };
+
+    // The lifetime of one overlay window that lives on another thread:
+    // CREATING -> OPEN -> (CLOSING ->) CLOSED, or CREATING -> CLOSED if creating it failed.
+    // The window thread reports what happened, any other thread can wait for it.
+    // Times are in nanoseconds, from any monotonic clock.
+    class OverlayLifetime
+    {
+    public:
+        explicit OverlayLifetime(int64_t requestedNS) :
+            m_state(OverlayState::CREATING),
+            m_requestedNS(requestedNS),
+            m_openLatencyNS(-1)
+        {}
+
+        // Called on the window thread once the window is created and its first frame is shown, or creating it failed.
+        // Returns false if the window was not being created.
+        bool OnCreated(bool succeeded, int64_t nowNS)
+        {
+            std::lock_guard<std::mutex> lock(m_mutex);
+            if (m_state != OverlayState::CREATING) return false;
+
+            m_state = succeeded ? OverlayState::OPEN : OverlayState::CLOSED;
+            if (succeeded) m_openLatencyNS = nowNS - m_requestedNS;
+
+            // notified under the lock, a waiter may destroy this as soon as it sees the new state
+            m_stateChanged.notify_all();
+            return true;
+        }
+
+        // Returns true if the window is open and the caller is the one that has to close it. close() is called under the
+        // lock before it returns, so the window cannot be destroyed while it runs, see OnDestroying.
+        template<typename Close>
+        bool BeginClose(Close close)
+        {
+            std::lock_guard<std::mutex> lock(m_mutex);
+            if (m_state != OverlayState::OPEN) return false;
+
+            m_state = OverlayState::CLOSING;
+            close();
+            return true;
+        }
+
+        // Called on the window thread before the window is destroyed, also if it closes on its own, so BeginClose
+        // does not start closing it any more.
+        void OnDestroying()
+        {
+            std::lock_guard<std::mutex> lock(m_mutex);
+            if (m_state == OverlayState::OPEN) m_state = OverlayState::CLOSING;
+        }
+
+        // Called on the window thread once the window is gone, also if it closed on its own.
+        void OnClosed()
+        {
+            std::lock_guard<std::mutex> lock(m_mutex);
+            m_state = OverlayState::CLOSED;
+            m_stateChanged.notify_all();
+        }
+
+        OverlayState GetState()
+        {
+            std::lock_guard<std::mutex> lock(m_mutex);
+            return m_state;
+        }
+
+        OverlayState WaitWhileCreating()
+        {
+            std::unique_lock<std::mutex> lock(m_mutex);
+            m_stateChanged.wait(lock, [this] { return m_state != OverlayState::CREATING; });
+            return m_state;
+        }
+
+        void WaitUntilClosed()
+        {
+            std::unique_lock<std::mutex> lock(m_mutex);
+            m_stateChanged.wait(lock, [this] { return m_state == OverlayState::CLOSED; });
+        }
+
+        // How long it took from the request to the first frame, or -1 if the window never opened.
+        int64_t GetOpenLatency()
+        {
+            std::lock_guard<std::mutex> lock(m_mutex);
+            return m_openLatencyNS;
+        }
+
+    private:
+        std::mutex m_mutex;
+        std::condition_variable m_stateChanged;
+
+        OverlayState m_state;
+        int64_t m_requestedNS;
+        int64_t m_openLatencyNS;
+    };
+}
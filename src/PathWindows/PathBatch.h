@@ -0,0 +1,80 @@
+#pragma once
+#include "PathTypes.h"
+#include "PixelKernels.h"
+#include <vector>
+#include <memory>
+#include <cstdint>
+#include <cstddef>
+
+namespace PathWindows
+{
+    // A batch of points is one flat array plus the indices into it where new figures start (in ascending order).
+    // Points before the first figure start continue the last figure that was added.
+    namespace PathBatch
+    {
+        inline bool IsValid(size_t pointCount, const int32_t* figureStarts, size_t figureCount)
+        {
+            if (figureCount > 0 && !figureStarts) return false;
+
+            for (size_t i = 0; i < figureCount; ++i)
+            {
+                if (figureStarts[i] < 0 || static_cast<size_t>(figureStarts[i]) >= pointCount) return false;
+                if (i > 0 && figureStarts[i] <= figureStarts[i - 1]) return false;
+            }
+
+            return true;
+        }
+
+        // Calls fn(size_t first, size_t count, bool newFigure) for every run of points that belong to the same figure.
+        // The batch has to be valid.
+        template<class Fn>
+        void ForEachRun(size_t pointCount, const int32_t* figureStarts, size_t figureCount, Fn&& fn)
+        {
+            size_t first = 0;
+            bool newFigure = false;
+
+            for (size_t i = 0; i <= figureCount; ++i)
+            {
+                size_t end = i < figureCount ? static_cast<size_t>(figureStarts[i]) : pointCount;
+                if (end > first) fn(first, end - first, newFigure);
+
+                first = end;
+                newFigure = true;
+            }
+        }
+
+        // A whole batch, converted on the thread that submitted it, which is handed on as one piece rather than point
+        // by point. delaysNS is empty if the batch has no delays.
+        struct Run
+        {
+            std::vector<PointF> points;
+            std::vector<int64_t> delaysNS;
+            std::vector<int32_t> figureStarts;
+        };
+
+        // Converts a valid batch of x, y int32 pairs (like POINT) in one go.
+        inline std::unique_ptr<Run> MakeRun(const int32_t* pXY, size_t pointCount, const int32_t* figureStarts, size_t figureCount)
+        {
+            std::unique_ptr<Run> pRun = std::make_unique<Run>();
+            pRun->points.resize(pointCount);
+            PixelKernels::ConvertPoints(pXY, pRun->points.data(), pointCount, PointF{ 0.0f, 0.0f });
+            pRun->figureStarts.assign(figureStarts, figureStarts + figureCount);
+            return pRun;
+        }
+
+        // Like MakeRun, for a valid batch of movements, whose delays are kept.
+        inline std::unique_ptr<Run> MakeTimedRun(const Movement* movements, size_t pointCount, const int32_t* figureStarts, size_t figureCount)
+        {
+            std::unique_ptr<Run> pRun = std::make_unique<Run>();
+            pRun->points.resize(pointCount);
+            pRun->delaysNS.resize(pointCount);
+            for (size_t i = 0; i < pointCount; ++i)
+            {
+                pRun->points[i] = PointF{ static_cast<float>(movements[i].delta.x), static_cast<float>(movements[i].delta.y) };
+                pRun->delaysNS[i] = movements[i].delayDurationNS;
+            }
+            pRun->figureStarts.assign(figureStarts, figureStarts + figureCount);
+            return pRun;
+        }
+    }
+}
@@ -0,0 +1,418 @@
+#include "PathCodec.h"
+#include "MappedFile.h"
+#include <algorithm>
+#include <cstring>
+
+using namespace PathWindows;
+using PathCodec::Result;
+
+namespace
+{
+    constexpr uint8_t MAGIC[4] = { 'A', 'R', 'P', 'C' };
+
+    // the delay code that is followed by the delay itself
+    constexpr uint64_t LITERAL_DELAY = PathCodec::DELAY_DICTIONARY_SIZE;
+
+    struct CrcTable
+    {
+        uint32_t entries[256];
+
+        CrcTable() : entries()
+        {
+            for (uint32_t i = 0; i < 256; ++i)
+            {
+                uint32_t crc = i;
+                for (int bit = 0; bit < 8; ++bit) crc = (crc >> 1) ^ (0xEDB88320u & (0u - (crc & 1)));
+                entries[i] = crc;
+            }
+        }
+    };
+
+    inline uint64_t ZigZag(int64_t value)
+    {
+        return (static_cast<uint64_t>(value) << 1) ^ static_cast<uint64_t>(value >> 63);
+    }
+
+    inline int64_t UnZigZag(uint64_t value)
+    {
+        return static_cast<int64_t>(value >> 1) ^ -static_cast<int64_t>(value & 1);
+    }
+
+    inline void WriteVarint(std::vector<uint8_t>& out, uint64_t value)
+    {
+        while (value >= 0x80)
+        {
+            out.push_back(static_cast<uint8_t>(value) | 0x80);
+            value >>= 7;
+        }
+        out.push_back(static_cast<uint8_t>(value));
+    }
+
+    // Returns false if the varint does not end before end or does not fit in 64 bits.
+    inline bool ReadVarint(const uint8_t*& pos, const uint8_t* end, uint64_t& value)
+    {
+        value = 0;
+        for (int shift = 0; shift < 64; shift += 7)
+        {
+            if (pos == end) return false;
+
+            uint8_t byte = *pos++;
+            // the tenth byte only has room for the top bit
+            if (shift == 63 && byte > 1) return false;
+
+            value |= static_cast<uint64_t>(byte & 0x7F) << shift;
+            if (!(byte & 0x80)) return true;
+        }
+
+        return false;
+    }
+
+    inline void WriteU32(uint8_t* dst, uint32_t value)
+    {
+        dst[0] = static_cast<uint8_t>(value);
+        dst[1] = static_cast<uint8_t>(value >> 8);
+        dst[2] = static_cast<uint8_t>(value >> 16);
+        dst[3] = static_cast<uint8_t>(value >> 24);
+    }
+
+    inline uint32_t ReadU32(const uint8_t* src)
+    {
+        return static_cast<uint32_t>(src[0]) | static_cast<uint32_t>(src[1]) << 8 | static_cast<uint32_t>(src[2]) << 16 | static_cast<uint32_t>(src[3]) << 24;
+    }
+
+    // positions are stored as differences from the last one, which can take 33 bits
+    inline int64_t Difference(int32_t value, int32_t previous)
+    {
+        return static_cast<int64_t>(value) - previous;
+    }
+
+    // Returns false if value + difference does not fit in 32 bits, which the encoder never writes.
+    inline bool Apply(int64_t value, int64_t difference, int32_t& result)
+    {
+        // added without overflowing, garbage differences can be anything
+        int64_t sum = static_cast<int64_t>(static_cast<uint64_t>(value) + static_cast<uint64_t>(difference));
+        if (sum < INT32_MIN || sum > INT32_MAX) return false;
+
+        result = static_cast<int32_t>(sum);
+        return true;
+    }
+}
+
+uint32_t PathCodec::Crc32(const uint8_t* data, size_t size)
+{
+    static const CrcTable table;
+
+    uint32_t crc = 0xFFFFFFFFu;
+    for (size_t i = 0; i < size; ++i) crc = (crc >> 8) ^ table.entries[(crc ^ data[i]) & 0xFF];
+
+    return ~crc;
+}
+
+PathEncoder::PathEncoder(bool absolute) :
+    ABSOLUTE_POSITIONS(absolute),
+    m_outputStart(0),
+    m_blockCount(0),
+    m_previous{},
+    m_dictionary(),
+    m_dictionarySize(0),
+    m_runLength(0),
+    m_runDelay(0)
+{
+    m_output.insert(m_output.end(), std::begin(MAGIC), std::end(MAGIC));
+    m_output.push_back(PathCodec::VERSION);
+    m_output.push_back(absolute ? PathCodec::FLAG_ABSOLUTE : 0);
+    m_output.push_back(0);
+    m_output.push_back(0);
+}
+
+void PathEncoder::Append(const Movement* movements, size_t count)
+{
+    for (size_t i = 0; i < count; ++i)
+    {
+        const Movement& movement = movements[i];
+
+        if (m_runLength > 0 && movement.delayDurationNS != m_runDelay) FlushRun();
+        m_runDelay = movement.delayDurationNS;
+
+        if (ABSOLUTE_POSITIONS)
+        {
+            WriteVarint(m_runCoordinates, ZigZag(Difference(movement.delta.x, m_previous.x)));
+            WriteVarint(m_runCoordinates, ZigZag(Difference(movement.delta.y, m_previous.y)));
+            m_previous = movement.delta;
+        }
+        else
+        {
+            WriteVarint(m_runCoordinates, ZigZag(movement.delta.x));
+            WriteVarint(m_runCoordinates, ZigZag(movement.delta.y));
+        }
+
+        ++m_runLength;
+
+        if (++m_blockCount == PathCodec::MAX_BLOCK_MOVEMENTS) Flush();
+    }
+}
+
+void PathEncoder::FlushRun()
+{
+    size_t code = std::find(m_dictionary, m_dictionary + m_dictionarySize, m_runDelay) - m_dictionary;
+
+    if (code < m_dictionarySize)
+    {
+        WriteVarint(m_payload, static_cast<uint64_t>(m_runLength - 1) << 4 | code);
+    }
+    else
+    {
+        WriteVarint(m_payload, static_cast<uint64_t>(m_runLength - 1) << 4 | LITERAL_DELAY);
+        WriteVarint(m_payload, ZigZag(m_runDelay));
+
+        if (m_dictionarySize < PathCodec::DELAY_DICTIONARY_SIZE) m_dictionary[m_dictionarySize++] = m_runDelay;
+    }
+
+    m_payload.insert(m_payload.end(), m_runCoordinates.begin(), m_runCoordinates.end());
+
+    m_runCoordinates.clear();
+    m_runLength = 0;
+}
+
+void PathEncoder::Flush()
+{
+    if (m_blockCount == 0) return;
+
+    FlushRun();
+
+    uint8_t header[PathCodec::BLOCK_HEADER_SIZE];
+    WriteU32(header, static_cast<uint32_t>(m_blockCount));
+    WriteU32(header + 4, static_cast<uint32_t>(m_payload.size()));
+    WriteU32(header + 8, PathCodec::Crc32(m_payload.data(), m_payload.size()));
+
+    // drop what was read already instead of growing forever while recording
+    if (m_outputStart > 0)
+    {
+        m_output.erase(m_output.begin(), m_output.begin() + m_outputStart);
+        m_outputStart = 0;
+    }
+
+    m_output.insert(m_output.end(), header, header + sizeof(header));
+    m_output.insert(m_output.end(), m_payload.begin(), m_payload.end());
+
+    m_payload.clear();
+    m_blockCount = 0;
+    m_previous = PointI{};
+    m_dictionarySize = 0;
+}
+
+size_t PathEncoder::GetOutputSize() const
+{
+    return m_output.size() - m_outputStart;
+}
+
+size_t PathEncoder::ReadOutput(uint8_t* dst, size_t capacity)
+{
+    size_t count = (std::min)(capacity, GetOutputSize());
+    if (count == 0) return 0;
+
+    std::memcpy(dst, m_output.data() + m_outputStart, count);
+    m_outputStart += count;
+
+    return count;
+}
+
+PathDecoder::PathDecoder() :
+    m_stage(Stage::HEADER),
+    m_result(Result::OK),
+    m_flags(0),
+    m_blockCount(0),
+    m_payloadSize(0),
+    m_checksum(0)
+{}
+
+Result PathDecoder::Feed(const uint8_t* data, size_t size, const std::function<void(const Movement*, size_t)>& sink)
+{
+    while (m_result == Result::OK && size > 0)
+    {
+        size_t stageSize = GetStageSize();
+
+        const uint8_t* stageData;
+        if (m_pending.empty() && size >= stageSize)
+        {
+            // the usual case, read straight from the input
+            stageData = data;
+            data += stageSize;
+            size -= stageSize;
+        }
+        else
+        {
+            size_t count = (std::min)(stageSize - m_pending.size(), size);
+            m_pending.insert(m_pending.end(), data, data + count);
+            data += count;
+            size -= count;
+
+            if (m_pending.size() < stageSize) break;
+            stageData = m_pending.data();
+        }
+
+        Stage stage = m_stage;
+        m_result = Consume(stageData);
+        m_pending.clear();
+
+        if (m_result == Result::OK && stage == Stage::PAYLOAD) sink(m_block.data(), m_block.size());
+    }
+
+    return m_result;
+}
+
+Result PathDecoder::Finish() const
+{
+    if (m_result != Result::OK) return m_result;
+
+    if (m_stage != Stage::BLOCK_HEADER || !m_pending.empty()) return Result::TRUNCATED;
+    return Result::OK;
+}
+
+bool PathDecoder::FeedFile(MappedFile& file, size_t viewSize, const std::function<void(const Movement*, size_t)>& sink, const std::function<bool()>& keepGoing, Result& result)
+{
+    result = m_result;
+    bool stopped = false;
+
+    bool mapped = file.ForEachView(viewSize, [this, &sink, &keepGoing, &result, &stopped](const uint8_t* data, size_t size)
+    {
+        result = Feed(data, size, sink);
+        stopped = result != Result::OK || !keepGoing();
+        return !stopped;
+    });
+
+    if (mapped && !stopped) result = Finish();
+    return mapped;
+}
+
+uint8_t PathDecoder::GetFlags() const
+{
+    return m_flags;
+}
+
+size_t PathDecoder::GetStageSize() const
+{
+    switch (m_stage)
+    {
+    case Stage::HEADER: return PathCodec::HEADER_SIZE;
+    case Stage::BLOCK_HEADER: return PathCodec::BLOCK_HEADER_SIZE;
+    default: return m_payloadSize;
+    }
+}
+
+Result PathDecoder::Consume(const uint8_t* data)
+{
+    switch (m_stage)
+    {
+    case Stage::HEADER:
+        if (std::memcmp(data, MAGIC, sizeof(MAGIC)) != 0) return Result::CORRUPT;
+        if (data[4] != PathCodec::VERSION) return Result::UNSUPPORTED_VERSION;
+        if ((data[5] & ~PathCodec::FLAG_ABSOLUTE) != 0 || data[6] != 0 || data[7] != 0) return Result::CORRUPT;
+
+        m_flags = data[5];
+        m_stage = Stage::BLOCK_HEADER;
+        return Result::OK;
+
+    case Stage::BLOCK_HEADER:
+        m_blockCount = ReadU32(data);
+        m_payloadSize = ReadU32(data + 4);
+        m_checksum = ReadU32(data + 8);
+
+        // every movement takes at least 2 bytes, and a block at least one run header
+        if (m_blockCount == 0 || m_blockCount > PathCodec::MAX_BLOCK_MOVEMENTS) return Result::CORRUPT;
+        if (m_payloadSize < m_blockCount * 2 + 1 || m_payloadSize > PathCodec::MAX_BLOCK_PAYLOAD) return Result::CORRUPT;
+
+        m_stage = Stage::PAYLOAD;
+        return Result::OK;
+
+    default:
+        if (PathCodec::Crc32(data, m_payloadSize) != m_checksum) return Result::CORRUPT;
+
+        m_stage = Stage::BLOCK_HEADER;
+        return DecodeBlock(data);
+    }
+}
+
+Result PathDecoder::DecodeBlock(const uint8_t* payload)
+{
+    const uint8_t* pos = payload;
+    const uint8_t* end = payload + m_payloadSize;
+
+    int64_t dictionary[PathCodec::DELAY_DICTIONARY_SIZE];
+    size_t dictionarySize = 0;
+
+    bool absolute = (m_flags & PathCodec::FLAG_ABSOLUTE) != 0;
+    PointI previous{};
+
+    m_block.resize(m_blockCount);
+    size_t count = 0;
+
+    while (pos != end)
+    {
+        uint64_t header;
+        if (!ReadVarint(pos, end, header)) return Result::CORRUPT;
+
+        uint64_t length = (header >> 4) + 1;
+        uint64_t code = header & 0xF;
+        if (length > m_blockCount - count) return Result::CORRUPT;
+
+        int64_t delay;
+        if (code == LITERAL_DELAY)
+        {
+            uint64_t value;
+            if (!ReadVarint(pos, end, value)) return Result::CORRUPT;
+
+            delay = UnZigZag(value);
+            if (dictionarySize < PathCodec::DELAY_DICTIONARY_SIZE) dictionary[dictionarySize++] = delay;
+        }
+        else
+        {
+            if (code >= dictionarySize) return Result::CORRUPT;
+            delay = dictionary[code];
+        }
+
+        for (uint64_t i = 0; i < length; ++i)
+        {
+            uint64_t x, y;
+            if (!ReadVarint(pos, end, x) || !ReadVarint(pos, end, y)) return Result::CORRUPT;
+
+            Movement& movement = m_block[count++];
+
+            PointI base = absolute ? previous : PointI{};
+            if (!Apply(base.x, UnZigZag(x), movement.delta.x) || !Apply(base.y, UnZigZag(y), movement.delta.y)) return Result::CORRUPT;
+
+            previous = movement.delta;
+            movement.delayDurationNS = delay;
+        }
+    }
+
+    if (count != m_blockCount) return Result::CORRUPT;
+    return Result::OK;
+}
+
+Result PathDecoder::CountMovements(const uint8_t* data, size_t size, size_t& count)
+{
+    count = 0;
+
+    if (size < PathCodec::HEADER_SIZE) return Result::TRUNCATED;
+    if (std::memcmp(data, MAGIC, sizeof(MAGIC)) != 0) return Result::CORRUPT;
+    if (data[4] != PathCodec::VERSION) return Result::UNSUPPORTED_VERSION;
+
+    size_t pos = PathCodec::HEADER_SIZE;
+    while (pos < size)
+    {
+        if (size - pos < PathCodec::BLOCK_HEADER_SIZE) return Result::TRUNCATED;
+
+        uint32_t blockCount = ReadU32(data + pos);
+        uint32_t payloadSize = ReadU32(data + pos + 4);
+        if (blockCount == 0 || blockCount > PathCodec::MAX_BLOCK_MOVEMENTS || payloadSize > PathCodec::MAX_BLOCK_PAYLOAD) return Result::CORRUPT;
+
+        pos += PathCodec::BLOCK_HEADER_SIZE;
+        if (size - pos < payloadSize) return Result::TRUNCATED;
+
+        pos += payloadSize;
+        count += blockCount;
+    }
+
+    return Result::OK;
+}
@@ -0,0 +1,139 @@
+#pragma once
+#include "PathTypes.h"
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <vector>
+
+// A compact binary format for sequences of movements, written and read a piece at a time.
+//
+// Stream:  header, then any number of blocks.
+// Header:  "ARPC", version (1 byte), flags (1 byte, PathCodec::FLAG_*), 2 reserved bytes of 0.
+// Block:   movement count, payload size and the CRC-32 of the payload (each 4 bytes, little endian), then the payload.
+//          Blocks hold at most MAX_BLOCK_MOVEMENTS movements and decode on their own.
+// Payload: runs of movements with the same delay. A run starts with the varint ((length - 1) << 4 | delay code),
+//          where a code below 15 picks an entry of the block's delay dictionary, and 15 is followed by the delay as a
+//          zigzag varint, which then becomes the next dictionary entry (while there is room).
+//          Then come the zigzag varint x and y of every movement in the run, which are differences from the movement
+//          before (0, 0 at the start of a block) if FLAG_ABSOLUTE is set, and stored as they are otherwise.
+// Varints are unsigned LEB128.
+
+namespace PathWindows
+{
+    class MappedFile;
+
+    namespace PathCodec
+    {
+        enum class Result
+        {
+            OK,
+            // the data is not a path stream or a checksum does not match
+            CORRUPT,
+            UNSUPPORTED_VERSION,
+            // the stream ended in the middle of the header or a block
+            TRUNCATED
+        };
+
+        constexpr uint8_t VERSION = 1;
+
+        // positions are absolute, rather than deltas, so consecutive ones are stored as differences
+        constexpr uint8_t FLAG_ABSOLUTE = 1;
+
+        constexpr size_t HEADER_SIZE = 8;
+        constexpr size_t BLOCK_HEADER_SIZE = 12;
+        constexpr size_t MAX_BLOCK_MOVEMENTS = 4096;
+        constexpr size_t DELAY_DICTIONARY_SIZE = 15;
+        // two 5 byte coordinates per movement, and a 3 byte run header and 10 byte delay for a run of one
+        constexpr size_t MAX_BLOCK_PAYLOAD = MAX_BLOCK_MOVEMENTS * 23;
+
+        uint32_t Crc32(const uint8_t* data, size_t size);
+    }
+
+    // Encodes movements as they are appended. Finished blocks pile up in the output until they are read.
+    class PathEncoder
+    {
+    public:
+        explicit PathEncoder(bool absolute);
+
+        void Append(const Movement* movements, size_t count);
+
+        // Ends the current block, so that everything appended so far can be read and decoded.
+        // Appending afterwards starts a new block.
+        void Flush();
+
+        size_t GetOutputSize() const;
+
+        // Moves up to capacity bytes of the output into dst and returns how many.
+        size_t ReadOutput(uint8_t* dst, size_t capacity);
+
+    private:
+        const bool ABSOLUTE_POSITIONS;
+
+        std::vector<uint8_t> m_output;
+        // where the unread output starts
+        size_t m_outputStart;
+
+        std::vector<uint8_t> m_payload;
+        size_t m_blockCount;
+        PointI m_previous;
+
+        int64_t m_dictionary[PathCodec::DELAY_DICTIONARY_SIZE];
+        size_t m_dictionarySize;
+
+        // the run being appended to, its coordinates are only written to the payload once its length is known
+        std::vector<uint8_t> m_runCoordinates;
+        size_t m_runLength;
+        int64_t m_runDelay;
+
+        void FlushRun();
+    };
+
+    // Decodes a stream fed to it in pieces of any size, one block at a time, so the whole path never has to be in memory.
+    class PathDecoder
+    {
+    public:
+        PathDecoder();
+
+        // Decodes every block completed by data and calls sink(const Movement*, size_t) once for each.
+        // After anything but OK is returned, the decoder stays failed.
+        PathCodec::Result Feed(const uint8_t* data, size_t size, const std::function<void(const Movement*, size_t)>& sink);
+
+        // Returns TRUNCATED if the stream stopped in the middle of the header or a block.
+        PathCodec::Result Finish() const;
+
+        // Feeds the file one view of up to viewSize bytes at a time, so only about that much of it is mapped at once
+        // however large it is, and finishes if it gets to the end. Stops early at the first view that fails to decode,
+        // or when keepGoing() returns false after a view. Returns false if a view could not be mapped (see
+        // MappedFile::GetError), otherwise result is set to how decoding went.
+        bool FeedFile(MappedFile& file, size_t viewSize, const std::function<void(const Movement*, size_t)>& sink, const std::function<bool()>& keepGoing, PathCodec::Result& result);
+
+        uint8_t GetFlags() const;
+
+        // Adds up the movement counts of the blocks in a complete stream, checking the framing but not the payloads.
+        static PathCodec::Result CountMovements(const uint8_t* data, size_t size, size_t& count);
+
+    private:
+        enum class Stage
+        {
+            HEADER,
+            BLOCK_HEADER,
+            PAYLOAD
+        };
+
+        Stage m_stage;
+        PathCodec::Result m_result;
+        uint8_t m_flags;
+
+        uint32_t m_blockCount;
+        uint32_t m_payloadSize;
+        uint32_t m_checksum;
+
+        // what has arrived of the header or block being read, when it did not arrive in one piece
+        std::vector<uint8_t> m_pending;
+        std::vector<Movement> m_block;
+
+        size_t GetStageSize() const;
+        PathCodec::Result Consume(const uint8_t* data);
+        PathCodec::Result DecodeBlock(const uint8_t* payload);
+    };
+}
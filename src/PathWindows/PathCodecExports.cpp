@@ -0,0 +1,233 @@
+#include "pch.h"
+#include "PathCodec.h"
+#include "CursorPath.h"
+#include "MappedFile.h"
+#include "PathWindow.h"
+#include "DrawablePathWindow.h"
+#include <climits>
+#include <cstring>
+#include <functional>
+#include <vector>
+
+using namespace PathWindows;
+
+static HRESULT ToHResult(PathCodec::Result result)
+{
+    switch (result)
+    {
+    case PathCodec::Result::OK: return S_OK;
+    case PathCodec::Result::UNSUPPORTED_VERSION: return HRESULT_FROM_WIN32(ERROR_NOT_SUPPORTED);
+    case PathCodec::Result::TRUNCATED: return HRESULT_FROM_WIN32(ERROR_HANDLE_EOF);
+    default: return HRESULT_FROM_WIN32(ERROR_INVALID_DATA);
+    }
+}
+
+// Positions are encoded as differences from each other if absolute is true, which suits paths already converted
+// to absolute positions, otherwise the movements are encoded as the deltas they are.
+extern "C" __declspec(dllexport) HRESULT __cdecl CreatePathEncoder(bool absolute, PathEncoder** ppEncoder)
+{
+    if (!ppEncoder) return E_POINTER;
+
+    *ppEncoder = new PathEncoder(absolute);
+
+    return S_OK;
+}
+
+extern "C" __declspec(dllexport) void __cdecl DestroyPathEncoder(PathEncoder* pEncoder)
+{
+    delete pEncoder;
+}
+
+// Can be called with a few movements at a time while recording. The encoded bytes become readable a block at a time,
+// or after FlushPathEncoder.
+extern "C" __declspec(dllexport) HRESULT __cdecl AppendToPathEncoder(PathEncoder* pEncoder, const MouseMovement* movements, int length)
+{
+    if (!pEncoder) return E_POINTER;
+    if (length < 0 || (length > 0 && !movements)) return E_INVALIDARG;
+
+    pEncoder->Append(reinterpret_cast<const Movement*>(movements), length);
+
+    return S_OK;
+}
+
+extern "C" __declspec(dllexport) HRESULT __cdecl FlushPathEncoder(PathEncoder* pEncoder)
+{
+    if (!pEncoder) return E_POINTER;
+
+    pEncoder->Flush();
+
+    return S_OK;
+}
+
+// Moves up to capacity encoded bytes into dst. Passing a capacity of 0 only returns how many are available in *pAvailable.
+extern "C" __declspec(dllexport) HRESULT __cdecl ReadPathEncoderOutput(PathEncoder* pEncoder, uint8_t* dst, int capacity, int* pCount, int* pAvailable)
+{
+    if (!pEncoder || !pCount || !pAvailable) return E_POINTER;
+    if (capacity < 0 || (capacity > 0 && !dst)) return E_INVALIDARG;
+
+    *pCount = static_cast<int>(pEncoder->ReadOutput(dst, capacity));
+    *pAvailable = static_cast<int>(pEncoder->GetOutputSize());
+
+    return S_OK;
+}
+
+extern "C" __declspec(dllexport) HRESULT __cdecl GetEncodedPathLength(const uint8_t* data, int size, int* pLength)
+{
+    if (!pLength) return E_POINTER;
+    if (size < 0 || (size > 0 && !data)) return E_INVALIDARG;
+
+    size_t count;
+    HRESULT hr = ToHResult(PathDecoder::CountMovements(data, size, count));
+    if (FAILED(hr)) return hr;
+
+    if (count > INT_MAX) return HRESULT_FROM_WIN32(ERROR_ARITHMETIC_OVERFLOW);
+
+    *pLength = static_cast<int>(count);
+    return S_OK;
+}
+
+// out needs room for GetEncodedPathLength movements.
+extern "C" __declspec(dllexport) HRESULT __cdecl DecodePath(const uint8_t* data, int size, MouseMovement* out, int capacity, int* pLength)
+{
+    if (!pLength) return E_POINTER;
+    if (size < 0 || (size > 0 && !data)) return E_INVALIDARG;
+    if (capacity < 0 || (capacity > 0 && !out)) return E_INVALIDARG;
+
+    size_t count = 0;
+    bool overflowed = false;
+
+    PathDecoder decoder;
+    HRESULT hr = ToHResult(decoder.Feed(data, size, [out, capacity, &count, &overflowed](const Movement* movements, size_t length)
+    {
+        if (overflowed || length > static_cast<size_t>(capacity) - count)
+        {
+            overflowed = true;
+            return;
+        }
+
+        std::memcpy(out + count, movements, length * sizeof(Movement));
+        count += length;
+    }));
+    if (SUCCEEDED(hr)) hr = ToHResult(decoder.Finish());
+    if (FAILED(hr)) return hr;
+
+    if (overflowed) return HRESULT_FROM_WIN32(ERROR_INSUFFICIENT_BUFFER);
+
+    *pLength = static_cast<int>(count);
+    return S_OK;
+}
+
+// Adds decoded blocks to a path window. Absolute paths are added as they are. The positions of relative paths are
+// worked out from start the same way ToAbsoluteCursorPath does, which needs the monitors and origin, see CursorPath::ToAbsolute.
+class PathWindowFeeder
+{
+public:
+    PathWindowFeeder(PathWindow* pPathWindow, const PathDecoder& decoder, MouseMovement start, const RECT* monitors, int monitorCount, POINT origin) :
+        m_pPathWindow(pPathWindow),
+        m_decoder(decoder),
+        m_monitors(reinterpret_cast<const RectI*>(monitors)),
+        m_monitorCount(monitorCount),
+        m_origin{ origin.x, origin.y },
+        m_last{ start.Delta.x, start.Delta.y },
+        m_first(true),
+        m_hr(S_OK)
+    {}
+
+    void operator()(const Movement* movements, size_t length)
+    {
+        if (FAILED(m_hr)) return;
+
+        const Movement* positions = movements;
+        size_t count = length;
+        // skips the position the relative path starts from, except for the very first block
+        size_t skip = 0;
+
+        if (!(m_decoder.GetFlags() & PathCodec::FLAG_ABSOLUTE))
+        {
+            if (m_monitorCount < 1 || !m_monitors)
+            {
+                m_hr = E_INVALIDARG;
+                return;
+            }
+
+            m_absolute.resize(length + 1);
+
+            CursorPath::Result result = CursorPath::ToAbsolute(Movement{ m_last, 0 }, movements, length, m_monitors, m_monitorCount, m_origin, m_absolute.data(), count);
+            if (result == CursorPath::Result::OFF_SCREEN)
+            {
+                m_hr = HRESULT_FROM_WIN32(ERROR_INVALID_DATA);
+                return;
+            }
+
+            positions = m_absolute.data();
+            skip = m_first ? 0 : 1;
+            m_last = PointI{ positions[count - 1].delta.x - m_origin.x, positions[count - 1].delta.y - m_origin.y };
+        }
+
+        m_first = false;
+        if (count <= skip) return;
+
+        m_hr = m_pPathWindow->EnqueueTimedBatch(positions + skip, static_cast<int>(count - skip), nullptr, 0);
+    }
+
+    HRESULT GetHR() const
+    {
+        return m_hr;
+    }
+
+private:
+    PathWindow* m_pPathWindow;
+    const PathDecoder& m_decoder;
+
+    const RectI* m_monitors;
+    int m_monitorCount;
+    PointI m_origin;
+
+    PointI m_last;
+    bool m_first;
+    HRESULT m_hr;
+
+    // reused for every block
+    std::vector<Movement> m_absolute;
+};
+
+// Adds an encoded path to the window a block at a time, without decoding all of it first, see PathWindowFeeder.
+// Each block is enqueued like AddTimedPathBatch does, so other threads can keep adding points meanwhile, their
+// points may end up between blocks.
+extern "C" __declspec(dllexport) HRESULT __cdecl AddEncodedPathToPath(PathWindow* pPathWindow, const uint8_t* data, int size, MouseMovement start, const RECT* monitors, int monitorCount, POINT origin)
+{
+    if (!pPathWindow) return E_POINTER;
+    if (size < 0 || (size > 0 && !data)) return E_INVALIDARG;
+
+    PathDecoder decoder;
+    PathWindowFeeder feeder(pPathWindow, decoder, start, monitors, monitorCount, origin);
+
+    PathCodec::Result result = decoder.Feed(data, size, std::ref(feeder));
+    if (FAILED(feeder.GetHR())) return feeder.GetHR();
+
+    if (result == PathCodec::Result::OK) result = decoder.Finish();
+    return ToHResult(result);
+}
+
+// Like AddEncodedPathToPath, for a path saved to a file. The file is mapped and decoded one view at a time, so only
+// about MAPPED_VIEW_SIZE bytes of it are in memory at once, however large it is.
+extern "C" __declspec(dllexport) HRESULT __cdecl AddPathFileToPath(PathWindow* pPathWindow, const wchar_t* fileName, MouseMovement start, const RECT* monitors, int monitorCount, POINT origin)
+{
+    constexpr size_t MAPPED_VIEW_SIZE = 4 << 20;
+
+    if (!pPathWindow || !fileName) return E_POINTER;
+
+    MappedFile file;
+    if (!file.Open(fileName)) return HRESULT_FROM_WIN32(file.GetError());
+
+    PathDecoder decoder;
+    PathWindowFeeder feeder(pPathWindow, decoder, start, monitors, monitorCount, origin);
+
+    PathCodec::Result result;
+    bool mapped = decoder.FeedFile(file, MAPPED_VIEW_SIZE, std::ref(feeder), [&feeder]() { return SUCCEEDED(feeder.GetHR()); }, result);
+
+    if (!mapped) return HRESULT_FROM_WIN32(file.GetError());
+    if (FAILED(feeder.GetHR())) return feeder.GetHR();
+
+    return ToHResult(result);
+}
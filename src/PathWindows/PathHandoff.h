@@ -0,0 +1,236 @@
+#pragma once
+#include "PathTypes.h"
+#include <cstddef>
+#include <cstdlib>
+#include <cstring>
+#include <mutex>
+#include <new>
+
+namespace PathWindows
+{
+    // Growable array of movements whose storage can be detached and handed to someone else without copying.
+    // Detached storage must be released with MovementBuffer::Release.
+    class MovementBuffer
+    {
+    public:
+        MovementBuffer() :
+            m_data(nullptr),
+            m_size(0),
+            m_capacity(0)
+        {}
+
+        ~MovementBuffer()
+        {
+            Release(m_data);
+        }
+
+        MovementBuffer(const MovementBuffer&) = delete;
+        MovementBuffer& operator=(const MovementBuffer&) = delete;
+
+        void Reserve(size_t capacity)
+        {
+            if (capacity <= m_capacity) return;
+
+            // movements are trivially copyable, so realloc can grow the block in place when there is room
+            Movement* data = static_cast<Movement*>(std::realloc(m_data, capacity * sizeof(Movement)));
+            if (!data) throw std::bad_alloc();
+
+            m_data = data;
+            m_capacity = capacity;
+        }
+
+        void PushBack(const Movement& movement)
+        {
+            if (m_size == m_capacity) Reserve(m_capacity < MIN_CAPACITY ? MIN_CAPACITY : m_capacity * 2);
+
+            m_data[m_size++] = movement;
+        }
+
+        // Keeps the capacity.
+        void Clear()
+        {
+            m_size = 0;
+        }
+
+        void Truncate(size_t size)
+        {
+            if (size < m_size) m_size = size;
+        }
+
+        // Gives up ownership of the storage, which then holds size movements. Returns nullptr if nothing was ever reserved.
+        Movement* Detach(size_t& size)
+        {
+            Movement* data = m_data;
+            size = m_size;
+
+            m_data = nullptr;
+            m_size = 0;
+            m_capacity = 0;
+
+            return data;
+        }
+
+        static void Release(Movement* data)
+        {
+            std::free(data);
+        }
+
+        const Movement* GetData() const
+        {
+            return m_data;
+        }
+
+        size_t GetSize() const
+        {
+            return m_size;
+        }
+
+        size_t GetCapacity() const
+        {
+            return m_capacity;
+        }
+
+    private:
+        static constexpr size_t MIN_CAPACITY = 64;
+
+        Movement* m_data;
+        size_t m_size;
+        size_t m_capacity;
+    };
+
+    // Collects a path as it is drawn on one thread, and hands it to another thread either stroke by stroke
+    // while drawing goes on, or all at once (without copying) when drawing is done.
+    class PathHandoff
+    {
+    public:
+        PathHandoff() :
+            m_finishedSize(0),
+            m_pulledSize(0),
+            m_cleared(false)
+        {}
+
+        void Reserve(size_t capacity)
+        {
+            std::lock_guard<std::mutex> lock(m_mutex);
+            m_buffer.Reserve(capacity);
+        }
+
+        void Append(const Movement& movement)
+        {
+            std::lock_guard<std::mutex> lock(m_mutex);
+            m_buffer.PushBack(movement);
+        }
+
+        // Makes everything appended so far available to PullFinished.
+        void FinishStroke()
+        {
+            std::lock_guard<std::mutex> lock(m_mutex);
+            m_finishedSize = m_buffer.GetSize();
+        }
+
+        // Treats everything appended so far as finished and already pulled, like a path the other thread handed in.
+        void MarkAllPulled()
+        {
+            std::lock_guard<std::mutex> lock(m_mutex);
+            m_finishedSize = m_buffer.GetSize();
+            m_pulledSize = m_finishedSize;
+        }
+
+        void Clear()
+        {
+            std::lock_guard<std::mutex> lock(m_mutex);
+            m_buffer.Clear();
+
+            // whatever was pulled before no longer belongs to the path, the next pull says so
+            m_cleared = m_pulledSize > 0 || m_cleared;
+            m_finishedSize = 0;
+            m_pulledSize = 0;
+        }
+
+        // Copies up to capacity movements of finished strokes that were not pulled yet into dst and returns how many.
+        // cleared is set if the path was cleared since the last pull, in which case everything pulled before is stale.
+        size_t PullFinished(Movement* dst, size_t capacity, bool& cleared)
+        {
+            std::lock_guard<std::mutex> lock(m_mutex);
+
+            cleared = m_cleared;
+            m_cleared = false;
+
+            size_t count = m_finishedSize - m_pulledSize;
+            if (count > capacity) count = capacity;
+
+            if (count > 0) std::memcpy(dst, m_buffer.GetData() + m_pulledSize, count * sizeof(Movement));
+            m_pulledSize += count;
+
+            return count;
+        }
+
+        // Calls fn(const Movement* path, size_t size) with the path, which must not be changed from inside fn.
+        template<class Fn>
+        void Visit(Fn&& fn)
+        {
+            std::lock_guard<std::mutex> lock(m_mutex);
+            fn(m_buffer.GetData(), m_buffer.GetSize());
+        }
+
+        // Replaces everything from index from on with count movements.
+        void ReplaceTail(size_t from, const Movement* movements, size_t count)
+        {
+            std::lock_guard<std::mutex> lock(m_mutex);
+            m_buffer.Truncate(from);
+            m_buffer.Reserve(from + count);
+            for (size_t i = 0; i < count; ++i) m_buffer.PushBack(movements[i]);
+
+            if (m_finishedSize > from) m_finishedSize = from;
+
+            // if some of the replaced movements were pulled already, the next pull starts over
+            if (m_pulledSize > from)
+            {
+                m_cleared = true;
+                m_pulledSize = 0;
+            }
+        }
+
+        // Replaces the whole path with count movements, which count as finished strokes.
+        void ReplaceAll(const Movement* movements, size_t count)
+        {
+            std::lock_guard<std::mutex> lock(m_mutex);
+            m_buffer.Clear();
+            m_buffer.Reserve(count);
+            for (size_t i = 0; i < count; ++i) m_buffer.PushBack(movements[i]);
+
+            // anything pulled before may be gone, the next pull starts over
+            m_cleared = m_pulledSize > 0 || m_cleared;
+            m_finishedSize = count;
+            m_pulledSize = 0;
+        }
+
+        // Hands over the whole path, see MovementBuffer::Detach. The handoff is empty afterwards.
+        Movement* Detach(size_t& size)
+        {
+            std::lock_guard<std::mutex> lock(m_mutex);
+
+            m_finishedSize = 0;
+            m_pulledSize = 0;
+            m_cleared = false;
+
+            return m_buffer.Detach(size);
+        }
+
+        size_t GetSize()
+        {
+            std::lock_guard<std::mutex> lock(m_mutex);
+            return m_buffer.GetSize();
+        }
+
+    private:
+        std::mutex m_mutex;
+        MovementBuffer m_buffer;
+
+        // the path up to here is made of finished strokes
+        size_t m_finishedSize;
+        // the path up to here was already pulled
+        size_t m_pulledSize;
+        bool m_cleared;
+    };
+}
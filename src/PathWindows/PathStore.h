@@ -0,0 +1,133 @@
+#pragma once
+#include "PathTypes.h"
+#include <vector>
+#include <algorithm>
+#include <iterator>
+#include <cstdint>
+#include <cstddef>
+
+namespace PathWindows
+{
+    // Contiguous view of the points of one figure.
+    struct FigureView
+    {
+        const PointF* points;
+        size_t count;
+    };
+
+    // Stores any number of figures in one flat point buffer plus the index each figure starts at, so appending
+    // never allocates per figure and clearing keeps the capacity for the next path.
+    // The points of a figure are contiguous, and laid out like D2D1_POINT_2F, so they can be handed to a
+    // geometry sink without copying.
+    class PathStore
+    {
+    public:
+        void Append(PointF point, bool newFigure)
+        {
+            if (newFigure || m_figureStarts.empty()) m_figureStarts.push_back(m_points.size());
+
+            m_points.push_back(point);
+        }
+
+        // Like calling Append for every point, with newFigure only for the first, but copies them in one go.
+        void AppendRange(const PointF* points, size_t count, bool newFigure)
+        {
+            if (count == 0) return;
+            if (newFigure || m_figureStarts.empty()) m_figureStarts.push_back(m_points.size());
+
+            m_points.insert(m_points.end(), points, points + count);
+        }
+
+        // Makes figures start at the points at indices (sorted, and none of them starting one already), which cuts the
+        // segments that ended there out of their figures. The points stay where they are.
+        void SplitFigures(const uint32_t* indices, size_t count)
+        {
+            m_mergedStarts.clear();
+            std::merge(m_figureStarts.begin(), m_figureStarts.end(), indices, indices + count, std::back_inserter(m_mergedStarts));
+            m_figureStarts.swap(m_mergedStarts);
+        }
+
+        // Joins the figures that start at the points at indices (sorted, none of them 0) to the figures before them,
+        // which puts back the segments that end there.
+        void JoinFigures(const uint32_t* indices, size_t count)
+        {
+            m_mergedStarts.clear();
+            std::set_difference(m_figureStarts.begin(), m_figureStarts.end(), indices, indices + count, std::back_inserter(m_mergedStarts));
+            m_figureStarts.swap(m_mergedStarts);
+        }
+
+        // Drops the points from index count on.
+        void Truncate(size_t count)
+        {
+            if (count >= m_points.size()) return;
+
+            m_points.resize(count);
+            m_figureStarts.erase(std::lower_bound(m_figureStarts.begin(), m_figureStarts.end(), count), m_figureStarts.end());
+        }
+
+        // Whether a figure starts at the point at index, in which case no segment ends there.
+        bool StartsFigure(size_t index) const
+        {
+            return std::binary_search(m_figureStarts.begin(), m_figureStarts.end(), index);
+        }
+
+        // The index of the figure the point at index is in.
+        size_t FindFigure(size_t index) const
+        {
+            return static_cast<size_t>(std::upper_bound(m_figureStarts.begin(), m_figureStarts.end(), index) - m_figureStarts.begin()) - 1;
+        }
+
+        void Reserve(size_t pointCount)
+        {
+            m_points.reserve(pointCount);
+        }
+
+        void Clear()
+        {
+            m_points.clear();
+            m_figureStarts.clear();
+        }
+
+        bool IsEmpty() const
+        {
+            return m_points.empty();
+        }
+
+        size_t GetPointCount() const
+        {
+            return m_points.size();
+        }
+
+        size_t GetFigureCount() const
+        {
+            return m_figureStarts.size();
+        }
+
+        size_t GetFigureStart(size_t figure) const
+        {
+            return m_figureStarts[figure];
+        }
+
+        size_t GetFigureEnd(size_t figure) const
+        {
+            return figure + 1 < m_figureStarts.size() ? m_figureStarts[figure + 1] : m_points.size();
+        }
+
+        FigureView GetFigure(size_t figure) const
+        {
+            size_t start = GetFigureStart(figure);
+            return FigureView{ m_points.data() + start, GetFigureEnd(figure) - start };
+        }
+
+        const PointF* GetPoints() const
+        {
+            return m_points.data();
+        }
+
+    private:
+        std::vector<PointF> m_points;
+        std::vector<size_t> m_figureStarts;
+        // reused by SplitFigures and JoinFigures
+        std::vector<size_t> m_mergedStarts;
+    };
+}
@@ -0,0 +1,168 @@
+#include "PathThumbnail.h"
+#include <algorithm>
+#include <cmath>
+
+using namespace PathWindows;
+
+namespace
+{
+    struct PointPath
+    {
+        const PointI* points;
+        size_t count;
+
+        PointI Get(size_t i) const { return points[i]; }
+        bool StartsFigure(size_t) const { return false; }
+    };
+
+    struct MovementPath
+    {
+        const Movement* movements;
+        size_t count;
+
+        PointI Get(size_t i) const { return movements[i].delta; }
+        bool StartsFigure(size_t i) const { return movements[i].delayDurationNS == 0; }
+    };
+}
+
+PathThumbnail::PathThumbnail(float strokeWidth, ColorF color) :
+    m_strokeWidth(strokeWidth),
+    m_color(color),
+    m_drawnCount(0)
+{}
+
+PathThumbnail::Transform PathThumbnail::Fit(PointF min, PointF max, int32_t width, int32_t height, float margin)
+{
+    // a path that does not move in one direction is centered in it
+    float extentX = std::max(max.x - min.x, 1.0f);
+    float extentY = std::max(max.y - min.y, 1.0f);
+    float availableX = std::max(static_cast<float>(width) - 2.0f * margin, 1.0f);
+    float availableY = std::max(static_cast<float>(height) - 2.0f * margin, 1.0f);
+
+    float scale = std::min(availableX / extentX, availableY / extentY);
+
+    return Transform{
+        scale,
+        PointF{ (static_cast<float>(width) - (max.x - min.x) * scale) / 2.0f - min.x * scale, (static_cast<float>(height) - (max.y - min.y) * scale) / 2.0f - min.y * scale }
+    };
+}
+
+void PathThumbnail::Render(const PointI* points, size_t count, uint32_t* pPixels, int32_t width, int32_t height)
+{
+    RenderPath(PointPath{ points, count }, pPixels, width, height);
+}
+
+void PathThumbnail::Render(const Movement* movements, size_t count, uint32_t* pPixels, int32_t width, int32_t height)
+{
+    RenderPath(MovementPath{ movements, count }, pPixels, width, height);
+}
+
+template<class Path>
+void PathThumbnail::RenderPath(const Path& path, uint32_t* pPixels, int32_t width, int32_t height)
+{
+    m_drawnCount = 0;
+
+    m_rasterizer.SetTarget(reinterpret_cast<uint8_t*>(pPixels), width, height, width * static_cast<int32_t>(sizeof(uint32_t)));
+    m_rasterizer.Clear(ColorF{ 0.0f, 0.0f, 0.0f, 0.0f });
+
+    m_visited.assign(static_cast<size_t>(std::max(width, 0)) * std::max(height, 0), 0);
+
+    if (path.count > 0 && width > 0 && height > 0)
+    {
+        PointI min = path.Get(0);
+        PointI max = min;
+        for (size_t i = 1; i < path.count; ++i)
+        {
+            PointI p = path.Get(i);
+            min.x = std::min(min.x, p.x);
+            min.y = std::min(min.y, p.y);
+            max.x = std::max(max.x, p.x);
+            max.y = std::max(max.y, p.y);
+        }
+
+        // antialiasing spills about a pixel past the edge of the stroke
+        Transform transform = Fit(
+            PointF{ static_cast<float>(min.x), static_cast<float>(min.y) },
+            PointF{ static_cast<float>(max.x), static_cast<float>(max.y) },
+            width, height, m_strokeWidth / 2.0f + 1.0f);
+
+        // the last skipped point, which is kept after all if the figure ends with it
+        PointF skipped{};
+        bool hasSkipped = false;
+
+        // the last kept point and the pixel it is in
+        PointF last{};
+        uint32_t lastPixel = 0;
+
+        // the fit keeps every point on the bitmap, the clamps only guard against rounding
+        float maxX = static_cast<float>(width - 1);
+        float maxY = static_cast<float>(height - 1);
+
+        // Most points of a long path are within a step of the last one kept, so they are only scaled and compared,
+        // the pixel a point is in is only worked out for the rest.
+        for (size_t i = 0; i < path.count; ++i)
+        {
+            PointI p = path.Get(i);
+            PointF point{ p.x * transform.scale + transform.offset.x, p.y * transform.scale + transform.offset.y };
+
+            if (i > 0 && path.StartsFigure(i))
+            {
+                if (hasSkipped) m_figure.push_back(skipped);
+                EndFigure();
+            }
+            else if (i > 0 && std::abs(point.x - last.x) < MIN_STEP && std::abs(point.y - last.y) < MIN_STEP)
+            {
+                skipped = point;
+                hasSkipped = true;
+                continue;
+            }
+
+            hasSkipped = false;
+
+            uint32_t pixel = static_cast<uint32_t>(std::clamp(point.y, 0.0f, maxY)) * static_cast<uint32_t>(width) + static_cast<uint32_t>(std::clamp(point.x, 0.0f, maxX));
+
+            if (!m_figure.empty())
+            {
+                // a short step between pixels that segments already passed through adds next to nothing, as a long
+                // path crosses the few pixels of a thumbnail over and over, so the polyline is broken there instead
+                if (std::abs(point.x - last.x) < 2.0f * MIN_STEP && std::abs(point.y - last.y) < 2.0f * MIN_STEP && m_visited[lastPixel] && m_visited[pixel])
+                {
+                    EndFigure();
+                }
+                else
+                {
+                    m_visited[lastPixel] = 1;
+                    m_visited[pixel] = 1;
+                }
+            }
+
+            m_figure.push_back(point);
+            last = point;
+            lastPixel = pixel;
+        }
+
+        if (hasSkipped) m_figure.push_back(skipped);
+        EndFigure();
+
+        m_rasterizer.FillStroke(m_color);
+    }
+
+    // the bitmap belongs to the caller
+    m_rasterizer.SetTarget(nullptr, 0, 0, 0);
+}
+
+void PathThumbnail::EndFigure()
+{
+    if (m_figure.size() > 1)
+    {
+        m_rasterizer.AddPolyline(m_figure.data(), m_figure.size(), m_strokeWidth);
+        m_drawnCount += m_figure.size();
+    }
+
+    m_figure.clear();
+}
+
+size_t PathThumbnail::GetDrawnCount() const
+{
+    return m_drawnCount;
+}
@@ -0,0 +1,62 @@
+#pragma once
+#include "PathTypes.h"
+#include "SoftwareRasterizer.h"
+#include <vector>
+#include <cstdint>
+#include <cstddef>
+
+namespace PathWindows
+{
+    // Draws a whole path scaled to fit a small bitmap on the CPU, e.g. to preview a recording without opening the overlay.
+    // Once scaled, points closer than MIN_STEP pixels to the last one kept are skipped, and so are short steps between
+    // pixels the path already passed through, so stroking a long path costs about as much as stroking a short one.
+    // What still grows with the length of the path are the pass to fit it and the one testing every point against the
+    // last one kept: 1M movements take about 10 ms at 64x64 and 13 ms at 128x128 on one core (see
+    // PathThumbnailBenchmarks for the budgets), at 256x256 stroking what is kept makes it about 40 ms.
+    class PathThumbnail
+    {
+    public:
+        // in pixels of the bitmap
+        static constexpr float MIN_STEP = 1.0f;
+
+        // Maps a path position p to p * scale + offset.
+        struct Transform
+        {
+            float scale;
+            PointF offset;
+        };
+
+        PathThumbnail(float strokeWidth, ColorF color);
+
+        // Fills pPixels (width * height premultiplied BGRA pixels, rows top to bottom without padding) with the path,
+        // and the rest with transparent pixels.
+        void Render(const PointI* points, size_t count, uint32_t* pPixels, int32_t width, int32_t height);
+        // A movement without a delay starts a new figure, like in the paths DrawablePathWindow takes.
+        void Render(const Movement* movements, size_t count, uint32_t* pPixels, int32_t width, int32_t height);
+
+        // How many points the last render drew, the rest were skipped.
+        size_t GetDrawnCount() const;
+
+        // Scales the box from min to max (both inclusive) as large as it fits into a width by height bitmap with margin
+        // pixels free on every side, keeping its aspect ratio, and centers it.
+        static Transform Fit(PointF min, PointF max, int32_t width, int32_t height, float margin);
+
+    private:
+        float m_strokeWidth;
+        ColorF m_color;
+
+        SoftwareRasterizer m_rasterizer;
+
+        // the pixels drawn segments start or end in
+        std::vector<uint8_t> m_visited;
+
+        // the kept points of the polyline being drawn
+        std::vector<PointF> m_figure;
+        size_t m_drawnCount;
+
+        template<class Path>
+        void RenderPath(const Path& path, uint32_t* pPixels, int32_t width, int32_t height);
+
+        void EndFigure();
+    };
+}
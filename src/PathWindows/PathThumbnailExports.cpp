@@ -0,0 +1,67 @@
+#include "pch.h"
+#include "PathThumbnail.h"
+#include "ThumbnailCache.h"
+#include "DrawablePathWindow.h"
+
+using namespace PathWindows;
+
+static constexpr int MAX_THUMBNAIL_SIZE = 1024;
+static constexpr size_t THUMBNAIL_CACHE_BYTES = 16 << 20;
+
+static constexpr float THUMBNAIL_STROKE_WIDTH = 1.5f;
+static constexpr ColorF THUMBNAIL_COLOR{ 1.0f, 0.0f, 0.0f, 0.9f };
+
+// tell apart points and movements in the cache
+static constexpr uint64_t POINTS_SEED = 1;
+static constexpr uint64_t MOVEMENTS_SEED = 2;
+
+static ThumbnailCache& GetThumbnailCache()
+{
+    static ThumbnailCache cache(THUMBNAIL_CACHE_BYTES);
+    return cache;
+}
+
+// Renders on the calling thread, without a window or a GPU.
+template<class T, class Path>
+static HRESULT RenderThumbnail(const T* path, int length, uint64_t seed, int width, int height, uint32_t* dst, bool* pCached)
+{
+    if (!dst) return E_POINTER;
+    if (length < 0 || (length > 0 && !path)) return E_INVALIDARG;
+    if (width < 1 || height < 1 || width > MAX_THUMBNAIL_SIZE || height > MAX_THUMBNAIL_SIZE) return E_INVALIDARG;
+
+    ThumbnailCache& cache = GetThumbnailCache();
+    ThumbnailCache::Key key = ThumbnailCache::MakeKey(path, length * sizeof(T), seed, width, height);
+
+    bool cached = cache.TryGet(key, dst);
+    if (!cached)
+    {
+        PathThumbnail thumbnail(THUMBNAIL_STROKE_WIDTH, THUMBNAIL_COLOR);
+        thumbnail.Render(reinterpret_cast<const Path*>(path), length, dst, width, height);
+
+        cache.Put(key, dst);
+    }
+
+    if (pCached) *pCached = cached;
+    return S_OK;
+}
+
+// Draws points (virtual screen positions, like CreatePathWindow takes) scaled to fit a width by height bitmap. dst needs
+// room for width * height premultiplied BGRA pixels, rows top to bottom without padding. The thumbnail is cached by the
+// contents of points, *pCached (can be nullptr) tells whether it was.
+extern "C" __declspec(dllexport) HRESULT __cdecl RenderPathThumbnail(const POINT* points, int length, int width, int height, uint32_t* dst, bool* pCached)
+{
+    return RenderThumbnail<POINT, PointI>(points, length, POINTS_SEED, width, height, dst, pCached);
+}
+
+// Like RenderPathThumbnail, for movements like CreateDrawablePathWindow takes, where a movement without a delay starts a new figure.
+extern "C" __declspec(dllexport) HRESULT __cdecl RenderMovementThumbnail(const MouseMovement* movements, int length, int width, int height, uint32_t* dst, bool* pCached)
+{
+    return RenderThumbnail<MouseMovement, Movement>(movements, length, MOVEMENTS_SEED, width, height, dst, pCached);
+}
+
+extern "C" __declspec(dllexport) HRESULT __cdecl ClearThumbnailCache()
+{
+    GetThumbnailCache().Clear();
+
+    return S_OK;
+}
@@ -0,0 +1,46 @@
+#pragma once
+#include <cstdint>
+
+// Plain types shared by the parts of PathWindows that do not depend on Windows headers.
+// They are layout compatible with their Win32/Direct2D counterparts (POINT, D2D1_POINT_2F, RECT, D2D1_COLOR_F),
+// and Movement with MouseMovement.
+
+namespace PathWindows
+{
+    struct PointI
+    {
+        int32_t x;
+        int32_t y;
+    };
+
+    struct PointF
+    {
+        float x;
+        float y;
+    };
+
+    // Right and bottom edges are exclusive, like a Win32 RECT.
+    struct RectI
+    {
+        int32_t left;
+        int32_t top;
+        int32_t right;
+        int32_t bottom;
+    };
+
+    // Straight (not premultiplied) alpha, every channel from 0 to 1.
+    struct ColorF
+    {
+        float r;
+        float g;
+        float b;
+        float a;
+    };
+
+    // A cursor position or delta, and how long to wait before moving to it.
+    struct Movement
+    {
+        PointI delta;
+        int64_t delayDurationNS;
+    };
+}
@@ -1,12 +1,16 @@
 #include "pch.h"
 #include "PathWindow.h"
+#include "D2DRenderBackend.h"
+#include "SoftwareRenderBackend.h"
+#include "PixelKernels.h"
+#include "Telemetry.h"
 #include <string>
-
-//#define MEASURE_RENDER
-#ifdef MEASURE_RENDER
+#include <thread>
+#include <algorithm>
 #include <chrono>
-#include <string>
-#endif
+#include <cstring>
+#include <cmath>
+#include <cfloat>
 
 #define HR(rval) {\
                      hr = rval;\
@@ -14,34 +18,74 @@
                  }
 
 using namespace PathWindows;
-using Microsoft::WRL::ComPtr;
 
-PathWindow::PathWindow(const std::function<void(HWND, UINT, WPARAM, LPARAM)>& onUnhandledMsg, bool clickable) :
+static_assert(sizeof(RectI) == sizeof(RECT), "RectI must be layout compatible with RECT.");
+
+static int64_t GetNowNS()
+{
+    return std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now().time_since_epoch()).count();
+}
+
+PathWindow::PathWindow(const std::function<void(HWND, UINT, WPARAM, LPARAM)>& onUnhandledMsg, bool clickable, bool erasable) :
     WND_WIDTH(GetSystemMetrics(SM_CXVIRTUALSCREEN)),
     WND_HEIGHT(GetSystemMetrics(SM_CYVIRTUALSCREEN)),
 
     CLICKABLE(clickable),
+    ERASABLE(erasable),
 
     m_info(WND_WIDTH, WND_HEIGHT),
+    m_dirty(),
+    m_tiles(WND_WIDTH, WND_HEIGHT, TILE_SIZE),
+    m_surfaceIsNew(true),
 
     m_hWnd(nullptr),
 
-    m_pD2Factory(nullptr),
-    m_pWICFactory(nullptr),
-    m_pStrokeStyle(nullptr),
+    m_pBackend(),
+    m_isSoftwareBackend(false),
+
+    m_strokeIndex(WND_WIDTH, WND_HEIGHT),
+    m_tailRect{},
+    m_tailShown(false),
+    m_tailChanged(false),
+    m_changedRects(),
+
+    m_trail(),
+    m_fadeBuckets(1),
+    m_trailChanged(false),
 
-    m_pRenderTarget(nullptr),
-    m_pInteropTarget(nullptr),
-    m_pPathBrush(nullptr),
+    m_pHeatmap(),
+
+    m_pColors(),
+
+    m_pReplay(),
+    m_replayClock(),
+    m_replayShown(0),
+    m_replayChanged(false),
+    m_markerRect{},
+    m_markerShown(false),
+
+    m_queue(QUEUE_CAPACITY),
+    m_drainPosted(false),
+
+    m_scheduler(),
+    m_maxFps(0),
+    m_refreshRate(0),
+    m_renderTimerSet(false),
+
+    // the points erased segments end at have to be the ones that were added
+    m_simplifier(erasable ? 0.0f : DEFAULT_SIMPLIFY_TOLERANCE),
 
     m_onUnhandledMsg(onUnhandledMsg)
 {}
 
 PathWindow::~PathWindow()
 {
-    SafeRelease(&m_pD2Factory);
-    SafeRelease(&m_pWICFactory);
-    SafeRelease(&m_pStrokeStyle);
+    // runs that were queued but never drained are freed with their commands
+    QueuedCommand command;
+    while (m_queue.TryPop(command))
+    {
+        if (command.type == QueuedCommand::ADD_RUN) delete command.pRun;
+    }
 
     DiscardDeviceResources();
 }
@@ -95,249 +139,1524 @@ HRESULT PathWindow::Initialize()
 
     SetWindowPos(m_hWnd, HWND_TOPMOST, primaryMonitorX - WND_WIDTH, primaryMonitorY - WND_HEIGHT, static_cast<int>(WND_WIDTH * dpi / 96.0f), static_cast<int>(WND_HEIGHT * dpi / 96.0f), 0);
     ShowWindow(m_hWnd, SW_SHOWNORMAL);
+
+    DEVMODE devMode{};
+    devMode.dmSize = sizeof(DEVMODE);
+    // 0 and 1 mean the hardware default refresh rate
+    if (EnumDisplaySettings(nullptr, ENUM_CURRENT_SETTINGS, &devMode) && devMode.dmDisplayFrequency > 1) m_refreshRate = devMode.dmDisplayFrequency;
+    UpdateFrameInterval();
+
     hr = Render();
+    m_scheduler.OnFrameRendered(GetNowNS());
 
     return hr;
 }
 
-HRESULT PathWindow::RunMessageLoop()
+void PathWindow::SetOnDestroyed(const std::function<void()>& onDestroyed)
+{
+    m_onDestroyed = onDestroyed;
+}
+
+HRESULT PathWindow::AddPoint(POINT point, bool render, bool newPath)
+{
+    AppendPoint(point, newPath);
+    Telemetry::Get().pointsIngested.Add(1);
+
+    if (render) return ScheduleRender();
+    return S_OK;
+}
+
+HRESULT PathWindow::AddPoints(POINT* points, int length)
 {
-    MSG msg{};
-    BOOL bRet;
-    while ((bRet = GetMessage(&msg, NULL, 0, 0)) != 0)
+    if (length < 1) return E_INVALIDARG;
+    if (!points) return E_INVALIDARG;
+
+    static_assert(sizeof(POINT) == 2 * sizeof(int32_t), "POINT must be two int32s.");
+
+    PointF converted[CONVERT_BATCH_SIZE];
+    for (int i = 0; i < length; i += static_cast<int>(CONVERT_BATCH_SIZE))
     {
-        if (bRet == -1)
-        {
-            return E_FAIL;
-        }
+        size_t count = std::min(static_cast<size_t>(length - i), CONVERT_BATCH_SIZE);
+        PixelKernels::ConvertPoints(reinterpret_cast<const int32_t*>(points + i), converted, count, PointF{ 0.0f, 0.0f });
 
-        //TranslateMessage(&msg);
-        DispatchMessage(&msg);
+        for (size_t j = 0; j < count; ++j) AppendPoint(converted[j], false);
     }
 
+    Telemetry::Get().pointsIngested.Add(length);
+
+    return ScheduleRender();
+}
+
+HRESULT PathWindow::ClearPoints(bool render)
+{
+    ClearPath();
+
+    if (render) return ScheduleRender();
     return S_OK;
 }
 
-inline std::vector<D2D1_POINT_2F>& PathWindow::GetLastPath()
+void PathWindow::ClearPath()
+{
+    m_simplifier.Reset();
+    m_strokes.Clear();
+    m_strokeIndex.Clear();
+    m_tailChanged = true;
+    m_changedRects.clear();
+    m_trail.Clear();
+    m_trailChanged = true;
+    if (m_pHeatmap) m_pHeatmap->Clear();
+    if (m_pColors) m_pColors->Clear();
+}
+
+HRESULT PathWindow::EraseSegments(const uint32_t* pointIndices, size_t count, bool render)
+{
+    return ChangeSegments(pointIndices, count, false, render);
+}
+
+HRESULT PathWindow::RestoreSegments(const uint32_t* pointIndices, size_t count, bool render)
 {
-    if (m_paths.size() == 0)
+    return ChangeSegments(pointIndices, count, true, render);
+}
+
+HRESULT PathWindow::ChangeSegments(const uint32_t* pointIndices, size_t count, bool restore, bool render)
+{
+    if (!ERASABLE) return HRESULT_FROM_WIN32(ERROR_NOT_SUPPORTED);
+    if (!pointIndices && count > 0) return E_POINTER;
+
+    const PathStore& store = m_strokes.GetStore();
+    const PointF* points = store.GetPoints();
+
+    // a segment ends at every point that does not start a figure, the ones that are already erased or there are skipped
+    m_restoreIds.clear();
+    for (size_t i = 0; i < count; ++i)
+    {
+        uint32_t id = pointIndices[i];
+        if (id == 0 || id >= store.GetPointCount()) return E_INVALIDARG;
+
+        if (store.StartsFigure(id) == restore) m_restoreIds.push_back(id);
+    }
+
+    std::sort(m_restoreIds.begin(), m_restoreIds.end());
+    m_restoreIds.erase(std::unique(m_restoreIds.begin(), m_restoreIds.end()), m_restoreIds.end());
+    if (m_restoreIds.empty()) return S_OK;
+
+    PointF min{ FLT_MAX, FLT_MAX };
+    PointF max{ -FLT_MAX, -FLT_MAX };
+
+    for (uint32_t id : m_restoreIds)
     {
-        m_paths.push_back(std::vector<D2D1_POINT_2F> {});
-        return m_paths[0];
+        PointF a = points[id - 1];
+        PointF b = points[id];
+
+        if (restore) m_strokeIndex.Insert(id, a, b);
+        else m_strokeIndex.Remove(id, a, b);
+
+        min = PointF{ (std::min)({ min.x, a.x, b.x }), (std::min)({ min.y, a.y, b.y }) };
+        max = PointF{ (std::max)({ max.x, a.x, b.x }), (std::max)({ max.y, a.y, b.y }) };
     }
 
-    return m_paths[m_paths.size() - 1];
+    if (restore) m_strokes.Join(m_restoreIds.data(), m_restoreIds.size());
+    else m_strokes.Split(m_restoreIds.data(), m_restoreIds.size());
+
+    MarkChanged(min, max);
+
+    if (render) return ScheduleRender();
+    return S_OK;
 }
 
-HRESULT PathWindow::AddPoint(POINT point, bool render, bool newPath)
+HRESULT PathWindow::DropPointsFrom(size_t index, bool render)
 {
-    D2D1_POINT_2F d2Point = D2D1::Point2F(static_cast<float>(point.x), static_cast<float>(point.y));
+    if (!ERASABLE) return HRESULT_FROM_WIN32(ERROR_NOT_SUPPORTED);
 
-    if (newPath)
+    const PathStore& store = m_strokes.GetStore();
+    const PointF* points = store.GetPoints();
+    if (index >= store.GetPointCount()) return S_OK;
+
+    PointF min{ FLT_MAX, FLT_MAX };
+    PointF max{ -FLT_MAX, -FLT_MAX };
+
+    for (size_t id = (std::max)(index, static_cast<size_t>(1)); id < store.GetPointCount(); ++id)
     {
-        m_paths.push_back(std::vector<D2D1_POINT_2F> { d2Point });
+        if (store.StartsFigure(id)) continue;
+
+        PointF a = points[id - 1];
+        PointF b = points[id];
+        m_strokeIndex.Remove(static_cast<uint32_t>(id), a, b);
+
+        min = PointF{ (std::min)({ min.x, a.x, b.x }), (std::min)({ min.y, a.y, b.y }) };
+        max = PointF{ (std::max)({ max.x, a.x, b.x }), (std::max)({ max.y, a.y, b.y }) };
     }
-    else
+
+    m_strokes.Truncate(index);
+
+    if (min.x <= max.x) MarkChanged(min, max);
+
+    if (render) return ScheduleRender();
+    return S_OK;
+}
+
+void PathWindow::MarkChanged(PointF min, PointF max)
+{
+    // antialiasing spills about a pixel past the edge of the stroke
+    constexpr float reach = STROKE_WIDTH / 2.0f + 1.0f;
+
+    m_changedRects.push_back(RectI{
+        static_cast<int32_t>(std::floor(min.x - reach)),
+        static_cast<int32_t>(std::floor(min.y - reach)),
+        static_cast<int32_t>(std::ceil(max.x + reach)),
+        static_cast<int32_t>(std::ceil(max.y + reach))
+    });
+}
+
+HRESULT PathWindow::SetSimplifyTolerance(float tolerance)
+{
+    if (!m_hWnd) return E_HANDLE;
+    if (ERASABLE) return HRESULT_FROM_WIN32(ERROR_NOT_SUPPORTED);
+
+    static_assert(sizeof(float) <= sizeof(WPARAM), "A float must fit in a WPARAM.");
+    WPARAM wParam = 0;
+    memcpy(&wParam, &tolerance, sizeof(float));
+
+    if (PostMessage(m_hWnd, WM_SETTOLERANCE, wParam, 0) == 0) return HRESULT_FROM_WIN32(GetLastError());
+
+    return S_OK;
+}
+
+HRESULT PathWindow::SetTrail(int maxPoints, int maxAgeMS, int fadeBuckets)
+{
+    if (!m_hWnd) return E_HANDLE;
+    if (maxPoints < 0 || maxAgeMS < 0 || fadeBuckets < 1 || fadeBuckets > MAX_FADE_BUCKETS) return E_INVALIDARG;
+
+    // does not fit in the message parameters, the window thread takes it when it handles the message
+    TrailOptions* pOptions = m_postedTrails.Add(std::make_unique<TrailOptions>(TrailOptions{ static_cast<size_t>(maxPoints), maxAgeMS * 1'000'000LL, static_cast<size_t>(fadeBuckets) }));
+
+    if (PostMessage(m_hWnd, WM_SETTRAIL, 0, reinterpret_cast<LPARAM>(pOptions)) == 0)
     {
-        GetLastPath().push_back(d2Point);
+        HRESULT hr = HRESULT_FROM_WIN32(GetLastError());
+        m_postedTrails.Take(pOptions);
+        return hr;
     }
 
-    if (render) return Render();
     return S_OK;
 }
 
-HRESULT PathWindow::AddPoints(POINT* points, int length)
+HRESULT PathWindow::SetHeatmap(bool enabled)
 {
-    if (length < 1) return E_INVALIDARG;
-    if (!points) return E_INVALIDARG;
+    if (!m_hWnd) return E_HANDLE;
+
+    if (PostMessage(m_hWnd, WM_SETHEATMAP, enabled ? 1 : 0, 0) == 0) return HRESULT_FROM_WIN32(GetLastError());
+
+    return S_OK;
+}
+
+HRESULT PathWindow::SetColoring(Coloring coloring, int bucketCount)
+{
+    if (!m_hWnd) return E_HANDLE;
+    if (coloring < Coloring::NONE || coloring > Coloring::ELAPSED_TIME) return E_INVALIDARG;
+    if (coloring != Coloring::NONE && (bucketCount < 1 || bucketCount > MAX_COLOR_BUCKETS)) return E_INVALIDARG;
+
+    if (PostMessage(m_hWnd, WM_SETCOLORING, static_cast<WPARAM>(coloring), static_cast<LPARAM>(bucketCount)) == 0) return HRESULT_FROM_WIN32(GetLastError());
 
-    for (int i = 0; i < length; ++i)
+    return S_OK;
+}
+
+HRESULT PathWindow::StartReplay(const Movement* movements, int length, float speed, bool showTrail)
+{
+    if (!m_hWnd) return E_HANDLE;
+    if (!movements || length < 1) return E_INVALIDARG;
+    if (!(speed >= MIN_REPLAY_SPEED && speed <= MAX_REPLAY_SPEED)) return E_INVALIDARG;
+
+    // indexed on this thread, so the window thread keeps rendering the other windows in the meantime
+    auto pReplay = std::make_unique<Replay>(Replay{ ReplayTimeline(), SegmentIndex(WND_WIDTH, WND_HEIGHT), speed, showTrail });
+
+    ReplayTimeline& timeline = pReplay->timeline;
+    timeline.Assign(movements, static_cast<size_t>(length));
+
+    for (size_t i = 1; i < timeline.GetCount(); ++i)
+    {
+        if (timeline.StartsFigure(i)) continue;
+
+        PointI a = timeline.GetPosition(i - 1);
+        PointI b = timeline.GetPosition(i);
+        pReplay->segments.Insert(static_cast<uint32_t>(i), PointF{ static_cast<float>(a.x), static_cast<float>(a.y) }, PointF{ static_cast<float>(b.x), static_cast<float>(b.y) });
+    }
+
+    // the window thread takes it when it handles the message
+    Replay* pPosted = m_postedReplays.Add(std::move(pReplay));
+
+    if (PostMessage(m_hWnd, WM_STARTREPLAY, 0, reinterpret_cast<LPARAM>(pPosted)) == 0)
     {
-        POINT point = points[i];
-        GetLastPath().push_back(D2D1::Point2F(static_cast<float>(point.x), static_cast<float>(point.y)));
+        HRESULT hr = HRESULT_FROM_WIN32(GetLastError());
+        m_postedReplays.Take(pPosted);
+        return hr;
     }
 
-    return Render();
+    return S_OK;
 }
 
-HRESULT PathWindow::ClearPoints()
+HRESULT PathWindow::StopReplay()
 {
-    m_paths.clear();
+    if (!m_hWnd) return E_HANDLE;
+
+    if (PostMessage(m_hWnd, WM_STARTREPLAY, 0, 0) == 0) return HRESULT_FROM_WIN32(GetLastError());
 
-    return Render();
+    return S_OK;
 }
 
-HRESULT PathWindow::CreateDeviceIndependentResources()
+HRESULT PathWindow::SetReplaySpeed(float speed)
 {
-    HRESULT hr = S_OK;
+    if (!m_hWnd) return E_HANDLE;
+    if (!(speed >= MIN_REPLAY_SPEED && speed <= MAX_REPLAY_SPEED)) return E_INVALIDARG;
 
-    HR(D2D1CreateFactory(D2D1_FACTORY_TYPE_SINGLE_THREADED, &m_pD2Factory));
-    HR(CoCreateInstance(CLSID_WICImagingFactory, NULL, CLSCTX_INPROC_SERVER, IID_PPV_ARGS(&m_pWICFactory)));
-    HR(m_pD2Factory->CreateStrokeStyle(D2D1::StrokeStyleProperties(D2D1_CAP_STYLE_FLAT, D2D1_CAP_STYLE_FLAT, D2D1_CAP_STYLE_FLAT, D2D1_LINE_JOIN_ROUND), nullptr, 0, &m_pStrokeStyle));
+    WPARAM wParam = 0;
+    memcpy(&wParam, &speed, sizeof(float));
 
-    return hr;
+    if (PostMessage(m_hWnd, WM_SETREPLAYSPEED, wParam, 0) == 0) return HRESULT_FROM_WIN32(GetLastError());
+
+    return S_OK;
 }
 
-HRESULT PathWindow::CreateDeviceResources()
+HRESULT PathWindow::SetReplayPaused(bool paused)
 {
-    HRESULT hr = S_OK;
+    if (!m_hWnd) return E_HANDLE;
 
-    if (m_pRenderTarget) return hr;
+    if (PostMessage(m_hWnd, WM_PAUSEREPLAY, paused ? 1 : 0, 0) == 0) return HRESULT_FROM_WIN32(GetLastError());
 
-    RECT rc{};
-    GetClientRect(m_hWnd, &rc);
-    auto width = rc.right - rc.left;
-    auto height = rc.bottom - rc.top;
+    return S_OK;
+}
 
-    ComPtr<IWICBitmap> pBitmap;
-    HR(m_pWICFactory->CreateBitmap(width, height, GUID_WICPixelFormat32bppPBGRA, WICBitmapCacheOnLoad, pBitmap.GetAddressOf()));
+HRESULT PathWindow::SeekReplay(int timeMS)
+{
+    if (!m_hWnd) return E_HANDLE;
+    if (timeMS < 0) return E_INVALIDARG;
 
-    D2D1_RENDER_TARGET_PROPERTIES renderTargetProps{};
-    renderTargetProps.type = D2D1_RENDER_TARGET_TYPE_DEFAULT;
-    renderTargetProps.pixelFormat = D2D1::PixelFormat(DXGI_FORMAT_B8G8R8A8_UNORM, D2D1_ALPHA_MODE_PREMULTIPLIED);
-    renderTargetProps.dpiX = 0.0f;
-    renderTargetProps.dpiY = 0.0f;
-    renderTargetProps.usage = D2D1_RENDER_TARGET_USAGE_GDI_COMPATIBLE;
-    renderTargetProps.minLevel = D2D1_FEATURE_LEVEL_DEFAULT;
+    if (PostMessage(m_hWnd, WM_SEEKREPLAY, static_cast<WPARAM>(timeMS), 0) == 0) return HRESULT_FROM_WIN32(GetLastError());
 
-    HR(m_pD2Factory->CreateWicBitmapRenderTarget(pBitmap.Get(), renderTargetProps, &m_pRenderTarget));
+    return S_OK;
+}
 
-    m_pRenderTarget->SetAntialiasMode(D2D1_ANTIALIAS_MODE_PER_PRIMITIVE);
+bool PathWindow::IsTrailMode() const
+{
+    return m_trail.GetMaxPoints() > 0;
+}
 
-    HR(m_pRenderTarget->CreateSolidColorBrush(D2D1::ColorF(D2D1::ColorF::Red, 0.7f), &m_pPathBrush));
+void PathWindow::ApplyTrail(const TrailOptions& options)
+{
+    ClearPath();
 
-    hr = m_pRenderTarget->QueryInterface(&m_pInteropTarget);
+    m_trail.Configure(options.maxPoints, options.maxAgeNS);
+    m_fadeBuckets = options.fadeBuckets;
+    if (options.maxPoints > 0)
+    {
+        m_pHeatmap.reset();
+        m_pColors.reset();
+    }
 
-    return hr;
+    ScheduleRender();
 }
 
-void PathWindow::DiscardDeviceResources()
+bool PathWindow::IsHeatmapMode() const
 {
-    SafeRelease(&m_pRenderTarget);
-    SafeRelease(&m_pInteropTarget);
-    SafeRelease(&m_pPathBrush);
+    return m_pHeatmap != nullptr;
 }
 
-HRESULT PathWindow::Render()
+void PathWindow::ApplyHeatmap(bool enabled)
 {
-#ifdef MEASURE_RENDER
-    std::chrono::steady_clock::time_point begin = std::chrono::steady_clock::now();
-#endif
+    ClearPath();
 
-    HRESULT hr = S_OK;
+    if (enabled)
+    {
+        m_trail.Configure(0, 0);
+        m_pColors.reset();
+        if (!m_pHeatmap) m_pHeatmap = std::make_unique<HeatmapGrid>(WND_WIDTH, WND_HEIGHT, HEATMAP_CELL_SIZE, GetClearColor());
+    }
+    else
+    {
+        m_pHeatmap.reset();
+        m_heatmapPixels = std::vector<uint32_t>();
+    }
 
-    HR(CreateDeviceResources());
+    ScheduleRender();
+}
 
-    m_pRenderTarget->BeginDraw();
-    m_pRenderTarget->SetTransform(D2D1::Matrix3x2F::Identity());
-    m_pRenderTarget->Clear(CLICKABLE ? D2D1::ColorF(0.0f, 0.0f, 0.0f, 0.1f) : D2D1::ColorF(0.0f, 0.0f, 0.0f, 0.0f));
+bool PathWindow::IsColorMode() const
+{
+    return m_pColors != nullptr;
+}
 
-    //D2D1_SIZE_F rtSize = m_pRenderTarget->GetSize();
+void PathWindow::ApplyColoring(Coloring coloring, size_t bucketCount)
+{
+    ClearPath();
 
-    if (m_paths.size() > 0)
+    if (coloring == Coloring::NONE)
+    {
+        m_pColors.reset();
+    }
+    else
     {
-#ifdef MEASURE_RENDER
-        std::chrono::steady_clock::time_point beginRender = std::chrono::steady_clock::now();
-#endif
+        m_trail.Configure(0, 0);
+        m_pHeatmap.reset();
+        m_heatmapPixels = std::vector<uint32_t>();
 
-        ComPtr<ID2D1PathGeometry> pGeometry;
-        HR(m_pD2Factory->CreatePathGeometry(pGeometry.GetAddressOf()));
+        ColorBuckets::Scale scale = coloring == Coloring::SPEED ? ColorBuckets::Scale::SPEED : ColorBuckets::Scale::ELAPSED_TIME;
+        m_pColors = std::make_unique<ColorBuckets>(scale, bucketCount);
+    }
 
-        ComPtr<ID2D1GeometrySink> pSink;
-        HR(pGeometry->Open(pSink.GetAddressOf()));
+    ScheduleRender();
+}
 
-        for (auto&& path : m_paths)
-        {
-            if (path.size() <= 1) continue;
+bool PathWindow::IsReplayMode() const
+{
+    return m_pReplay != nullptr;
+}
 
-            pSink->BeginFigure(D2D1::Point2F(static_cast<float>(path[0].x), static_cast<float>(path[0].y)), D2D1_FIGURE_BEGIN_HOLLOW);
-            pSink->AddLines(&path[1], static_cast<UINT32>(path.size() - 1));
-            pSink->EndFigure(D2D1_FIGURE_END_OPEN);
-        }
+void PathWindow::ApplyReplay(std::unique_ptr<Replay> pReplay)
+{
+    m_pReplay = std::move(pReplay);
+    m_replayShown = 0;
+    m_replayChanged = true;
+    m_markerShown = false;
+
+    if (m_pReplay)
+    {
+        int64_t now = GetNowNS();
+
+        m_replayClock = ReplayClock();
+        m_replayClock.SetSpeed(m_pReplay->speed, now);
+        m_replayClock.Play(now);
+    }
+    else
+    {
+        // whatever was added during the replay has not been drawn, and the replay has to be cleared
+        m_strokes.Invalidate();
+        m_trailChanged = true;
+        if (m_pHeatmap) m_pHeatmap->Invalidate();
+        if (m_pColors) m_pColors->Invalidate();
+
+        m_restoreIds = std::vector<uint32_t>();
+        m_restorePoints = std::vector<PointF>();
+    }
 
-        HR(pSink->Close());
+    ScheduleRender();
+}
 
-        m_pRenderTarget->DrawGeometry(pGeometry.Get(), m_pPathBrush, 3.0f, m_pStrokeStyle);
+void PathWindow::ApplyReplaySpeed(float speed)
+{
+    if (!IsReplayMode()) return;
 
-        //for (int i = 1; i < m_points.size(); ++i)
-        //{
-        //    m_pRenderTarget->DrawLine(m_points[i - 1], m_points[i], m_pPathBrush, 3.0f, m_pStrokeStyle);
-        //}
+    m_pReplay->speed = speed;
+    m_replayClock.SetSpeed(speed, GetNowNS());
+}
 
-#ifdef MEASURE_RENDER
-        std::chrono::steady_clock::time_point endRender = std::chrono::steady_clock::now();
-        OutputDebugString(L"Geometry: ");
-        OutputDebugString(std::to_wstring(std::chrono::duration_cast<std::chrono::milliseconds>(endRender - beginRender).count()).c_str());
-        OutputDebugString(L"ms\n");
-#endif
-    }
+void PathWindow::ApplyReplayPaused(bool paused)
+{
+    if (!IsReplayMode()) return;
 
+    int64_t now = GetNowNS();
+
+    if (paused)
     {
-#ifdef MEASURE_RENDER
-        std::chrono::steady_clock::time_point beginDC = std::chrono::steady_clock::now();
-#endif
+        m_replayClock.Pause(now);
+        return;
+    }
+
+    if (m_replayShown == m_pReplay->timeline.GetCount()) m_replayClock.Seek(0, now);
+    m_replayClock.Play(now);
+
+    ScheduleRender();
+}
 
-        HDC dc;
-        HR(m_pInteropTarget->GetDC(D2D1_DC_INITIALIZE_MODE_COPY, &dc));
+void PathWindow::ApplyReplaySeek(int64_t timeNS)
+{
+    if (!IsReplayMode()) return;
 
-        hr = m_info.Update(m_hWnd, dc);
+    m_replayClock.Seek(timeNS, GetNowNS());
 
-        RECT r{};
-        m_pInteropTarget->ReleaseDC(&r);
+    ScheduleRender();
+}
 
-        if (FAILED(hr)) return hr;
+ColorF PathWindow::GetClearColor() const
+{
+    return CLICKABLE ? ColorF{ 0.0f, 0.0f, 0.0f, 0.1f } : ColorF{ 0.0f, 0.0f, 0.0f, 0.0f };
+}
+
+void PathWindow::AppendPoint(POINT point, bool newPath, int64_t delayNS)
+{
+    AppendPoint(PointF{ static_cast<float>(point.x), static_cast<float>(point.y) }, newPath, delayNS);
+}
 
-#ifdef MEASURE_RENDER
-        std::chrono::steady_clock::time_point endDC = std::chrono::steady_clock::now();
-        OutputDebugString(L"DC: ");
-        OutputDebugString(std::to_wstring(std::chrono::duration_cast<std::chrono::milliseconds>(endDC - beginDC).count()).c_str());
-        OutputDebugString(L"ms\n");
-#endif
+void PathWindow::AppendPoint(PointF point, bool newPath, int64_t delayNS)
+{
+    // the simplifier would merge segments of different speeds, and with them the colors that show them
+    if (IsColorMode())
+    {
+        m_pColors->Append(point, delayNS, newPath);
+        return;
     }
 
-    hr = m_pRenderTarget->EndDraw();
-    if (hr == D2DERR_RECREATE_TARGET)
+    // a heatmap only counts the cells the path passes through, which fewer points would not make any cheaper
+    if (IsHeatmapMode())
     {
-        DiscardDeviceResources();
-        hr = S_OK;
+        m_pHeatmap->Append(point, newPath);
+        return;
     }
 
-#ifdef MEASURE_RENDER
-    std::chrono::steady_clock::time_point end = std::chrono::steady_clock::now();
-    OutputDebugString(L"All: ");
-    OutputDebugString(std::to_wstring(std::chrono::duration_cast<std::chrono::milliseconds>(end - begin).count()).c_str());
-    OutputDebugString(L"ms\n\n");
-#endif
+    // after a reset the simplifier emits the point it is given right away, so that is the one that starts the new figure
+    if (newPath)
+    {
+        FlushSimplifier();
+        m_simplifier.Reset();
+    }
 
-    return hr;
+    m_simplifier.Add(point, [this, newPath](PointF p)
+    {
+        StorePoint(p, newPath);
+    });
+
+    // the run the simplifier holds back is drawn as a tail that is not stored, see DrawTail
+    if (IsTrailMode()) m_trailChanged = true;
+    else m_tailChanged = true;
 }
 
-LRESULT CALLBACK PathWindow::WndProc(HWND hWnd, UINT message, WPARAM wParam, LPARAM lParam)
+void PathWindow::AppendRun(const PathBatch::Run& run)
 {
-    if (message == WM_CREATE)
+    const PointF* points = run.points.data();
+    const int64_t* delays = run.delaysNS.empty() ? nullptr : run.delaysNS.data();
+
+    // without simplifying every point is stored as it is, unless the path is colored, a heatmap or a trail
+    bool storedAsIs = m_simplifier.GetTolerance() <= 0.0f && !IsColorMode() && !IsHeatmapMode() && !IsTrailMode();
+
+    PathBatch::ForEachRun(run.points.size(), run.figureStarts.data(), run.figureStarts.size(), [this, points, delays, storedAsIs](size_t first, size_t count, bool newFigure)
     {
-        auto pcs = (LPCREATESTRUCT)lParam;
-        auto pPathWindow = (PathWindow*)pcs->lpCreateParams;
+        if (storedAsIs)
+        {
+            StoreRun(points + first, count, newFigure);
+            return;
+        }
 
-        SetWindowLongPtr(hWnd, GWLP_USERDATA, reinterpret_cast<LONG_PTR>(pPathWindow));
+        for (size_t i = 0; i < count; ++i) AppendPoint(points[first + i], newFigure && i == 0, delays ? delays[first + i] : 0);
+    });
+}
 
-        return 1;
+void PathWindow::StoreRun(const PointF* points, size_t count, bool newFigure)
+{
+    // whatever the simplifier held back from before its tolerance was turned off goes first, and the point after the
+    // run starts afresh, which at a tolerance of 0 is what Add does anyway
+    FlushSimplifier();
+    m_simplifier.Reset();
+
+    const PathStore& store = m_strokes.GetStore();
+    size_t first = store.GetPointCount();
+    // the first point only ends a segment if it continues the last figure
+    size_t firstSegment = !newFigure && first > 0 ? first : first + 1;
+
+    m_strokes.AppendRange(points, count, newFigure);
+    m_tailChanged = true;
+
+    if (!IsStrokeIndexed()) return;
+
+    const PointF* stored = store.GetPoints();
+    for (size_t i = firstSegment; i < first + count; ++i) m_strokeIndex.Insert(static_cast<uint32_t>(i), stored[i - 1], stored[i]);
+}
+
+void PathWindow::FlushSimplifier()
+{
+    m_simplifier.Flush([this](PointF p) { StorePoint(p, false); });
+}
+
+void PathWindow::StorePoint(PointF point, bool newFigure)
+{
+    if (IsTrailMode())
+    {
+        m_trail.Append(point, newFigure, GetNowNS());
+        m_trailChanged = true;
+        return;
     }
 
-    auto pPathWindow = reinterpret_cast<PathWindow*>(static_cast<LONG_PTR>(GetWindowLongPtr(hWnd, GWLP_USERDATA)));
+    const PathStore& store = m_strokes.GetStore();
+    bool continues = !newFigure && store.GetPointCount() > 0;
 
-    if (pPathWindow)
+    m_strokes.Append(point, newFigure);
+
+    if (continues && IsStrokeIndexed())
     {
-        switch (message)
+        size_t id = store.GetPointCount() - 1;
+        m_strokeIndex.Insert(static_cast<uint32_t>(id), store.GetPoints()[id - 1], point);
+    }
+}
+
+bool PathWindow::IsStrokeIndexed() const
+{
+    // without simplifying there is never a tail to restore
+    return ERASABLE || m_simplifier.GetTolerance() > 0.0f;
+}
+
+void PathWindow::IndexStrokes()
+{
+    m_strokeIndex.Clear();
+    if (!IsStrokeIndexed()) return;
+
+    const PathStore& store = m_strokes.GetStore();
+    const PointF* points = store.GetPoints();
+    for (size_t figure = 0; figure < store.GetFigureCount(); ++figure)
+    {
+        for (size_t i = store.GetFigureStart(figure) + 1; i < store.GetFigureEnd(figure); ++i)
         {
-        case WM_SIZE:
-            return 0;
+            m_strokeIndex.Insert(static_cast<uint32_t>(i), points[i - 1], points[i]);
+        }
+    }
+}
 
-        case WM_DISPLAYCHANGE:
-            PostQuitMessage(1);
-            return 0;
+HRESULT PathWindow::EnqueuePoint(POINT point, bool render)
+{
+    QueuedCommand command{ QueuedCommand::ADD_POINT, point };
 
-        case WM_PAINT:
+    std::lock_guard<std::mutex> lock(m_producerMutex);
+    HRESULT hr = PushCommands(&command, 1);
+    if (FAILED(hr)) return hr;
+
+    if (render) return PostDrain();
+    return S_OK;
+}
+
+HRESULT PathWindow::EnqueuePoints(const POINT* points, int length)
+{
+    return EnqueueBatch(points, length, nullptr, 0);
+}
+
+HRESULT PathWindow::EnqueueBatch(const POINT* points, int length, const int32_t* figureStarts, int figureCount)
+{
+    if (!points) return E_INVALIDARG;
+    if (length < 1) return E_INVALIDARG;
+    if (figureCount < 0 || !PathBatch::IsValid(length, figureStarts, figureCount)) return E_INVALIDARG;
+
+    // a long batch is converted here, off the window thread, and queued as one command, a short one is not worth
+    // allocating for
+    if (static_cast<size_t>(length) >= MIN_RUN_LENGTH)
+    {
+        return EnqueueRun(PathBatch::MakeRun(reinterpret_cast<const int32_t*>(points), length, figureStarts, figureCount));
+    }
+
+    return EnqueueRuns(length, figureStarts, figureCount, [points](size_t i)
+    {
+        return QueuedCommand{ QueuedCommand::ADD_POINT, points[i], 0 };
+    });
+}
+
+HRESULT PathWindow::EnqueueTimedBatch(const Movement* movements, int length, const int32_t* figureStarts, int figureCount)
+{
+    if (!movements) return E_INVALIDARG;
+    if (length < 1) return E_INVALIDARG;
+    if (figureCount < 0 || !PathBatch::IsValid(length, figureStarts, figureCount)) return E_INVALIDARG;
+
+    static_assert(sizeof(PointI) == sizeof(POINT), "PointI must be layout compatible with POINT.");
+
+    if (static_cast<size_t>(length) >= MIN_RUN_LENGTH) return EnqueueRun(PathBatch::MakeTimedRun(movements, length, figureStarts, figureCount));
+
+    return EnqueueRuns(length, figureStarts, figureCount, [movements](size_t i)
+    {
+        return QueuedCommand{ QueuedCommand::ADD_POINT, POINT{ movements[i].delta.x, movements[i].delta.y }, movements[i].delayDurationNS };
+    });
+}
+
+// makeCommand(size_t i) returns the command that adds the i-th point. The batch has to be valid.
+template<class MakeCommand>
+HRESULT PathWindow::EnqueueRuns(int length, const int32_t* figureStarts, int figureCount, MakeCommand&& makeCommand)
+{
+    QueuedCommand batch[DRAIN_BATCH_SIZE];
+
+    std::lock_guard<std::mutex> lock(m_producerMutex);
+    HRESULT hr = S_OK;
+    PathBatch::ForEachRun(length, figureStarts, figureCount, [this, &makeCommand, &batch, &hr](size_t first, size_t count, bool newFigure)
+    {
+        for (size_t i = 0; i < count && SUCCEEDED(hr); i += DRAIN_BATCH_SIZE)
+        {
+            size_t chunk = std::min(count - i, DRAIN_BATCH_SIZE);
+            for (size_t j = 0; j < chunk; ++j) batch[j] = makeCommand(first + i + j);
+
+            if (newFigure && i == 0) batch[0].type = QueuedCommand::START_FIGURE;
+
+            hr = PushCommands(batch, chunk);
+        }
+    });
+
+    if (FAILED(hr)) return hr;
+    return PostDrain();
+}
+
+HRESULT PathWindow::EnqueueRun(std::unique_ptr<PathBatch::Run> pRun)
+{
+    QueuedCommand command{ QueuedCommand::ADD_RUN, POINT{} };
+    command.pRun = pRun.get();
+
+    std::lock_guard<std::mutex> lock(m_producerMutex);
+    HRESULT hr = PushCommands(&command, 1);
+    if (FAILED(hr)) return hr;
+
+    // the command owns the run now
+    pRun.release();
+    return PostDrain();
+}
+
+HRESULT PathWindow::PushCommands(const QueuedCommand* commands, size_t count)
+{
+    // the window thread only drains when it is posted to, so it has to be told when the ring is full
+    size_t pushed = 0;
+    while ((pushed += m_queue.TryPushRange(commands + pushed, count - pushed)) < count)
+    {
+        HRESULT hr = PostDrain();
+        if (FAILED(hr)) return hr;
+        std::this_thread::yield();
+    }
+
+    return S_OK;
+}
+
+HRESULT PathWindow::EnqueueClear()
+{
+    // clearing goes through the queue too, so that it is ordered with the points around it
+    QueuedCommand command{ QueuedCommand::CLEAR, POINT{} };
+
+    std::lock_guard<std::mutex> lock(m_producerMutex);
+    HRESULT hr = PushCommands(&command, 1);
+    if (FAILED(hr)) return hr;
+
+    return PostDrain();
+}
+
+HRESULT PathWindow::RequestRender()
+{
+    return PostDrain();
+}
+
+HRESULT PathWindow::SetMaxFps(int maxFps)
+{
+    if (!m_hWnd) return E_HANDLE;
+
+    if (PostMessage(m_hWnd, WM_SETMAXFPS, static_cast<WPARAM>(maxFps), 0) == 0) return HRESULT_FROM_WIN32(GetLastError());
+
+    return S_OK;
+}
+
+HRESULT PathWindow::PostDrain()
+{
+    if (!m_hWnd) return E_HANDLE;
+
+    // one pending message is enough, the drain picks up everything pushed before it clears the flag
+    if (m_drainPosted.exchange(true, std::memory_order_acq_rel)) return S_OK;
+
+    if (PostMessage(m_hWnd, WM_DRAINQUEUE, 0, 0) == 0)
+    {
+        m_drainPosted.store(false, std::memory_order_release);
+        return HRESULT_FROM_WIN32(GetLastError());
+    }
+
+    return S_OK;
+}
+
+HRESULT PathWindow::DrainQueue()
+{
+    // cleared before popping, so anything pushed after the last pop posts a new message
+    m_drainPosted.store(false, std::memory_order_release);
+
+    Telemetry& telemetry = Telemetry::Get();
+    telemetry.queueDepth.Set(m_queue.GetSizeApprox());
+
+    QueuedCommand batch[DRAIN_BATCH_SIZE];
+    // counted here and added once, the counter is shared with every other window
+    uint64_t pointCount = 0;
+
+    size_t count;
+    while ((count = m_queue.PopBatch(batch, DRAIN_BATCH_SIZE)) > 0)
+    {
+        for (size_t i = 0; i < count; ++i)
+        {
+            const QueuedCommand& cmd = batch[i];
+            switch (cmd.type)
+            {
+            case QueuedCommand::ADD_POINT:
+                AppendPoint(cmd.point, false, cmd.delayNS);
+                ++pointCount;
+                break;
+
+            case QueuedCommand::START_FIGURE:
+                AppendPoint(cmd.point, true, cmd.delayNS);
+                ++pointCount;
+                break;
+
+            case QueuedCommand::ADD_RUN:
+            {
+                std::unique_ptr<PathBatch::Run> pRun(cmd.pRun);
+                AppendRun(*pRun);
+                pointCount += pRun->points.size();
+                break;
+            }
+
+            case QueuedCommand::CLEAR:
+                ClearPath();
+                break;
+            }
+        }
+    }
+
+    telemetry.pointsIngested.Add(pointCount);
+
+    return ScheduleRender();
+}
+
+HRESULT PathWindow::ScheduleRender()
+{
+    m_scheduler.Invalidate();
+
+    return RenderIfDue();
+}
+
+HRESULT PathWindow::RenderIfDue()
+{
+    int64_t now = GetNowNS();
+
+    if (m_scheduler.IsDue(now))
+    {
+        if (m_renderTimerSet)
+        {
+            KillTimer(m_hWnd, RENDER_TIMER_ID);
+            m_renderTimerSet = false;
+        }
+
+        HRESULT hr = Render();
+        m_scheduler.OnFrameRendered(now);
+
+        // an aging trail changes without any new points, so frames keep coming until it is empty
+        if (SUCCEEDED(hr) && IsTrailMode() && m_trail.IsAging()) return ScheduleRender();
+        // and a replay until its marker reaches the end
+        if (SUCCEEDED(hr) && IsReplayMode() && m_replayClock.IsPlaying() && m_replayShown < m_pReplay->timeline.GetCount()) return ScheduleRender();
+
+        return hr;
+    }
+
+    // everything invalidated before the timer fires is rendered in the same frame
+    if (m_scheduler.IsInvalidated() && !m_renderTimerSet)
+    {
+        int64_t waitNS = m_scheduler.GetTimeUntilDeadline(now);
+        UINT waitMS = static_cast<UINT>((waitNS + 999'999) / 1'000'000);
+
+        if (SetTimer(m_hWnd, RENDER_TIMER_ID, waitMS, nullptr) == 0) return HRESULT_FROM_WIN32(GetLastError());
+        m_renderTimerSet = true;
+    }
+
+    return S_OK;
+}
+
+void PathWindow::UpdateFrameInterval()
+{
+    int fps = m_refreshRate;
+    if (m_maxFps > 0 && (fps <= 0 || m_maxFps < fps)) fps = m_maxFps;
+    if (fps <= 0) fps = DEFAULT_FPS;
+
+    m_scheduler.SetMaxFps(fps);
+}
+
+HRESULT PathWindow::CreateDeviceIndependentResources()
+{
+    m_pBackend = std::make_unique<D2DRenderBackend>(STROKE_WIDTH, STROKE_COLOR);
+    m_isSoftwareBackend = false;
+
+    if (FAILED(m_pBackend->Initialize())) return UseSoftwareBackend();
+
+    return S_OK;
+}
+
+HRESULT PathWindow::UseSoftwareBackend()
+{
+    if (m_pBackend) m_pBackend->DiscardResources();
+
+    m_pBackend = std::make_unique<SoftwareRenderBackend>(STROKE_WIDTH, STROKE_COLOR);
+    m_isSoftwareBackend = true;
+
+    return m_pBackend->Initialize();
+}
+
+HRESULT PathWindow::CreateDeviceResources()
+{
+    HRESULT hr = S_OK;
+
+    if (m_pBackend->HasResources()) return hr;
+
+    RECT rc{};
+    GetClientRect(m_hWnd, &rc);
+    auto width = rc.right - rc.left;
+    auto height = rc.bottom - rc.top;
+
+    hr = m_pBackend->CreateResources(width, height);
+    if (FAILED(hr) && !m_isSoftwareBackend)
+    {
+        // nothing Direct2D needs is required to draw on the CPU
+        HR(UseSoftwareBackend());
+        hr = m_pBackend->CreateResources(width, height);
+    }
+
+    if (FAILED(hr)) return hr;
+
+    // the new bitmap is blank, so everything has to be stroked again
+    m_strokes.Invalidate();
+    m_trailChanged = true;
+    if (m_pHeatmap) m_pHeatmap->Invalidate();
+    if (m_pColors) m_pColors->Invalidate();
+    m_replayChanged = true;
+    m_surfaceIsNew = true;
+
+    return hr;
+}
+
+void PathWindow::DiscardDeviceResources()
+{
+    if (m_pBackend) m_pBackend->DiscardResources();
+}
+
+HRESULT PathWindow::Render()
+{
+    HRESULT hr = S_OK;
+
+    Telemetry& telemetry = Telemetry::Get();
+    int64_t frameStart = GetNowNS();
+
+    HR(CreateDeviceResources());
+
+    size_t replayReached = 0;
+
+    // a replay hides the other modes without turning them off
+    bool replayMode = IsReplayMode();
+    bool heatmapMode = !replayMode && IsHeatmapMode();
+    bool colorMode = !replayMode && IsColorMode();
+    bool trailMode = !replayMode && IsTrailMode();
+    if (trailMode && m_trail.Evict(frameStart) > 0) m_trailChanged = true;
+
+    // the bitmap behind the render target keeps its contents between frames, so unless it has to be redrawn
+    // from scratch (first frame, cleared points, new device resources) only the newly added segments are stroked.
+    // A trail loses its oldest segments and fades as it goes, so it is redrawn whole whenever it changed.
+    // A heatmap only redraws the blocks that changed, unless its color scale did. Colored segments are stroked like
+    // the rest, except that all of them are stroked again when the time their colors span grows. A replay redraws the
+    // area its marker left and strokes the segments it made since the last frame, unless it went back over its trail.
+    bool fullRedraw;
+    bool pending;
+    if (replayMode)
+    {
+        replayReached = m_pReplay->timeline.Step(m_replayShown, m_replayClock.GetTime(frameStart));
+
+        fullRedraw = m_replayChanged || (m_pReplay->showTrail && replayReached < m_replayShown);
+        pending = replayReached != m_replayShown;
+    }
+    else if (heatmapMode)
+    {
+        fullRedraw = m_pHeatmap->NeedsFullRedraw();
+        pending = m_pHeatmap->HasChanges();
+    }
+    else if (colorMode)
+    {
+        fullRedraw = m_pColors->NeedsFullRedraw();
+        pending = m_pColors->HasPending();
+    }
+    else if (trailMode)
+    {
+        fullRedraw = m_trailChanged || (m_fadeBuckets > 1 && m_trail.IsAging());
+        pending = false;
+    }
+    else
+    {
+        fullRedraw = m_strokes.NeedsFullRedraw();
+        pending = m_strokes.HasPending() || m_tailChanged || !m_changedRects.empty();
+    }
+
+    if (!fullRedraw && !pending)
+    {
+        telemetry.framesSkipped.Add(1);
+        return hr;
+    }
+
+    // a new bitmap has never been cleared or presented, so all of it is, otherwise only what changed is
+    bool fullPresent = m_surfaceIsNew;
+
+    m_pBackend->BeginDraw();
+
+    // drawn in here so that a failure anywhere still reaches EndDraw, which the backend needs to end the frame
+    hr = [&]() -> HRESULT
+    {
+        HRESULT hr = S_OK;
+
+        m_dirty.Clear();
+
+        if (fullRedraw)
+        {
+            ColorF clearColor = GetClearColor();
+
+            if (fullPresent)
+            {
+                m_pBackend->Clear(clearColor);
+            }
+            else
+            {
+                // only the tiles the previous path passed through have anything to clear
+                m_tiles.ForEachOccupiedSpan([this, &clearColor](RectI rect)
+                {
+                    m_pBackend->Clear(rect, clearColor);
+                    m_dirty.Add(rect);
+                });
+            }
+
+            m_tiles.Clear();
+            m_tailShown = false;
+        }
+
+        if (replayMode)
+        {
+            int64_t geometryStart = GetNowNS();
+
+            HR(DrawReplay(replayReached, fullRedraw, fullPresent));
+
+            telemetry.geometryTime.Record(GetNowNS() - geometryStart);
+        }
+        else if (heatmapMode)
+        {
+            int64_t geometryStart = GetNowNS();
+
+            HR(DrawHeatmap(fullPresent));
+
+            telemetry.geometryTime.Record(GetNowNS() - geometryStart);
+        }
+        else if (colorMode)
+        {
+            int64_t geometryStart = GetNowNS();
+
+            HR(StrokeColors(fullPresent));
+
+            telemetry.geometryTime.Record(GetNowNS() - geometryStart);
+        }
+        else if (trailMode)
+        {
+            int64_t geometryStart = GetNowNS();
+
+            HR(StrokeTrail(frameStart, fullPresent));
+
+            telemetry.geometryTime.Record(GetNowNS() - geometryStart);
+        }
+        else if (m_strokes.GetFigureCount() > 0)
+        {
+            int64_t geometryStart = GetNowNS();
+
+            if (m_tailShown) HR(RestoreUnderTail(fullPresent));
+
+            // a full redraw already strokes the segments as they are now
+            if (!fullRedraw)
+            {
+                for (const RectI& rect : m_changedRects) HR(RestoreStrokes(rect, fullPresent));
+            }
+
+            HR(m_pBackend->BeginStroke());
+
+            m_strokes.ForEachPendingRun([this, fullPresent](const PointF* points, size_t count)
+            {
+                StrokeRun(points, count, fullPresent);
+            });
+
+            HR(m_pBackend->EndStroke());
+
+            HR(DrawTail(fullPresent));
+
+            telemetry.geometryTime.Record(GetNowNS() - geometryStart);
+        }
+
+        {
+            int64_t presentStart = GetNowNS();
+            uint64_t presentedPixels = 0;
+
+            HDC dc;
+            HR(m_pBackend->GetDC(&dc));
+
+            // a new bitmap is pushed whole, otherwise only the cleared tiles and the rects the new segments touched are
+            if (fullPresent)
+            {
+                hr = m_info.Update(m_hWnd, dc);
+                presentedPixels = static_cast<uint64_t>(WND_WIDTH) * WND_HEIGHT;
+            }
+            else
+            {
+                m_dirty.ClipTo(RectI{ 0, 0, WND_WIDTH, WND_HEIGHT });
+
+                const RECT* pRects = reinterpret_cast<const RECT*>(m_dirty.GetRects());
+                for (size_t i = 0; i < m_dirty.GetCount() && SUCCEEDED(hr); ++i)
+                {
+                    hr = m_info.Update(m_hWnd, dc, &pRects[i]);
+                    presentedPixels += static_cast<uint64_t>(pRects[i].right - pRects[i].left) * (pRects[i].bottom - pRects[i].top);
+                }
+            }
+
+            m_pBackend->ReleaseDC();
+
+            HR(hr);
+
+            telemetry.presentTime.Record(GetNowNS() - presentStart);
+            // the bitmaps are 32 bits per pixel
+            telemetry.bytesPresented.Add(presentedPixels * 4);
+        }
+
+        return hr;
+    }();
+
+    HRESULT endHR = m_pBackend->EndDraw();
+    if (endHR == D2DERR_RECREATE_TARGET)
+    {
+        DiscardDeviceResources();
+        return hr;
+    }
+
+    if (SUCCEEDED(hr)) hr = endHR;
+    if (SUCCEEDED(hr))
+    {
+        m_strokes.Commit();
+        m_tailChanged = false;
+        m_changedRects.clear();
+        m_trailChanged = false;
+        if (heatmapMode) m_pHeatmap->Commit();
+        if (colorMode) m_pColors->Commit();
+        m_replayChanged = false;
+        m_surfaceIsNew = false;
+
+        telemetry.framesRendered.Add(1);
+        telemetry.frameTime.Record(GetNowNS() - frameStart);
+    }
+
+    return hr;
+}
+
+void PathWindow::StrokeRun(const PointF* points, size_t count, bool fullPresent)
+{
+    // antialiasing spills about a pixel past the edge of the stroke
+    constexpr float inflate = STROKE_WIDTH / 2.0f + 1.0f;
+
+    for (size_t i = 1; i < count; ++i)
+    {
+        m_tiles.MarkSegment(points[i - 1], points[i], inflate);
+        if (!fullPresent) m_dirty.AddSegment(points[i - 1], points[i], inflate);
+    }
+
+    m_pBackend->AddPolyline(points, count);
+}
+
+HRESULT PathWindow::StrokeTrail(int64_t nowNS, bool fullPresent)
+{
+    HRESULT hr = S_OK;
+
+    // one stroke per fade bucket, the runs come in bucket order
+    bool stroking = false;
+    size_t strokeBucket = 0;
+
+    m_trail.ForEachRun(nowNS, m_fadeBuckets, [this, fullPresent, &hr, &stroking, &strokeBucket](size_t bucket, const PointF* points, size_t count)
+    {
+        if (FAILED(hr)) return;
+
+        if (stroking && bucket != strokeBucket)
+        {
+            stroking = false;
+            hr = m_pBackend->EndStroke();
+            if (FAILED(hr)) return;
+        }
+
+        if (!stroking)
+        {
+            float fade = static_cast<float>(m_fadeBuckets - bucket) / static_cast<float>(m_fadeBuckets);
+            m_pBackend->SetStrokeColor(ColorF{ STROKE_COLOR.r, STROKE_COLOR.g, STROKE_COLOR.b, STROKE_COLOR.a * fade });
+
+            hr = m_pBackend->BeginStroke();
+            if (FAILED(hr)) return;
+
+            stroking = true;
+            strokeBucket = bucket;
+        }
+
+        StrokeRun(points, count, fullPresent);
+    });
+
+    if (stroking && SUCCEEDED(hr)) hr = m_pBackend->EndStroke();
+
+    m_pBackend->SetStrokeColor(STROKE_COLOR);
+
+    // the tail is the newest part of the trail, so it is not faded
+    if (SUCCEEDED(hr)) hr = DrawTail(fullPresent);
+
+    return hr;
+}
+
+HRESULT PathWindow::DrawHeatmap(bool fullPresent)
+{
+    HRESULT hr = S_OK;
+
+    size_t blockSize = static_cast<size_t>(m_pHeatmap->GetBlockSize());
+    m_heatmapPixels.resize(blockSize * blockSize);
+
+    m_pHeatmap->ForEachChangedBlock([this, fullPresent, blockSize, &hr](RectI rect)
+    {
+        if (FAILED(hr)) return;
+
+        m_pHeatmap->Colorize(rect, m_heatmapPixels.data(), blockSize);
+        hr = m_pBackend->CopyPixels(rect, m_heatmapPixels.data(), blockSize);
+
+        m_tiles.MarkRect(rect);
+        if (!fullPresent) m_dirty.Add(rect);
+    });
+
+    return hr;
+}
+
+HRESULT PathWindow::StrokeColors(bool fullPresent)
+{
+    HRESULT hr = S_OK;
+
+    m_pColors->Build();
+
+    // one stroke per bucket, the runs come in bucket order
+    bool stroking = false;
+    size_t strokeBucket = 0;
+
+    m_pColors->ForEachRun([this, fullPresent, &hr, &stroking, &strokeBucket](size_t bucket, const PointF* points, size_t count)
+    {
+        if (FAILED(hr)) return;
+
+        if (stroking && bucket != strokeBucket)
+        {
+            stroking = false;
+            hr = m_pBackend->EndStroke();
+            if (FAILED(hr)) return;
+        }
+
+        if (!stroking)
+        {
+            m_pBackend->SetStrokeColor(m_pColors->GetColor(bucket));
+
+            hr = m_pBackend->BeginStroke();
+            if (FAILED(hr)) return;
+
+            stroking = true;
+            strokeBucket = bucket;
+        }
+
+        StrokeRun(points, count, fullPresent);
+    });
+
+    if (stroking && SUCCEEDED(hr)) hr = m_pBackend->EndStroke();
+
+    m_pBackend->SetStrokeColor(STROKE_COLOR);
+
+    return hr;
+}
+
+HRESULT PathWindow::DrawReplay(size_t reachedCount, bool fullRedraw, bool fullPresent)
+{
+    HRESULT hr = S_OK;
+
+    if (fullRedraw)
+    {
+        // cleared along with everything else
+        m_markerShown = false;
+
+        HR(StrokeReplayRange(0, m_pReplay->showTrail ? reachedCount : m_pReplay->timeline.GetCount(), fullPresent));
+    }
+    else
+    {
+        if (m_markerShown) HR(RestoreUnderMarker(fullPresent));
+
+        // starting at the last movement made before, so the new segments join the trail
+        if (m_pReplay->showTrail && reachedCount > m_replayShown) HR(StrokeReplayRange(m_replayShown > 0 ? m_replayShown - 1 : 0, reachedCount, fullPresent));
+    }
+
+    m_replayShown = reachedCount;
+
+    if (reachedCount > 0) HR(DrawMarker(m_pReplay->timeline.GetPosition(reachedCount - 1), fullPresent));
+
+    return hr;
+}
+
+// Strokes the segments between the movements from first to last (exclusive).
+HRESULT PathWindow::StrokeReplayRange(size_t first, size_t last, bool fullPresent)
+{
+    HRESULT hr = S_OK;
+
+    const ReplayTimeline& timeline = m_pReplay->timeline;
+
+    HR(m_pBackend->BeginStroke());
+
+    m_restorePoints.clear();
+    for (size_t i = first; i < last; ++i)
+    {
+        if (i > first && timeline.StartsFigure(i))
+        {
+            StrokeRun(m_restorePoints.data(), m_restorePoints.size(), fullPresent);
+            m_restorePoints.clear();
+        }
+
+        PointI p = timeline.GetPosition(i);
+        m_restorePoints.push_back(PointF{ static_cast<float>(p.x), static_cast<float>(p.y) });
+    }
+
+    StrokeRun(m_restorePoints.data(), m_restorePoints.size(), fullPresent);
+
+    return m_pBackend->EndStroke();
+}
+
+// Clears rect and strokes again the parts of the shown segments in it, which are the ones segments lists with an id
+// below shownCount. The segment with id i goes from getPoint(i - 1) to getPoint(i).
+template<class GetPoint>
+HRESULT PathWindow::RestoreRect(RectI rect, const SegmentIndex& segments, size_t shownCount, GetPoint&& getPoint, bool fullPresent)
+{
+    HRESULT hr = S_OK;
+
+    // segments that pass by the rect reach into it as far as their strokes are wide
+    constexpr float reach = STROKE_WIDTH / 2.0f + 1.0f;
+
+    m_restoreIds.clear();
+    segments.ForEachCandidate(
+        PointF{ rect.left - reach, rect.top - reach },
+        PointF{ rect.right + reach, rect.bottom + reach },
+        [this, shownCount](uint32_t id)
+        {
+            if (id < shownCount) m_restoreIds.push_back(id);
+        });
+
+    // a segment is listed once for every cell it passes through
+    std::sort(m_restoreIds.begin(), m_restoreIds.end());
+    m_restoreIds.erase(std::unique(m_restoreIds.begin(), m_restoreIds.end()), m_restoreIds.end());
+
+    m_pBackend->Clear(rect, GetClearColor());
+
+    // the parts of the segments outside the rect are still there, and would be blended twice
+    m_pBackend->PushClip(rect);
+
+    // segments that follow each other are stroked as one polyline, so they join like the rest of the path, and each
+    // polyline is its own stroke, so where the path crosses itself it blends over itself as it did when first drawn
+    for (size_t i = 0; i < m_restoreIds.size() && SUCCEEDED(hr);)
+    {
+        size_t end = i + 1;
+        while (end < m_restoreIds.size() && m_restoreIds[end] == m_restoreIds[end - 1] + 1) ++end;
+
+        m_restorePoints.clear();
+        for (size_t index = m_restoreIds[i] - 1; index <= m_restoreIds[end - 1]; ++index) m_restorePoints.push_back(getPoint(index));
+
+        hr = m_pBackend->BeginStroke();
+        if (SUCCEEDED(hr))
+        {
+            m_pBackend->AddPolyline(m_restorePoints.data(), m_restorePoints.size());
+            hr = m_pBackend->EndStroke();
+        }
+        i = end;
+    }
+
+    m_pBackend->PopClip();
+
+    if (!fullPresent) m_dirty.Add(rect);
+
+    return hr;
+}
+
+HRESULT PathWindow::RestoreUnderMarker(bool fullPresent)
+{
+    const ReplayTimeline& timeline = m_pReplay->timeline;
+    size_t shownCount = m_pReplay->showTrail ? m_replayShown : timeline.GetCount();
+
+    m_markerShown = false;
+
+    return RestoreRect(m_markerRect, m_pReplay->segments, shownCount, [&timeline](size_t index)
+    {
+        PointI p = timeline.GetPosition(index);
+        return PointF{ static_cast<float>(p.x), static_cast<float>(p.y) };
+    }, fullPresent);
+}
+
+HRESULT PathWindow::RestoreStrokes(RectI rect, bool fullPresent)
+{
+    const PointF* points = m_strokes.GetStore().GetPoints();
+
+    // only what was stroked by the last frame, the rest is stroked after this
+    return RestoreRect(rect, m_strokeIndex, m_strokes.GetCommittedPointCount(), [points](size_t index)
+    {
+        return points[index];
+    }, fullPresent);
+}
+
+HRESULT PathWindow::RestoreUnderTail(bool fullPresent)
+{
+    m_tailShown = false;
+
+    return RestoreStrokes(m_tailRect, fullPresent);
+}
+
+// Strokes the segment the simplifier would replace the run it holds back with, without storing it, so every frame
+// shows the path up to the newest point while simplification still spans the whole run.
+HRESULT PathWindow::DrawTail(bool fullPresent)
+{
+    HRESULT hr = S_OK;
+
+    PointF tail[2];
+    if (!m_simplifier.GetPendingSegment(tail[0], tail[1])) return hr;
+
+    HR(m_pBackend->BeginStroke());
+    StrokeRun(tail, 2, fullPresent);
+    HR(m_pBackend->EndStroke());
+
+    // antialiasing spills about a pixel past the edge of the stroke
+    constexpr float reach = STROKE_WIDTH / 2.0f + 1.0f;
+    m_tailRect = RectI{
+        static_cast<int32_t>(std::floor(std::min(tail[0].x, tail[1].x) - reach)),
+        static_cast<int32_t>(std::floor(std::min(tail[0].y, tail[1].y) - reach)),
+        static_cast<int32_t>(std::ceil(std::max(tail[0].x, tail[1].x) + reach)),
+        static_cast<int32_t>(std::ceil(std::max(tail[0].y, tail[1].y) + reach))
+    };
+    m_tailShown = true;
+
+    return hr;
+}
+
+HRESULT PathWindow::DrawMarker(PointI position, bool fullPresent)
+{
+    HRESULT hr = S_OK;
+
+    constexpr float TWO_PI = 6.28318531f;
+    PointF center{ static_cast<float>(position.x), static_cast<float>(position.y) };
+
+    // one side past a full turn, so the ends of the polyline meet in a join
+    PointF ring[MARKER_SIDES + 2];
+    for (size_t i = 0; i < MARKER_SIDES + 2; ++i)
+    {
+        float angle = TWO_PI * static_cast<float>(i) / static_cast<float>(MARKER_SIDES);
+        ring[i] = PointF{ center.x + MARKER_RADIUS * std::cos(angle), center.y + MARKER_RADIUS * std::sin(angle) };
+    }
+
+    m_pBackend->SetStrokeColor(MARKER_COLOR);
+
+    hr = m_pBackend->BeginStroke();
+    if (SUCCEEDED(hr))
+    {
+        m_pBackend->AddPolyline(ring, MARKER_SIDES + 2);
+        hr = m_pBackend->EndStroke();
+    }
+
+    m_pBackend->SetStrokeColor(STROKE_COLOR);
+
+    if (FAILED(hr)) return hr;
+
+    // antialiasing spills about a pixel past the edge of the stroke
+    constexpr float reach = MARKER_RADIUS + STROKE_WIDTH / 2.0f + 1.0f;
+    m_markerRect = RectI{
+        static_cast<int32_t>(std::floor(center.x - reach)),
+        static_cast<int32_t>(std::floor(center.y - reach)),
+        static_cast<int32_t>(std::ceil(center.x + reach)),
+        static_cast<int32_t>(std::ceil(center.y + reach))
+    };
+    m_markerShown = true;
+
+    m_tiles.MarkRect(m_markerRect);
+    if (!fullPresent) m_dirty.Add(m_markerRect);
+
+    return hr;
+}
+
+LRESULT CALLBACK PathWindow::WndProc(HWND hWnd, UINT message, WPARAM wParam, LPARAM lParam)
+{
+    if (message == WM_CREATE)
+    {
+        auto pcs = (LPCREATESTRUCT)lParam;
+        auto pPathWindow = (PathWindow*)pcs->lpCreateParams;
+
+        SetWindowLongPtr(hWnd, GWLP_USERDATA, reinterpret_cast<LONG_PTR>(pPathWindow));
+
+        return 1;
+    }
+
+    auto pPathWindow = reinterpret_cast<PathWindow*>(static_cast<LONG_PTR>(GetWindowLongPtr(hWnd, GWLP_USERDATA)));
+
+    if (pPathWindow)
+    {
+        switch (message)
+        {
+        case WM_SIZE:
+            return 0;
+
+        case WM_DISPLAYCHANGE:
+            // the window no longer covers the virtual screen
+            DestroyWindow(hWnd);
+            return 0;
+
+        case WM_PAINT:
+            return 0;
+
+        case WM_DRAINQUEUE:
+            pPathWindow->DrainQueue();
+            return 0;
+
+        case WM_SETTOLERANCE:
+        {
+            float tolerance;
+            memcpy(&tolerance, &wParam, sizeof(float));
+
+            pPathWindow->FlushSimplifier();
+
+            bool wasIndexed = pPathWindow->IsStrokeIndexed();
+            pPathWindow->m_simplifier.SetTolerance(tolerance);
+
+            if (pPathWindow->IsStrokeIndexed() != wasIndexed)
+            {
+                // a tail drawn before may not be restorable from the index any more
+                pPathWindow->IndexStrokes();
+                pPathWindow->m_strokes.Invalidate();
+            }
+            return 0;
+        }
+
+        case WM_SETTRAIL:
+        {
+            std::unique_ptr<TrailOptions> pOptions = pPathWindow->m_postedTrails.Take(reinterpret_cast<TrailOptions*>(lParam));
+            if (pOptions) pPathWindow->ApplyTrail(*pOptions);
+            return 0;
+        }
+
+        case WM_SETHEATMAP:
+            pPathWindow->ApplyHeatmap(wParam != 0);
+            return 0;
+
+        case WM_SETCOLORING:
+            pPathWindow->ApplyColoring(static_cast<Coloring>(wParam), static_cast<size_t>(lParam));
+            return 0;
+
+        case WM_STARTREPLAY:
+            // StopReplay posts null, which is never held
+            pPathWindow->ApplyReplay(pPathWindow->m_postedReplays.Take(reinterpret_cast<Replay*>(lParam)));
+            return 0;
+
+        case WM_SETREPLAYSPEED:
+        {
+            float speed;
+            memcpy(&speed, &wParam, sizeof(float));
+
+            pPathWindow->ApplyReplaySpeed(speed);
+            return 0;
+        }
+
+        case WM_PAUSEREPLAY:
+            pPathWindow->ApplyReplayPaused(wParam != 0);
+            return 0;
+
+        case WM_SEEKREPLAY:
+            pPathWindow->ApplyReplaySeek(static_cast<int64_t>(wParam) * 1'000'000);
+            return 0;
+
+        case WM_SETMAXFPS:
+            pPathWindow->m_maxFps = static_cast<int>(wParam);
+            pPathWindow->UpdateFrameInterval();
+            return 0;
+
+        case WM_TIMER:
+            if (wParam != RENDER_TIMER_ID) break;
+            KillTimer(hWnd, RENDER_TIMER_ID);
+            pPathWindow->m_renderTimerSet = false;
+            pPathWindow->RenderIfDue();
             return 0;
 
         case WM_CLOSE:
@@ -345,7 +1664,8 @@ LRESULT CALLBACK PathWindow::WndProc(HWND hWnd, UINT message, WPARAM wParam, LPA
             return 0;
 
         case WM_DESTROY:
-            PostQuitMessage(0);
+            // other windows live on the same thread, so the message loop keeps running
+            if (pPathWindow->m_onDestroyed) pPathWindow->m_onDestroyed();
             return 0;
 
         default:
@@ -2,18 +2,26 @@
 #include "pch.h"
 #include "IWindow.h"
 #include "LayeredWindowInfo.h"
+#include "StrokeAccumulator.h"
+#include "DirtyRegion.h"
+#include "TileGrid.h"
+#include "SpscQueue.h"
+#include "FrameScheduler.h"
+#include "PolylineSimplifier.h"
+#include "RenderBackend.h"
+#include "PathBatch.h"
+#include "TrailBuffer.h"
+#include "HeatmapGrid.h"
+#include "ColorBuckets.h"
+#include "ReplayTimeline.h"
+#include "ReplayClock.h"
+#include "SegmentIndex.h"
+#include "PostedObjects.h"
 #include <vector>
+#include <memory>
 #include <functional>
-
-template<class T>
-inline void SafeRelease(T** ppT)
-{
-    if (*ppT)
-    {
-        (*ppT)->Release();
-        (*ppT) = NULL;
-    }
-}
+#include <atomic>
+#include <mutex>
 
 #ifndef HINST_THISCOMPONENT
 EXTERN_C IMAGE_DOS_HEADER __ImageBase;
@@ -25,45 +33,230 @@ namespace PathWindows
     class PathWindow : public IWindow
     {
     public:
-        PathWindow(const std::function<void(HWND, UINT, WPARAM, LPARAM)>& = nullptr, bool clickable = false);
+        // An erasable window keeps every point it is given, see EraseSegments.
+        PathWindow(const std::function<void(HWND, UINT, WPARAM, LPARAM)>& = nullptr, bool clickable = false, bool erasable = false);
         ~PathWindow();
 
         HWND GetHandle();
 
         HRESULT Initialize();
 
-        HRESULT RunMessageLoop();
+        void SetOnDestroyed(const std::function<void()>& onDestroyed);
 
         HRESULT AddPoint(POINT point, bool render, bool newPath = false);
         HRESULT AddPoints(POINT* points, int length);
 
-        HRESULT ClearPoints();
+        HRESULT ClearPoints(bool render = true);
+
+        // Takes the segments that end at the given points off the path, which splits their figures there, and redraws
+        // only the area they covered. Points are counted from the last clear. These are only for erasable windows.
+        HRESULT EraseSegments(const uint32_t* pointIndices, size_t count, bool render);
+        // Puts back segments that were erased.
+        HRESULT RestoreSegments(const uint32_t* pointIndices, size_t count, bool render);
+        // Drops the points from index on, as if they had never been added.
+        HRESULT DropPointsFrom(size_t index, bool render);
 
         HRESULT Render();
 
+        // Thread safe versions of the above for threads other than the window's. They only enqueue (and post a message
+        // when rendering is requested), the window thread applies everything queued and renders once per drain.
+        // Calls from several threads are serialized, each call's points stay together in the queue.
+        HRESULT EnqueuePoint(POINT point, bool render);
+        HRESULT EnqueuePoints(const POINT* points, int length);
+        // figureStarts are the indices into points where new figures start, see PathBatch.
+        HRESULT EnqueueBatch(const POINT* points, int length, const int32_t* figureStarts, int figureCount);
+        // Like EnqueueBatch, with how long it took to get to each point, which only the colors of ColorBuckets use.
+        // Points added any other way took no time.
+        HRESULT EnqueueTimedBatch(const Movement* movements, int length, const int32_t* figureStarts, int figureCount);
+        HRESULT EnqueueClear();
+        HRESULT RequestRender();
+
+        // Caps how often the window renders, it never renders more often than the display refreshes.
+        // 0 or less means once per display refresh. Can be called from any thread.
+        HRESULT SetMaxFps(int maxFps);
+
+        // Sets how far (in pixels) the displayed path may stray from the added points so that fewer of them have to be drawn.
+        // 0 or less draws every point. Can be called from any thread. Not supported by erasable windows.
+        HRESULT SetSimplifyTolerance(float tolerance);
+
+        // Keeps only the newest maxPoints points, and only those added within the last maxAgeMS if it is above 0, so the
+        // path takes constant memory and time to render however long it gets. Older segments fade out in fadeBuckets
+        // steps (1 does not fade). A maxPoints of 0 turns trail mode off. Clears the path. Can be called from any thread.
+        HRESULT SetTrail(int maxPoints, int maxAgeMS, int fadeBuckets);
+
+        // Shows how often the path passed through each part of the window instead of the path itself, which costs the
+        // same however long the path gets, see HeatmapGrid. Turns trail mode off. Clears the path. Can be called from any thread.
+        HRESULT SetHeatmap(bool enabled);
+
+        enum class Coloring
+        {
+            NONE,
+            SPEED,
+            ELAPSED_TIME
+        };
+
+        // Colors every segment by how fast the cursor moved along it, or by when it got there, in bucketCount steps
+        // of a gradient, see ColorBuckets. Turns trail and heatmap mode off. Clears the path. Can be called from any thread.
+        HRESULT SetColoring(Coloring coloring, int bucketCount);
+
+        // Moves a marker along the absolute positions of movements the way replaying them would move the cursor, with
+        // their delays divided by speed, without touching the cursor. showTrail draws the path only as far as the marker
+        // got. Shows nothing else until StopReplay, and keeps everything added in the meantime. These can be called from any thread.
+        HRESULT StartReplay(const Movement* movements, int length, float speed, bool showTrail);
+        HRESULT StopReplay();
+
+        HRESULT SetReplaySpeed(float speed);
+        // Resuming a replay that ended starts it over.
+        HRESULT SetReplayPaused(bool paused);
+        // Moves the marker to where it is timeMS into the movements, before dividing by the speed.
+        HRESULT SeekReplay(int timeMS);
+
     private:
         const int WND_WIDTH;
         const int WND_HEIGHT;
 
         const bool CLICKABLE;
+        // every point added is stored and indexed, so segments can be erased by the index of their points
+        const bool ERASABLE;
+
+        static constexpr float STROKE_WIDTH = 3.0f;
+        static constexpr ColorF STROKE_COLOR{ 1.0f, 0.0f, 0.0f, 0.7f };
+
+        static constexpr int32_t TILE_SIZE = 256;
+
+        static constexpr size_t QUEUE_CAPACITY = 1 << 16;
+        static constexpr size_t DRAIN_BATCH_SIZE = 1024;
+        static constexpr size_t CONVERT_BATCH_SIZE = 256;
+        // batches at least this long are converted and queued as one PathBatch::Run, shorter ones point by point (runs
+        // of 64 points are about as fast as queuing them one by one, longer ones faster)
+        static constexpr size_t MIN_RUN_LENGTH = 128;
+
+        static constexpr UINT WM_DRAINQUEUE = WM_APP + 1;
+        static constexpr UINT WM_SETMAXFPS = WM_APP + 2;
+        static constexpr UINT WM_SETTOLERANCE = WM_APP + 3;
+        static constexpr UINT WM_SETTRAIL = WM_APP + 4;
+        static constexpr UINT WM_SETHEATMAP = WM_APP + 5;
+        static constexpr UINT WM_SETCOLORING = WM_APP + 6;
+        static constexpr UINT WM_STARTREPLAY = WM_APP + 7;
+        static constexpr UINT WM_SETREPLAYSPEED = WM_APP + 8;
+        static constexpr UINT WM_PAUSEREPLAY = WM_APP + 9;
+        static constexpr UINT WM_SEEKREPLAY = WM_APP + 10;
+
+        static constexpr UINT_PTR RENDER_TIMER_ID = 1;
+
+        // used when the refresh rate of the display is unknown
+        static constexpr int DEFAULT_FPS = 60;
+
+        // well under the stroke width, so the difference is not visible
+        static constexpr float DEFAULT_SIMPLIFY_TOLERANCE = 0.5f;
+
+        static constexpr int MAX_FADE_BUCKETS = 32;
+
+        static constexpr int32_t HEATMAP_CELL_SIZE = 4;
+
+        static constexpr int MAX_COLOR_BUCKETS = 32;
+
+        static constexpr float MIN_REPLAY_SPEED = 0.01f;
+        static constexpr float MAX_REPLAY_SPEED = 100.0f;
+
+        // a ring around the position the replay got to
+        static constexpr float MARKER_RADIUS = 6.0f;
+        static constexpr size_t MARKER_SIDES = 16;
+        static constexpr ColorF MARKER_COLOR{ 1.0f, 0.8f, 0.0f, 1.0f };
+
+        struct QueuedCommand
+        {
+            enum : uint32_t { ADD_POINT, START_FIGURE, ADD_RUN, CLEAR } type;
+            POINT point;
+            union
+            {
+                int64_t delayNS;
+                // owned by the command until it is drained
+                PathBatch::Run* pRun;
+            };
+        };
+
+        struct TrailOptions
+        {
+            size_t maxPoints;
+            int64_t maxAgeNS;
+            size_t fadeBuckets;
+        };
+
+        struct Replay
+        {
+            ReplayTimeline timeline;
+            // the segments of the timeline, by the index of the movement they end at
+            SegmentIndex segments;
+            float speed;
+            bool showTrail;
+        };
 
         LayeredWindowInfo m_info;
+        DirtyRegion m_dirty;
+        TileGrid m_tiles;
+        bool m_surfaceIsNew;
 
         HWND m_hWnd;
 
-        ID2D1Factory* m_pD2Factory;
-        IWICImagingFactory* m_pWICFactory;
-        ID2D1StrokeStyle* m_pStrokeStyle;
+        std::unique_ptr<RenderBackend> m_pBackend;
+        bool m_isSoftwareBackend;
 
-        ID2D1RenderTarget* m_pRenderTarget;
-        ID2D1GdiInteropRenderTarget* m_pInteropTarget;
-        ID2D1SolidColorBrush* m_pPathBrush;
+        StrokeAccumulator m_strokes;
+        // the stroked segments, by the index of the point they end at, while the simplifier is on or the window is
+        // erasable, so what the tail the simplifier holds back or an erased segment covered can be restored
+        SegmentIndex m_strokeIndex;
+        // where the tail was drawn, which has to be restored before the tail is drawn again
+        RectI m_tailRect;
+        bool m_tailShown;
+        bool m_tailChanged;
+        // where segments were erased, restored or dropped since the last frame, which has to be redrawn
+        std::vector<RectI> m_changedRects;
 
-        std::vector<std::vector<D2D1_POINT_2F>> m_paths;
+        // used instead of m_strokes in trail mode, which is on while it has room for any points
+        TrailBuffer m_trail;
+        size_t m_fadeBuckets;
+        bool m_trailChanged;
 
-        std::function<void(HWND, UINT, WPARAM, LPARAM)> m_onUnhandledMsg;
+        // used instead of m_strokes in heatmap mode, which is on while it exists
+        std::unique_ptr<HeatmapGrid> m_pHeatmap;
+        // the pixels of one block of it, reused
+        std::vector<uint32_t> m_heatmapPixels;
 
-        std::vector<D2D1_POINT_2F>& GetLastPath();
+        // used instead of m_strokes while it exists, the points go around the simplifier
+        std::unique_ptr<ColorBuckets> m_pColors;
+
+        // shown instead of everything else while it exists, which is kept as it is to be shown again afterwards
+        std::unique_ptr<Replay> m_pReplay;
+        ReplayClock m_replayClock;
+        // how many movements of it the bitmap shows as made
+        size_t m_replayShown;
+        bool m_replayChanged;
+        // where the marker was drawn, which is all that has to be redrawn when it moves
+        RectI m_markerRect;
+        bool m_markerShown;
+        // reused for the segments under the marker or the tail, the replayed ones and the erased ones
+        std::vector<uint32_t> m_restoreIds;
+        std::vector<PointF> m_restorePoints;
+
+        SpscQueue<QueuedCommand> m_queue;
+        // the queue only takes one producer at a time
+        std::mutex m_producerMutex;
+        std::atomic<bool> m_drainPosted;
+
+        // what WM_SETTRAIL and WM_STARTREPLAY point to, until they are handled
+        PostedObjects<TrailOptions> m_postedTrails;
+        PostedObjects<Replay> m_postedReplays;
+
+        FrameScheduler m_scheduler;
+        int m_maxFps;
+        int m_refreshRate;
+        bool m_renderTimerSet;
+
+        PolylineSimplifier m_simplifier;
+
+        std::function<void(HWND, UINT, WPARAM, LPARAM)> m_onUnhandledMsg;
+        std::function<void()> m_onDestroyed;
 
         HRESULT CreateDeviceIndependentResources();
 
@@ -71,6 +264,63 @@ namespace PathWindows
 
         void DiscardDeviceResources();
 
+        HRESULT UseSoftwareBackend();
+
+        template<class MakeCommand>
+        HRESULT EnqueueRuns(int length, const int32_t* figureStarts, int figureCount, MakeCommand&& makeCommand);
+        HRESULT EnqueueRun(std::unique_ptr<PathBatch::Run> pRun);
+        HRESULT PushCommands(const QueuedCommand* commands, size_t count);
+        HRESULT PostDrain();
+        HRESULT DrainQueue();
+
+        void AppendPoint(POINT point, bool newPath, int64_t delayNS = 0);
+        void AppendPoint(PointF point, bool newPath, int64_t delayNS = 0);
+        // Appends a queued run, its figures in one go where the points are stored as they are.
+        void AppendRun(const PathBatch::Run& run);
+        void StoreRun(const PointF* points, size_t count, bool newFigure);
+        void FlushSimplifier();
+        void StorePoint(PointF point, bool newFigure);
+        bool IsStrokeIndexed() const;
+        void IndexStrokes();
+        void ClearPath();
+        HRESULT ChangeSegments(const uint32_t* pointIndices, size_t count, bool restore, bool render);
+        void MarkChanged(PointF min, PointF max);
+
+        bool IsTrailMode() const;
+        void ApplyTrail(const TrailOptions& options);
+
+        bool IsHeatmapMode() const;
+        void ApplyHeatmap(bool enabled);
+
+        bool IsColorMode() const;
+        void ApplyColoring(Coloring coloring, size_t bucketCount);
+
+        bool IsReplayMode() const;
+        void ApplyReplay(std::unique_ptr<Replay> pReplay);
+        void ApplyReplaySpeed(float speed);
+        void ApplyReplayPaused(bool paused);
+        void ApplyReplaySeek(int64_t timeNS);
+
+        ColorF GetClearColor() const;
+
+        void StrokeRun(const PointF* points, size_t count, bool fullPresent);
+        template<class GetPoint>
+        HRESULT RestoreRect(RectI rect, const SegmentIndex& segments, size_t shownCount, GetPoint&& getPoint, bool fullPresent);
+        HRESULT RestoreStrokes(RectI rect, bool fullPresent);
+        HRESULT RestoreUnderTail(bool fullPresent);
+        HRESULT DrawTail(bool fullPresent);
+        HRESULT StrokeTrail(int64_t nowNS, bool fullPresent);
+        HRESULT DrawHeatmap(bool fullPresent);
+        HRESULT StrokeColors(bool fullPresent);
+        HRESULT DrawReplay(size_t reachedCount, bool fullRedraw, bool fullPresent);
+        HRESULT StrokeReplayRange(size_t first, size_t last, bool fullPresent);
+        HRESULT RestoreUnderMarker(bool fullPresent);
+        HRESULT DrawMarker(PointI position, bool fullPresent);
+
+        HRESULT ScheduleRender();
+        HRESULT RenderIfDue();
+        void UpdateFrameInterval();
+
         static LRESULT CALLBACK WndProc(HWND hWnd, UINT message, WPARAM wParam, LPARAM lParam);
     };
 }
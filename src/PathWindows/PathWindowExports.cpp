@@ -1,5 +1,6 @@
 #include "pch.h"
 #include "PathWindow.h"
+#include "DrawablePathWindow.h"
 
 using namespace PathWindows;
 
@@ -7,26 +8,118 @@ extern "C" __declspec(dllexport) HRESULT __cdecl AddPointToPath(PathWindow* pPat
 {
     if (!pPathWindow) return E_POINTER;
 
-    return pPathWindow->AddPoint(point, render);
+    return pPathWindow->EnqueuePoint(point, render);
 }
 
 extern "C" __declspec(dllexport) HRESULT __cdecl AddPointsToPath(PathWindow* pPathWindow, POINT* points, int length)
 {
     if (!pPathWindow) return E_POINTER;
 
-    return pPathWindow->AddPoints(points, length);
+    return pPathWindow->EnqueuePoints(points, length);
+}
+
+// Adds a whole batch of points in one call. figureStarts are the indices into points where new figures start, in
+// ascending order (nullptr if figureCount is 0), points before the first of them continue the current figure.
+// The buffers are only read during the call, so the caller can keep reusing them.
+extern "C" __declspec(dllexport) HRESULT __cdecl AddPathBatch(PathWindow* pPathWindow, const POINT* points, int length, const int32_t* figureStarts, int figureCount)
+{
+    if (!pPathWindow) return E_POINTER;
+
+    return pPathWindow->EnqueueBatch(points, length, figureStarts, figureCount);
+}
+
+// Like AddPathBatch, with the absolute positions of movements as the points, and their delays for the colors
+// SetPathColoring shows.
+extern "C" __declspec(dllexport) HRESULT __cdecl AddTimedPathBatch(PathWindow* pPathWindow, const MouseMovement* movements, int length, const int32_t* figureStarts, int figureCount)
+{
+    if (!pPathWindow) return E_POINTER;
+
+    return pPathWindow->EnqueueTimedBatch(reinterpret_cast<const Movement*>(movements), length, figureStarts, figureCount);
 }
 
 extern "C" __declspec(dllexport) HRESULT __cdecl ClearPoints(PathWindow* pPathWindow)
 {
     if (!pPathWindow) return E_POINTER;
 
-    return pPathWindow->ClearPoints();
+    return pPathWindow->EnqueueClear();
 }
 
 extern "C" __declspec(dllexport) HRESULT __cdecl Render(PathWindow* pPathWindow)
 {
     if (!pPathWindow) return E_POINTER;
 
-    return pPathWindow->Render();
+    return pPathWindow->RequestRender();
+}
+
+extern "C" __declspec(dllexport) HRESULT __cdecl SetPathWindowMaxFps(PathWindow* pPathWindow, int maxFps)
+{
+    if (!pPathWindow) return E_POINTER;
+
+    return pPathWindow->SetMaxFps(maxFps);
+}
+
+extern "C" __declspec(dllexport) HRESULT __cdecl SetPathSimplifyTolerance(PathWindow* pPathWindow, float tolerance)
+{
+    if (!pPathWindow) return E_POINTER;
+
+    return pPathWindow->SetSimplifyTolerance(tolerance);
+}
+
+extern "C" __declspec(dllexport) HRESULT __cdecl SetPathTrail(PathWindow* pPathWindow, int maxPoints, int maxAgeMS, int fadeBuckets)
+{
+    if (!pPathWindow) return E_POINTER;
+
+    return pPathWindow->SetTrail(maxPoints, maxAgeMS, fadeBuckets);
+}
+
+extern "C" __declspec(dllexport) HRESULT __cdecl SetPathHeatmap(PathWindow* pPathWindow, bool enabled)
+{
+    if (!pPathWindow) return E_POINTER;
+
+    return pPathWindow->SetHeatmap(enabled);
+}
+
+// coloring is 0 for none, 1 for speed and 2 for elapsed time, see PathWindow::Coloring.
+extern "C" __declspec(dllexport) HRESULT __cdecl SetPathColoring(PathWindow* pPathWindow, int coloring, int bucketCount)
+{
+    if (!pPathWindow) return E_POINTER;
+
+    return pPathWindow->SetColoring(static_cast<PathWindow::Coloring>(coloring), bucketCount);
+}
+
+// Moves a marker along movements (absolute positions, like AddTimedPathBatch takes) as fast as replaying them would,
+// times speed, without moving the cursor. The movements are copied during the call.
+extern "C" __declspec(dllexport) HRESULT __cdecl StartPathReplay(PathWindow* pPathWindow, const MouseMovement* movements, int length, float speed, bool showTrail)
+{
+    if (!pPathWindow) return E_POINTER;
+
+    return pPathWindow->StartReplay(reinterpret_cast<const Movement*>(movements), length, speed, showTrail);
+}
+
+extern "C" __declspec(dllexport) HRESULT __cdecl StopPathReplay(PathWindow* pPathWindow)
+{
+    if (!pPathWindow) return E_POINTER;
+
+    return pPathWindow->StopReplay();
+}
+
+extern "C" __declspec(dllexport) HRESULT __cdecl SetPathReplaySpeed(PathWindow* pPathWindow, float speed)
+{
+    if (!pPathWindow) return E_POINTER;
+
+    return pPathWindow->SetReplaySpeed(speed);
+}
+
+extern "C" __declspec(dllexport) HRESULT __cdecl SetPathReplayPaused(PathWindow* pPathWindow, bool paused)
+{
+    if (!pPathWindow) return E_POINTER;
+
+    return pPathWindow->SetReplayPaused(paused);
+}
+
+extern "C" __declspec(dllexport) HRESULT __cdecl SeekPathReplay(PathWindow* pPathWindow, int timeMS)
+{
+    if (!pPathWindow) return E_POINTER;
+
+    return pPathWindow->SeekReplay(timeMS);
 }
@@ -0,0 +1,386 @@
+#include "PixelKernels.h"
+#include <atomic>
+#include <cstring>
+
+#if defined(_M_X64) || defined(__x86_64__) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2) || defined(__SSE2__)
+#define PIXELKERNELS_X86
+#endif
+
+#ifdef PIXELKERNELS_X86
+#ifdef _MSC_VER
+#include <intrin.h>
+#define TARGET_AVX2
+#else
+#include <immintrin.h>
+#include <cpuid.h>
+#define TARGET_AVX2 __attribute__((target("avx2")))
+#endif
+#endif
+
+using namespace PathWindows;
+using namespace PathWindows::PixelKernels;
+
+namespace
+{
+    // x / 255 rounded to nearest, exact for 0 <= x <= 255 * 255
+    inline uint32_t Div255(uint32_t x)
+    {
+        x += 128;
+        return (x + (x >> 8)) >> 8;
+    }
+
+    // scalar
+
+    void FillSpanScalar(uint32_t* pDst, size_t count, uint32_t pixel)
+    {
+        for (size_t i = 0; i < count; ++i) pDst[i] = pixel;
+    }
+
+    inline uint32_t BlendPixel(uint32_t dst, uint32_t coverage, uint32_t src)
+    {
+        uint32_t srcA = Div255((src >> 24) * coverage);
+        uint32_t inverse = 255 - srcA;
+
+        uint32_t result = 0;
+        for (int shift = 0; shift < 32; shift += 8)
+        {
+            uint32_t channel = Div255(((src >> shift) & 0xFF) * coverage) + Div255(((dst >> shift) & 0xFF) * inverse);
+            result |= (channel > 255 ? 255 : channel) << shift;
+        }
+
+        return result;
+    }
+
+    void BlendSpanScalar(uint32_t* pDst, const uint8_t* pCoverage, size_t count, uint32_t src)
+    {
+        for (size_t i = 0; i < count; ++i)
+        {
+            if (pCoverage[i] != 0) pDst[i] = BlendPixel(pDst[i], pCoverage[i], src);
+        }
+    }
+
+    void ConvertPointsScalar(const int32_t* pXY, PointF* pDst, size_t count, PointF offset)
+    {
+        for (size_t i = 0; i < count; ++i)
+        {
+            pDst[i] = PointF{ static_cast<float>(pXY[i * 2]) + offset.x, static_cast<float>(pXY[i * 2 + 1]) + offset.y };
+        }
+    }
+
+    void MapCountsScalar(const uint16_t* pCounts, uint32_t* pDst, size_t count, const uint32_t* pPalette, uint32_t shift)
+    {
+        for (size_t i = 0; i < count; ++i)
+        {
+            uint32_t index = (static_cast<uint32_t>(pCounts[i]) << 8) >> shift;
+            if (index > 255) index = 255;
+            if (index == 0 && pCounts[i] != 0) index = 1;
+
+            pDst[i] = pPalette[index];
+        }
+    }
+
+#ifdef PIXELKERNELS_X86
+
+    // SSE2
+
+    inline __m128i Div255(__m128i x)
+    {
+        x = _mm_add_epi16(x, _mm_set1_epi16(128));
+        return _mm_srli_epi16(_mm_add_epi16(x, _mm_srli_epi16(x, 8)), 8);
+    }
+
+    // two pixels as 16-bit channels, with the coverage of each repeated in all four channels
+    inline __m128i BlendPixels(__m128i dst, __m128i coverage, __m128i src)
+    {
+        __m128i srcScaled = Div255(_mm_mullo_epi16(src, coverage));
+
+        __m128i alpha = _mm_shufflehi_epi16(_mm_shufflelo_epi16(srcScaled, _MM_SHUFFLE(3, 3, 3, 3)), _MM_SHUFFLE(3, 3, 3, 3));
+        __m128i inverse = _mm_sub_epi16(_mm_set1_epi16(255), alpha);
+
+        return _mm_add_epi16(srcScaled, Div255(_mm_mullo_epi16(dst, inverse)));
+    }
+
+    void FillSpanSSE2(uint32_t* pDst, size_t count, uint32_t pixel)
+    {
+        __m128i value = _mm_set1_epi32(static_cast<int>(pixel));
+
+        size_t i = 0;
+        for (; i + 4 <= count; i += 4) _mm_storeu_si128(reinterpret_cast<__m128i*>(pDst + i), value);
+
+        FillSpanScalar(pDst + i, count - i, pixel);
+    }
+
+    void BlendSpanSSE2(uint32_t* pDst, const uint8_t* pCoverage, size_t count, uint32_t src)
+    {
+        __m128i zero = _mm_setzero_si128();
+        __m128i src16 = _mm_unpacklo_epi8(_mm_set1_epi32(static_cast<int>(src)), zero);
+
+        size_t i = 0;
+        for (; i + 4 <= count; i += 4)
+        {
+            int32_t coverage4;
+            memcpy(&coverage4, pCoverage + i, sizeof(coverage4));
+            if (coverage4 == 0) continue;
+
+            __m128i coverage = _mm_cvtsi32_si128(coverage4);
+            coverage = _mm_unpacklo_epi8(coverage, coverage);
+            coverage = _mm_unpacklo_epi16(coverage, coverage);
+
+            __m128i* pPixels = reinterpret_cast<__m128i*>(pDst + i);
+            __m128i dst = _mm_loadu_si128(pPixels);
+
+            __m128i lo = BlendPixels(_mm_unpacklo_epi8(dst, zero), _mm_unpacklo_epi8(coverage, zero), src16);
+            __m128i hi = BlendPixels(_mm_unpackhi_epi8(dst, zero), _mm_unpackhi_epi8(coverage, zero), src16);
+
+            _mm_storeu_si128(pPixels, _mm_packus_epi16(lo, hi));
+        }
+
+        BlendSpanScalar(pDst + i, pCoverage + i, count - i, src);
+    }
+
+    void ConvertPointsSSE2(const int32_t* pXY, PointF* pDst, size_t count, PointF offset)
+    {
+        __m128 offset4 = _mm_setr_ps(offset.x, offset.y, offset.x, offset.y);
+
+        size_t i = 0;
+        for (; i + 2 <= count; i += 2)
+        {
+            __m128i xy = _mm_loadu_si128(reinterpret_cast<const __m128i*>(pXY + i * 2));
+            _mm_storeu_ps(reinterpret_cast<float*>(pDst + i), _mm_add_ps(_mm_cvtepi32_ps(xy), offset4));
+        }
+
+        ConvertPointsScalar(pXY + i * 2, pDst + i, count - i, offset);
+    }
+
+    void MapCountsSSE2(const uint16_t* pCounts, uint32_t* pDst, size_t count, const uint32_t* pPalette, uint32_t shift)
+    {
+        __m128i zero = _mm_setzero_si128();
+        __m128i one = _mm_set1_epi16(1);
+        __m128i shift128 = _mm_cvtsi32_si128(static_cast<int>(shift));
+
+        // SSE2 has no gather, the indices are worked out 8 at a time and looked up one by one
+        alignas(16) uint8_t indices[16];
+
+        size_t i = 0;
+        for (; i + 8 <= count; i += 8)
+        {
+            __m128i counts = _mm_loadu_si128(reinterpret_cast<const __m128i*>(pCounts + i));
+
+            // at most 2^24, so packing to int16 saturates them at 32767 and packing to uint8 at 255
+            __m128i lo = _mm_srl_epi32(_mm_slli_epi32(_mm_unpacklo_epi16(counts, zero), 8), shift128);
+            __m128i hi = _mm_srl_epi32(_mm_slli_epi32(_mm_unpackhi_epi16(counts, zero), 8), shift128);
+            __m128i index = _mm_packs_epi32(lo, hi);
+
+            __m128i nonZero = _mm_andnot_si128(_mm_cmpeq_epi16(counts, zero), one);
+            index = _mm_max_epi16(index, nonZero);
+
+            _mm_storel_epi64(reinterpret_cast<__m128i*>(indices), _mm_packus_epi16(index, index));
+            for (size_t j = 0; j < 8; ++j) pDst[i + j] = pPalette[indices[j]];
+        }
+
+        MapCountsScalar(pCounts + i, pDst + i, count - i, pPalette, shift);
+    }
+
+    // AVX2
+
+    TARGET_AVX2 inline __m256i Div255(__m256i x)
+    {
+        x = _mm256_add_epi16(x, _mm256_set1_epi16(128));
+        return _mm256_srli_epi16(_mm256_add_epi16(x, _mm256_srli_epi16(x, 8)), 8);
+    }
+
+    TARGET_AVX2 inline __m256i BlendPixels(__m256i dst, __m256i coverage, __m256i src)
+    {
+        __m256i srcScaled = Div255(_mm256_mullo_epi16(src, coverage));
+
+        __m256i alpha = _mm256_shufflehi_epi16(_mm256_shufflelo_epi16(srcScaled, _MM_SHUFFLE(3, 3, 3, 3)), _MM_SHUFFLE(3, 3, 3, 3));
+        __m256i inverse = _mm256_sub_epi16(_mm256_set1_epi16(255), alpha);
+
+        return _mm256_add_epi16(srcScaled, Div255(_mm256_mullo_epi16(dst, inverse)));
+    }
+
+    TARGET_AVX2 void FillSpanAVX2(uint32_t* pDst, size_t count, uint32_t pixel)
+    {
+        __m256i value = _mm256_set1_epi32(static_cast<int>(pixel));
+
+        size_t i = 0;
+        for (; i + 8 <= count; i += 8) _mm256_storeu_si256(reinterpret_cast<__m256i*>(pDst + i), value);
+
+        FillSpanSSE2(pDst + i, count - i, pixel);
+    }
+
+    TARGET_AVX2 void BlendSpanAVX2(uint32_t* pDst, const uint8_t* pCoverage, size_t count, uint32_t src)
+    {
+        __m256i zero = _mm256_setzero_si256();
+        __m256i src16 = _mm256_unpacklo_epi8(_mm256_set1_epi32(static_cast<int>(src)), zero);
+
+        size_t i = 0;
+        for (; i + 8 <= count; i += 8)
+        {
+            int64_t coverage8;
+            memcpy(&coverage8, pCoverage + i, sizeof(coverage8));
+            if (coverage8 == 0) continue;
+
+            // each 128-bit lane holds four pixels, and the coverage of those four repeated per channel
+            __m128i coverage = _mm_loadl_epi64(reinterpret_cast<const __m128i*>(pCoverage + i));
+            coverage = _mm_unpacklo_epi8(coverage, coverage);
+            __m256i coverage32 = _mm256_set_m128i(_mm_unpackhi_epi16(coverage, coverage), _mm_unpacklo_epi16(coverage, coverage));
+
+            __m256i* pPixels = reinterpret_cast<__m256i*>(pDst + i);
+            __m256i dst = _mm256_loadu_si256(pPixels);
+
+            __m256i lo = BlendPixels(_mm256_unpacklo_epi8(dst, zero), _mm256_unpacklo_epi8(coverage32, zero), src16);
+            __m256i hi = BlendPixels(_mm256_unpackhi_epi8(dst, zero), _mm256_unpackhi_epi8(coverage32, zero), src16);
+
+            _mm256_storeu_si256(pPixels, _mm256_packus_epi16(lo, hi));
+        }
+
+        BlendSpanSSE2(pDst + i, pCoverage + i, count - i, src);
+    }
+
+    TARGET_AVX2 void ConvertPointsAVX2(const int32_t* pXY, PointF* pDst, size_t count, PointF offset)
+    {
+        __m256 offset8 = _mm256_setr_ps(offset.x, offset.y, offset.x, offset.y, offset.x, offset.y, offset.x, offset.y);
+
+        size_t i = 0;
+        for (; i + 4 <= count; i += 4)
+        {
+            __m256i xy = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(pXY + i * 2));
+            _mm256_storeu_ps(reinterpret_cast<float*>(pDst + i), _mm256_add_ps(_mm256_cvtepi32_ps(xy), offset8));
+        }
+
+        ConvertPointsSSE2(pXY + i * 2, pDst + i, count - i, offset);
+    }
+
+    TARGET_AVX2 void MapCountsAVX2(const uint16_t* pCounts, uint32_t* pDst, size_t count, const uint32_t* pPalette, uint32_t shift)
+    {
+        __m256i zero = _mm256_setzero_si256();
+        __m256i one = _mm256_set1_epi32(1);
+        __m256i maxIndex = _mm256_set1_epi32(255);
+        __m128i shift128 = _mm_cvtsi32_si128(static_cast<int>(shift));
+
+        size_t i = 0;
+        for (; i + 8 <= count; i += 8)
+        {
+            __m256i counts = _mm256_cvtepu16_epi32(_mm_loadu_si128(reinterpret_cast<const __m128i*>(pCounts + i)));
+
+            __m256i index = _mm256_min_epu32(_mm256_srl_epi32(_mm256_slli_epi32(counts, 8), shift128), maxIndex);
+            index = _mm256_max_epu32(index, _mm256_andnot_si256(_mm256_cmpeq_epi32(counts, zero), one));
+
+            _mm256_storeu_si256(reinterpret_cast<__m256i*>(pDst + i), _mm256_i32gather_epi32(reinterpret_cast<const int*>(pPalette), index, 4));
+        }
+
+        MapCountsSSE2(pCounts + i, pDst + i, count - i, pPalette, shift);
+    }
+
+    bool IsAVX2Supported()
+    {
+#ifdef _MSC_VER
+        int info[4];
+        __cpuid(info, 0);
+        if (info[0] < 7) return false;
+
+        __cpuid(info, 1);
+        bool osxsave = (info[2] & (1 << 27)) != 0;
+        bool avx = (info[2] & (1 << 28)) != 0;
+        if (!osxsave || !avx) return false;
+
+        // the OS has to save the ymm registers on context switches
+        if ((_xgetbv(0) & 0x6) != 0x6) return false;
+
+        __cpuidex(info, 7, 0);
+        return (info[1] & (1 << 5)) != 0;
+#else
+        __builtin_cpu_init();
+        return __builtin_cpu_supports("avx2");
+#endif
+    }
+
+#endif
+
+    SimdLevel DetectLevel()
+    {
+#ifdef PIXELKERNELS_X86
+        return IsAVX2Supported() ? SimdLevel::AVX2 : SimdLevel::SSE2;
+#else
+        return SimdLevel::SCALAR;
+#endif
+    }
+
+    struct KernelTable
+    {
+        void (*fillSpan)(uint32_t*, size_t, uint32_t);
+        void (*blendSpan)(uint32_t*, const uint8_t*, size_t, uint32_t);
+        void (*convertPoints)(const int32_t*, PointF*, size_t, PointF);
+        void (*mapCounts)(const uint16_t*, uint32_t*, size_t, const uint32_t*, uint32_t);
+    };
+
+    const KernelTable SCALAR_KERNELS{ FillSpanScalar, BlendSpanScalar, ConvertPointsScalar, MapCountsScalar };
+#ifdef PIXELKERNELS_X86
+    const KernelTable SSE2_KERNELS{ FillSpanSSE2, BlendSpanSSE2, ConvertPointsSSE2, MapCountsSSE2 };
+    const KernelTable AVX2_KERNELS{ FillSpanAVX2, BlendSpanAVX2, ConvertPointsAVX2, MapCountsAVX2 };
+#endif
+
+    const KernelTable* GetTable(SimdLevel level)
+    {
+        switch (level)
+        {
+#ifdef PIXELKERNELS_X86
+        case SimdLevel::AVX2:
+            return &AVX2_KERNELS;
+        case SimdLevel::SSE2:
+            return &SSE2_KERNELS;
+#endif
+        default:
+            return &SCALAR_KERNELS;
+        }
+    }
+
+    std::atomic<SimdLevel>& GetLevelStorage()
+    {
+        static std::atomic<SimdLevel> level(DetectLevel());
+        return level;
+    }
+
+    inline const KernelTable& GetKernels()
+    {
+        return *GetTable(GetLevelStorage().load(std::memory_order_relaxed));
+    }
+}
+
+SimdLevel PixelKernels::GetSupportedLevel()
+{
+    static const SimdLevel supported = DetectLevel();
+    return supported;
+}
+
+SimdLevel PixelKernels::GetLevel()
+{
+    return GetLevelStorage().load(std::memory_order_relaxed);
+}
+
+void PixelKernels::SetLevel(SimdLevel level)
+{
+    SimdLevel supported = GetSupportedLevel();
+    GetLevelStorage().store(level < supported ? level : supported, std::memory_order_relaxed);
+}
+
+void PixelKernels::FillSpan(uint32_t* pDst, size_t count, uint32_t pixel)
+{
+    GetKernels().fillSpan(pDst, count, pixel);
+}
+
+void PixelKernels::BlendSpan(uint32_t* pDst, const uint8_t* pCoverage, size_t count, uint32_t src)
+{
+    GetKernels().blendSpan(pDst, pCoverage, count, src);
+}
+
+void PixelKernels::ConvertPoints(const int32_t* pXY, PointF* pDst, size_t count, PointF offset)
+{
+    GetKernels().convertPoints(pXY, pDst, count, offset);
+}
+
+void PixelKernels::MapCounts(const uint16_t* pCounts, uint32_t* pDst, size_t count, const uint32_t* pPalette, uint32_t shift)
+{
+    GetKernels().mapCounts(pCounts, pDst, count, pPalette, shift);
+}
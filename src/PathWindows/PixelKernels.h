@@ -0,0 +1,38 @@
+#pragma once
+#include "PathTypes.h"
+#include <cstdint>
+#include <cstddef>
+
+namespace PathWindows
+{
+    // Vectorized loops for the CPU side of drawing paths. Every kernel has a scalar, SSE2 and AVX2 version, the best
+    // one the CPU supports is picked the first time any of them runs. All versions produce exactly the same output.
+    namespace PixelKernels
+    {
+        enum class SimdLevel
+        {
+            SCALAR,
+            SSE2,
+            AVX2
+        };
+
+        SimdLevel GetSupportedLevel();
+        SimdLevel GetLevel();
+
+        // Limits the kernels to the given level (or the best supported one, if that is lower), e.g. to compare them.
+        void SetLevel(SimdLevel level);
+
+        // Sets count premultiplied BGRA pixels to pixel.
+        void FillSpan(uint32_t* pDst, size_t count, uint32_t pixel);
+
+        // Blends the premultiplied BGRA pixel src over count pixels, scaled by the 0 to 255 coverage of each.
+        void BlendSpan(uint32_t* pDst, const uint8_t* pCoverage, size_t count, uint32_t src);
+
+        // Converts count points given as x, y int32 pairs (like POINT) to floats and adds the offset.
+        void ConvertPoints(const int32_t* pXY, PointF* pDst, size_t count, PointF offset);
+
+        // Maps count counts to pixels of the 256 entry palette, each to pPalette[min((count << 8) >> shift, 255)], but
+        // counts above 0 at least to pPalette[1]. shift is at most 16.
+        void MapCounts(const uint16_t* pCounts, uint32_t* pDst, size_t count, const uint32_t* pPalette, uint32_t shift);
+    }
+}
@@ -0,0 +1,156 @@
+#include "pch.h"
+#include "PlaybackScheduler.h"
+#include "Win32PlaybackClock.h"
+#include "DrawablePathWindow.h"
+#include <vector>
+
+using namespace PathWindows;
+
+// Moves the cursor with SendInput. A batch of movements is sent with a single call, or only its last position is
+// when the movements are positions, since the ones before it would be overwritten within the batch threshold anyway.
+class SendInputSink : public PlaybackSink
+{
+public:
+    enum class Mode
+    {
+        // deltas, like MoveMouse with relativePos
+        RELATIVE,
+        // positions already converted to normalized absolute coordinates of the virtual desktop
+        ABSOLUTE,
+        // positions relative to the primary monitor, sent as deltas from where the cursor is
+        FROM_CURSOR,
+    };
+
+    SendInputSink() :
+        m_mode(Mode::RELATIVE)
+    {}
+
+    void SetMode(Mode mode)
+    {
+        m_mode = mode;
+    }
+
+    void Emit(const Movement* movements, size_t count, int64_t deadlineNS) override
+    {
+        m_inputs.clear();
+
+        if (m_mode == Mode::RELATIVE)
+        {
+            for (size_t i = 0; i < count; ++i) AddMove(movements[i].delta.x, movements[i].delta.y, MOUSEEVENTF_MOVE);
+        }
+        else if (m_mode == Mode::ABSOLUTE)
+        {
+            PointI last = movements[count - 1].delta;
+            AddMove(last.x, last.y, MOUSEEVENTF_MOVE | MOUSEEVENTF_ABSOLUTE | MOUSEEVENTF_VIRTUALDESK);
+        }
+        else
+        {
+            POINT cursor;
+            if (!GetCursorPos(&cursor)) return;
+
+            PointI last = movements[count - 1].delta;
+            AddMove(last.x - cursor.x, last.y - cursor.y, MOUSEEVENTF_MOVE);
+        }
+
+        SendInput(static_cast<UINT>(m_inputs.size()), m_inputs.data(), sizeof(INPUT));
+    }
+
+private:
+    Mode m_mode;
+    // reused for every batch
+    std::vector<INPUT> m_inputs;
+
+    void AddMove(int dx, int dy, DWORD flags)
+    {
+        INPUT input = {};
+        input.type = INPUT_MOUSE;
+        input.mi.dx = dx;
+        input.mi.dy = dy;
+        input.mi.dwFlags = flags;
+        m_inputs.push_back(input);
+    }
+};
+
+// Plays cursor paths on a thread of its own, see PlaybackScheduler.
+class CursorPlayback
+{
+public:
+    CursorPlayback() :
+        m_scheduler(m_clock, m_sink)
+    {}
+
+    bool Start(SendInputSink::Mode mode, const Movement* movements, size_t count)
+    {
+        // the sink is only read on the playback thread, which Start starts after this
+        if (m_scheduler.IsPlaying()) return false;
+        m_sink.SetMode(mode);
+
+        return m_scheduler.Start(movements, count);
+    }
+
+    bool Wait()
+    {
+        return m_scheduler.Wait();
+    }
+
+    void Cancel()
+    {
+        m_scheduler.Cancel();
+    }
+
+private:
+    Win32PlaybackClock m_clock;
+    SendInputSink m_sink;
+    PlaybackScheduler m_scheduler;
+};
+
+extern "C" __declspec(dllexport) HRESULT __cdecl CreateCursorPlayback(CursorPlayback** ppPlayback)
+{
+    if (!ppPlayback) return E_POINTER;
+
+    *ppPlayback = new CursorPlayback();
+
+    return S_OK;
+}
+
+// Cancels playback and waits for it to end first.
+extern "C" __declspec(dllexport) void __cdecl DestroyCursorPlayback(CursorPlayback* pPlayback)
+{
+    delete pPlayback;
+}
+
+// Copies the movements and starts moving the cursor, each movement after its delay. mode is a SendInputSink::Mode.
+// Fails with ERROR_BUSY if the last playback has not ended.
+extern "C" __declspec(dllexport) HRESULT __cdecl StartCursorPlayback(CursorPlayback* pPlayback, const MouseMovement* movements, int length, int mode)
+{
+    if (!pPlayback) return E_POINTER;
+    if (length < 0 || (length > 0 && !movements)) return E_INVALIDARG;
+    if (mode < static_cast<int>(SendInputSink::Mode::RELATIVE) || mode > static_cast<int>(SendInputSink::Mode::FROM_CURSOR)) return E_INVALIDARG;
+
+    if (!pPlayback->Start(static_cast<SendInputSink::Mode>(mode), reinterpret_cast<const Movement*>(movements), length))
+    {
+        return HRESULT_FROM_WIN32(ERROR_BUSY);
+    }
+
+    return S_OK;
+}
+
+// Blocks until playback ends, *pCompleted is set to whether it played everything instead of being cancelled.
+extern "C" __declspec(dllexport) HRESULT __cdecl WaitCursorPlayback(CursorPlayback* pPlayback, bool* pCompleted)
+{
+    if (!pPlayback || !pCompleted) return E_POINTER;
+
+    *pCompleted = pPlayback->Wait();
+
+    return S_OK;
+}
+
+// Can be called from any thread, playback ends within a few milliseconds.
+extern "C" __declspec(dllexport) HRESULT __cdecl CancelCursorPlayback(CursorPlayback* pPlayback)
+{
+    if (!pPlayback) return E_POINTER;
+
+    pPlayback->Cancel();
+
+    return S_OK;
+}
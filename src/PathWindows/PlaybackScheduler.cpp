@@ -0,0 +1,136 @@
+#include "PlaybackScheduler.h"
+#include <algorithm>
+
+using namespace PathWindows;
+
+PlaybackScheduler::PlaybackScheduler(PlaybackClock& clock, PlaybackSink& sink, const Options& options) :
+    m_clock(clock),
+    m_sink(sink),
+    m_options(options),
+    m_completed(false),
+    m_playing(false),
+    m_cancelled(false),
+    m_oversleepNS(options.minSpinNS)
+{}
+
+PlaybackScheduler::~PlaybackScheduler()
+{
+    Cancel();
+    if (m_thread.joinable()) m_thread.join();
+}
+
+bool PlaybackScheduler::Start(const Movement* movements, size_t count)
+{
+    if (m_playing.exchange(true)) return false;
+
+    // the last playback ended, but its thread was never waited for
+    if (m_thread.joinable()) m_thread.join();
+
+    m_movements.assign(movements, movements + count);
+    m_cancelled.store(false);
+
+    m_thread = std::thread([this]()
+    {
+        m_clock.OnThreadStarted();
+        m_completed = Run(m_movements.data(), m_movements.size());
+    });
+
+    return true;
+}
+
+bool PlaybackScheduler::Wait()
+{
+    if (m_thread.joinable()) m_thread.join();
+
+    return m_completed;
+}
+
+bool PlaybackScheduler::Play(const Movement* movements, size_t count)
+{
+    if (m_playing.exchange(true)) return false;
+
+    m_cancelled.store(false);
+
+    return Run(movements, count);
+}
+
+bool PlaybackScheduler::Run(const Movement* movements, size_t count)
+{
+    int64_t start = m_clock.Now();
+    int64_t elapsed = 0;
+    bool completed = true;
+
+    for (size_t i = 0; i < count;)
+    {
+        elapsed += std::max<int64_t>(movements[i].delayDurationNS, 0);
+        int64_t deadline = start + elapsed;
+
+        int64_t now;
+        if (!WaitUntil(deadline, now))
+        {
+            completed = false;
+            break;
+        }
+
+        size_t end = i + 1;
+        while (end < count)
+        {
+            int64_t next = elapsed + std::max<int64_t>(movements[end].delayDurationNS, 0);
+            if (start + next > now + m_options.batchThresholdNS) break;
+
+            elapsed = next;
+            ++end;
+        }
+
+        m_sink.Emit(movements + i, end - i, deadline);
+        i = end;
+    }
+
+    m_playing.store(false);
+
+    return completed;
+}
+
+bool PlaybackScheduler::WaitUntil(int64_t deadlineNS, int64_t& nowNS)
+{
+    while (!m_cancelled.load(std::memory_order_relaxed))
+    {
+        nowNS = m_clock.Now();
+
+        int64_t remaining = deadlineNS - nowNS;
+        if (remaining <= 0) return true;
+
+        int64_t spin = GetSpinDuration();
+        if (remaining <= spin)
+        {
+            m_clock.Pause();
+            continue;
+        }
+
+        int64_t sleep = std::min(remaining - spin, m_options.maxSleepNS);
+        m_clock.Sleep(sleep);
+
+        // follows a later wake up right away, and earlier ones slowly
+        int64_t oversleep = std::max<int64_t>(m_clock.Now() - nowNS - sleep, 0);
+        if (oversleep > m_oversleepNS) m_oversleepNS = oversleep;
+        else m_oversleepNS -= (m_oversleepNS - oversleep) / 64;
+    }
+
+    return false;
+}
+
+void PlaybackScheduler::Cancel()
+{
+    m_cancelled.store(true);
+}
+
+bool PlaybackScheduler::IsPlaying() const
+{
+    return m_playing.load();
+}
+
+int64_t PlaybackScheduler::GetSpinDuration() const
+{
+    // a quarter more than sleeps have been waking up late, which leaves room for the ones that wake up later still
+    return std::clamp(m_oversleepNS + m_oversleepNS / 4, m_options.minSpinNS, m_options.maxSpinNS);
+}
@@ -0,0 +1,102 @@
+#pragma once
+#include "PathTypes.h"
+#include <vector>
+#include <thread>
+#include <atomic>
+#include <cstdint>
+#include <cstddef>
+
+namespace PathWindows
+{
+    // What a PlaybackScheduler reads the time from and waits with. Times are in nanoseconds, from any monotonic clock.
+    class PlaybackClock
+    {
+    public:
+        virtual ~PlaybackClock() {};
+
+        virtual int64_t Now() = 0;
+
+        // Blocks for about durationNS, it is fine to wake up late, or a little early.
+        virtual void Sleep(int64_t durationNS) = 0;
+
+        // Called between reads of Now while spinning.
+        virtual void Pause() {};
+
+        // Called on the playback thread before it plays anything.
+        virtual void OnThreadStarted() {};
+    };
+
+    // Where a PlaybackScheduler sends the movements when they are due.
+    class PlaybackSink
+    {
+    public:
+        virtual ~PlaybackSink() {};
+
+        // movements (at least one) were batched because they were due within a short time of each other, and the
+        // first of them was due at deadlineNS.
+        virtual void Emit(const Movement* movements, size_t count, int64_t deadlineNS) = 0;
+    };
+
+    // Plays movements at the times their delays add up to. Every deadline is counted from the start of playback,
+    // so a wait that ends late is made up by the ones after it instead of delaying everything that follows.
+    // It sleeps until shortly before a deadline and spins for the rest, a little longer than the clock's sleeps have
+    // recently been waking up late. Movements due within a batch threshold of the one waited for (or already
+    // overdue) are emitted with it, rather than each waiting for a few microseconds.
+    class PlaybackScheduler
+    {
+    public:
+        struct Options
+        {
+            int64_t batchThresholdNS;
+            // the least and most to spin before a deadline
+            int64_t minSpinNS;
+            int64_t maxSpinNS;
+            // sleeps are split up into ones this long at most, so Cancel does not wait for a long one to end
+            int64_t maxSleepNS;
+        };
+
+        static constexpr Options DEFAULT_OPTIONS{ 100'000, 250'000, 4'000'000, 10'000'000 };
+
+        // The clock and sink must outlive the scheduler.
+        PlaybackScheduler(PlaybackClock& clock, PlaybackSink& sink, const Options& options = DEFAULT_OPTIONS);
+        // Cancels playback and waits for its thread.
+        ~PlaybackScheduler();
+
+        // Copies the movements and plays them on a thread of its own. Returns false if it is already playing.
+        bool Start(const Movement* movements, size_t count);
+        // Waits until the thread Start started ends. Returns whether it played everything.
+        bool Wait();
+
+        // Plays the movements on the calling thread. Returns whether it played everything, which it does not if it
+        // is already playing.
+        bool Play(const Movement* movements, size_t count);
+
+        // Stops playback within maxSleepNS. Can be called from any thread.
+        void Cancel();
+
+        bool IsPlaying() const;
+
+        // How long it currently spins before a deadline.
+        int64_t GetSpinDuration() const;
+
+    private:
+        PlaybackClock& m_clock;
+        PlaybackSink& m_sink;
+        Options m_options;
+
+        std::vector<Movement> m_movements;
+        std::thread m_thread;
+        bool m_completed;
+
+        std::atomic<bool> m_playing;
+        std::atomic<bool> m_cancelled;
+
+        // how late sleeps have recently been waking up
+        int64_t m_oversleepNS;
+
+        // Ends with m_playing set to false.
+        bool Run(const Movement* movements, size_t count);
+        // Sets nowNS to the time it woke up at, returns false if it was cancelled.
+        bool WaitUntil(int64_t deadlineNS, int64_t& nowNS);
+    };
+}
@@ -0,0 +1,128 @@
+#pragma once
+#include "PathTypes.h"
+#include <vector>
+#include <cstddef>
+
+namespace PathWindows
+{
+    // Drops points from a polyline as they stream in, so that every dropped point lies within the tolerance
+    // (in pixels) of the segment that replaced it.
+    // Points only ever get appended to the output: a point is emitted once it is known to be kept, the run
+    // since the last emitted point is held back until then (or until Flush is called).
+    class PolylineSimplifier
+    {
+    public:
+        explicit PolylineSimplifier(float tolerance = 0.0f) :
+            m_tolerance(tolerance),
+            m_hasAnchor(false),
+            m_anchor{}
+        {
+            m_run.reserve(MAX_RUN_LENGTH);
+        }
+
+        // A tolerance of 0 or less disables simplification.
+        void SetTolerance(float tolerance)
+        {
+            m_tolerance = tolerance;
+        }
+
+        float GetTolerance() const
+        {
+            return m_tolerance;
+        }
+
+        // Calls emit(PointF) for every point that is now known to be part of the simplified polyline.
+        template<class Emit>
+        void Add(PointF point, Emit&& emit)
+        {
+            if (!m_hasAnchor || m_tolerance <= 0.0f)
+            {
+                Flush(emit);
+                m_anchor = point;
+                m_hasAnchor = true;
+                emit(point);
+                return;
+            }
+
+            if (m_run.size() >= MAX_RUN_LENGTH || !RunFitsSegment(point))
+            {
+                // the last point that still fit becomes the start of the next segment
+                m_anchor = m_run.back();
+                m_run.clear();
+                emit(m_anchor);
+            }
+
+            m_run.push_back(point);
+        }
+
+        // Emits the point that ends the current run, if any, so that the output ends at the last point added.
+        template<class Emit>
+        void Flush(Emit&& emit)
+        {
+            if (m_run.empty()) return;
+
+            m_anchor = m_run.back();
+            m_run.clear();
+            emit(m_anchor);
+        }
+
+        // The segment the held back run would be replaced with if it ended now, from the last point emitted to the
+        // last point added. Returns false if nothing is held back.
+        bool GetPendingSegment(PointF& from, PointF& to) const
+        {
+            if (m_run.empty()) return false;
+
+            from = m_anchor;
+            to = m_run.back();
+            return true;
+        }
+
+        // Starts a new polyline, discarding anything that was not emitted yet.
+        void Reset()
+        {
+            m_hasAnchor = false;
+            m_run.clear();
+        }
+
+    private:
+        // bounds the work done per point
+        static constexpr size_t MAX_RUN_LENGTH = 64;
+
+        float m_tolerance;
+
+        bool m_hasAnchor;
+        PointF m_anchor;
+
+        // points added since the anchor, the last of which would end the segment if the run ended now
+        std::vector<PointF> m_run;
+
+        bool RunFitsSegment(PointF end) const
+        {
+            float toleranceSq = m_tolerance * m_tolerance;
+            for (auto&& point : m_run)
+            {
+                if (DistanceToSegmentSq(point, m_anchor, end) > toleranceSq) return false;
+            }
+
+            return true;
+        }
+
+        static float DistanceToSegmentSq(PointF p, PointF a, PointF b)
+        {
+            float dx = b.x - a.x;
+            float dy = b.y - a.y;
+            float lengthSq = dx * dx + dy * dy;
+
+            float t = 0.0f;
+            if (lengthSq > 0.0f)
+            {
+                t = ((p.x - a.x) * dx + (p.y - a.y) * dy) / lengthSq;
+                t = t < 0.0f ? 0.0f : (t > 1.0f ? 1.0f : t);
+            }
+
+            float ex = a.x + t * dx - p.x;
+            float ey = a.y + t * dy - p.y;
+            return ex * ex + ey * ey;
+        }
+    };
+}
@@ -0,0 +1,50 @@
+#pragma once
+#include <algorithm>
+#include <memory>
+#include <mutex>
+#include <vector>
+
+namespace PathWindows
+{
+    // Objects handed to another thread through a pointer in a posted message. They stay owned here until the
+    // message is handled, so whatever is still queued when the receiver goes away (and its messages are dropped)
+    // is freed with this instead of leaked. Few are ever in flight at once, so they are kept in a plain vector.
+    template<class T>
+    class PostedObjects
+    {
+    public:
+        // Returns the pointer to post.
+        T* Add(std::unique_ptr<T> pObject)
+        {
+            std::lock_guard<std::mutex> lock(m_mutex);
+
+            T* p = pObject.get();
+            m_objects.push_back(std::move(pObject));
+            return p;
+        }
+
+        // Gives up ownership of an object that was posted, or takes back one whose message could not be posted.
+        // Returns null for a pointer that is not held here.
+        std::unique_ptr<T> Take(T* p)
+        {
+            std::lock_guard<std::mutex> lock(m_mutex);
+
+            auto it = std::find_if(m_objects.begin(), m_objects.end(), [p](const std::unique_ptr<T>& pObject) { return pObject.get() == p; });
+            if (it == m_objects.end()) return nullptr;
+
+            std::unique_ptr<T> pObject = std::move(*it);
+            m_objects.erase(it);
+            return pObject;
+        }
+
+        size_t GetCount()
+        {
+            std::lock_guard<std::mutex> lock(m_mutex);
+            return m_objects.size();
+        }
+
+    private:
+        std::mutex m_mutex;
+        std::vector<std::unique_ptr<T>> m_objects;
+    };
+}
@@ -0,0 +1,50 @@
+#pragma once
+#include "pch.h"
+#include "PathTypes.h"
+#include <cstddef>
+
+namespace PathWindows
+{
+    // What PathWindow draws with. A backend draws into a retained bitmap the size of the window, which keeps its
+    // contents between frames and is handed to UpdateLayeredWindowIndirect through a GDI DC.
+    // All drawing happens between BeginDraw and EndDraw, and the DC is only valid until ReleaseDC.
+    class RenderBackend
+    {
+    public:
+        virtual ~RenderBackend() {};
+
+        // Creates the resources that do not depend on the device.
+        virtual HRESULT Initialize() = 0;
+
+        virtual bool HasResources() = 0;
+        virtual HRESULT CreateResources(int width, int height) = 0;
+        virtual void DiscardResources() = 0;
+
+        virtual void BeginDraw() = 0;
+
+        virtual void Clear(ColorF color) = 0;
+        virtual void Clear(RectI rect, ColorF color) = 0;
+
+        // Everything added between BeginStroke and EndStroke is stroked as one geometry.
+        virtual HRESULT BeginStroke() = 0;
+        virtual void AddPolyline(const PointF* points, size_t count) = 0;
+        virtual HRESULT EndStroke() = 0;
+
+        // The color of the strokes ended from now on, until it is set again.
+        virtual void SetStrokeColor(ColorF color) = 0;
+
+        // Strokes begun and ended between PushClip and PopClip only change the pixels in rect. Clips do not nest.
+        virtual void PushClip(RectI rect) = 0;
+        virtual void PopClip() = 0;
+
+        // Replaces the pixels in rect (which must lie within the bitmap) with premultiplied BGRA pixels, stride is in pixels.
+        virtual HRESULT CopyPixels(RectI rect, const uint32_t* pPixels, size_t stride) = 0;
+
+        virtual HRESULT GetDC(HDC* pDC) = 0;
+        virtual void ReleaseDC() = 0;
+
+        // Also ends a stroke or a clip that a failed frame left open.
+        // Returns D2DERR_RECREATE_TARGET if the resources were lost and have to be created again.
+        virtual HRESULT EndDraw() = 0;
+    };
+}
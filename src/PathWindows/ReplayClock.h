@@ -0,0 +1,72 @@
+#pragma once
+#include <cstdint>
+
+namespace PathWindows
+{
+    // The time a replay is at, which moves at speed times the pace of the clock it is read with while playing.
+    // Changing the speed or pausing does not make it jump. Like FrameScheduler it does not read a clock itself,
+    // the current time (in nanoseconds, from any monotonic clock) is passed to it.
+    class ReplayClock
+    {
+    public:
+        ReplayClock() :
+            m_speed(1.0),
+            m_originNS(0),
+            m_startNS(0),
+            m_playing(false)
+        {}
+
+        bool IsPlaying() const
+        {
+            return m_playing;
+        }
+
+        void Play(int64_t nowNS)
+        {
+            if (m_playing) return;
+
+            m_startNS = nowNS;
+            m_playing = true;
+        }
+
+        void Pause(int64_t nowNS)
+        {
+            if (!m_playing) return;
+
+            m_originNS = GetTime(nowNS);
+            m_playing = false;
+        }
+
+        void Seek(int64_t timeNS, int64_t nowNS)
+        {
+            m_originNS = timeNS;
+            m_startNS = nowNS;
+        }
+
+        double GetSpeed() const
+        {
+            return m_speed;
+        }
+
+        // speed must be above 0.
+        void SetSpeed(double speed, int64_t nowNS)
+        {
+            Seek(GetTime(nowNS), nowNS);
+            m_speed = speed;
+        }
+
+        int64_t GetTime(int64_t nowNS) const
+        {
+            if (!m_playing) return m_originNS;
+
+            return m_originNS + static_cast<int64_t>(static_cast<double>(nowNS - m_startNS) * m_speed);
+        }
+
+    private:
+        double m_speed;
+        // the time it was at when it was last started, sought or sped up, and when that was
+        int64_t m_originNS;
+        int64_t m_startNS;
+        bool m_playing;
+    };
+}
@@ -0,0 +1,76 @@
+#include "ReplayTimeline.h"
+#include <algorithm>
+
+using namespace PathWindows;
+
+ReplayTimeline::ReplayTimeline()
+{}
+
+void ReplayTimeline::Assign(const Movement* movements, size_t count)
+{
+    m_times.resize(count);
+    m_positions.resize(count);
+
+    int64_t time = 0;
+    for (size_t i = 0; i < count; ++i)
+    {
+        time += std::max<int64_t>(movements[i].delayDurationNS, 0);
+        m_times[i] = time;
+        m_positions[i] = movements[i].delta;
+    }
+}
+
+void ReplayTimeline::Clear()
+{
+    m_times.clear();
+    m_positions.clear();
+}
+
+size_t ReplayTimeline::GetCount() const
+{
+    return m_times.size();
+}
+
+int64_t ReplayTimeline::GetDuration() const
+{
+    return m_times.empty() ? 0 : m_times.back();
+}
+
+int64_t ReplayTimeline::GetTime(size_t index) const
+{
+    return m_times[index];
+}
+
+PointI ReplayTimeline::GetPosition(size_t index) const
+{
+    return m_positions[index];
+}
+
+bool ReplayTimeline::StartsFigure(size_t index) const
+{
+    // the prefix sums only stay the same across a movement without a delay
+    return index == 0 || m_times[index] == m_times[index - 1];
+}
+
+size_t ReplayTimeline::Seek(int64_t timeNS) const
+{
+    return static_cast<size_t>(std::upper_bound(m_times.begin(), m_times.end(), timeNS) - m_times.begin());
+}
+
+size_t ReplayTimeline::Step(size_t reachedCount, int64_t timeNS) const
+{
+    size_t count = m_times.size();
+    if (reachedCount > count || (reachedCount > 0 && m_times[reachedCount - 1] > timeNS)) return Seek(timeNS);
+
+    // find a bound past the answer by doubling the step, then search between the last two bounds
+    size_t low = reachedCount;
+    size_t step = 1;
+    while (low + step <= count && m_times[low + step - 1] <= timeNS)
+    {
+        low += step;
+        step *= 2;
+    }
+
+    size_t high = std::min(low + step, count);
+    return static_cast<size_t>(std::upper_bound(m_times.begin() + low, m_times.begin() + high, timeNS) - m_times.begin());
+}
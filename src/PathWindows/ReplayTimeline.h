@@ -0,0 +1,45 @@
+#pragma once
+#include "PathTypes.h"
+#include <vector>
+#include <cstdint>
+#include <cstddef>
+
+namespace PathWindows
+{
+    // When each movement of a path is made if it is replayed from time 0, as prefix sums of their delays, so finding
+    // how far a replay got by any time is a binary search. A movement is made once its delay has passed after the one
+    // before it, and one without a delay starts a new figure, like in the paths DrawablePathWindow takes.
+    // Times are in nanoseconds.
+    class ReplayTimeline
+    {
+    public:
+        ReplayTimeline();
+
+        // Negative delays count as none.
+        void Assign(const Movement* movements, size_t count);
+
+        void Clear();
+
+        size_t GetCount() const;
+
+        // When the last movement is made.
+        int64_t GetDuration() const;
+
+        int64_t GetTime(size_t index) const;
+        PointI GetPosition(size_t index) const;
+        bool StartsFigure(size_t index) const;
+
+        // How many movements have been made by timeNS.
+        size_t Seek(int64_t timeNS) const;
+
+        // Like Seek, starting from reachedCount, what it returned for an earlier time. Searches forward in steps that
+        // double, so it costs O(log k) for the k movements made in between, which is O(1) when called every frame.
+        // A time before the one reachedCount was found for is sought from scratch.
+        size_t Step(size_t reachedCount, int64_t timeNS) const;
+
+    private:
+        // kept apart from the positions, so a search only reads times
+        std::vector<int64_t> m_times;
+        std::vector<PointI> m_positions;
+    };
+}
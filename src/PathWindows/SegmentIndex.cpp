@@ -0,0 +1,104 @@
+#include "SegmentIndex.h"
+#include <algorithm>
+#include <cmath>
+
+using namespace PathWindows;
+
+SegmentIndex::SegmentIndex(int32_t width, int32_t height, int32_t cellSize) :
+    m_cellSize(std::max(cellSize, 1)),
+    m_columns(std::max((width + m_cellSize - 1) / m_cellSize, 1)),
+    m_rows(std::max((height + m_cellSize - 1) / m_cellSize, 1)),
+    m_cells(static_cast<size_t>(m_columns) * m_rows),
+    m_count(0)
+{}
+
+int32_t SegmentIndex::ToColumn(float x) const
+{
+    // compared as floats first, a position far off the surface does not fit in an int
+    float column = std::floor(x / m_cellSize);
+    if (!(column > 0.0f)) return 0;
+    if (column >= static_cast<float>(m_columns - 1)) return m_columns - 1;
+
+    return static_cast<int32_t>(column);
+}
+
+int32_t SegmentIndex::ToRow(float y) const
+{
+    float row = std::floor(y / m_cellSize);
+    if (!(row > 0.0f)) return 0;
+    if (row >= static_cast<float>(m_rows - 1)) return m_rows - 1;
+
+    return static_cast<int32_t>(row);
+}
+
+template<class Fn>
+void SegmentIndex::ForEachCell(PointF a, PointF b, Fn&& fn)
+{
+    // a little slack, so that rounding never leaves out a cell the segment touches
+    constexpr float slack = 0.5f;
+
+    int32_t firstRow = ToRow(std::min(a.y, b.y) - slack);
+    int32_t lastRow = ToRow(std::max(a.y, b.y) + slack);
+
+    float dy = b.y - a.y;
+
+    for (int32_t row = firstRow; row <= lastRow; ++row)
+    {
+        // clip the segment to the band of the row (the border rows reach out forever), and take the columns between
+        // where it enters and leaves the band, the same way TileGrid::MarkSegment does
+        float t0 = 0.0f;
+        float t1 = 1.0f;
+        if (dy != 0.0f && firstRow != lastRow)
+        {
+            float bandTop = row == 0 ? -INFINITY : static_cast<float>(row * m_cellSize) - slack;
+            float bandBottom = row == m_rows - 1 ? INFINITY : static_cast<float>((row + 1) * m_cellSize) + slack;
+
+            float tTop = (bandTop - a.y) / dy;
+            float tBottom = (bandBottom - a.y) / dy;
+            t0 = std::max(std::min(tTop, tBottom), 0.0f);
+            t1 = std::min(std::max(tTop, tBottom), 1.0f);
+        }
+
+        float x0 = a.x + (b.x - a.x) * t0;
+        float x1 = a.x + (b.x - a.x) * t1;
+
+        int32_t firstColumn = ToColumn(std::min(x0, x1) - slack);
+        int32_t lastColumn = ToColumn(std::max(x0, x1) + slack);
+
+        std::vector<uint32_t>* pRow = m_cells.data() + static_cast<size_t>(row) * m_columns;
+        for (int32_t column = firstColumn; column <= lastColumn; ++column) fn(pRow[column]);
+    }
+}
+
+void SegmentIndex::Insert(uint32_t id, PointF a, PointF b)
+{
+    ForEachCell(a, b, [id](std::vector<uint32_t>& cell) { cell.push_back(id); });
+    ++m_count;
+}
+
+void SegmentIndex::Remove(uint32_t id, PointF a, PointF b)
+{
+    ForEachCell(a, b, [id](std::vector<uint32_t>& cell)
+    {
+        // cells hold few segments, and their order does not matter
+        auto it = std::find(cell.begin(), cell.end(), id);
+        if (it == cell.end()) return;
+
+        *it = cell.back();
+        cell.pop_back();
+    });
+    --m_count;
+}
+
+void SegmentIndex::Clear()
+{
+    if (m_count == 0) return;
+
+    for (auto&& cell : m_cells) cell.clear();
+    m_count = 0;
+}
+
+size_t SegmentIndex::GetCount() const
+{
+    return m_count;
+}
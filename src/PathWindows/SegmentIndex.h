@@ -0,0 +1,58 @@
+#pragma once
+#include "PathTypes.h"
+#include <vector>
+#include <cstdint>
+#include <cstddef>
+
+namespace PathWindows
+{
+    // Finds the segments near a point without looking at all of them: a uniform grid of cells over a surface, each
+    // listing the ids of the segments that pass through it. Anything beyond the surface falls into the border cells.
+    class SegmentIndex
+    {
+    public:
+        SegmentIndex(int32_t width, int32_t height, int32_t cellSize = 32);
+
+        // A segment from a point to itself is a point.
+        void Insert(uint32_t id, PointF a, PointF b);
+        // a and b must be the ones the segment was inserted with.
+        void Remove(uint32_t id, PointF a, PointF b);
+
+        void Clear();
+
+        size_t GetCount() const;
+
+        // Calls fn(uint32_t id) for every segment in the cells the box from min to max touches, which includes every
+        // segment that passes through the box. Segments in more than one of the cells are passed more than once.
+        template<class Fn>
+        void ForEachCandidate(PointF min, PointF max, Fn&& fn) const
+        {
+            int32_t firstColumn = ToColumn(min.x);
+            int32_t lastColumn = ToColumn(max.x);
+            int32_t lastRow = ToRow(max.y);
+
+            for (int32_t row = ToRow(min.y); row <= lastRow; ++row)
+            {
+                for (int32_t column = firstColumn; column <= lastColumn; ++column)
+                {
+                    for (uint32_t id : m_cells[static_cast<size_t>(row) * m_columns + column]) fn(id);
+                }
+            }
+        }
+
+    private:
+        int32_t m_cellSize;
+        int32_t m_columns;
+        int32_t m_rows;
+
+        std::vector<std::vector<uint32_t>> m_cells;
+        size_t m_count;
+
+        int32_t ToColumn(float x) const;
+        int32_t ToRow(float y) const;
+
+        // Calls fn(std::vector<uint32_t>& cell) for every cell the segment passes through.
+        template<class Fn>
+        void ForEachCell(PointF a, PointF b, Fn&& fn);
+    };
+}
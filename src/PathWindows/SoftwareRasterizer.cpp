@@ -0,0 +1,220 @@
+#include "SoftwareRasterizer.h"
+#include "PixelKernels.h"
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+
+using namespace PathWindows;
+
+namespace
+{
+    // long segments are split up so the pixels tested for each piece stay close to it
+    constexpr float MAX_PIECE_LENGTH = 8.0f;
+
+    inline uint32_t ToPremultipliedBGRA(ColorF color)
+    {
+        auto channel = [](float value) { return static_cast<uint32_t>(std::clamp(value, 0.0f, 1.0f) * 255.0f + 0.5f); };
+
+        return channel(color.b * color.a)
+            | (channel(color.g * color.a) << 8)
+            | (channel(color.r * color.a) << 16)
+            | (channel(color.a) << 24);
+    }
+
+    inline float DistanceToSegment(float px, float py, PointF a, PointF b)
+    {
+        float dx = b.x - a.x;
+        float dy = b.y - a.y;
+        float lengthSq = dx * dx + dy * dy;
+
+        float t = 0.0f;
+        if (lengthSq > 0.0f) t = std::clamp(((px - a.x) * dx + (py - a.y) * dy) / lengthSq, 0.0f, 1.0f);
+
+        float ex = a.x + t * dx - px;
+        float ey = a.y + t * dy - py;
+        return std::sqrt(ex * ex + ey * ey);
+    }
+}
+
+SoftwareRasterizer::SoftwareRasterizer() :
+    m_pPixels(nullptr),
+    m_width(0),
+    m_height(0),
+    m_stride(0),
+    m_clip{},
+    m_top(0),
+    m_bottom(-1)
+{}
+
+void SoftwareRasterizer::SetTarget(uint8_t* pPixels, int32_t width, int32_t height, int32_t stride)
+{
+    m_pPixels = pPixels;
+    m_width = pPixels ? std::max(width, 0) : 0;
+    m_height = pPixels ? std::max(height, 0) : 0;
+    m_stride = stride;
+    m_clip = RectI{ 0, 0, m_width, m_height };
+
+    m_coverage.assign(static_cast<size_t>(m_width) * m_height, 0);
+    m_rowLeft.assign(m_height, m_width);
+    m_rowRight.assign(m_height, -1);
+    m_top = m_height;
+    m_bottom = -1;
+}
+
+int32_t SoftwareRasterizer::GetWidth() const
+{
+    return m_width;
+}
+
+int32_t SoftwareRasterizer::GetHeight() const
+{
+    return m_height;
+}
+
+void SoftwareRasterizer::Clear(ColorF color)
+{
+    Clear(RectI{ 0, 0, m_width, m_height }, color);
+}
+
+void SoftwareRasterizer::Clear(RectI rect, ColorF color)
+{
+    int32_t left = std::max(rect.left, 0);
+    int32_t top = std::max(rect.top, 0);
+    int32_t right = std::min(rect.right, m_width);
+    int32_t bottom = std::min(rect.bottom, m_height);
+    if (left >= right || top >= bottom) return;
+
+    uint32_t pixel = ToPremultipliedBGRA(color);
+    for (int32_t y = top; y < bottom; ++y)
+    {
+        uint32_t* pRow = reinterpret_cast<uint32_t*>(m_pPixels + static_cast<size_t>(y) * m_stride);
+        PixelKernels::FillSpan(pRow + left, right - left, pixel);
+    }
+}
+
+void SoftwareRasterizer::CopyPixels(RectI rect, const uint32_t* pPixels, size_t stride)
+{
+    int32_t left = std::max(rect.left, 0);
+    int32_t top = std::max(rect.top, 0);
+    int32_t right = std::min(rect.right, m_width);
+    int32_t bottom = std::min(rect.bottom, m_height);
+    if (left >= right || top >= bottom) return;
+
+    for (int32_t y = top; y < bottom; ++y)
+    {
+        const uint32_t* pSrc = pPixels + static_cast<size_t>(y - rect.top) * stride + (left - rect.left);
+        uint8_t* pRow = m_pPixels + static_cast<size_t>(y) * m_stride + static_cast<size_t>(left) * 4;
+        std::memcpy(pRow, pSrc, static_cast<size_t>(right - left) * 4);
+    }
+}
+
+void SoftwareRasterizer::SetClip(RectI rect)
+{
+    m_clip = RectI{ std::max(rect.left, 0), std::max(rect.top, 0), std::min(rect.right, m_width), std::min(rect.bottom, m_height) };
+}
+
+void SoftwareRasterizer::AddPolyline(const PointF* points, size_t count, float width)
+{
+    if (!m_pPixels || count < 2) return;
+
+    // capsules around every segment, their round ends make the joins round
+    for (size_t i = 1; i < count; ++i) AddSegment(points[i - 1], points[i], width / 2.0f);
+}
+
+void SoftwareRasterizer::FillStroke(ColorF color)
+{
+    uint32_t src = ToPremultipliedBGRA(color);
+
+    for (int32_t y = m_top; y <= m_bottom; ++y)
+    {
+        int32_t left = m_rowLeft[y];
+        int32_t right = m_rowRight[y];
+        if (left > right) continue;
+
+        const uint8_t* pCoverage = m_coverage.data() + static_cast<size_t>(y) * m_width;
+        uint32_t* pRow = reinterpret_cast<uint32_t*>(m_pPixels + static_cast<size_t>(y) * m_stride);
+
+        PixelKernels::BlendSpan(pRow + left, pCoverage + left, right - left + 1, src);
+    }
+
+    ResetCoverage();
+}
+
+void SoftwareRasterizer::AddSegment(PointF a, PointF b, float halfWidth)
+{
+    float dx = b.x - a.x;
+    float dy = b.y - a.y;
+    float length = std::sqrt(dx * dx + dy * dy);
+
+    // the capsules of consecutive pieces add up to the capsule of the whole segment
+    int pieces = std::max(static_cast<int>(std::ceil(length / MAX_PIECE_LENGTH)), 1);
+    PointF start = a;
+    for (int i = 1; i <= pieces; ++i)
+    {
+        PointF end = i == pieces ? b : PointF{ a.x + dx * i / pieces, a.y + dy * i / pieces };
+        AddCapsule(start, end, halfWidth);
+        start = end;
+    }
+}
+
+void SoftwareRasterizer::AddCapsule(PointF a, PointF b, float halfWidth)
+{
+    // coverage falls off linearly over the pixel straddling the edge
+    float reach = halfWidth + 0.5f;
+
+    int32_t left = std::max(static_cast<int32_t>(std::floor(std::min(a.x, b.x) - reach)), m_clip.left);
+    int32_t top = std::max(static_cast<int32_t>(std::floor(std::min(a.y, b.y) - reach)), m_clip.top);
+    int32_t right = std::min(static_cast<int32_t>(std::ceil(std::max(a.x, b.x) + reach)), m_clip.right - 1);
+    int32_t bottom = std::min(static_cast<int32_t>(std::ceil(std::max(a.y, b.y) + reach)), m_clip.bottom - 1);
+    if (left > right || top > bottom) return;
+
+    for (int32_t y = top; y <= bottom; ++y)
+    {
+        uint8_t* pCoverage = m_coverage.data() + static_cast<size_t>(y) * m_width;
+        float py = y + 0.5f;
+
+        int32_t rowLeft = right + 1;
+        int32_t rowRight = left - 1;
+        for (int32_t x = left; x <= right; ++x)
+        {
+            float coverage = reach - DistanceToSegment(x + 0.5f, py, a, b);
+            if (coverage <= 0.0f) continue;
+
+            uint8_t value = static_cast<uint8_t>(std::min(coverage, 1.0f) * 255.0f + 0.5f);
+            pCoverage[x] = std::max(pCoverage[x], value);
+
+            rowLeft = std::min(rowLeft, x);
+            rowRight = x;
+        }
+
+        if (rowLeft > rowRight) continue;
+
+        m_rowLeft[y] = std::min(m_rowLeft[y], rowLeft);
+        m_rowRight[y] = std::max(m_rowRight[y], rowRight);
+        m_top = std::min(m_top, y);
+        m_bottom = std::max(m_bottom, y);
+    }
+}
+
+void SoftwareRasterizer::DiscardStroke()
+{
+    ResetCoverage();
+}
+
+void SoftwareRasterizer::ResetCoverage()
+{
+    for (int32_t y = m_top; y <= m_bottom; ++y)
+    {
+        if (m_rowLeft[y] <= m_rowRight[y])
+        {
+            uint8_t* pCoverage = m_coverage.data() + static_cast<size_t>(y) * m_width;
+            std::fill(pCoverage + m_rowLeft[y], pCoverage + m_rowRight[y] + 1, static_cast<uint8_t>(0));
+        }
+
+        m_rowLeft[y] = m_width;
+        m_rowRight[y] = -1;
+    }
+
+    m_top = m_height;
+    m_bottom = -1;
+}
@@ -0,0 +1,59 @@
+#pragma once
+#include "PathTypes.h"
+#include <vector>
+#include <cstdint>
+#include <cstddef>
+
+namespace PathWindows
+{
+    // Draws antialiased thick polylines with round joins into a premultiplied BGRA bitmap on the CPU.
+    // The bitmap is owned by the caller. Strokes are collected into a coverage mask first and blended once, so
+    // (like a single Direct2D geometry) parts of the stroke that overlap are not blended twice.
+    class SoftwareRasterizer
+    {
+    public:
+        SoftwareRasterizer();
+
+        // stride is in bytes. Passing nullptr detaches the rasterizer from the bitmap.
+        void SetTarget(uint8_t* pPixels, int32_t width, int32_t height, int32_t stride);
+
+        int32_t GetWidth() const;
+        int32_t GetHeight() const;
+
+        void Clear(ColorF color);
+        void Clear(RectI rect, ColorF color);
+
+        // Replaces the pixels in rect with premultiplied BGRA pixels, stride is in pixels. Whatever is outside the bitmap is skipped.
+        void CopyPixels(RectI rect, const uint32_t* pPixels, size_t stride);
+
+        // Polylines added from now on only cover the pixels in rect. SetTarget resets it to the whole bitmap.
+        void SetClip(RectI rect);
+
+        void AddPolyline(const PointF* points, size_t count, float width);
+
+        // Blends everything added since the last call with the color and starts a new stroke.
+        void FillStroke(ColorF color);
+        // Starts a new stroke without blending what was added.
+        void DiscardStroke();
+
+    private:
+        uint8_t* m_pPixels;
+        int32_t m_width;
+        int32_t m_height;
+        int32_t m_stride;
+        // within the bitmap
+        RectI m_clip;
+
+        // coverage of the current stroke, 0 to 255 per pixel, and the columns touched in every row (left > right if none)
+        std::vector<uint8_t> m_coverage;
+        std::vector<int32_t> m_rowLeft;
+        std::vector<int32_t> m_rowRight;
+        int32_t m_top;
+        int32_t m_bottom;
+
+        void AddSegment(PointF a, PointF b, float halfWidth);
+        void AddCapsule(PointF a, PointF b, float halfWidth);
+
+        void ResetCoverage();
+    };
+}
@@ -0,0 +1,148 @@
+#include "pch.h"
+#include "SoftwareRenderBackend.h"
+
+using namespace PathWindows;
+
+SoftwareRenderBackend::SoftwareRenderBackend(float strokeWidth, ColorF strokeColor) :
+    STROKE_WIDTH(strokeWidth),
+    m_strokeColor(strokeColor),
+
+    m_rasterizer(),
+
+    m_hDC(nullptr),
+    m_hBitmap(nullptr),
+    m_hOldBitmap(nullptr)
+{}
+
+SoftwareRenderBackend::~SoftwareRenderBackend()
+{
+    DiscardResources();
+}
+
+HRESULT SoftwareRenderBackend::Initialize()
+{
+    return S_OK;
+}
+
+bool SoftwareRenderBackend::HasResources()
+{
+    return m_hBitmap != nullptr;
+}
+
+HRESULT SoftwareRenderBackend::CreateResources(int width, int height)
+{
+    if (m_hBitmap) return S_OK;
+
+    // top-down 32bpp, which UpdateLayeredWindowIndirect reads as premultiplied BGRA
+    BITMAPINFO bmi{};
+    bmi.bmiHeader.biSize = sizeof(BITMAPINFOHEADER);
+    bmi.bmiHeader.biWidth = width;
+    bmi.bmiHeader.biHeight = -height;
+    bmi.bmiHeader.biPlanes = 1;
+    bmi.bmiHeader.biBitCount = 32;
+    bmi.bmiHeader.biCompression = BI_RGB;
+
+    m_hDC = CreateCompatibleDC(nullptr);
+    if (!m_hDC) return E_FAIL;
+
+    void* pBits = nullptr;
+    m_hBitmap = CreateDIBSection(m_hDC, &bmi, DIB_RGB_COLORS, &pBits, nullptr, 0);
+    if (!m_hBitmap)
+    {
+        DiscardResources();
+        return E_OUTOFMEMORY;
+    }
+
+    m_hOldBitmap = SelectObject(m_hDC, m_hBitmap);
+
+    m_rasterizer.SetTarget(static_cast<uint8_t*>(pBits), width, height, width * 4);
+
+    return S_OK;
+}
+
+void SoftwareRenderBackend::DiscardResources()
+{
+    m_rasterizer.SetTarget(nullptr, 0, 0, 0);
+
+    if (m_hDC && m_hOldBitmap) SelectObject(m_hDC, m_hOldBitmap);
+    m_hOldBitmap = nullptr;
+
+    if (m_hBitmap) DeleteObject(m_hBitmap);
+    m_hBitmap = nullptr;
+
+    if (m_hDC) DeleteDC(m_hDC);
+    m_hDC = nullptr;
+}
+
+void SoftwareRenderBackend::BeginDraw()
+{
+    // GDI may still be reading the bitmap from the last frame
+    GdiFlush();
+}
+
+void SoftwareRenderBackend::Clear(ColorF color)
+{
+    m_rasterizer.Clear(color);
+}
+
+void SoftwareRenderBackend::Clear(RectI rect, ColorF color)
+{
+    m_rasterizer.Clear(rect, color);
+}
+
+HRESULT SoftwareRenderBackend::BeginStroke()
+{
+    return S_OK;
+}
+
+void SoftwareRenderBackend::AddPolyline(const PointF* points, size_t count)
+{
+    m_rasterizer.AddPolyline(points, count, STROKE_WIDTH);
+}
+
+HRESULT SoftwareRenderBackend::EndStroke()
+{
+    m_rasterizer.FillStroke(m_strokeColor);
+
+    return S_OK;
+}
+
+void SoftwareRenderBackend::SetStrokeColor(ColorF color)
+{
+    m_strokeColor = color;
+}
+
+void SoftwareRenderBackend::PushClip(RectI rect)
+{
+    m_rasterizer.SetClip(rect);
+}
+
+void SoftwareRenderBackend::PopClip()
+{
+    m_rasterizer.SetClip(RectI{ 0, 0, m_rasterizer.GetWidth(), m_rasterizer.GetHeight() });
+}
+
+HRESULT SoftwareRenderBackend::CopyPixels(RectI rect, const uint32_t* pPixels, size_t stride)
+{
+    m_rasterizer.CopyPixels(rect, pPixels, stride);
+
+    return S_OK;
+}
+
+HRESULT SoftwareRenderBackend::GetDC(HDC* pDC)
+{
+    *pDC = m_hDC;
+
+    return S_OK;
+}
+
+void SoftwareRenderBackend::ReleaseDC()
+{}
+
+HRESULT SoftwareRenderBackend::EndDraw()
+{
+    m_rasterizer.DiscardStroke();
+    PopClip();
+
+    return S_OK;
+}
@@ -0,0 +1,52 @@
+#pragma once
+#include "pch.h"
+#include "RenderBackend.h"
+#include "SoftwareRasterizer.h"
+
+namespace PathWindows
+{
+    // Draws on the CPU into a DIB section, used when Direct2D is not available.
+    class SoftwareRenderBackend : public RenderBackend
+    {
+    public:
+        SoftwareRenderBackend(float strokeWidth, ColorF strokeColor);
+        ~SoftwareRenderBackend();
+
+        HRESULT Initialize();
+
+        bool HasResources();
+        HRESULT CreateResources(int width, int height);
+        void DiscardResources();
+
+        void BeginDraw();
+
+        void Clear(ColorF color);
+        void Clear(RectI rect, ColorF color);
+
+        HRESULT BeginStroke();
+        void AddPolyline(const PointF* points, size_t count);
+        HRESULT EndStroke();
+
+        void SetStrokeColor(ColorF color);
+
+        void PushClip(RectI rect);
+        void PopClip();
+
+        HRESULT CopyPixels(RectI rect, const uint32_t* pPixels, size_t stride);
+
+        HRESULT GetDC(HDC* pDC);
+        void ReleaseDC();
+
+        HRESULT EndDraw();
+
+    private:
+        const float STROKE_WIDTH;
+        ColorF m_strokeColor;
+
+        SoftwareRasterizer m_rasterizer;
+
+        HDC m_hDC;
+        HBITMAP m_hBitmap;
+        HGDIOBJ m_hOldBitmap;
+    };
+}
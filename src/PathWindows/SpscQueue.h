@@ -0,0 +1,132 @@
+#pragma once
+#include <atomic>
+#include <memory>
+#include <algorithm>
+#include <cstddef>
+
+namespace PathWindows
+{
+    // Bounded wait-free ring buffer for exactly one producer thread and one consumer thread.
+    // The capacity is rounded up to a power of two. Push and pop never block, they report failure
+    // (or a partial count for the range versions) when the ring is full or empty.
+    template<class T>
+    class SpscQueue
+    {
+    public:
+        explicit SpscQueue(size_t capacity) :
+            m_mask(RoundUpToPowerOfTwo(capacity) - 1),
+            m_buffer(new T[m_mask + 1]),
+            m_head(0),
+            m_cachedTail(0),
+            m_tail(0),
+            m_cachedHead(0)
+        {}
+
+        SpscQueue(const SpscQueue&) = delete;
+        SpscQueue& operator=(const SpscQueue&) = delete;
+
+        size_t GetCapacity() const
+        {
+            return m_mask + 1;
+        }
+
+        // Only exact when called from the producer or consumer thread while the other one is idle.
+        size_t GetSizeApprox() const
+        {
+            return m_tail.load(std::memory_order_acquire) - m_head.load(std::memory_order_acquire);
+        }
+
+        // producer
+
+        bool TryPush(const T& item)
+        {
+            size_t tail = m_tail.load(std::memory_order_relaxed);
+            if (tail - m_cachedHead > m_mask)
+            {
+                m_cachedHead = m_head.load(std::memory_order_acquire);
+                if (tail - m_cachedHead > m_mask) return false;
+            }
+
+            m_buffer[tail & m_mask] = item;
+            m_tail.store(tail + 1, std::memory_order_release);
+            return true;
+        }
+
+        // Pushes as many of the items as fit and returns how many that was.
+        size_t TryPushRange(const T* items, size_t count)
+        {
+            size_t tail = m_tail.load(std::memory_order_relaxed);
+            size_t free = GetCapacity() - (tail - m_cachedHead);
+            if (free < count)
+            {
+                m_cachedHead = m_head.load(std::memory_order_acquire);
+                free = GetCapacity() - (tail - m_cachedHead);
+            }
+
+            count = std::min(count, free);
+            if (count == 0) return 0;
+
+            // at most two contiguous copies, one up to the end of the buffer and one from its start
+            size_t first = tail & m_mask;
+            size_t firstCount = std::min(count, GetCapacity() - first);
+            std::copy(items, items + firstCount, m_buffer.get() + first);
+            std::copy(items + firstCount, items + count, m_buffer.get());
+
+            m_tail.store(tail + count, std::memory_order_release);
+            return count;
+        }
+
+        // consumer
+
+        bool TryPop(T& item)
+        {
+            return PopBatch(&item, 1) == 1;
+        }
+
+        // Pops up to maxCount items into out and returns how many were popped.
+        size_t PopBatch(T* out, size_t maxCount)
+        {
+            size_t head = m_head.load(std::memory_order_relaxed);
+            if (m_cachedTail - head < maxCount)
+            {
+                m_cachedTail = m_tail.load(std::memory_order_acquire);
+            }
+
+            size_t count = std::min(maxCount, m_cachedTail - head);
+            if (count == 0) return 0;
+
+            size_t first = head & m_mask;
+            size_t firstCount = std::min(count, GetCapacity() - first);
+            std::copy(m_buffer.get() + first, m_buffer.get() + first + firstCount, out);
+            std::copy(m_buffer.get(), m_buffer.get() + (count - firstCount), out + firstCount);
+
+            m_head.store(head + count, std::memory_order_release);
+            return count;
+        }
+
+    private:
+        static constexpr size_t CACHE_LINE = 64;
+
+        const size_t m_mask;
+        const std::unique_ptr<T[]> m_buffer;
+
+        // the consumer and producer halves are padded apart so the two threads don't share a cache line
+
+        char m_pad0[CACHE_LINE];
+        std::atomic<size_t> m_head;
+        size_t m_cachedTail;
+
+        char m_pad1[CACHE_LINE];
+        std::atomic<size_t> m_tail;
+        size_t m_cachedHead;
+
+        char m_pad2[CACHE_LINE];
+
+        static size_t RoundUpToPowerOfTwo(size_t value)
+        {
+            size_t result = 1;
+            while (result < value) result <<= 1;
+            return result;
+        }
+    };
+}
@@ -0,0 +1,153 @@
+#pragma once
+#include "PathStore.h"
+#include <cstddef>
+
+namespace PathWindows
+{
+    // Append-only list of figures that remembers how much of it has already been stroked, so that a
+    // retained surface only needs the newly appended tail drawn on top of what it already contains.
+    // Figures can be split where segments are erased and joined again, and points dropped from the end, the other points
+    // stay where they are.
+    class StrokeAccumulator
+    {
+    public:
+        StrokeAccumulator() :
+            m_committedFigure(0),
+            m_committedPoints(0),
+            m_fullRedraw(true)
+        {}
+
+        void Append(PointF point, bool newFigure)
+        {
+            m_store.Append(point, newFigure);
+        }
+
+        void AppendRange(const PointF* points, size_t count, bool newFigure)
+        {
+            m_store.AppendRange(points, count, newFigure);
+        }
+
+        // Cuts the segments that end at the points at indices out of their figures, see PathStore::SplitFigures. Where
+        // they were already stroked has to be redrawn by the caller.
+        void Split(const uint32_t* indices, size_t count)
+        {
+            m_store.SplitFigures(indices, count);
+            UpdateCommittedFigure();
+        }
+
+        // Puts back segments that were cut out, see PathStore::JoinFigures. The ones before the points that were
+        // already stroked have to be stroked by the caller.
+        void Join(const uint32_t* indices, size_t count)
+        {
+            m_store.JoinFigures(indices, count);
+            UpdateCommittedFigure();
+        }
+
+        // Drops the points from index count on. Where they were already stroked has to be redrawn by the caller.
+        void Truncate(size_t count)
+        {
+            m_store.Truncate(count);
+            if (m_committedPoints > count) m_committedPoints = count;
+            UpdateCommittedFigure();
+        }
+
+        void Clear()
+        {
+            m_store.Clear();
+            m_committedFigure = 0;
+            m_committedPoints = 0;
+            m_fullRedraw = true;
+        }
+
+        // Forces the next frame to redraw everything, e.g. after the surface that held the strokes was lost.
+        void Invalidate()
+        {
+            m_fullRedraw = true;
+        }
+
+        bool NeedsFullRedraw() const
+        {
+            return m_fullRedraw;
+        }
+
+        bool HasPending() const
+        {
+            if (m_fullRedraw) return true;
+
+            return m_committedPoints < m_store.GetPointCount();
+        }
+
+        size_t GetFigureCount() const
+        {
+            return m_store.GetFigureCount();
+        }
+
+        const PathStore& GetStore() const
+        {
+            return m_store;
+        }
+
+        // How many points (of all figures) were stroked when Commit was last called.
+        size_t GetCommittedPointCount() const
+        {
+            return m_committedPoints;
+        }
+
+        // Calls fn(const PointF* points, size_t count) for every figure with at least one segment.
+        template<class Fn>
+        void ForEachRun(Fn&& fn) const
+        {
+            for (size_t i = 0; i < m_store.GetFigureCount(); ++i)
+            {
+                FigureView figure = m_store.GetFigure(i);
+                if (figure.count > 1) fn(figure.points, figure.count);
+            }
+        }
+
+        // Calls fn(const PointF* points, size_t count) for every run of segments that has not been stroked yet
+        // (everything if a full redraw is needed). A run that continues an already stroked figure starts at the
+        // last stroked point, so the new segments join up with the old ones.
+        template<class Fn>
+        void ForEachPendingRun(Fn&& fn) const
+        {
+            if (m_fullRedraw)
+            {
+                ForEachRun(fn);
+                return;
+            }
+
+            const PointF* points = m_store.GetPoints();
+            for (size_t i = m_committedFigure; i < m_store.GetFigureCount(); ++i)
+            {
+                size_t first = m_store.GetFigureStart(i);
+                size_t end = m_store.GetFigureEnd(i);
+
+                if (i == m_committedFigure && m_committedPoints > first) first = m_committedPoints - 1;
+                if (end - first > 1) fn(points + first, end - first);
+            }
+        }
+
+        // Marks everything appended so far as stroked.
+        void Commit()
+        {
+            m_fullRedraw = false;
+
+            m_committedFigure = m_store.GetFigureCount() > 0 ? m_store.GetFigureCount() - 1 : 0;
+            m_committedPoints = m_store.GetPointCount();
+        }
+
+    private:
+        PathStore m_store;
+
+        // index of the last figure that was (at least partly) stroked, and how many points (of all figures) were
+        size_t m_committedFigure;
+        size_t m_committedPoints;
+
+        bool m_fullRedraw;
+
+        void UpdateCommittedFigure()
+        {
+            m_committedFigure = m_committedPoints > 0 ? m_store.FindFigure(m_committedPoints - 1) : 0;
+        }
+    };
+}
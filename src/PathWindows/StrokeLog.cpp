@@ -0,0 +1,143 @@
+#include "StrokeLog.h"
+#include <algorithm>
+
+using namespace PathWindows;
+
+StrokeLog::StrokeLog() :
+    m_steps{ Step{ 0, 0, 0, 0 } },
+    m_cursor(1),
+    m_strokeOpen(false),
+    m_eraseOpen(false)
+{}
+
+void StrokeLog::Reset(const Movement* path, size_t count)
+{
+    m_buffer.assign(path, path + count);
+    m_segmentRanges.clear();
+    m_pointRanges.clear();
+    m_steps.assign(1, Step{ 0, count, 0, 0 });
+    m_cursor = 1;
+    m_strokeOpen = false;
+    m_eraseOpen = false;
+}
+
+void StrokeLog::DropRedo()
+{
+    // everything past the last applied step only belongs to steps that can no longer be redone
+    const Step& last = m_steps[m_cursor - 1];
+    m_buffer.resize(last.end);
+    m_segmentRanges.resize(last.segmentsEnd);
+    m_pointRanges.resize(last.pointsEnd);
+    m_steps.resize(m_cursor);
+}
+
+void StrokeLog::PushStep(size_t end)
+{
+    const Step& last = m_steps.back();
+    m_steps.push_back(Step{ last.end, end, last.segmentsEnd, last.pointsEnd });
+    ++m_cursor;
+}
+
+void StrokeLog::BeginStroke()
+{
+    DropRedo();
+    PushStep(m_buffer.size());
+
+    m_strokeOpen = true;
+    m_eraseOpen = false;
+}
+
+void StrokeLog::Append(const Movement& movement)
+{
+    if (!m_strokeOpen) BeginStroke();
+
+    m_buffer.push_back(movement);
+    m_steps.back().end = m_buffer.size();
+}
+
+void StrokeLog::AddRanges(std::vector<uint32_t>& indices, std::vector<IndexRange>& ranges, size_t first)
+{
+    std::sort(indices.begin(), indices.end());
+    indices.erase(std::unique(indices.begin(), indices.end()), indices.end());
+
+    for (uint32_t index : indices)
+    {
+        // only the ranges of the same step can be extended
+        if (ranges.size() > first && ranges.back().end == index) ++ranges.back().end;
+        else ranges.push_back(IndexRange{ index, index + 1 });
+    }
+}
+
+void StrokeLog::Erase(std::vector<uint32_t>& segments, std::vector<uint32_t>& points, bool merge)
+{
+    m_strokeOpen = false;
+    DropRedo();
+
+    // the step that is merged into is always the last one, anything after it was dropped when it was made
+    if (!merge || !m_eraseOpen) PushStep(m_buffer.size());
+
+    Step& step = m_steps.back();
+    const Step& before = m_steps[m_steps.size() - 2];
+
+    AddRanges(segments, m_segmentRanges, before.segmentsEnd);
+    AddRanges(points, m_pointRanges, before.pointsEnd);
+    step.segmentsEnd = m_segmentRanges.size();
+    step.pointsEnd = m_pointRanges.size();
+
+    m_eraseOpen = true;
+}
+
+StrokeLog::Change StrokeLog::GetChange(size_t step) const
+{
+    const Step& before = m_steps[step - 1];
+    const Step& after = m_steps[step];
+
+    return Change{
+        after.begin,
+        after.end,
+        m_segmentRanges.data() + before.segmentsEnd,
+        after.segmentsEnd - before.segmentsEnd,
+        m_pointRanges.data() + before.pointsEnd,
+        after.pointsEnd - before.pointsEnd
+    };
+}
+
+bool StrokeLog::Undo(Change& change)
+{
+    m_strokeOpen = false;
+    m_eraseOpen = false;
+    if (m_cursor < 2) return false;
+
+    change = GetChange(--m_cursor);
+    return true;
+}
+
+bool StrokeLog::Redo(Change& change)
+{
+    m_strokeOpen = false;
+    m_eraseOpen = false;
+    if (m_cursor == m_steps.size()) return false;
+
+    change = GetChange(m_cursor++);
+    return true;
+}
+
+const Movement* StrokeLog::GetMovements() const
+{
+    return m_buffer.data();
+}
+
+size_t StrokeLog::GetSize() const
+{
+    return m_steps[m_cursor - 1].end;
+}
+
+size_t StrokeLog::GetUndoCount() const
+{
+    return m_cursor - 1;
+}
+
+size_t StrokeLog::GetRedoCount() const
+{
+    return m_steps.size() - m_cursor;
+}
@@ -0,0 +1,92 @@
+#pragma once
+#include "PathTypes.h"
+#include <vector>
+#include <cstdint>
+#include <cstddef>
+
+namespace PathWindows
+{
+    // The history of a drawn path as a list of steps over one movement buffer, and a cursor into it.
+    // A step either appends a stroke to the buffer, or erases segments (by the index of the point they end at) and
+    // points of it, which it keeps as ranges of their indices. Erased movements stay in the buffer, so indices never
+    // change, and undoing or redoing a step only takes back or applies again what that step changed.
+    // Starting a new step drops the ones that could have been redone.
+    class StrokeLog
+    {
+    public:
+        // The indices from first up to (not including) end.
+        struct IndexRange
+        {
+            uint32_t first;
+            uint32_t end;
+        };
+
+        // What a step changed: the movements from strokeBegin up to strokeEnd of the buffer it appended, or the ranges
+        // of segments and points it erased.
+        struct Change
+        {
+            size_t strokeBegin;
+            size_t strokeEnd;
+            const IndexRange* segments;
+            size_t segmentRangeCount;
+            const IndexRange* points;
+            size_t pointRangeCount;
+        };
+
+        StrokeLog();
+
+        // Drops the history and starts over from path, which can not be undone.
+        void Reset(const Movement* path, size_t count);
+
+        // Starts a new stroke, which is undone as one step.
+        void BeginStroke();
+        // Adds to the stroke, and begins one if there is none (e.g. right after an undo).
+        void Append(const Movement& movement);
+
+        // Records erasing segments and points as one step, see ErasablePath::Erase (sorts them). If merge is set and
+        // nothing else happened since the last erase, they are added to that step instead, so that everything erased
+        // in one drag is undone at once.
+        void Erase(std::vector<uint32_t>& segments, std::vector<uint32_t>& points, bool merge);
+
+        // Returns false if there is nothing to undo, otherwise change is set to what has to be taken back.
+        bool Undo(Change& change);
+        // Returns false if there is nothing to redo, otherwise change is set to what has to be applied again.
+        bool Redo(Change& change);
+
+        // Every movement of the path, erased ones included, with the steps up to the cursor applied.
+        const Movement* GetMovements() const;
+        size_t GetSize() const;
+
+        size_t GetUndoCount() const;
+        size_t GetRedoCount() const;
+
+    private:
+        struct Step
+        {
+            // the movements the path had before the step and after it, a step that erases does not change them
+            size_t begin;
+            size_t end;
+            // where its ranges in m_segmentRanges and m_pointRanges end, they start where those of the step before end
+            // (a stroke has none)
+            size_t segmentsEnd;
+            size_t pointsEnd;
+        };
+
+        std::vector<Movement> m_buffer;
+        std::vector<IndexRange> m_segmentRanges;
+        std::vector<IndexRange> m_pointRanges;
+        // the first step is the path the history starts from
+        std::vector<Step> m_steps;
+        // how many steps are applied
+        size_t m_cursor;
+        // whether the last step can still be added to, by Append or by a merging Erase
+        bool m_strokeOpen;
+        bool m_eraseOpen;
+
+        void DropRedo();
+        void PushStep(size_t end);
+        Change GetChange(size_t step) const;
+        // Adds indices to ranges, the ranges from first on belong to the same step.
+        static void AddRanges(std::vector<uint32_t>& indices, std::vector<IndexRange>& ranges, size_t first);
+    };
+}
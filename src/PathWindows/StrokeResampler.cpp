@@ -0,0 +1,179 @@
+#include "StrokeResampler.h"
+#include <algorithm>
+#include <cmath>
+
+using namespace PathWindows;
+
+namespace
+{
+    inline PointF ToPointF(PointI point)
+    {
+        return PointF{ static_cast<float>(point.x), static_cast<float>(point.y) };
+    }
+
+    inline PointI Round(PointF point)
+    {
+        return PointI{ static_cast<int32_t>(std::lround(point.x)), static_cast<int32_t>(std::lround(point.y)) };
+    }
+
+    inline float Distance(PointF a, PointF b)
+    {
+        float dx = b.x - a.x;
+        float dy = b.y - a.y;
+        return std::sqrt(dx * dx + dy * dy);
+    }
+
+    // the point at t on the uniform Catmull-Rom segment from p1 to p2
+    inline PointF CatmullRom(PointF p0, PointF p1, PointF p2, PointF p3, float t)
+    {
+        float t2 = t * t;
+        float t3 = t2 * t;
+
+        auto axis = [=](float a, float b, float c, float d)
+        {
+            return 0.5f * (2.0f * b + (c - a) * t + (2.0f * a - 5.0f * b + 4.0f * c - d) * t2 + (3.0f * b - a - 3.0f * c + d) * t3);
+        };
+
+        return PointF{ axis(p0.x, p1.x, p2.x, p3.x), axis(p0.y, p1.y, p2.y, p3.y) };
+    }
+
+    // An upper bound of how fast the segment moves per unit of t: the segment is the cubic bezier p1, b1, b2, p2,
+    // whose derivative is a quadratic bezier with three times the differences of consecutive control points.
+    inline float CatmullRomMaxSpeed(PointF p0, PointF p1, PointF p2, PointF p3)
+    {
+        PointF b1{ p1.x + (p2.x - p0.x) / 6.0f, p1.y + (p2.y - p0.y) / 6.0f };
+        PointF b2{ p2.x - (p3.x - p1.x) / 6.0f, p2.y - (p3.y - p1.y) / 6.0f };
+
+        return 3.0f * (std::max)({ Distance(p1, b1), Distance(b1, b2), Distance(b2, p2) });
+    }
+
+    // Inverse of the smoothstep curve 3x^2 - 2x^3: the fraction of the duration after which the given fraction of the
+    // length is covered.
+    inline double InverseSmoothstep(double x)
+    {
+        double y = std::clamp(1.0 - 2.0 * x, -1.0, 1.0);
+        return 0.5 - std::sin(std::asin(y) / 3.0);
+    }
+}
+
+StrokeResampler::StrokeResampler(const ResampleOptions& options) :
+    m_options(options),
+    m_last{},
+    m_lastRounded{},
+    m_pendingLength(0.0f)
+{}
+
+void StrokeResampler::Resample(const Movement* path, size_t count, const PointI* anchor, std::vector<Movement>& out)
+{
+    size_t start = 0;
+    while (start < count)
+    {
+        size_t end = start + 1;
+        while (end < count && path[end].delayDurationNS != 0) ++end;
+
+        m_controlPoints.clear();
+
+        if (start == 0 && anchor && path[0].delayDurationNS != 0)
+        {
+            m_controlPoints.push_back(ToPointF(*anchor));
+        }
+        else
+        {
+            out.push_back(Movement{ path[start].delta, 0 });
+        }
+
+        for (size_t i = start; i < end; ++i) m_controlPoints.push_back(ToPointF(path[i].delta));
+
+        Densify();
+        EmitSteps(out);
+
+        start = end;
+    }
+}
+
+void StrokeResampler::Densify()
+{
+    m_steps.clear();
+
+    const PointF* c = m_controlPoints.data();
+    size_t count = m_controlPoints.size();
+
+    m_last = c[0];
+    m_lastRounded = Round(c[0]);
+    m_pendingLength = 0.0f;
+
+    for (size_t i = 0; i + 1 < count; ++i)
+    {
+        PointF p1 = c[i];
+        PointF p2 = c[i + 1];
+        PointF p0 = i > 0 ? c[i - 1] : p1;
+        PointF p3 = i + 2 < count ? c[i + 2] : p2;
+
+        bool curved = m_options.interpolation == Interpolation::CATMULL_ROM;
+
+        // a step covers 1 / stepCount of t, and no more than the max step length
+        float maxLength = curved ? CatmullRomMaxSpeed(p0, p1, p2, p3) : Distance(p1, p2);
+        size_t stepCount = static_cast<size_t>(std::ceil(maxLength / m_options.maxStepLength));
+
+        for (size_t step = 1; step <= stepCount; ++step)
+        {
+            if (step == stepCount)
+            {
+                // end exactly on the drawn point
+                AddStep(p2);
+                break;
+            }
+
+            float t = static_cast<float>(step) / static_cast<float>(stepCount);
+            AddStep(curved
+                ? CatmullRom(p0, p1, p2, p3, t)
+                : PointF{ p1.x + (p2.x - p1.x) * t, p1.y + (p2.y - p1.y) * t });
+        }
+    }
+
+    if (m_pendingLength > 0.0f && !m_steps.empty()) m_steps.back().length += m_pendingLength;
+}
+
+void StrokeResampler::AddStep(PointF position)
+{
+    float length = Distance(m_last, position);
+    m_last = position;
+
+    PointI rounded = Round(position);
+    if (rounded.x == m_lastRounded.x && rounded.y == m_lastRounded.y)
+    {
+        // still on the same pixel, the time it takes goes to the next step that leaves it
+        m_pendingLength += length;
+        return;
+    }
+
+    m_steps.push_back(Step{ rounded, length + m_pendingLength });
+    m_lastRounded = rounded;
+    m_pendingLength = 0.0f;
+}
+
+void StrokeResampler::EmitSteps(std::vector<Movement>& out)
+{
+    double totalLength = 0.0;
+    for (auto&& step : m_steps) totalLength += step.length;
+
+    double duration = totalLength * m_options.nsPerPixel;
+    bool eased = m_options.easing == Easing::EASE_IN_OUT && totalLength > 0.0;
+
+    out.reserve(out.size() + m_steps.size());
+
+    // delays are the differences of rounded timestamps, so rounding errors do not add up over the stroke
+    double length = 0.0;
+    int64_t elapsed = 0;
+    for (auto&& step : m_steps)
+    {
+        length += step.length;
+
+        double time = eased ? duration * InverseSmoothstep(length / totalLength) : length * m_options.nsPerPixel;
+        int64_t delay = std::llround(time) - elapsed;
+        if (delay < 1) delay = 1;
+
+        elapsed += delay;
+        out.push_back(Movement{ step.position, delay });
+    }
+}
@@ -0,0 +1,71 @@
+#pragma once
+#include "PathTypes.h"
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+namespace PathWindows
+{
+    enum class Interpolation : uint32_t
+    {
+        LINEAR,
+        // through every drawn point, with uniform parameterization
+        CATMULL_ROM
+    };
+
+    enum class Easing : uint32_t
+    {
+        // the cursor moves at the same speed along the whole stroke
+        CONSTANT,
+        // every stroke speeds up from its start and slows down into its end, taking as long as it would at constant speed
+        EASE_IN_OUT
+    };
+
+    struct ResampleOptions
+    {
+        // longest step between two output positions, in pixels, before they are rounded to whole pixels
+        float maxStepLength;
+        // how long the cursor takes to move one pixel at constant speed
+        double nsPerPixel;
+        Interpolation interpolation;
+        Easing easing;
+    };
+
+    // Turns drawn strokes into timed movements that can be replayed: every stroke is densified so that no step is
+    // longer than the max step length, and every step gets the delay that makes the cursor glide along it.
+    // Input and output are absolute positions. A movement with a delay of 0 starts a new stroke (the cursor jumps
+    // there), any other delay in the input is ignored. Output delays within a stroke are never 0.
+    class StrokeResampler
+    {
+    public:
+        explicit StrokeResampler(const ResampleOptions& options);
+
+        // Appends the resampled path to out. If anchor is not null and path does not start a new stroke, the first stroke
+        // continues from anchor, which is not written itself.
+        void Resample(const Movement* path, size_t count, const PointI* anchor, std::vector<Movement>& out);
+
+    private:
+        struct Step
+        {
+            PointI position;
+            // length of the step before rounding, plus that of any steps merged into it
+            float length;
+        };
+
+        ResampleOptions m_options;
+
+        // the control points of the current stroke, and the steps they were densified into
+        std::vector<PointF> m_controlPoints;
+        std::vector<Step> m_steps;
+
+        // where the last step ended, before and after rounding, and the length of the steps since then that did not
+        // reach another pixel
+        PointF m_last;
+        PointI m_lastRounded;
+        float m_pendingLength;
+
+        void Densify();
+        void AddStep(PointF position);
+        void EmitSteps(std::vector<Movement>& out);
+    };
+}
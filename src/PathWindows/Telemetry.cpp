@@ -0,0 +1,79 @@
+#include "Telemetry.h"
+
+#ifdef _MSC_VER
+#include <intrin.h>
+#endif
+
+using namespace PathWindows;
+
+size_t Histogram::BitWidth(uint64_t value)
+{
+#if defined(_MSC_VER) && defined(_M_X64)
+    unsigned long index;
+    return _BitScanReverse64(&index, value) ? index + 1 : 0;
+#elif defined(_MSC_VER)
+    unsigned long index;
+    if (_BitScanReverse(&index, static_cast<unsigned long>(value >> 32))) return index + 33;
+    return _BitScanReverse(&index, static_cast<unsigned long>(value)) ? index + 1 : 0;
+#else
+    return value ? 64 - __builtin_clzll(value) : 0;
+#endif
+}
+
+void Histogram::CopyTo(HistogramSnapshot& snapshot) const
+{
+    snapshot.count = m_count.load(std::memory_order_relaxed);
+    snapshot.sumNS = m_sum.load(std::memory_order_relaxed);
+    snapshot.maxNS = m_max.load(std::memory_order_relaxed);
+
+    for (size_t i = 0; i < HISTOGRAM_BUCKET_COUNT; ++i) snapshot.buckets[i] = m_buckets[i].load(std::memory_order_relaxed);
+}
+
+void Histogram::Reset()
+{
+    for (auto&& bucket : m_buckets) bucket.store(0, std::memory_order_relaxed);
+
+    m_count.store(0, std::memory_order_relaxed);
+    m_sum.store(0, std::memory_order_relaxed);
+    m_max.store(0, std::memory_order_relaxed);
+}
+
+Telemetry& Telemetry::Get()
+{
+    static Telemetry telemetry;
+    return telemetry;
+}
+
+void Telemetry::CopyTo(StatsSnapshot& snapshot) const
+{
+    snapshot.size = sizeof(StatsSnapshot);
+    snapshot.reserved = 0;
+
+    snapshot.pointsIngested = pointsIngested.Get();
+    snapshot.framesRendered = framesRendered.Get();
+    snapshot.framesSkipped = framesSkipped.Get();
+    snapshot.bytesPresented = bytesPresented.Get();
+
+    snapshot.queueDepth = queueDepth.Get();
+    snapshot.maxQueueDepth = queueDepth.GetMax();
+
+    frameTime.CopyTo(snapshot.frameTime);
+    geometryTime.CopyTo(snapshot.geometryTime);
+    presentTime.CopyTo(snapshot.presentTime);
+    openLatency.CopyTo(snapshot.openLatency);
+}
+
+void Telemetry::Reset()
+{
+    pointsIngested.Reset();
+    framesRendered.Reset();
+    framesSkipped.Reset();
+    bytesPresented.Reset();
+
+    queueDepth.Reset();
+
+    frameTime.Reset();
+    geometryTime.Reset();
+    presentTime.Reset();
+    openLatency.Reset();
+}
@@ -0,0 +1,164 @@
+#pragma once
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+
+namespace PathWindows
+{
+    constexpr size_t HISTOGRAM_BUCKET_COUNT = 48;
+
+    // Plain copies of the telemetry, laid out for callers of the C API.
+    struct HistogramSnapshot
+    {
+        uint64_t count;
+        uint64_t sumNS;
+        uint64_t maxNS;
+        // bucket 0 counts values of 0, bucket i values from 2^(i-1) to 2^i - 1 ns, the last bucket everything above
+        uint64_t buckets[HISTOGRAM_BUCKET_COUNT];
+    };
+
+    struct StatsSnapshot
+    {
+        // set by the caller to the size of the struct it was built with, the fields that fit are filled in and size is
+        // set to how many bytes were, so older callers keep working and newer ones can tell which fields they got
+        uint32_t size;
+        uint32_t reserved;
+
+        uint64_t pointsIngested;
+        uint64_t framesRendered;
+        // render calls that found nothing new to draw
+        uint64_t framesSkipped;
+        // bytes of bitmap pushed to layered windows
+        uint64_t bytesPresented;
+
+        // commands waiting in the queue of the window that drained last, and the most ever seen
+        uint64_t queueDepth;
+        uint64_t maxQueueDepth;
+
+        HistogramSnapshot frameTime;
+        HistogramSnapshot geometryTime;
+        HistogramSnapshot presentTime;
+        HistogramSnapshot openLatency;
+    };
+
+    // Everything below only uses relaxed atomics, so recording never waits, and a snapshot is not taken atomically
+    // as a whole (a frame may show up in one counter and not yet in another).
+
+    class Counter
+    {
+    public:
+        Counter() : m_value(0) {}
+
+        void Add(uint64_t value)
+        {
+            m_value.fetch_add(value, std::memory_order_relaxed);
+        }
+
+        uint64_t Get() const
+        {
+            return m_value.load(std::memory_order_relaxed);
+        }
+
+        void Reset()
+        {
+            m_value.store(0, std::memory_order_relaxed);
+        }
+
+    private:
+        std::atomic<uint64_t> m_value;
+    };
+
+    // The last value set, and the largest.
+    class Gauge
+    {
+    public:
+        Gauge() : m_value(0), m_max(0) {}
+
+        void Set(uint64_t value)
+        {
+            m_value.store(value, std::memory_order_relaxed);
+            UpdateMax(m_max, value);
+        }
+
+        uint64_t Get() const
+        {
+            return m_value.load(std::memory_order_relaxed);
+        }
+
+        uint64_t GetMax() const
+        {
+            return m_max.load(std::memory_order_relaxed);
+        }
+
+        void Reset()
+        {
+            m_value.store(0, std::memory_order_relaxed);
+            m_max.store(0, std::memory_order_relaxed);
+        }
+
+        static void UpdateMax(std::atomic<uint64_t>& max, uint64_t value)
+        {
+            uint64_t current = max.load(std::memory_order_relaxed);
+            while (value > current && !max.compare_exchange_weak(current, value, std::memory_order_relaxed));
+        }
+
+    private:
+        std::atomic<uint64_t> m_value;
+        std::atomic<uint64_t> m_max;
+    };
+
+    // Durations in nanoseconds, counted in power of two buckets.
+    class Histogram
+    {
+    public:
+        Histogram()
+        {
+            Reset();
+        }
+
+        void Record(int64_t ns)
+        {
+            uint64_t value = ns > 0 ? static_cast<uint64_t>(ns) : 0;
+
+            size_t bucket = BitWidth(value);
+            if (bucket >= HISTOGRAM_BUCKET_COUNT) bucket = HISTOGRAM_BUCKET_COUNT - 1;
+
+            m_buckets[bucket].fetch_add(1, std::memory_order_relaxed);
+            m_count.fetch_add(1, std::memory_order_relaxed);
+            m_sum.fetch_add(value, std::memory_order_relaxed);
+            Gauge::UpdateMax(m_max, value);
+        }
+
+        void CopyTo(HistogramSnapshot& snapshot) const;
+        void Reset();
+
+        static size_t BitWidth(uint64_t value);
+
+    private:
+        std::atomic<uint64_t> m_buckets[HISTOGRAM_BUCKET_COUNT];
+        std::atomic<uint64_t> m_count;
+        std::atomic<uint64_t> m_sum;
+        std::atomic<uint64_t> m_max;
+    };
+
+    // Process wide, every window records into the same telemetry.
+    struct Telemetry
+    {
+        Counter pointsIngested;
+        Counter framesRendered;
+        Counter framesSkipped;
+        Counter bytesPresented;
+
+        Gauge queueDepth;
+
+        Histogram frameTime;
+        Histogram geometryTime;
+        Histogram presentTime;
+        Histogram openLatency;
+
+        static Telemetry& Get();
+
+        void CopyTo(StatsSnapshot& snapshot) const;
+        void Reset();
+    };
+}
@@ -0,0 +1,26 @@
+#include "pch.h"
+#include "Telemetry.h"
+#include <algorithm>
+#include <cstddef>
+#include <cstring>
+
+using namespace PathWindows;
+
+// pStats->size has to be set to the size of the caller's StatsSnapshot, only that many bytes are written.
+extern "C" __declspec(dllexport) HRESULT __cdecl GetPathWindowStats(StatsSnapshot* pStats)
+{
+    if (!pStats) return E_POINTER;
+    if (pStats->size < offsetof(StatsSnapshot, pointsIngested)) return E_INVALIDARG;
+
+    StatsSnapshot stats;
+    Telemetry::Get().CopyTo(stats);
+
+    stats.size = static_cast<uint32_t>(std::min<size_t>(pStats->size, sizeof(StatsSnapshot)));
+    std::memcpy(pStats, &stats, stats.size);
+    return S_OK;
+}
+
+extern "C" __declspec(dllexport) void __cdecl ResetPathWindowStats()
+{
+    Telemetry::Get().Reset();
+}
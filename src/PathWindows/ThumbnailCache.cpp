@@ -0,0 +1,162 @@
+#include "ThumbnailCache.h"
+#include <cstring>
+#include <iterator>
+
+using namespace PathWindows;
+
+namespace
+{
+    // the primes and rounds of XXH64, so it hashes about as fast as memory can be read
+    constexpr uint64_t PRIME1 = 0x9E3779B185EBCA87ULL;
+    constexpr uint64_t PRIME2 = 0xC2B2AE3D27D4EB4FULL;
+    constexpr uint64_t PRIME3 = 0x165667B19E3779F9ULL;
+    constexpr uint64_t PRIME4 = 0x85EBCA77C2B2AE63ULL;
+    constexpr uint64_t PRIME5 = 0x27D4EB2F165667C5ULL;
+
+    inline uint64_t RotateLeft(uint64_t value, int bits)
+    {
+        return (value << bits) | (value >> (64 - bits));
+    }
+
+    inline uint64_t Read64(const uint8_t* p)
+    {
+        uint64_t value;
+        std::memcpy(&value, p, sizeof(value));
+        return value;
+    }
+
+    inline uint64_t Round(uint64_t accumulator, uint64_t input)
+    {
+        return RotateLeft(accumulator + input * PRIME2, 31) * PRIME1;
+    }
+
+    inline uint64_t Merge(uint64_t hash, uint64_t accumulator)
+    {
+        return (hash ^ Round(0, accumulator)) * PRIME1 + PRIME4;
+    }
+}
+
+ThumbnailCache::ThumbnailCache(size_t maxBytes) :
+    m_maxBytes(maxBytes),
+    m_bytes(0)
+{}
+
+uint64_t ThumbnailCache::Hash(const void* pData, size_t size, uint64_t seed)
+{
+    const uint8_t* p = static_cast<const uint8_t*>(pData);
+    const uint8_t* pEnd = p + size;
+    uint64_t hash;
+
+    if (size >= 32)
+    {
+        // four independent lanes, so the multiplies of one do not wait for the others
+        uint64_t v1 = seed + PRIME1 + PRIME2;
+        uint64_t v2 = seed + PRIME2;
+        uint64_t v3 = seed;
+        uint64_t v4 = seed - PRIME1;
+
+        for (; pEnd - p >= 32; p += 32)
+        {
+            v1 = Round(v1, Read64(p));
+            v2 = Round(v2, Read64(p + 8));
+            v3 = Round(v3, Read64(p + 16));
+            v4 = Round(v4, Read64(p + 24));
+        }
+
+        hash = RotateLeft(v1, 1) + RotateLeft(v2, 7) + RotateLeft(v3, 12) + RotateLeft(v4, 18);
+        hash = Merge(hash, v1);
+        hash = Merge(hash, v2);
+        hash = Merge(hash, v3);
+        hash = Merge(hash, v4);
+    }
+    else
+    {
+        hash = seed + PRIME5;
+    }
+
+    hash += static_cast<uint64_t>(size);
+
+    for (; pEnd - p >= 8; p += 8) hash = RotateLeft(hash ^ Round(0, Read64(p)), 27) * PRIME1 + PRIME4;
+    for (; p < pEnd; ++p) hash = RotateLeft(hash ^ (*p * PRIME5), 11) * PRIME1;
+
+    hash ^= hash >> 33;
+    hash *= PRIME2;
+    hash ^= hash >> 29;
+    hash *= PRIME3;
+    hash ^= hash >> 32;
+
+    return hash;
+}
+
+ThumbnailCache::Key ThumbnailCache::MakeKey(const void* pPath, size_t byteCount, uint64_t seed, int32_t width, int32_t height)
+{
+    return Key{ Hash(pPath, byteCount, seed), byteCount, width, height };
+}
+
+bool ThumbnailCache::TryGet(const Key& key, uint32_t* pPixels)
+{
+    std::lock_guard<std::mutex> lock(m_mutex);
+
+    auto found = m_index.find(key);
+    if (found == m_index.end()) return false;
+
+    m_entries.splice(m_entries.begin(), m_entries, found->second);
+
+    const std::vector<uint32_t>& pixels = found->second->pixels;
+    std::memcpy(pPixels, pixels.data(), pixels.size() * sizeof(uint32_t));
+
+    return true;
+}
+
+void ThumbnailCache::Put(const Key& key, const uint32_t* pPixels)
+{
+    size_t pixelCount = static_cast<size_t>(key.width) * key.height;
+    size_t bytes = pixelCount * sizeof(uint32_t);
+
+    // copied before locking, so other threads only wait for the list to change
+    Entry entry{ key, std::vector<uint32_t>(pPixels, pPixels + pixelCount) };
+
+    std::lock_guard<std::mutex> lock(m_mutex);
+
+    auto found = m_index.find(key);
+    if (found != m_index.end()) Remove(found->second);
+
+    // one that could never fit would only push out everything else
+    if (bytes > m_maxBytes) return;
+
+    while (m_bytes + bytes > m_maxBytes) Remove(std::prev(m_entries.end()));
+
+    m_entries.push_front(std::move(entry));
+    m_index.emplace(key, m_entries.begin());
+    m_bytes += bytes;
+}
+
+void ThumbnailCache::Remove(std::list<Entry>::iterator it)
+{
+    m_bytes -= it->pixels.size() * sizeof(uint32_t);
+    m_index.erase(it->key);
+    m_entries.erase(it);
+}
+
+void ThumbnailCache::Clear()
+{
+    std::lock_guard<std::mutex> lock(m_mutex);
+
+    m_entries.clear();
+    m_index.clear();
+    m_bytes = 0;
+}
+
+size_t ThumbnailCache::GetCount() const
+{
+    std::lock_guard<std::mutex> lock(m_mutex);
+
+    return m_entries.size();
+}
+
+size_t ThumbnailCache::GetBytes() const
+{
+    std::lock_guard<std::mutex> lock(m_mutex);
+
+    return m_bytes;
+}
@@ -0,0 +1,74 @@
+#pragma once
+#include <list>
+#include <unordered_map>
+#include <vector>
+#include <mutex>
+#include <cstdint>
+#include <cstddef>
+
+namespace PathWindows
+{
+    // Keeps rendered thumbnails by a hash of the bytes of the path they show and their size, so a path that did not
+    // change is never rendered again. Drops the least recently used ones once they take more than maxBytes.
+    // Can be used from any thread.
+    class ThumbnailCache
+    {
+    public:
+        struct Key
+        {
+            uint64_t hash;
+            size_t byteCount;
+            int32_t width;
+            int32_t height;
+
+            bool operator==(const Key& other) const
+            {
+                return hash == other.hash && byteCount == other.byteCount && width == other.width && height == other.height;
+            }
+        };
+
+        explicit ThumbnailCache(size_t maxBytes);
+
+        // seed tells apart different kinds of paths that could have the same bytes.
+        static Key MakeKey(const void* pPath, size_t byteCount, uint64_t seed, int32_t width, int32_t height);
+
+        // 64 bit hash of size bytes, reads 32 of them at a time.
+        static uint64_t Hash(const void* pData, size_t size, uint64_t seed);
+
+        // Copies the thumbnail to pPixels (width * height pixels of the key) if there is one, and marks it as used.
+        bool TryGet(const Key& key, uint32_t* pPixels);
+        // Adds a copy of the thumbnail, or replaces the one with the same key.
+        void Put(const Key& key, const uint32_t* pPixels);
+
+        void Clear();
+
+        size_t GetCount() const;
+        size_t GetBytes() const;
+
+    private:
+        struct KeyHash
+        {
+            size_t operator()(const Key& key) const
+            {
+                return static_cast<size_t>(key.hash);
+            }
+        };
+
+        struct Entry
+        {
+            Key key;
+            std::vector<uint32_t> pixels;
+        };
+
+        mutable std::mutex m_mutex;
+
+        // the most recently used first
+        std::list<Entry> m_entries;
+        std::unordered_map<Key, std::list<Entry>::iterator, KeyHash> m_index;
+
+        size_t m_maxBytes;
+        size_t m_bytes;
+
+        void Remove(std::list<Entry>::iterator it);
+    };
+}
@@ -0,0 +1,119 @@
+#include "TileGrid.h"
+#include <algorithm>
+#include <cmath>
+
+using namespace PathWindows;
+
+TileGrid::TileGrid(int32_t width, int32_t height, int32_t tileSize) :
+    m_width(std::max(width, 0)),
+    m_height(std::max(height, 0)),
+    m_tileSize(std::max(tileSize, 1)),
+    m_columns((m_width + m_tileSize - 1) / m_tileSize),
+    m_rows((m_height + m_tileSize - 1) / m_tileSize),
+    m_occupied(static_cast<size_t>(m_columns) * m_rows, 0),
+    m_occupiedCount(0)
+{}
+
+void TileGrid::MarkSegment(PointF a, PointF b, float inflate)
+{
+    if (m_occupied.empty()) return;
+
+    float top = std::min(a.y, b.y) - inflate;
+    float bottom = std::max(a.y, b.y) + inflate;
+    if (bottom < 0.0f || top >= static_cast<float>(m_height)) return;
+
+    int32_t firstRow = std::max(static_cast<int32_t>(std::floor(top / m_tileSize)), 0);
+    int32_t lastRow = std::min(static_cast<int32_t>(std::floor(bottom / m_tileSize)), m_rows - 1);
+
+    float dy = b.y - a.y;
+
+    for (int32_t row = firstRow; row <= lastRow; ++row)
+    {
+        // clip the segment to the band of rows this tile row covers (grown by inflate), and mark the columns
+        // between where it enters and leaves the band
+        float bandTop = static_cast<float>(row * m_tileSize) - inflate;
+        float bandBottom = static_cast<float>((row + 1) * m_tileSize) + inflate;
+
+        float t0 = 0.0f;
+        float t1 = 1.0f;
+        if (dy != 0.0f)
+        {
+            float tTop = (bandTop - a.y) / dy;
+            float tBottom = (bandBottom - a.y) / dy;
+            t0 = std::max(std::min(tTop, tBottom), 0.0f);
+            t1 = std::min(std::max(tTop, tBottom), 1.0f);
+            if (t0 > t1) continue;
+        }
+
+        float x0 = a.x + (b.x - a.x) * t0;
+        float x1 = a.x + (b.x - a.x) * t1;
+
+        float left = std::min(x0, x1) - inflate;
+        float right = std::max(x0, x1) + inflate;
+        if (right < 0.0f || left >= static_cast<float>(m_width)) continue;
+
+        int32_t firstColumn = std::max(static_cast<int32_t>(std::floor(left / m_tileSize)), 0);
+        int32_t lastColumn = std::min(static_cast<int32_t>(std::floor(right / m_tileSize)), m_columns - 1);
+
+        MarkSpan(row, firstColumn, lastColumn);
+    }
+}
+
+void TileGrid::MarkRect(RectI rect)
+{
+    int32_t left = std::max(rect.left, 0);
+    int32_t top = std::max(rect.top, 0);
+    int32_t right = std::min(rect.right, m_width);
+    int32_t bottom = std::min(rect.bottom, m_height);
+    if (left >= right || top >= bottom) return;
+
+    for (int32_t row = top / m_tileSize; row <= (bottom - 1) / m_tileSize; ++row) MarkSpan(row, left / m_tileSize, (right - 1) / m_tileSize);
+}
+
+void TileGrid::Clear()
+{
+    if (m_occupiedCount == 0) return;
+
+    std::fill(m_occupied.begin(), m_occupied.end(), static_cast<uint8_t>(0));
+    m_occupiedCount = 0;
+}
+
+bool TileGrid::IsEmpty() const
+{
+    return m_occupiedCount == 0;
+}
+
+size_t TileGrid::GetOccupiedCount() const
+{
+    return m_occupiedCount;
+}
+
+size_t TileGrid::GetTileCount() const
+{
+    return m_occupied.size();
+}
+
+bool TileGrid::IsOccupied(int32_t column, int32_t row) const
+{
+    return m_occupied[static_cast<size_t>(row) * m_columns + column] != 0;
+}
+
+void TileGrid::MarkSpan(int32_t row, int32_t firstColumn, int32_t lastColumn)
+{
+    uint8_t* pRow = m_occupied.data() + static_cast<size_t>(row) * m_columns;
+    for (int32_t column = firstColumn; column <= lastColumn; ++column)
+    {
+        m_occupiedCount += pRow[column] == 0;
+        pRow[column] = 1;
+    }
+}
+
+RectI TileGrid::GetSpanRect(int32_t row, int32_t firstColumn, int32_t endColumn) const
+{
+    return RectI{
+        firstColumn * m_tileSize,
+        row * m_tileSize,
+        std::min(endColumn * m_tileSize, m_width),
+        std::min((row + 1) * m_tileSize, m_height)
+    };
+}
@@ -0,0 +1,68 @@
+#pragma once
+#include "PathTypes.h"
+#include <vector>
+#include <cstdint>
+#include <cstddef>
+
+namespace PathWindows
+{
+    // Divides a surface into square tiles and records which of them anything was drawn into, so that clearing the
+    // surface only has to touch the tiles a path actually passed through.
+    class TileGrid
+    {
+    public:
+        TileGrid(int32_t width, int32_t height, int32_t tileSize = 256);
+
+        // Marks every tile the segment from a to b, grown by inflate on every side, passes through.
+        void MarkSegment(PointF a, PointF b, float inflate);
+
+        // Marks every tile the rect overlaps.
+        void MarkRect(RectI rect);
+
+        void Clear();
+
+        bool IsEmpty() const;
+
+        size_t GetOccupiedCount() const;
+        size_t GetTileCount() const;
+
+        bool IsOccupied(int32_t column, int32_t row) const;
+
+        // Calls fn(RectI) for every run of horizontally adjacent occupied tiles, clipped to the surface.
+        template<class Fn>
+        void ForEachOccupiedSpan(Fn&& fn) const
+        {
+            for (int32_t row = 0; row < m_rows; ++row)
+            {
+                int32_t column = 0;
+                while (column < m_columns)
+                {
+                    if (!IsOccupied(column, row))
+                    {
+                        ++column;
+                        continue;
+                    }
+
+                    int32_t first = column;
+                    while (column < m_columns && IsOccupied(column, row)) ++column;
+
+                    fn(GetSpanRect(row, first, column));
+                }
+            }
+        }
+
+    private:
+        int32_t m_width;
+        int32_t m_height;
+        int32_t m_tileSize;
+        int32_t m_columns;
+        int32_t m_rows;
+
+        std::vector<uint8_t> m_occupied;
+        size_t m_occupiedCount;
+
+        void MarkSpan(int32_t row, int32_t firstColumn, int32_t lastColumn);
+
+        RectI GetSpanRect(int32_t row, int32_t firstColumn, int32_t endColumn) const;
+    };
+}
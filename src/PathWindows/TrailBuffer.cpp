@@ -0,0 +1,95 @@
+#include "TrailBuffer.h"
+#include <algorithm>
+
+using namespace PathWindows;
+
+TrailBuffer::TrailBuffer() :
+    m_head(0),
+    m_count(0),
+    m_maxPoints(0),
+    m_maxAgeNS(0)
+{}
+
+void TrailBuffer::Configure(size_t maxPoints, int64_t maxAgeNS)
+{
+    m_maxPoints = maxPoints;
+    m_maxAgeNS = maxAgeNS > 0 ? maxAgeNS : 0;
+
+    // sized once, the ring never allocates while points stream through it, and turning it off frees it
+    m_points = std::vector<PointF>(maxPoints);
+    m_times = std::vector<int64_t>(maxPoints);
+    m_figureStarts = std::vector<uint8_t>(maxPoints);
+
+    Clear();
+}
+
+void TrailBuffer::Append(PointF point, bool newFigure, int64_t nowNS)
+{
+    if (m_maxPoints == 0) return;
+
+    if (m_count == m_maxPoints) PopOldest();
+
+    // the buckets rely on the times never going back
+    if (m_count > 0) nowNS = (std::max)(nowNS, m_times[Physical(m_count - 1)]);
+
+    size_t physical = Physical(m_count);
+    m_points[physical] = point;
+    m_times[physical] = nowNS;
+    m_figureStarts[physical] = newFigure;
+
+    ++m_count;
+}
+
+size_t TrailBuffer::Evict(int64_t nowNS)
+{
+    if (m_maxAgeNS == 0) return 0;
+
+    size_t evicted = 0;
+    while (m_count > 0 && nowNS - m_times[m_head] > m_maxAgeNS)
+    {
+        PopOldest();
+        ++evicted;
+    }
+
+    return evicted;
+}
+
+void TrailBuffer::PopOldest()
+{
+    m_head = m_head + 1 < m_maxPoints ? m_head + 1 : 0;
+    --m_count;
+}
+
+void TrailBuffer::Clear()
+{
+    m_head = 0;
+    m_count = 0;
+}
+
+size_t TrailBuffer::GetCount() const
+{
+    return m_count;
+}
+
+size_t TrailBuffer::GetMaxPoints() const
+{
+    return m_maxPoints;
+}
+
+bool TrailBuffer::IsAging() const
+{
+    return m_maxAgeNS > 0 && m_count > 0;
+}
+
+size_t TrailBuffer::GetBucket(size_t index, int64_t nowNS, size_t bucketCount) const
+{
+    if (bucketCount < 2) return 0;
+
+    // how far along the point is towards being dropped, by whichever limit drops it first
+    double fraction = static_cast<double>(m_count - 1 - index) / static_cast<double>(m_maxPoints);
+    if (m_maxAgeNS > 0) fraction = (std::max)(fraction, static_cast<double>(nowNS - m_times[Physical(index)]) / static_cast<double>(m_maxAgeNS));
+
+    if (!(fraction > 0.0)) return 0;
+
+    return (std::min)(static_cast<size_t>(fraction * static_cast<double>(bucketCount)), bucketCount - 1);
+}
@@ -0,0 +1,114 @@
+#pragma once
+#include "PathTypes.h"
+#include <vector>
+#include <cstdint>
+#include <cstddef>
+
+namespace PathWindows
+{
+    // Keeps only the newest points of a path, at most a fixed number of them and optionally only those younger than
+    // a max age, in a ring that never grows, so any number of points can stream through it in constant memory.
+    // Points are split into fade buckets by how close they are to being dropped, bucket 0 holding the newest.
+    // Times are in nanoseconds, from any monotonic clock.
+    class TrailBuffer
+    {
+    public:
+        TrailBuffer();
+
+        // Clears the trail. A maxAgeNS of 0 or less keeps points until they are pushed out by newer ones.
+        void Configure(size_t maxPoints, int64_t maxAgeNS);
+
+        // Drops the oldest point if the trail is full.
+        void Append(PointF point, bool newFigure, int64_t nowNS);
+
+        // Drops the points older than the max age and returns how many.
+        size_t Evict(int64_t nowNS);
+
+        void Clear();
+
+        size_t GetCount() const;
+        size_t GetMaxPoints() const;
+
+        // Whether the trail changes with time alone, i.e. points are dropped (and fade) as they get older.
+        bool IsAging() const;
+
+        // The fade bucket of the segment that ends at the index-th oldest point.
+        size_t GetBucket(size_t index, int64_t nowNS, size_t bucketCount) const;
+
+        // Calls fn(size_t bucket, const PointF* points, size_t count) for every run of segments of the same figure in
+        // the same fade bucket, oldest first (so in descending bucket order). A run that continues the one before starts
+        // at its last point, so the segments join up.
+        template<class Fn>
+        void ForEachRun(int64_t nowNS, size_t bucketCount, Fn&& fn) const
+        {
+            size_t start = 0;
+            size_t bucket = 0;
+            bool hasSegment = false;
+
+            for (size_t i = 1; i < m_count; ++i)
+            {
+                if (m_figureStarts[Physical(i)])
+                {
+                    if (hasSegment) EmitRun(start, i - 1, bucket, fn);
+
+                    start = i;
+                    hasSegment = false;
+                    continue;
+                }
+
+                size_t b = GetBucket(i, nowNS, bucketCount);
+                if (hasSegment && b != bucket)
+                {
+                    EmitRun(start, i - 1, bucket, fn);
+                    start = i - 1;
+                }
+
+                bucket = b;
+                hasSegment = true;
+            }
+
+            if (hasSegment) EmitRun(start, m_count - 1, bucket, fn);
+        }
+
+    private:
+        std::vector<PointF> m_points;
+        std::vector<int64_t> m_times;
+        std::vector<uint8_t> m_figureStarts;
+
+        // physical index of the oldest point
+        size_t m_head;
+        size_t m_count;
+
+        size_t m_maxPoints;
+        int64_t m_maxAgeNS;
+
+        size_t Physical(size_t index) const
+        {
+            size_t physical = m_head + index;
+            return physical < m_maxPoints ? physical : physical - m_maxPoints;
+        }
+
+        void PopOldest();
+
+        // Emits the points from index first to last, split where the ring wraps around.
+        template<class Fn>
+        void EmitRun(size_t first, size_t last, size_t bucket, Fn& fn) const
+        {
+            size_t begin = Physical(first);
+            size_t end = Physical(last);
+
+            if (begin <= end)
+            {
+                fn(bucket, m_points.data() + begin, end - begin + 1);
+                return;
+            }
+
+            if (m_maxPoints - begin > 1) fn(bucket, m_points.data() + begin, m_maxPoints - begin);
+
+            PointF bridge[2] = { m_points[m_maxPoints - 1], m_points[0] };
+            fn(bucket, bridge, 2);
+
+            if (end > 0) fn(bucket, m_points.data(), end + 1);
+        }
+    };
+}
@@ -0,0 +1,51 @@
+#include "pch.h"
+#include "Win32PlaybackClock.h"
+#include <chrono>
+
+using namespace PathWindows;
+
+Win32PlaybackClock::Win32PlaybackClock() :
+    m_hTimer(CreateWaitableTimerExW(nullptr, nullptr, CREATE_WAITABLE_TIMER_HIGH_RESOLUTION, TIMER_ALL_ACCESS))
+{
+    // the flag is not supported before Windows 10 1803
+    if (!m_hTimer) m_hTimer = CreateWaitableTimerExW(nullptr, nullptr, 0, TIMER_ALL_ACCESS);
+}
+
+Win32PlaybackClock::~Win32PlaybackClock()
+{
+    if (m_hTimer) CloseHandle(m_hTimer);
+}
+
+int64_t Win32PlaybackClock::Now()
+{
+    // steady_clock reads QueryPerformanceCounter
+    return std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now().time_since_epoch()).count();
+}
+
+void Win32PlaybackClock::Sleep(int64_t durationNS)
+{
+    if (m_hTimer)
+    {
+        // negative due times are relative, in 100 ns units
+        LARGE_INTEGER dueTime;
+        dueTime.QuadPart = -(durationNS / 100);
+
+        if (SetWaitableTimer(m_hTimer, &dueTime, 0, nullptr, nullptr, FALSE))
+        {
+            WaitForSingleObject(m_hTimer, INFINITE);
+            return;
+        }
+    }
+
+    ::Sleep(static_cast<DWORD>(durationNS / 1'000'000));
+}
+
+void Win32PlaybackClock::Pause()
+{
+    YieldProcessor();
+}
+
+void Win32PlaybackClock::OnThreadStarted()
+{
+    SetThreadPriority(GetCurrentThread(), THREAD_PRIORITY_HIGHEST);
+}
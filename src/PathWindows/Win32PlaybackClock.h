@@ -0,0 +1,26 @@
+#pragma once
+#include "PlaybackScheduler.h"
+
+namespace PathWindows
+{
+    // Sleeps on a high resolution waitable timer where there is one (Windows 10 1803 and later), which wakes up within
+    // about half a millisecond instead of a whole timer tick, and raises the priority of the playback thread.
+    class Win32PlaybackClock : public PlaybackClock
+    {
+    public:
+        Win32PlaybackClock();
+        ~Win32PlaybackClock();
+
+        Win32PlaybackClock(const Win32PlaybackClock&) = delete;
+        Win32PlaybackClock& operator=(const Win32PlaybackClock&) = delete;
+
+        int64_t Now() override;
+        void Sleep(int64_t durationNS) override;
+        void Pause() override;
+        void OnThreadStarted() override;
+
+    private:
+        // null if no timer could be created, then it sleeps with Sleep
+        HANDLE m_hTimer;
+    };
+}
@@ -1,24 +1,38 @@
 #include "pch.h"
 #include "WindowHost.h"
+#include "OverlayHost.h"
+#include "Telemetry.h"
+#include <chrono>
 
 using namespace PathWindows;
 
+static int64_t GetNowNS()
+{
+    return std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now().time_since_epoch()).count();
+}
+
 WindowHost::WindowHost(IWindow* pPathWindow) :
     m_pWindow(pPathWindow),
-    m_isRunning(false),
     m_threadHR(S_OK),
-    m_wndInitCondVar(),
-    m_wndInitMutex(),
-    m_thread(&WindowHost::CreateAndShowWindow, this)
+    m_lifetime(GetNowNS())
 {
-    std::unique_lock<std::mutex> lk(m_wndInitMutex);
-    m_wndInitCondVar.wait(lk, [this] { return m_isRunning; });
+    OverlayHost& host = OverlayHost::Get();
+
+    m_threadHR = host.Start();
+    if (FAILED(m_threadHR))
+    {
+        delete pPathWindow;
+        m_pWindow = nullptr;
+        m_lifetime.OnCreated(false, GetNowNS());
+        return;
+    }
+
+    host.Invoke([this] { CreateWindowOnHost(); });
 }
 
 WindowHost::~WindowHost()
 {
     CloseWindow();
-    if (m_thread.joinable()) m_thread.join();
 }
 
 IWindow* WindowHost::GetPWindow()
@@ -31,46 +45,68 @@ HRESULT WindowHost::GetThreadHR()
     return m_threadHR;
 }
 
-void WindowHost::CreateAndShowWindow()
+int64_t WindowHost::GetOpenLatency()
+{
+    return m_lifetime.GetOpenLatency();
+}
+
+void WindowHost::CreateWindowOnHost()
 {
-    m_threadHR = CoInitializeEx(NULL, COINIT_APARTMENTTHREADED);
-    if (FAILED(m_threadHR)) return;
+    IWindow* pWindow = m_pWindow;
 
-    m_threadHR = m_pWindow->Initialize();
+    m_threadHR = pWindow->Initialize();
     if (FAILED(m_threadHR))
     {
-        delete m_pWindow;
+        // the window may have been created before initializing failed, and the thread does not end with it
+        HWND hWnd = pWindow->GetHandle();
+        if (hWnd) DestroyWindow(hWnd);
+
+        delete pWindow;
         m_pWindow = nullptr;
+        m_lifetime.OnCreated(false, GetNowNS());
         return;
     }
 
+    // the window cannot be deleted while it handles WM_DESTROY
+    pWindow->SetOnDestroyed([this]
     {
-        std::lock_guard<std::mutex> lk(m_wndInitMutex);
-        m_isRunning = true;
-    }
-    m_wndInitCondVar.notify_all();
+        m_lifetime.OnDestroying();
+        OverlayHost::Get().Post([this] { OnWindowDestroyed(); });
+    });
 
-    m_threadHR = m_pWindow->RunMessageLoop();
+    OverlayHost::Get().OnWindowOpened();
 
-    CoUninitialize();
-    
-    m_isRunning = false;
+    // Initialize renders the first frame
+    m_lifetime.OnCreated(true, GetNowNS());
 
-    delete m_pWindow;
-    m_pWindow = nullptr;
+    Telemetry::Get().openLatency.Record(m_lifetime.GetOpenLatency());
+}
+
+void WindowHost::OnWindowDestroyed()
+{
+    // CloseWindow only reads the window while the lifetime is OPEN, which OnDestroying ended
+    delete m_pWindow.exchange(nullptr);
+
+    OverlayHost::Get().OnWindowClosed();
+
+    m_lifetime.OnClosed();
 }
 
 HRESULT WindowHost::CloseWindow()
 {
-    if (!m_pWindow)
+    HRESULT hr = m_threadHR;
+
+    HWND hWnd = nullptr;
+    if (m_lifetime.BeginClose([this, &hWnd] { hWnd = m_pWindow.load()->GetHandle(); }) && hWnd)
     {
-        if (m_thread.joinable()) m_thread.join();
-        return E_FAIL;
+        // if posting fails the window is already being destroyed
+        if (PostMessage(hWnd, WM_CLOSE, 0, 0) == 0) hr = HRESULT_FROM_WIN32(GetLastError());
     }
 
-    if (PostMessage(m_pWindow->GetHandle(), WM_CLOSE, 0, 0) == 0) return E_FAIL;
+    // on the host thread the window would never get to close
+    if (OverlayHost::Get().IsHostThread()) return hr;
 
-    m_thread.join();
+    m_lifetime.WaitUntilClosed();
 
-    return m_threadHR;
+    return hr;
 }
@@ -1,11 +1,13 @@
 #pragma once
 #include "pch.h"
 #include "IWindow.h"
-#include <thread>
-#include <condition_variable>
+#include "OverlayLifetime.h"
+#include <atomic>
 
 namespace PathWindows
 {
+	// Owns one window that lives on the OverlayHost thread, and lets other threads wait for it to open and close.
+	// Must not be destroyed on the host thread.
 	class WindowHost
 	{
 	public:
@@ -17,17 +19,17 @@ namespace PathWindows
 
 		HRESULT CloseWindow();
 
-	private:
-		std::thread m_thread;
-		bool m_isRunning;
-
-		std::condition_variable m_wndInitCondVar;
-		std::mutex m_wndInitMutex;
+		// Nanoseconds from when the host was created until the window showed its first frame, or -1 if it did not open.
+		int64_t GetOpenLatency();
 
-		IWindow* m_pWindow;
+	private:
+		std::atomic<IWindow*> m_pWindow;
 
 		HRESULT m_threadHR;
 
-		void CreateAndShowWindow();
+		OverlayLifetime m_lifetime;
+
+		void CreateWindowOnHost();
+		void OnWindowDestroyed();
 	};
 }
@@ -2,6 +2,7 @@
 #include "WindowHost.h"
 #include "PathWindow.h"
 #include "DrawablePathWindow.h"
+#include "OverlayHost.h"
 
 using namespace PathWindows;
 
@@ -15,6 +16,7 @@ extern "C" __declspec(dllexport) HRESULT __cdecl CreatePathWindow(POINT* points,
     hr = wrapper->GetThreadHR();
     if (FAILED(hr))
     {
+        delete wrapper;
         (*ppWrapper) = 0;
         return hr;
     }
@@ -23,7 +25,7 @@ extern "C" __declspec(dllexport) HRESULT __cdecl CreatePathWindow(POINT* points,
 
     if (points)
     {
-        hr = static_cast<PathWindow*>(wrapper->GetPWindow())->AddPoints(points, length);
+        hr = static_cast<PathWindow*>(wrapper->GetPWindow())->EnqueuePoints(points, length);
     }
 
     return hr;
@@ -45,6 +47,7 @@ extern "C" __declspec(dllexport) HRESULT __cdecl CreateDrawablePathWindow(MouseM
     hr = wrapper->GetThreadHR();
     if (FAILED(hr))
     {
+        delete wrapper;
         (*ppWrapper) = 0;
         return hr;
     }
@@ -73,3 +76,25 @@ extern "C" __declspec(dllexport) void __cdecl DisposeDangerous(WindowHost* pWrap
 
     delete pWrapper;
 }
+
+// Nanoseconds from the create call until the window showed its first frame, or -1 if it did not open.
+extern "C" __declspec(dllexport) HRESULT __cdecl GetPathWindowOpenLatency(WindowHost* pWrapper, int64_t* pLatencyNS)
+{
+    if (!pWrapper || !pLatencyNS) return E_POINTER;
+
+    *pLatencyNS = pWrapper->GetOpenLatency();
+
+    return S_OK;
+}
+
+// Starts the thread the windows live on, and creates what they share on it, so that the first window opens as fast as the rest.
+extern "C" __declspec(dllexport) HRESULT __cdecl WarmUpWindowHost()
+{
+    return OverlayHost::Get().WarmUp();
+}
+
+// Stops the thread the windows live on. Fails while any window is open.
+extern "C" __declspec(dllexport) HRESULT __cdecl ShutdownWindowHost()
+{
+    return OverlayHost::Get().Shutdown();
+}
@@ -0,0 +1,88 @@
+#pragma once
+#include <cstddef>
+#include <functional>
+#include <future>
+#include <memory>
+#include <mutex>
+#include <utility>
+#include <vector>
+
+namespace PathWindows
+{
+    // Runs work items posted from any thread on the one thread that calls RunPending.
+    // The wake function is called (outside the lock) when work is posted while none is pending, so that the owning
+    // thread knows to call RunPending. Posts that arrive before it gets to run only wake it once.
+    class WorkDispatcher
+    {
+    public:
+        explicit WorkDispatcher(std::function<void()> wake = nullptr) :
+            m_wake(std::move(wake)),
+            m_wakePending(false)
+        {}
+
+        // Must be set before anything is posted.
+        void SetWake(std::function<void()> wake)
+        {
+            m_wake = std::move(wake);
+        }
+
+        void Post(std::function<void()> work)
+        {
+            bool wake;
+            {
+                std::lock_guard<std::mutex> lock(m_mutex);
+                m_pending.push_back(std::move(work));
+
+                wake = !m_wakePending;
+                m_wakePending = true;
+            }
+
+            if (wake && m_wake) m_wake();
+        }
+
+        // Posts fn and returns a future for its result.
+        template<class Fn>
+        auto PostForResult(Fn&& fn) -> std::future<decltype(fn())>
+        {
+            // std::function must be copyable, which a packaged_task is not
+            auto task = std::make_shared<std::packaged_task<decltype(fn())()>>(std::forward<Fn>(fn));
+            auto result = task->get_future();
+
+            Post([task] { (*task)(); });
+
+            return result;
+        }
+
+        // Runs everything posted so far, in order, and returns how many items ran.
+        // Work posted by the items themselves runs on the next call.
+        size_t RunPending()
+        {
+            {
+                std::lock_guard<std::mutex> lock(m_mutex);
+                m_running.swap(m_pending);
+                m_wakePending = false;
+            }
+
+            size_t count = m_running.size();
+            for (auto&& work : m_running) work();
+            m_running.clear();
+
+            return count;
+        }
+
+        bool HasPending()
+        {
+            std::lock_guard<std::mutex> lock(m_mutex);
+            return !m_pending.empty();
+        }
+
+    private:
+        std::mutex m_mutex;
+        std::vector<std::function<void()>> m_pending;
+        // only touched by the thread that runs the work, the capacity of both vectors is reused
+        std::vector<std::function<void()>> m_running;
+
+        std::function<void()> m_wake;
+        bool m_wakePending;
+    };
+}
@@ -2,6 +2,8 @@
 
 // Exclude rarely-used stuff from Windows headers
 #define WIN32_LEAN_AND_MEAN
+// Keep min and max from clashing with std::min, std::max and numeric_limits
+#define NOMINMAX
 // Windows Header Files
 #include <windows.h>
 
@@ -0,0 +1,107 @@
+#pragma once
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <cstddef>
+
+// A minimal benchmark harness in the style of Google Benchmark, so the benchmarks build with nothing but the standard library.
+// Every BENCHMARK is run with more and more iterations until it takes long enough to time, then reported as the time per
+// iteration, the items and bytes processed per second if it sets them, and its counters.
+// The executable takes an optional argument, and then only runs the benchmarks whose names contain it.
+// --quick runs every benchmark once (for smoke testing), --min-time=<seconds> sets how long each one runs (0.5 by default).
+// The executable exits with 1 if any benchmark reported an error, e.g. missed its budget.
+
+namespace PathWindows::Benchmarks
+{
+    class State
+    {
+    public:
+        explicit State(uint64_t iterations);
+
+        // Returns true as long as there are iterations left, and times them, so the benchmark runs
+        // while (state.KeepRunning()) { ... }.
+        bool KeepRunning();
+
+        // Leaves what happens in between (e.g. resetting what an iteration changed) out of the time.
+        void PauseTiming();
+        void ResumeTiming();
+
+        uint64_t GetIterations() const;
+
+        // The totals over all iterations, reported per second.
+        void SetItemsProcessed(uint64_t items);
+        void SetBytesProcessed(uint64_t bytes);
+
+        // Reports a value as it is, e.g. a ratio or a count. The name has to outlive the run.
+        void SetCounter(const char* name, double value);
+
+        // Fails the benchmark, e.g. when it is slower than its budget. The message has to outlive the run.
+        void SetError(const char* message);
+
+        // what the runner reads
+        double GetSeconds() const;
+        uint64_t GetItemsProcessed() const;
+        uint64_t GetBytesProcessed() const;
+        size_t GetCounterCount() const;
+        const char* GetCounterName(size_t index) const;
+        double GetCounterValue(size_t index) const;
+        const char* GetError() const;
+
+    private:
+        static constexpr size_t MAX_COUNTERS = 8;
+
+        typedef std::chrono::steady_clock Clock;
+
+        const uint64_t ITERATIONS;
+        uint64_t m_left;
+        bool m_started;
+
+        Clock::time_point m_resumed;
+        Clock::duration m_elapsed;
+        bool m_paused;
+
+        uint64_t m_items;
+        uint64_t m_bytes;
+
+        const char* m_counterNames[MAX_COUNTERS];
+        double m_counterValues[MAX_COUNTERS];
+        size_t m_counterCount;
+
+        const char* m_error;
+    };
+
+    typedef void(*BenchmarkFunction)(State&);
+
+    // Adds a benchmark to the executable, BENCHMARK defines one of these for every benchmark.
+    struct BenchmarkRegistrar
+    {
+        BenchmarkRegistrar(const char* name, BenchmarkFunction function);
+    };
+
+    // Keeps the compiler from optimizing away the computation of value.
+    template<class T>
+    inline void DoNotOptimize(const T& value)
+    {
+#if defined(__GNUC__) || defined(__clang__)
+        asm volatile("" : : "r,m"(value) : "memory");
+#else
+        const volatile char* p = reinterpret_cast<const volatile char*>(&value);
+        static_cast<void>(*p);
+#endif
+    }
+
+    // Keeps the compiler from assuming memory is unchanged across it.
+    inline void ClobberMemory()
+    {
+#if defined(__GNUC__) || defined(__clang__)
+        asm volatile("" : : : "memory");
+#else
+        std::atomic_signal_fence(std::memory_order_seq_cst);
+#endif
+    }
+}
+
+#define BENCHMARK(name) \
+    static void name(PathWindows::Benchmarks::State& state); \
+    static const PathWindows::Benchmarks::BenchmarkRegistrar name##Registrar(#name, name); \
+    static void name(PathWindows::Benchmarks::State& state)
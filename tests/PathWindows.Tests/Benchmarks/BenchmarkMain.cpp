@@ -0,0 +1,230 @@
+#include "BenchmarkHarness.h"
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <vector>
+
+using namespace PathWindows::Benchmarks;
+
+State::State(uint64_t iterations) :
+    ITERATIONS(iterations),
+    m_left(iterations),
+    m_started(false),
+    m_elapsed(0),
+    m_paused(false),
+    m_items(0),
+    m_bytes(0),
+    m_counterNames{},
+    m_counterValues{},
+    m_counterCount(0),
+    m_error(nullptr)
+{}
+
+bool State::KeepRunning()
+{
+    if (!m_started)
+    {
+        m_started = true;
+        m_resumed = Clock::now();
+    }
+
+    if (m_left > 0)
+    {
+        --m_left;
+        return true;
+    }
+
+    if (!m_paused) m_elapsed += Clock::now() - m_resumed;
+    m_paused = true;
+
+    return false;
+}
+
+void State::PauseTiming()
+{
+    if (m_paused) return;
+
+    m_elapsed += Clock::now() - m_resumed;
+    m_paused = true;
+}
+
+void State::ResumeTiming()
+{
+    if (!m_paused) return;
+
+    m_paused = false;
+    m_resumed = Clock::now();
+}
+
+uint64_t State::GetIterations() const
+{
+    return ITERATIONS;
+}
+
+void State::SetItemsProcessed(uint64_t items)
+{
+    m_items = items;
+}
+
+void State::SetBytesProcessed(uint64_t bytes)
+{
+    m_bytes = bytes;
+}
+
+void State::SetCounter(const char* name, double value)
+{
+    for (size_t i = 0; i < m_counterCount; ++i)
+    {
+        if (std::strcmp(m_counterNames[i], name) == 0)
+        {
+            m_counterValues[i] = value;
+            return;
+        }
+    }
+
+    if (m_counterCount == MAX_COUNTERS) return;
+
+    m_counterNames[m_counterCount] = name;
+    m_counterValues[m_counterCount] = value;
+    ++m_counterCount;
+}
+
+void State::SetError(const char* message)
+{
+    m_error = message;
+}
+
+double State::GetSeconds() const
+{
+    return std::chrono::duration<double>(m_elapsed).count();
+}
+
+uint64_t State::GetItemsProcessed() const
+{
+    return m_items;
+}
+
+uint64_t State::GetBytesProcessed() const
+{
+    return m_bytes;
+}
+
+size_t State::GetCounterCount() const
+{
+    return m_counterCount;
+}
+
+const char* State::GetCounterName(size_t index) const
+{
+    return m_counterNames[index];
+}
+
+double State::GetCounterValue(size_t index) const
+{
+    return m_counterValues[index];
+}
+
+const char* State::GetError() const
+{
+    return m_error;
+}
+
+namespace
+{
+    struct Benchmark
+    {
+        const char* name;
+        BenchmarkFunction function;
+    };
+
+    // a function local, so it exists before the registrars of the benchmarks run
+    std::vector<Benchmark>& GetBenchmarks()
+    {
+        static std::vector<Benchmark> benchmarks;
+        return benchmarks;
+    }
+
+    void PrintRate(double perSecond, const char* unit)
+    {
+        if (perSecond >= 1e9) std::printf("  %8.2f G%s/s", perSecond / 1e9, unit);
+        else if (perSecond >= 1e6) std::printf("  %8.2f M%s/s", perSecond / 1e6, unit);
+        else if (perSecond >= 1e3) std::printf("  %8.2f k%s/s", perSecond / 1e3, unit);
+        else std::printf("  %8.2f %s/s", perSecond, unit);
+    }
+
+    void Report(const char* name, const State& state)
+    {
+        double seconds = state.GetSeconds();
+        double ns = seconds * 1e9 / static_cast<double>(state.GetIterations());
+
+        std::printf("%-48s %12llu %14.1f ns", name, static_cast<unsigned long long>(state.GetIterations()), ns);
+
+        if (seconds > 0)
+        {
+            if (state.GetItemsProcessed() > 0) PrintRate(state.GetItemsProcessed() / seconds, "items");
+            if (state.GetBytesProcessed() > 0) PrintRate(state.GetBytesProcessed() / seconds, "B");
+        }
+
+        for (size_t i = 0; i < state.GetCounterCount(); ++i)
+        {
+            std::printf("  %s=%g", state.GetCounterName(i), state.GetCounterValue(i));
+        }
+
+        if (state.GetError()) std::printf("  ERROR: %s", state.GetError());
+
+        std::printf("\n");
+        std::fflush(stdout);
+    }
+}
+
+BenchmarkRegistrar::BenchmarkRegistrar(const char* name, BenchmarkFunction function)
+{
+    GetBenchmarks().push_back(Benchmark{ name, function });
+}
+
+int main(int argc, char** argv)
+{
+    const char* filter = nullptr;
+    bool quick = false;
+    double minSeconds = 0.5;
+
+    for (int i = 1; i < argc; ++i)
+    {
+        if (std::strcmp(argv[i], "--quick") == 0) quick = true;
+        else if (std::strncmp(argv[i], "--min-time=", 11) == 0) minSeconds = std::atof(argv[i] + 11);
+        else filter = argv[i];
+    }
+
+    std::printf("%-48s %12s %17s\n", "benchmark", "iterations", "time/iteration");
+
+    bool failed = false;
+
+    for (const Benchmark& benchmark : GetBenchmarks())
+    {
+        if (filter && !std::strstr(benchmark.name, filter)) continue;
+
+        uint64_t iterations = 1;
+        for (;;)
+        {
+            State state(iterations);
+            benchmark.function(state);
+
+            double seconds = state.GetSeconds();
+            if (quick || seconds >= minSeconds || iterations >= (1ull << 40) || state.GetError() != nullptr)
+            {
+                Report(benchmark.name, state);
+                failed = failed || state.GetError() != nullptr;
+                break;
+            }
+
+            // aims a little past the minimum time, but grows by at most 10 times so a slow start does not overshoot
+            double scale = seconds > 0 ? minSeconds * 1.4 / seconds : 10.0;
+            if (scale > 10.0) scale = 10.0;
+            if (scale < 2.0) scale = 2.0;
+
+            iterations = static_cast<uint64_t>(static_cast<double>(iterations) * scale);
+        }
+    }
+
+    return failed ? 1 : 0;
+}
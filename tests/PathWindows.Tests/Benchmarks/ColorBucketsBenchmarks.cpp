@@ -0,0 +1,117 @@
+#include "BenchmarkHarness.h"
+#include "ColorBuckets.h"
+#include <algorithm>
+#include <cstdint>
+#include <random>
+#include <vector>
+
+using namespace PathWindows;
+using namespace PathWindows::Benchmarks;
+
+// Coloring a recorded path of 1M points by speed in 8 buckets. "draws" is how many strokes a frame takes, one per
+// bucket for the batched runs, against one per segment when every segment is stroked in its own color.
+
+namespace
+{
+    constexpr size_t POINT_COUNT = 1'000'000;
+    constexpr size_t BUCKET_COUNT = 8;
+
+    // a path that speeds up and slows down, at the polling rate
+    const std::vector<PointF>& GetPath()
+    {
+        static const std::vector<PointF> path = []
+        {
+            std::mt19937 random(1);
+            std::uniform_real_distribution<float> direction(-1.0f, 1.0f);
+
+            std::vector<PointF> points;
+            PointF position{ 960, 540 };
+            for (size_t i = 0; i < POINT_COUNT; ++i)
+            {
+                float speed = static_cast<float>((i / 200) % 10);
+                position.x = std::clamp(position.x + direction(random) * speed, 0.0f, 1919.0f);
+                position.y = std::clamp(position.y + direction(random) * speed, 0.0f, 1079.0f);
+                points.push_back(position);
+            }
+
+            return points;
+        }();
+
+        return path;
+    }
+
+    void Fill(ColorBuckets& buckets)
+    {
+        const std::vector<PointF>& path = GetPath();
+        for (size_t i = 0; i < path.size(); ++i) buckets.Append(path[i], 1'000'000, i == 0);
+    }
+}
+
+BENCHMARK(Build_Batched_1M)
+{
+    ColorBuckets buckets(ColorBuckets::Scale::SPEED, BUCKET_COUNT);
+    Fill(buckets);
+
+    uint64_t pointCount = 0;
+    while (state.KeepRunning())
+    {
+        buckets.Invalidate();
+        buckets.Build();
+        buckets.ForEachRun([&pointCount](size_t, const PointF*, size_t count) { pointCount += count; });
+    }
+
+    DoNotOptimize(pointCount);
+    state.SetItemsProcessed(state.GetIterations() * POINT_COUNT);
+    state.SetCounter("draws", static_cast<double>(buckets.GetBatchCount()));
+    state.SetCounter("runs", static_cast<double>(buckets.GetRunCount()));
+}
+
+// every segment as its own figure in its own color, which is what drawing them one by one has to build
+BENCHMARK(Build_PerSegment_1M)
+{
+    ColorBuckets buckets(ColorBuckets::Scale::SPEED, BUCKET_COUNT);
+    Fill(buckets);
+    const std::vector<PointF>& path = GetPath();
+
+    struct Draw
+    {
+        PointF from;
+        PointF to;
+        size_t bucket;
+    };
+    std::vector<Draw> draws;
+
+    while (state.KeepRunning())
+    {
+        draws.clear();
+        for (size_t i = 1; i < path.size(); ++i) draws.push_back(Draw{ path[i - 1], path[i], buckets.GetBucket(i) });
+        DoNotOptimize(draws.data());
+    }
+
+    state.SetItemsProcessed(state.GetIterations() * POINT_COUNT);
+    state.SetCounter("draws", static_cast<double>(draws.size()));
+}
+
+// a frame while recording, with the points of 16 ms at 1 kHz added since the last one
+BENCHMARK(Build_Incremental_16Points)
+{
+    ColorBuckets buckets(ColorBuckets::Scale::SPEED, BUCKET_COUNT);
+    Fill(buckets);
+    buckets.Build();
+    buckets.Commit();
+
+    const std::vector<PointF>& path = GetPath();
+    size_t next = 0;
+    uint64_t pointCount = 0;
+    while (state.KeepRunning())
+    {
+        for (int i = 0; i < 16; ++i) buckets.Append(path[next++ % POINT_COUNT], 1'000'000, false);
+
+        buckets.Build();
+        buckets.ForEachRun([&pointCount](size_t, const PointF*, size_t count) { pointCount += count; });
+        buckets.Commit();
+    }
+
+    DoNotOptimize(pointCount);
+    state.SetCounter("draws", static_cast<double>(buckets.GetBatchCount()));
+}
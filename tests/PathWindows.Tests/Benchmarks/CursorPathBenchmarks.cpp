@@ -0,0 +1,70 @@
+#include "BenchmarkHarness.h"
+#include "CursorPath.h"
+#include <random>
+#include <vector>
+
+using namespace PathWindows;
+using namespace PathWindows::Benchmarks;
+
+namespace
+{
+    constexpr size_t DELTA_COUNT = 500'000;
+
+    const RectI THREE_MONITORS[] = {
+        RectI{ 0, 0, 1919, 1079 },
+        RectI{ 1920, 0, 3839, 1079 },
+        RectI{ -1920, 0, -1, 1079 },
+    };
+
+    // a recording that mostly stays on one monitor and sometimes moves over to another one
+    std::vector<Movement> MakeDeltas()
+    {
+        std::mt19937 random(1);
+        std::uniform_int_distribution<int32_t> step(-12, 12);
+
+        std::vector<Movement> deltas(DELTA_COUNT);
+        for (size_t i = 0; i < DELTA_COUNT; ++i)
+        {
+            int32_t dx = step(random) + (i / 20000 % 4 < 2 ? 1 : -1);
+            deltas[i] = Movement{ PointI{ dx, step(random) }, 8'000'000 };
+        }
+
+        return deltas;
+    }
+}
+
+BENCHMARK(ToAbsolute_500K)
+{
+    std::vector<Movement> deltas = MakeDeltas();
+    std::vector<Movement> path(DELTA_COUNT + 1);
+
+    while (state.KeepRunning())
+    {
+        size_t count = 0;
+        CursorPath::ToAbsolute(Movement{ PointI{ 960, 540 }, 0 }, deltas.data(), deltas.size(), THREE_MONITORS, 3, PointI{ 1920, 0 }, path.data(), count);
+        DoNotOptimize(count);
+    }
+
+    state.SetItemsProcessed(state.GetIterations() * DELTA_COUNT);
+}
+
+BENCHMARK(ToRelative_500K)
+{
+    std::vector<Movement> deltas = MakeDeltas();
+    std::vector<Movement> absolute(DELTA_COUNT + 1);
+    size_t count = 0;
+    CursorPath::ToAbsolute(Movement{ PointI{ 960, 540 }, 0 }, deltas.data(), deltas.size(), THREE_MONITORS, 3, PointI{ 1920, 0 }, absolute.data(), count);
+
+    std::vector<Movement> path(count);
+    while (state.KeepRunning())
+    {
+        state.PauseTiming();
+        path.assign(absolute.begin(), absolute.begin() + count);
+        state.ResumeTiming();
+
+        CursorPath::ToRelative(path.data(), count, PointI{ 1920, 0 });
+        ClobberMemory();
+    }
+
+    state.SetItemsProcessed(state.GetIterations() * count);
+}
@@ -0,0 +1,81 @@
+#include "BenchmarkHarness.h"
+#include "DirtyRegion.h"
+#include <random>
+#include <vector>
+
+using namespace PathWindows;
+using namespace PathWindows::Benchmarks;
+
+namespace
+{
+    // A cursor path as a random walk that jumps somewhere else (starting a new figure) every jumpEvery points.
+    std::vector<PointF> MakeWalk(size_t count, size_t jumpEvery)
+    {
+        std::mt19937 rng(7);
+        std::uniform_real_distribution<float> step(-6.0f, 6.0f);
+        std::uniform_real_distribution<float> jumpX(0.0f, 1920.0f);
+        std::uniform_real_distribution<float> jumpY(0.0f, 1080.0f);
+
+        std::vector<PointF> points(count);
+        PointF p{ 960, 540 };
+        for (size_t i = 0; i < count; ++i)
+        {
+            p = i % jumpEvery == jumpEvery - 1 ? PointF{ jumpX(rng), jumpY(rng) } : PointF{ p.x + step(rng), p.y + step(rng) };
+            points[i] = p;
+        }
+
+        return points;
+    }
+
+    // Adds a frame of segments (about what a 1000 Hz mouse moves in 16 ms, in 4 places) and presents it, reporting how
+    // much area the rects cover compared to their bounds.
+    void AddFrame(State& state, size_t maxRects)
+    {
+        constexpr size_t SEGMENTS_PER_FRAME = 16;
+        std::vector<PointF> walk = MakeWalk(SEGMENTS_PER_FRAME + 1, 4);
+
+        DirtyRegion region(maxRects);
+        int64_t rectArea = 0;
+        int64_t boundsArea = 0;
+
+        while (state.KeepRunning())
+        {
+            region.Clear();
+            for (size_t i = 0; i < SEGMENTS_PER_FRAME; ++i)
+            {
+                // no segment leads to where a figure starts
+                if (i % 4 != 2) region.AddSegment(walk[i], walk[i + 1], 2.0f);
+            }
+            region.ClipTo(RectI{ 0, 0, 1920, 1080 });
+
+            DoNotOptimize(region.GetRects());
+        }
+
+        for (size_t i = 0; i < region.GetCount(); ++i)
+        {
+            const RectI& r = region.GetRects()[i];
+            rectArea += static_cast<int64_t>(r.right - r.left) * (r.bottom - r.top);
+        }
+        RectI bounds = region.GetBounds();
+        boundsArea = static_cast<int64_t>(bounds.right - bounds.left) * (bounds.bottom - bounds.top);
+
+        state.SetItemsProcessed(state.GetIterations() * SEGMENTS_PER_FRAME);
+        state.SetCounter("rects", static_cast<double>(region.GetCount()));
+        state.SetCounter("areaVsBounds", boundsArea > 0 ? static_cast<double>(rectArea) / boundsArea : 0.0);
+    }
+}
+
+BENCHMARK(AddSegments_Max1)
+{
+    AddFrame(state, 1);
+}
+
+BENCHMARK(AddSegments_Max4)
+{
+    AddFrame(state, 4);
+}
+
+BENCHMARK(AddSegments_Max16)
+{
+    AddFrame(state, 16);
+}
@@ -0,0 +1,148 @@
+#include "BenchmarkHarness.h"
+#include "ErasablePath.h"
+#include "SegmentIndex.h"
+#include <algorithm>
+#include <cstdint>
+#include <random>
+#include <vector>
+
+using namespace PathWindows;
+using namespace PathWindows::Benchmarks;
+
+// Erasing from a long drawing on a 1920x1080 surface: the grid against checking every segment, what one erase and
+// putting it back costs, and what keeping the grid up to date while drawing costs.
+
+namespace
+{
+    constexpr int32_t WIDTH = 1920;
+    constexpr int32_t HEIGHT = 1080;
+    constexpr size_t POINT_COUNT = 500'000;
+    constexpr float RADIUS = 12.0f;
+
+    // a random walk that scribbles over the whole surface
+    const std::vector<Movement>& GetPath()
+    {
+        static const std::vector<Movement> path = []
+        {
+            std::mt19937 random(1);
+            std::uniform_int_distribution<int32_t> step(-8, 8);
+
+            std::vector<Movement> movements;
+            int32_t x = WIDTH / 2, y = HEIGHT / 2;
+            for (size_t i = 0; i < POINT_COUNT; ++i)
+            {
+                x = std::clamp(x + step(random), 0, WIDTH - 1);
+                y = std::clamp(y + step(random), 0, HEIGHT - 1);
+                movements.push_back(Movement{ PointI{ x, y }, i == 0 ? 0 : 8'000'000 });
+            }
+
+            return movements;
+        }();
+
+        return path;
+    }
+
+    std::vector<PointF> MakeErasers(size_t count)
+    {
+        std::mt19937 random(2);
+
+        std::vector<PointF> erasers(count);
+        for (PointF& eraser : erasers) eraser = PointF{ float(random() % WIDTH), float(random() % HEIGHT) };
+        return erasers;
+    }
+}
+
+BENCHMARK(Append_500K)
+{
+    const std::vector<Movement>& movements = GetPath();
+
+    while (state.KeepRunning())
+    {
+        ErasablePath path(WIDTH, HEIGHT);
+        for (const Movement& movement : movements) path.Append(movement);
+        DoNotOptimize(path.GetSegmentCount());
+    }
+
+    state.SetItemsProcessed(state.GetIterations() * POINT_COUNT);
+}
+
+// the candidates of one eraser position, without erasing anything
+BENCHMARK(Query_Grid_500K)
+{
+    const std::vector<Movement>& movements = GetPath();
+    SegmentIndex index(WIDTH, HEIGHT);
+    for (size_t i = 1; i < movements.size(); ++i)
+    {
+        PointF a{ float(movements[i - 1].delta.x), float(movements[i - 1].delta.y) };
+        PointF b{ float(movements[i].delta.x), float(movements[i].delta.y) };
+        index.Insert(static_cast<uint32_t>(i), a, b);
+    }
+
+    std::vector<PointF> erasers = MakeErasers(1024);
+    size_t next = 0;
+    uint64_t candidates = 0;
+    uint64_t sum = 0;
+
+    while (state.KeepRunning())
+    {
+        PointF at = erasers[next++ & 1023];
+        index.ForEachCandidate(PointF{ at.x - RADIUS, at.y - RADIUS }, PointF{ at.x + RADIUS, at.y + RADIUS }, [&candidates, &sum](uint32_t id)
+        {
+            ++candidates;
+            sum += id;
+        });
+    }
+
+    DoNotOptimize(sum);
+    state.SetItemsProcessed(state.GetIterations());
+    state.SetCounter("candidates", static_cast<double>(candidates) / state.GetIterations());
+}
+
+// what the grid saves: every segment's bounding box checked against the eraser's
+BENCHMARK(Query_Scan_500K)
+{
+    const std::vector<Movement>& movements = GetPath();
+    std::vector<PointF> erasers = MakeErasers(1024);
+    size_t next = 0;
+    uint64_t hits = 0;
+
+    while (state.KeepRunning())
+    {
+        PointF at = erasers[next++ & 1023];
+        for (size_t i = 1; i < movements.size(); ++i)
+        {
+            const PointI& a = movements[i - 1].delta;
+            const PointI& b = movements[i].delta;
+            hits += (std::min)(a.x, b.x) <= at.x + RADIUS && (std::max)(a.x, b.x) >= at.x - RADIUS &&
+                (std::min)(a.y, b.y) <= at.y + RADIUS && (std::max)(a.y, b.y) >= at.y - RADIUS;
+        }
+    }
+
+    DoNotOptimize(hits);
+    state.SetItemsProcessed(state.GetIterations());
+}
+
+// one erase and putting it back (e.g. undoing it), which both update the grid
+BENCHMARK(EraseAndRestore_500K)
+{
+    ErasablePath path(WIDTH, HEIGHT);
+    for (const Movement& movement : GetPath()) path.Append(movement);
+
+    std::vector<PointF> erasers = MakeErasers(1024);
+    std::vector<uint32_t> segments, points;
+    size_t next = 0;
+    uint64_t erased = 0;
+
+    while (state.KeepRunning())
+    {
+        PointF at = erasers[next++ & 1023];
+
+        segments.clear();
+        points.clear();
+        erased += path.Erase(at, at, RADIUS, segments, points);
+        path.Restore(segments.data(), segments.size(), points.data(), points.size());
+    }
+
+    state.SetItemsProcessed(state.GetIterations());
+    state.SetCounter("erased", static_cast<double>(erased) / state.GetIterations());
+}
@@ -0,0 +1,124 @@
+#include "BenchmarkHarness.h"
+#include "HeatmapGrid.h"
+#include <algorithm>
+#include <cstdint>
+#include <random>
+#include <vector>
+
+using namespace PathWindows;
+using namespace PathWindows::Benchmarks;
+
+// The frame of the heatmap overlay on a 1920x1080 surface with 4 pixel cells, as PathWindow draws it: the points that
+// arrived since the last frame are added, the blocks they changed are colored and committed. After the first few
+// thousand points, a frame has to cost the same however many points the path already has.
+
+namespace
+{
+    constexpr int32_t WIDTH = 1920;
+    constexpr int32_t HEIGHT = 1080;
+    constexpr int32_t CELL_SIZE = 4;
+    constexpr size_t POINTS_PER_FRAME = 16;
+
+    // a random walk over the surface, in small steps as the mouse moves
+    class Walk
+    {
+    public:
+        Walk() : m_random(1), m_step(-6.0f, 6.0f), m_position{ WIDTH / 2.0f, HEIGHT / 2.0f } {}
+
+        PointF Next()
+        {
+            m_position.x = std::clamp(m_position.x + m_step(m_random), 0.0f, WIDTH - 1.0f);
+            m_position.y = std::clamp(m_position.y + m_step(m_random), 0.0f, HEIGHT - 1.0f);
+            return m_position;
+        }
+
+    private:
+        std::mt19937 m_random;
+        std::uniform_real_distribution<float> m_step;
+        PointF m_position;
+    };
+
+    // one block of pixels, which is what the window colors into before copying it to the surface
+    size_t DrawFrame(HeatmapGrid& grid, std::vector<uint32_t>& pixels)
+    {
+        size_t blockSize = static_cast<size_t>(grid.GetBlockSize());
+        size_t blockCount = 0;
+
+        grid.ForEachChangedBlock([&](RectI rect)
+        {
+            grid.Colorize(rect, pixels.data(), blockSize);
+            ++blockCount;
+        });
+        grid.Commit();
+
+        return blockCount;
+    }
+
+    void Frame(State& state, size_t pointCount)
+    {
+        HeatmapGrid grid(WIDTH, HEIGHT, CELL_SIZE, ColorF{ 0, 0, 0, 0 });
+        std::vector<uint32_t> pixels(static_cast<size_t>(grid.GetBlockSize()) * grid.GetBlockSize());
+
+        Walk walk;
+        for (size_t i = 0; i < pointCount; ++i) grid.Append(walk.Next(), i == 0);
+        DrawFrame(grid, pixels);
+
+        uint64_t blockCount = 0, fullRedraws = 0;
+        while (state.KeepRunning())
+        {
+            for (size_t i = 0; i < POINTS_PER_FRAME; ++i) grid.Append(walk.Next(), false);
+
+            fullRedraws += grid.NeedsFullRedraw();
+            blockCount += DrawFrame(grid, pixels);
+        }
+
+        state.SetItemsProcessed(state.GetIterations() * POINTS_PER_FRAME);
+        state.SetCounter("blocks", static_cast<double>(blockCount) / state.GetIterations());
+        state.SetCounter("fullRedraws", static_cast<double>(fullRedraws));
+    }
+}
+
+BENCHMARK(Frame_After100KPoints)
+{
+    Frame(state, 100'000);
+}
+
+BENCHMARK(Frame_After1MPoints)
+{
+    Frame(state, 1'000'000);
+}
+
+BENCHMARK(Frame_After10MPoints)
+{
+    Frame(state, 10'000'000);
+}
+
+// what a frame costs when the scale changed or the surface was lost
+BENCHMARK(Frame_FullRedraw)
+{
+    HeatmapGrid grid(WIDTH, HEIGHT, CELL_SIZE, ColorF{ 0, 0, 0, 0 });
+    std::vector<uint32_t> pixels(static_cast<size_t>(grid.GetBlockSize()) * grid.GetBlockSize());
+
+    Walk walk;
+    for (size_t i = 0; i < 1'000'000; ++i) grid.Append(walk.Next(), i == 0);
+
+    uint64_t blockCount = 0;
+    while (state.KeepRunning())
+    {
+        grid.Invalidate();
+        blockCount += DrawFrame(grid, pixels);
+    }
+
+    state.SetCounter("blocks", static_cast<double>(blockCount) / state.GetIterations());
+}
+
+BENCHMARK(Append_Segments)
+{
+    HeatmapGrid grid(WIDTH, HEIGHT, CELL_SIZE, ColorF{ 0, 0, 0, 0 });
+    Walk walk;
+
+    while (state.KeepRunning()) grid.Append(walk.Next(), false);
+
+    DoNotOptimize(grid.GetMaxCount());
+    state.SetItemsProcessed(state.GetIterations());
+}
@@ -0,0 +1,106 @@
+#include "BenchmarkHarness.h"
+#include "HostThread.h"
+#include <condition_variable>
+#include <mutex>
+
+using namespace PathWindows;
+using namespace PathWindows::Benchmarks;
+
+namespace
+{
+    // a message loop that waits on a condition variable, about as fast as GetMessage gets woken
+    class WaitingPlatform
+    {
+    public:
+        bool Enter(WorkDispatcher& dispatcher)
+        {
+            m_pDispatcher = &dispatcher;
+
+            std::lock_guard<std::mutex> lock(m_mutex);
+            m_quit = false;
+            return true;
+        }
+
+        void Run()
+        {
+            m_pDispatcher->RunPending();
+
+            std::unique_lock<std::mutex> lock(m_mutex);
+            while (!m_quit)
+            {
+                m_woken.wait(lock, [this] { return m_wake; });
+                m_wake = false;
+
+                lock.unlock();
+                m_pDispatcher->RunPending();
+                lock.lock();
+            }
+        }
+
+        void Wake()
+        {
+            std::lock_guard<std::mutex> lock(m_mutex);
+            m_wake = true;
+            m_woken.notify_one();
+        }
+
+        void Quit()
+        {
+            std::lock_guard<std::mutex> lock(m_mutex);
+            m_quit = true;
+        }
+
+        void Leave()
+        {}
+
+    private:
+        WorkDispatcher* m_pDispatcher = nullptr;
+
+        std::mutex m_mutex;
+        std::condition_variable m_woken;
+        bool m_wake = false;
+        bool m_quit = false;
+    };
+}
+
+// what opening a window costs on the long-lived thread before any window code runs
+BENCHMARK(Invoke_WarmThread)
+{
+    WaitingPlatform platform;
+    HostThread<WaitingPlatform> host(platform);
+    host.Start();
+
+    while (state.KeepRunning())
+    {
+        DoNotOptimize(host.Invoke([] { return 1; }));
+    }
+}
+
+// and what it cost with a thread of its own for every window
+BENCHMARK(StartInvokeStop_ColdThread)
+{
+    WaitingPlatform platform;
+    HostThread<WaitingPlatform> host(platform);
+
+    while (state.KeepRunning())
+    {
+        host.Start();
+        DoNotOptimize(host.Invoke([] { return 1; }));
+        host.Stop();
+    }
+}
+
+BENCHMARK(PostAndRun_Dispatcher)
+{
+    WorkDispatcher dispatcher;
+    int sum = 0;
+
+    while (state.KeepRunning())
+    {
+        dispatcher.Post([&sum] { ++sum; });
+        dispatcher.RunPending();
+    }
+
+    DoNotOptimize(sum);
+    state.SetItemsProcessed(state.GetIterations());
+}
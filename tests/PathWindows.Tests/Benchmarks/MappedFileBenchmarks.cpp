@@ -0,0 +1,224 @@
+#include "BenchmarkHarness.h"
+#include "CursorPath.h"
+#include "MappedFile.h"
+#include "PathBatch.h"
+#include "PathCodec.h"
+#include <algorithm>
+#include <cstdint>
+#include <cstdio>
+#include <filesystem>
+#include <fstream>
+#include <functional>
+#include <map>
+#include <memory>
+#include <vector>
+
+using namespace PathWindows;
+using namespace PathWindows::Benchmarks;
+
+// Loading an encoded path file the way AddPathFileToPath does, mapped and decoded a view at a time, against reading
+// the whole file into memory first. Every decoded block is turned into positions and a PathBatch::Run like
+// PathWindowFeeder does before EnqueueTimedBatch; the runs are then dropped, as the store they would be copied into
+// grows with the path either way. "peakRssMB" is how far the resident set grew above where it started while the file
+// was loaded, which should stay at about one view when mapped however many movements the file holds.
+
+namespace
+{
+    constexpr size_t VIEW_SIZE = 4 << 20;
+    constexpr RectI MONITOR{ 0, 0, 1920, 1080 };
+
+    // The resident set in bytes, or 0 where /proc is not there to read it from.
+    uint64_t GetResidentBytes()
+    {
+        uint64_t size = 0, resident = 0;
+
+        FILE* statm = std::fopen("/proc/self/statm", "r");
+        if (!statm) return 0;
+
+        if (std::fscanf(statm, "%llu %llu", reinterpret_cast<unsigned long long*>(&size), reinterpret_cast<unsigned long long*>(&resident)) != 2) resident = 0;
+        std::fclose(statm);
+
+        return resident * 4096;
+    }
+
+    // A relative path of movementCount movements, encoded into a temporary file that is deleted at exit. Each size is
+    // only written once, for both ways of loading it.
+    const std::filesystem::path& GetPathFile(size_t movementCount)
+    {
+        struct File
+        {
+            std::filesystem::path path;
+
+            ~File()
+            {
+                std::error_code error;
+                std::filesystem::remove(path, error);
+            }
+        };
+
+        static std::map<size_t, File> files;
+
+        File& file = files[movementCount];
+        if (!file.path.empty()) return file.path;
+
+        file.path = std::filesystem::temp_directory_path() / ("PathWindowsMappedFileBenchmarks" + std::to_string(movementCount) + ".path");
+        std::ofstream stream(file.path, std::ios::binary | std::ios::trunc);
+
+        PathEncoder encoder(false);
+        std::vector<Movement> chunk(PathCodec::MAX_BLOCK_MOVEMENTS);
+        std::vector<uint8_t> output;
+
+        for (size_t first = 0; first < movementCount; first += chunk.size())
+        {
+            size_t count = (std::min)(chunk.size(), movementCount - first);
+            for (size_t i = 0; i < count; ++i)
+            {
+                size_t n = first + i;
+                chunk[i] = Movement{ PointI{ static_cast<int32_t>(n % 7) - 3, static_cast<int32_t>(n / 7 % 5) - 2 }, n % 16 == 0 ? 16'000'000 : 8'000'000 };
+            }
+
+            encoder.Append(chunk.data(), count);
+
+            output.resize(encoder.GetOutputSize());
+            output.resize(encoder.ReadOutput(output.data(), output.size()));
+            stream.write(reinterpret_cast<const char*>(output.data()), static_cast<std::streamsize>(output.size()));
+        }
+
+        encoder.Flush();
+        output.resize(encoder.GetOutputSize());
+        output.resize(encoder.ReadOutput(output.data(), output.size()));
+        stream.write(reinterpret_cast<const char*>(output.data()), static_cast<std::streamsize>(output.size()));
+
+        return file.path;
+    }
+
+    // What PathWindowFeeder does with a block, up to handing the run to the window.
+    class RunFeeder
+    {
+    public:
+        RunFeeder() :
+            m_last{ 960, 540 },
+            m_movementCount(0)
+        {}
+
+        void operator()(const Movement* movements, size_t length)
+        {
+            m_absolute.resize(length + 1);
+
+            size_t count;
+            CursorPath::ToAbsolute(Movement{ m_last, 0 }, movements, length, &MONITOR, 1, PointI{}, m_absolute.data(), count);
+            m_last = m_absolute[count - 1].delta;
+
+            std::unique_ptr<PathBatch::Run> pRun = PathBatch::MakeTimedRun(m_absolute.data() + 1, count - 1, nullptr, 0);
+            DoNotOptimize(pRun->points.data());
+            m_movementCount += length;
+        }
+
+        size_t GetMovementCount() const
+        {
+            return m_movementCount;
+        }
+
+    private:
+        PointI m_last;
+        std::vector<Movement> m_absolute;
+        size_t m_movementCount;
+    };
+
+    void Report(State& state, size_t movementCount, const std::filesystem::path& path, uint64_t peak, bool decoded)
+    {
+        state.SetItemsProcessed(state.GetIterations() * movementCount);
+        state.SetBytesProcessed(state.GetIterations() * std::filesystem::file_size(path));
+        state.SetCounter("fileMB", std::filesystem::file_size(path) / double(1 << 20));
+        if (GetResidentBytes() > 0) state.SetCounter("peakRssMB", peak / double(1 << 20));
+        else state.SetCounter("unsupported", 1);
+
+        if (!decoded) state.SetError("the path did not decode");
+    }
+
+    void LoadMapped(State& state, size_t movementCount)
+    {
+        const std::filesystem::path& path = GetPathFile(movementCount);
+
+        uint64_t peak = 0;
+        bool decoded = true;
+        while (state.KeepRunning())
+        {
+            uint64_t baseline = GetResidentBytes();
+
+            MappedFile file;
+            PathDecoder decoder;
+            RunFeeder feeder;
+            PathCodec::Result result;
+
+            bool mapped = file.Open(path.c_str()) && decoder.FeedFile(file, VIEW_SIZE, std::ref(feeder), [&]()
+            {
+                uint64_t resident = GetResidentBytes();
+                if (resident > baseline && resident - baseline > peak) peak = resident - baseline;
+                return true;
+            }, result);
+
+            decoded = decoded && mapped && result == PathCodec::Result::OK && feeder.GetMovementCount() == movementCount;
+        }
+
+        Report(state, movementCount, path, peak, decoded);
+    }
+
+    void LoadCopy(State& state, size_t movementCount)
+    {
+        const std::filesystem::path& path = GetPathFile(movementCount);
+
+        uint64_t peak = 0;
+        bool decoded = true;
+        while (state.KeepRunning())
+        {
+            uint64_t baseline = GetResidentBytes();
+
+            std::vector<uint8_t> content(std::filesystem::file_size(path));
+            std::ifstream stream(path, std::ios::binary);
+            stream.read(reinterpret_cast<char*>(content.data()), static_cast<std::streamsize>(content.size()));
+
+            PathDecoder decoder;
+            RunFeeder feeder;
+            PathCodec::Result result = decoder.Feed(content.data(), content.size(), std::ref(feeder));
+            if (result == PathCodec::Result::OK) result = decoder.Finish();
+
+            uint64_t resident = GetResidentBytes();
+            if (resident > baseline && resident - baseline > peak) peak = resident - baseline;
+
+            decoded = decoded && result == PathCodec::Result::OK && feeder.GetMovementCount() == movementCount;
+        }
+
+        Report(state, movementCount, path, peak, decoded);
+    }
+}
+
+BENCHMARK(Mapped_1MMovements)
+{
+    LoadMapped(state, 1'000'000);
+}
+
+BENCHMARK(Mapped_10MMovements)
+{
+    LoadMapped(state, 10'000'000);
+}
+
+BENCHMARK(Mapped_100MMovements)
+{
+    LoadMapped(state, 100'000'000);
+}
+
+BENCHMARK(Copy_1MMovements)
+{
+    LoadCopy(state, 1'000'000);
+}
+
+BENCHMARK(Copy_10MMovements)
+{
+    LoadCopy(state, 10'000'000);
+}
+
+BENCHMARK(Copy_100MMovements)
+{
+    LoadCopy(state, 100'000'000);
+}
@@ -0,0 +1,249 @@
+#include "BenchmarkHarness.h"
+#include "PathBatch.h"
+#include "PolylineSimplifier.h"
+#include "SpscQueue.h"
+#include "StrokeAccumulator.h"
+#include <algorithm>
+#include <cstdint>
+#include <memory>
+#include <vector>
+
+using namespace PathWindows;
+using namespace PathWindows::Benchmarks;
+
+// Points per second from EnqueueBatch to the PathStore: what PathWindow does on either side of its queue, with the
+// window messages left out. The producer pushes until the ring is full and the window thread then drains all of it,
+// which is what posting WM_DRAINQUEUE from PushCommands comes to on one core. A batch is queued either point by point,
+// 24 bytes a command, each popped and passed through the simplifier, or (at MIN_RUN_LENGTH points or more) converted
+// up front and queued as one PathBatch::Run whose figures are copied into the store in one go.
+
+namespace
+{
+    constexpr size_t POINT_COUNT = 100'000;
+
+    // the same sizes as PathWindow
+    constexpr size_t QUEUE_CAPACITY = 1 << 16;
+    constexpr size_t DRAIN_BATCH_SIZE = 1024;
+    constexpr size_t MIN_RUN_LENGTH = 128;
+
+    // laid out like PathWindow::QueuedCommand
+    struct Command
+    {
+        enum : uint32_t { ADD_POINT, START_FIGURE, ADD_RUN } type;
+        PointI point;
+        union
+        {
+            int64_t delayNS;
+            PathBatch::Run* pRun;
+        };
+    };
+
+    class QueuedPath
+    {
+    public:
+        QueuedPath(size_t minRunLength) :
+            m_minRunLength(minRunLength),
+            m_queue(QUEUE_CAPACITY)
+        {}
+
+        // PathWindow::EnqueueBatch
+        void EnqueueBatch(const int32_t* pXY, size_t count, const int32_t* figureStarts, size_t figureCount)
+        {
+            if (count < 1 || !PathBatch::IsValid(count, figureStarts, figureCount)) return;
+
+            if (count >= m_minRunLength)
+            {
+                Command command{ Command::ADD_RUN, PointI{}, 0 };
+                command.pRun = PathBatch::MakeRun(pXY, count, figureStarts, figureCount).release();
+                Push(&command, 1);
+                return;
+            }
+
+            PathBatch::ForEachRun(count, figureStarts, figureCount, [this, pXY](size_t first, size_t runCount, bool newFigure)
+            {
+                for (size_t i = 0; i < runCount; i += DRAIN_BATCH_SIZE)
+                {
+                    size_t chunk = (std::min)(runCount - i, DRAIN_BATCH_SIZE);
+                    for (size_t j = 0; j < chunk; ++j)
+                    {
+                        const int32_t* xy = pXY + (first + i + j) * 2;
+                        m_batch[j] = Command{ Command::ADD_POINT, PointI{ xy[0], xy[1] }, 0 };
+                    }
+
+                    if (newFigure && i == 0) m_batch[0].type = Command::START_FIGURE;
+
+                    Push(m_batch, chunk);
+                }
+            });
+        }
+
+        // PathWindow::DrainQueue
+        void Drain()
+        {
+            Command batch[DRAIN_BATCH_SIZE];
+
+            size_t count;
+            while ((count = m_queue.PopBatch(batch, DRAIN_BATCH_SIZE)) > 0)
+            {
+                for (size_t i = 0; i < count; ++i)
+                {
+                    const Command& cmd = batch[i];
+                    switch (cmd.type)
+                    {
+                    case Command::ADD_POINT:
+                    case Command::START_FIGURE:
+                        AppendPoint(PointF{ static_cast<float>(cmd.point.x), static_cast<float>(cmd.point.y) }, cmd.type == Command::START_FIGURE);
+                        break;
+
+                    case Command::ADD_RUN:
+                    {
+                        std::unique_ptr<PathBatch::Run> pRun(cmd.pRun);
+                        AppendRun(*pRun);
+                        break;
+                    }
+                    }
+                }
+            }
+        }
+
+        void Clear()
+        {
+            m_simplifier.Reset();
+            m_strokes.Clear();
+        }
+
+        const PathStore& GetStore() const
+        {
+            return m_strokes.GetStore();
+        }
+
+    private:
+        size_t m_minRunLength;
+        SpscQueue<Command> m_queue;
+        Command m_batch[DRAIN_BATCH_SIZE];
+
+        // a window without simplifying, coloring, a heatmap or a trail
+        PolylineSimplifier m_simplifier;
+        StrokeAccumulator m_strokes;
+
+        void Push(const Command* commands, size_t count)
+        {
+            size_t pushed = 0;
+            while ((pushed += m_queue.TryPushRange(commands + pushed, count - pushed)) < count) Drain();
+        }
+
+        // PathWindow::AppendPoint
+        void AppendPoint(PointF point, bool newPath)
+        {
+            if (newPath)
+            {
+                m_simplifier.Flush([this](PointF p) { m_strokes.Append(p, false); });
+                m_simplifier.Reset();
+            }
+
+            m_simplifier.Add(point, [this, newPath](PointF p) { m_strokes.Append(p, newPath); });
+        }
+
+        // PathWindow::AppendRun and StoreRun
+        void AppendRun(const PathBatch::Run& run)
+        {
+            PathBatch::ForEachRun(run.points.size(), run.figureStarts.data(), run.figureStarts.size(), [this, &run](size_t first, size_t count, bool newFigure)
+            {
+                m_simplifier.Flush([this](PointF p) { m_strokes.Append(p, false); });
+                m_simplifier.Reset();
+
+                m_strokes.AppendRange(run.points.data() + first, count, newFigure);
+            });
+        }
+    };
+
+    // a point as the C# side hands it over, x, y pairs like POINT
+    std::vector<int32_t> MakePoints()
+    {
+        std::vector<int32_t> xy(POINT_COUNT * 2);
+        for (size_t i = 0; i < POINT_COUNT; ++i)
+        {
+            xy[i * 2] = static_cast<int32_t>(i % 1920);
+            xy[i * 2 + 1] = static_cast<int32_t>(i % 1080);
+        }
+
+        return xy;
+    }
+
+    void Enqueue(State& state, size_t batchSize, size_t minRunLength)
+    {
+        constexpr size_t FIGURE_LENGTH = 256;
+
+        std::vector<int32_t> xy = MakePoints();
+        std::vector<int32_t> batchStarts;
+        QueuedPath path(minRunLength);
+
+        while (state.KeepRunning())
+        {
+            path.Clear();
+
+            for (size_t first = 0; first < POINT_COUNT; first += batchSize)
+            {
+                size_t count = (std::min)(batchSize, POINT_COUNT - first);
+
+                // the figure starts are relative to the batch
+                batchStarts.clear();
+                for (size_t start = (first + FIGURE_LENGTH - 1) / FIGURE_LENGTH * FIGURE_LENGTH; start < first + count; start += FIGURE_LENGTH)
+                {
+                    batchStarts.push_back(static_cast<int32_t>(start - first));
+                }
+
+                path.EnqueueBatch(xy.data() + first * 2, count, batchStarts.data(), batchStarts.size());
+            }
+
+            path.Drain();
+            DoNotOptimize(path.GetStore().GetPoints());
+        }
+
+        state.SetItemsProcessed(state.GetIterations() * POINT_COUNT);
+        state.SetCounter("figures", static_cast<double>(path.GetStore().GetFigureCount()));
+    }
+}
+
+// every batch queued point by point, which is what EnqueueBatch did for all of them before runs
+BENCHMARK(Enqueue_PerPoint_256Points)
+{
+    Enqueue(state, 256, SIZE_MAX);
+}
+
+BENCHMARK(Enqueue_PerPoint_100KPoints)
+{
+    Enqueue(state, POINT_COUNT, SIZE_MAX);
+}
+
+// below MIN_RUN_LENGTH, so still point by point
+BENCHMARK(Enqueue_16Points)
+{
+    Enqueue(state, 16, MIN_RUN_LENGTH);
+}
+
+// where allocating a run stops costing more than it saves
+BENCHMARK(Enqueue_Run_64Points)
+{
+    Enqueue(state, 64, 64);
+}
+
+BENCHMARK(Enqueue_Run_128Points)
+{
+    Enqueue(state, 128, MIN_RUN_LENGTH);
+}
+
+BENCHMARK(Enqueue_Run_256Points)
+{
+    Enqueue(state, 256, MIN_RUN_LENGTH);
+}
+
+BENCHMARK(Enqueue_Run_4096Points)
+{
+    Enqueue(state, 4096, MIN_RUN_LENGTH);
+}
+
+BENCHMARK(Enqueue_Run_100KPoints)
+{
+    Enqueue(state, POINT_COUNT, MIN_RUN_LENGTH);
+}
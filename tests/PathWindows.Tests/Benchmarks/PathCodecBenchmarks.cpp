@@ -0,0 +1,111 @@
+#include "BenchmarkHarness.h"
+#include "PathCodec.h"
+#include <cstdint>
+#include <random>
+#include <vector>
+
+using namespace PathWindows;
+using namespace PathWindows::Benchmarks;
+
+namespace
+{
+    constexpr size_t MOVEMENT_COUNT = 1'000'000;
+
+    // a recorded drag: small steps at the polling rate, with a few pauses and the odd jump
+    std::vector<Movement> MakePath(bool absolute)
+    {
+        std::mt19937 random(1);
+        std::uniform_int_distribution<int32_t> step(-4, 4);
+
+        std::vector<Movement> path(MOVEMENT_COUNT);
+        PointI position{ 960, 540 };
+        for (Movement& movement : path)
+        {
+            PointI delta{ step(random), step(random) };
+            if (random() % 200 == 0) delta = PointI{ static_cast<int32_t>(random() % 400) - 200, static_cast<int32_t>(random() % 400) - 200 };
+
+            position.x += delta.x;
+            position.y += delta.y;
+            movement.delta = absolute ? position : delta;
+            movement.delayDurationNS = random() % 50 == 0 ? 1'000'000 + random() % 100'000'000 : 8'000'000;
+        }
+
+        return path;
+    }
+
+    std::vector<uint8_t> Encode(const std::vector<Movement>& path, bool absolute)
+    {
+        PathEncoder encoder(absolute);
+        encoder.Append(path.data(), path.size());
+        encoder.Flush();
+
+        std::vector<uint8_t> bytes(encoder.GetOutputSize());
+        encoder.ReadOutput(bytes.data(), bytes.size());
+        return bytes;
+    }
+
+    // bytes per second of the movements themselves, and how many times smaller they got
+    void Encode(State& state, bool absolute)
+    {
+        std::vector<Movement> path = MakePath(absolute);
+        size_t encodedSize = 0;
+
+        while (state.KeepRunning())
+        {
+            encodedSize = Encode(path, absolute).size();
+            DoNotOptimize(encodedSize);
+        }
+
+        state.SetBytesProcessed(state.GetIterations() * MOVEMENT_COUNT * sizeof(Movement));
+        state.SetCounter("ratio", static_cast<double>(MOVEMENT_COUNT * sizeof(Movement)) / encodedSize);
+        state.SetCounter("bytesPerMovement", static_cast<double>(encodedSize) / MOVEMENT_COUNT);
+    }
+
+    void Decode(State& state, bool absolute)
+    {
+        std::vector<uint8_t> bytes = Encode(MakePath(absolute), absolute);
+        int64_t checksum = 0;
+
+        while (state.KeepRunning())
+        {
+            PathDecoder decoder;
+            decoder.Feed(bytes.data(), bytes.size(), [&checksum](const Movement* movements, size_t count)
+            {
+                checksum += movements[count - 1].delta.x;
+            });
+            DoNotOptimize(checksum);
+        }
+
+        state.SetBytesProcessed(state.GetIterations() * MOVEMENT_COUNT * sizeof(Movement));
+    }
+}
+
+BENCHMARK(Encode_Deltas)
+{
+    Encode(state, false);
+}
+
+BENCHMARK(Encode_Positions)
+{
+    Encode(state, true);
+}
+
+BENCHMARK(Decode_Deltas)
+{
+    Decode(state, false);
+}
+
+BENCHMARK(Decode_Positions)
+{
+    Decode(state, true);
+}
+
+// the cost of the checksum alone, which every block pays on both ends
+BENCHMARK(Crc32)
+{
+    std::vector<uint8_t> bytes(1 << 20, 0x5A);
+
+    while (state.KeepRunning()) DoNotOptimize(PathCodec::Crc32(bytes.data(), bytes.size()));
+
+    state.SetBytesProcessed(state.GetIterations() * bytes.size());
+}
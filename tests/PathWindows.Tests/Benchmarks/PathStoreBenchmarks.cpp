@@ -0,0 +1,130 @@
+#include "BenchmarkHarness.h"
+#include "PathStore.h"
+#include <vector>
+
+using namespace PathWindows;
+using namespace PathWindows::Benchmarks;
+
+namespace
+{
+    constexpr size_t POINT_COUNT = 1'000'000;
+
+    // the layout PathWindow used before PathStore, a vector per figure
+    typedef std::vector<std::vector<PointF>> NestedPath;
+
+    // what most allocators add to every block
+    constexpr size_t ALLOCATION_OVERHEAD = 16;
+
+    size_t GetBytes(const NestedPath& path)
+    {
+        size_t bytes = path.capacity() * sizeof(std::vector<PointF>) + ALLOCATION_OVERHEAD;
+        for (const auto& figure : path) bytes += figure.capacity() * sizeof(PointF) + (figure.capacity() > 0 ? ALLOCATION_OVERHEAD : 0);
+        return bytes;
+    }
+
+    PointF GetPoint(size_t i)
+    {
+        return PointF{ static_cast<float>(i % 1920), static_cast<float>(i % 1080) };
+    }
+
+    void AppendNested(State& state, size_t figureLength)
+    {
+        NestedPath path;
+        while (state.KeepRunning())
+        {
+            path = NestedPath();
+            for (size_t i = 0; i < POINT_COUNT; ++i)
+            {
+                if (i % figureLength == 0) path.emplace_back();
+                path.back().push_back(GetPoint(i));
+            }
+
+            DoNotOptimize(path.data());
+        }
+
+        state.SetItemsProcessed(state.GetIterations() * POINT_COUNT);
+        state.SetCounter("bytes", static_cast<double>(GetBytes(path)));
+    }
+
+    void AppendStore(State& state, size_t figureLength)
+    {
+        PathStore store;
+        while (state.KeepRunning())
+        {
+            store = PathStore();
+            for (size_t i = 0; i < POINT_COUNT; ++i) store.Append(GetPoint(i), i % figureLength == 0);
+
+            DoNotOptimize(store.GetPoints());
+        }
+
+        // the point buffer and the figure starts, each one block, without the slack they keep from growing
+        size_t bytes = store.GetPointCount() * sizeof(PointF) + store.GetFigureCount() * sizeof(size_t) + 2 * ALLOCATION_OVERHEAD;
+
+        state.SetItemsProcessed(state.GetIterations() * POINT_COUNT);
+        state.SetCounter("bytes", static_cast<double>(bytes));
+    }
+}
+
+BENCHMARK(Append1M_Nested_Figures10)
+{
+    AppendNested(state, 10);
+}
+
+BENCHMARK(Append1M_Store_Figures10)
+{
+    AppendStore(state, 10);
+}
+
+BENCHMARK(Append1M_Nested_Figures1000)
+{
+    AppendNested(state, 1000);
+}
+
+BENCHMARK(Append1M_Store_Figures1000)
+{
+    AppendStore(state, 1000);
+}
+
+// what a full redraw reads
+BENCHMARK(Iterate1M_Nested)
+{
+    NestedPath path;
+    for (size_t i = 0; i < POINT_COUNT; ++i)
+    {
+        if (i % 10 == 0) path.emplace_back();
+        path.back().push_back(GetPoint(i));
+    }
+
+    while (state.KeepRunning())
+    {
+        float sum = 0;
+        for (const auto& figure : path)
+        {
+            for (PointF point : figure) sum += point.x;
+        }
+
+        DoNotOptimize(sum);
+    }
+
+    state.SetItemsProcessed(state.GetIterations() * POINT_COUNT);
+}
+
+BENCHMARK(Iterate1M_Store)
+{
+    PathStore store;
+    for (size_t i = 0; i < POINT_COUNT; ++i) store.Append(GetPoint(i), i % 10 == 0);
+
+    while (state.KeepRunning())
+    {
+        float sum = 0;
+        for (size_t f = 0; f < store.GetFigureCount(); ++f)
+        {
+            FigureView figure = store.GetFigure(f);
+            for (size_t i = 0; i < figure.count; ++i) sum += figure.points[i].x;
+        }
+
+        DoNotOptimize(sum);
+    }
+
+    state.SetItemsProcessed(state.GetIterations() * POINT_COUNT);
+}
@@ -0,0 +1,107 @@
+#include "BenchmarkHarness.h"
+#include "PathThumbnail.h"
+#include "ThumbnailCache.h"
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdint>
+#include <vector>
+
+using namespace PathWindows;
+using namespace PathWindows::Benchmarks;
+
+// How long RenderPathThumbnail takes for a recording of 1M movements: rendering it at the sizes a list of recordings
+// shows, and finding it in the cache, which hashes the whole path every time.
+// A render fails if even the fastest of its renders (there are at least three, with --quick too) takes longer than its
+// budget. Up to 128 pixels most of the time goes into the two passes over the path, one to fit it into the bitmap and
+// one to test every point against the last one kept, at 256 pixels into stroking the points kept.
+
+namespace
+{
+    constexpr size_t MOVEMENT_COUNT = 1'000'000;
+    constexpr float STROKE_WIDTH = 1.5f;
+    constexpr ColorF STROKE_COLOR{ 1.0f, 0.0f, 0.0f, 0.9f };
+
+    // hours of moving about a 1920x1080 screen, with a new figure now and then
+    const std::vector<Movement>& GetPath()
+    {
+        static const std::vector<Movement> path = []
+        {
+            std::vector<Movement> movements(MOVEMENT_COUNT);
+            for (size_t i = 0; i < MOVEMENT_COUNT; ++i)
+            {
+                double t = static_cast<double>(i);
+                int32_t x = static_cast<int32_t>(960 + 900 * std::sin(t / 997) * std::cos(t / 71));
+                int32_t y = static_cast<int32_t>(540 + 500 * std::cos(t / 613) * std::sin(t / 53));
+                movements[i] = Movement{ PointI{ x, y }, i % 5000 == 0 ? 0 : 8'000'000 };
+            }
+
+            return movements;
+        }();
+
+        return path;
+    }
+
+    void Render(State& state, int32_t size, double budgetMS)
+    {
+        typedef std::chrono::steady_clock Clock;
+
+        const std::vector<Movement>& path = GetPath();
+        PathThumbnail thumbnail(STROKE_WIDTH, STROKE_COLOR);
+        std::vector<uint32_t> pixels(static_cast<size_t>(size) * size);
+
+        double fastestMS = budgetMS * 1000;
+        auto render = [&]()
+        {
+            Clock::time_point start = Clock::now();
+            thumbnail.Render(path.data(), path.size(), pixels.data(), size, size);
+            ClobberMemory();
+            fastestMS = (std::min)(fastestMS, std::chrono::duration<double, std::milli>(Clock::now() - start).count());
+        };
+
+        // warms up the allocations and caches, and counts towards the fastest render
+        render();
+        render();
+
+        while (state.KeepRunning()) render();
+
+        state.SetItemsProcessed(state.GetIterations() * MOVEMENT_COUNT);
+        state.SetCounter("drawnPoints", static_cast<double>(thumbnail.GetDrawnCount()));
+        state.SetCounter("fastestMS", fastestMS);
+        state.SetCounter("budgetMS", budgetMS);
+        if (fastestMS > budgetMS) state.SetError("slower than the budget");
+    }
+}
+
+BENCHMARK(Render_1M_64px)
+{
+    Render(state, 64, 15);
+}
+
+BENCHMARK(Render_1M_128px)
+{
+    Render(state, 128, 20);
+}
+
+BENCHMARK(Render_1M_256px)
+{
+    Render(state, 256, 60);
+}
+
+// what a recording that did not change costs the second time
+BENCHMARK(CacheHit_1M_128px)
+{
+    const std::vector<Movement>& path = GetPath();
+    ThumbnailCache cache(16 << 20);
+    std::vector<uint32_t> pixels(128 * 128);
+
+    cache.Put(ThumbnailCache::MakeKey(path.data(), path.size() * sizeof(Movement), 0, 128, 128), pixels.data());
+
+    while (state.KeepRunning())
+    {
+        ThumbnailCache::Key key = ThumbnailCache::MakeKey(path.data(), path.size() * sizeof(Movement), 0, 128, 128);
+        DoNotOptimize(cache.TryGet(key, pixels.data()));
+    }
+
+    state.SetBytesProcessed(state.GetIterations() * path.size() * sizeof(Movement));
+}
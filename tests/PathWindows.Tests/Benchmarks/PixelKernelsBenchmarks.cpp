@@ -0,0 +1,118 @@
+#include "BenchmarkHarness.h"
+#include "PixelKernels.h"
+#include <random>
+#include <vector>
+
+using namespace PathWindows;
+using namespace PathWindows::Benchmarks;
+
+namespace
+{
+    // a 1920 pixel wide row, as cleared and blended for every frame
+    constexpr size_t SPAN = 1920;
+    constexpr size_t POINT_COUNT = 4096;
+
+    // Where the CPU does not have level, the best one it has runs instead and the result is marked.
+    void UseLevel(State& state, PixelKernels::SimdLevel level)
+    {
+        if (level > PixelKernels::GetSupportedLevel()) state.SetCounter("unsupported", 1);
+
+        PixelKernels::SetLevel(level);
+    }
+
+    void FillSpan(State& state, PixelKernels::SimdLevel level)
+    {
+        UseLevel(state, level);
+
+        std::vector<uint32_t> pixels(SPAN);
+        while (state.KeepRunning())
+        {
+            PixelKernels::FillSpan(pixels.data(), pixels.size(), 0x80000000);
+            ClobberMemory();
+        }
+
+        state.SetBytesProcessed(state.GetIterations() * SPAN * sizeof(uint32_t));
+    }
+
+    void BlendSpan(State& state, PixelKernels::SimdLevel level)
+    {
+        UseLevel(state, level);
+
+        // an antialiased edge every few pixels, like a row crossing a stroke
+        std::mt19937 random(1);
+        std::vector<uint32_t> pixels(SPAN, 0x40000000);
+        std::vector<uint8_t> coverage(SPAN);
+        for (uint8_t& value : coverage) value = static_cast<uint8_t>(random() % 3 == 0 ? random() : 255);
+
+        while (state.KeepRunning())
+        {
+            PixelKernels::BlendSpan(pixels.data(), coverage.data(), pixels.size(), 0xB3B30000);
+            ClobberMemory();
+        }
+
+        state.SetBytesProcessed(state.GetIterations() * SPAN * sizeof(uint32_t));
+    }
+
+    void ConvertPoints(State& state, PixelKernels::SimdLevel level)
+    {
+        UseLevel(state, level);
+
+        std::vector<int32_t> xy(POINT_COUNT * 2);
+        for (size_t i = 0; i < xy.size(); ++i) xy[i] = static_cast<int32_t>(i % 3840);
+        std::vector<PointF> points(POINT_COUNT);
+
+        while (state.KeepRunning())
+        {
+            PixelKernels::ConvertPoints(xy.data(), points.data(), POINT_COUNT, PointF{ 1920.0f, 0.0f });
+            ClobberMemory();
+        }
+
+        // what is read
+        state.SetBytesProcessed(state.GetIterations() * xy.size() * sizeof(int32_t));
+    }
+}
+
+BENCHMARK(FillSpan_Scalar)
+{
+    FillSpan(state, PixelKernels::SimdLevel::SCALAR);
+}
+
+BENCHMARK(FillSpan_SSE2)
+{
+    FillSpan(state, PixelKernels::SimdLevel::SSE2);
+}
+
+BENCHMARK(FillSpan_AVX2)
+{
+    FillSpan(state, PixelKernels::SimdLevel::AVX2);
+}
+
+BENCHMARK(BlendSpan_Scalar)
+{
+    BlendSpan(state, PixelKernels::SimdLevel::SCALAR);
+}
+
+BENCHMARK(BlendSpan_SSE2)
+{
+    BlendSpan(state, PixelKernels::SimdLevel::SSE2);
+}
+
+BENCHMARK(BlendSpan_AVX2)
+{
+    BlendSpan(state, PixelKernels::SimdLevel::AVX2);
+}
+
+BENCHMARK(ConvertPoints_Scalar)
+{
+    ConvertPoints(state, PixelKernels::SimdLevel::SCALAR);
+}
+
+BENCHMARK(ConvertPoints_SSE2)
+{
+    ConvertPoints(state, PixelKernels::SimdLevel::SSE2);
+}
+
+BENCHMARK(ConvertPoints_AVX2)
+{
+    ConvertPoints(state, PixelKernels::SimdLevel::AVX2);
+}
@@ -0,0 +1,176 @@
+#include "BenchmarkHarness.h"
+#include "PlaybackScheduler.h"
+#include <algorithm>
+#include <chrono>
+#include <cstdint>
+#include <thread>
+#include <vector>
+
+using namespace PathWindows;
+using namespace PathWindows::Benchmarks;
+
+// How close to their deadlines played movements are emitted, on the real clock: the scheduler sleeping and then
+// spinning towards deadlines counted from the start, against sleeping for each delay in turn, which is what waiting
+// between movements one by one amounts to. Jitter is how late a movement was emitted, reported as p50, p99 and max in
+// microseconds, and drift as how late the last one was.
+
+namespace
+{
+    constexpr int64_t MS = 1'000'000;
+    constexpr size_t PATH_LENGTH = 200;
+
+    int64_t SteadyNow()
+    {
+        return std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now().time_since_epoch()).count();
+    }
+
+    class SteadyClock : public PlaybackClock
+    {
+    public:
+        int64_t Now() override
+        {
+            return SteadyNow();
+        }
+
+        void Sleep(int64_t durationNS) override
+        {
+            std::this_thread::sleep_for(std::chrono::nanoseconds(durationNS));
+        }
+    };
+
+    // records how late every movement was, from the deadline of the batch it came in and the delays after that
+    class LatenessSink : public PlaybackSink
+    {
+    public:
+        std::vector<int64_t> latenessNS;
+
+        void Emit(const Movement* movements, size_t count, int64_t deadlineNS) override
+        {
+            int64_t now = SteadyNow();
+            int64_t deadline = deadlineNS;
+            for (size_t i = 0; i < count; ++i)
+            {
+                if (i > 0) deadline += (std::max)(movements[i].delayDurationNS, int64_t{ 0 });
+                latenessNS.push_back(now - deadline);
+            }
+        }
+    };
+
+    std::vector<Movement> MakePath(int64_t delayNS)
+    {
+        std::vector<Movement> path(PATH_LENGTH);
+        for (size_t i = 0; i < PATH_LENGTH; ++i) path[i] = Movement{ PointI{ static_cast<int32_t>(i), 0 }, delayNS };
+        return path;
+    }
+
+    void ReportLateness(State& state, std::vector<int64_t>& latenessNS, const std::vector<int64_t>& driftNS)
+    {
+        if (latenessNS.empty()) return;
+
+        std::sort(latenessNS.begin(), latenessNS.end());
+        auto percentile = [&](size_t p) { return latenessNS[(latenessNS.size() - 1) * p / 100] / 1'000.0; };
+
+        state.SetCounter("p50us", percentile(50));
+        state.SetCounter("p99us", percentile(99));
+        state.SetCounter("maxUS", latenessNS.back() / 1'000.0);
+        state.SetCounter("driftUS", *std::max_element(driftNS.begin(), driftNS.end()) / 1'000.0);
+        state.SetItemsProcessed(latenessNS.size());
+    }
+
+    void Scheduler(State& state, int64_t delayNS)
+    {
+        SteadyClock clock;
+        LatenessSink sink;
+        PlaybackScheduler scheduler(clock, sink);
+        std::vector<Movement> path = MakePath(delayNS);
+        std::vector<int64_t> drift;
+
+        while (state.KeepRunning())
+        {
+            scheduler.Play(path.data(), path.size());
+            drift.push_back(sink.latenessNS.back());
+        }
+
+        ReportLateness(state, sink.latenessNS, drift);
+        state.SetCounter("spinUS", scheduler.GetSpinDuration() / 1'000.0);
+    }
+
+    void SleepPerDelay(State& state, int64_t delayNS)
+    {
+        std::vector<Movement> path = MakePath(delayNS);
+        std::vector<int64_t> lateness;
+        std::vector<int64_t> drift;
+
+        while (state.KeepRunning())
+        {
+            int64_t deadline = SteadyNow();
+            for (const Movement& movement : path)
+            {
+                std::this_thread::sleep_for(std::chrono::nanoseconds(movement.delayDurationNS));
+                deadline += movement.delayDurationNS;
+                lateness.push_back(SteadyNow() - deadline);
+            }
+            drift.push_back(lateness.back());
+        }
+
+        ReportLateness(state, lateness, drift);
+    }
+}
+
+BENCHMARK(Scheduler_1ms)
+{
+    Scheduler(state, 1 * MS);
+}
+
+BENCHMARK(SleepPerDelay_1ms)
+{
+    SleepPerDelay(state, 1 * MS);
+}
+
+// a typical recorded mouse, which reports at 125 Hz
+BENCHMARK(Scheduler_8ms)
+{
+    Scheduler(state, 8 * MS);
+}
+
+BENCHMARK(SleepPerDelay_8ms)
+{
+    SleepPerDelay(state, 8 * MS);
+}
+
+// what the scheduler itself costs per movement, with every movement due right when it is waited for
+BENCHMARK(Scheduler_Overhead)
+{
+    // time stands still, so nothing is ever overdue either, which would batch it
+    class StoppedClock : public PlaybackClock
+    {
+    public:
+        int64_t Now() override
+        {
+            return 0;
+        }
+
+        void Sleep(int64_t) override
+        {}
+    } clock;
+
+    class NullSink : public PlaybackSink
+    {
+    public:
+        void Emit(const Movement* movements, size_t, int64_t) override
+        {
+            DoNotOptimize(movements);
+        }
+    } sink;
+
+    // and without batching every movement is waited for and emitted on its own
+    PlaybackScheduler::Options options = PlaybackScheduler::DEFAULT_OPTIONS;
+    options.batchThresholdNS = -1;
+
+    PlaybackScheduler scheduler(clock, sink, options);
+    std::vector<Movement> path(100'000, Movement{ PointI{}, 0 });
+
+    while (state.KeepRunning()) scheduler.Play(path.data(), path.size());
+
+    state.SetItemsProcessed(state.GetIterations() * path.size());
+}
@@ -0,0 +1,74 @@
+#include "BenchmarkHarness.h"
+#include "PolylineSimplifier.h"
+#include <cmath>
+#include <random>
+#include <vector>
+
+using namespace PathWindows;
+using namespace PathWindows::Benchmarks;
+
+namespace
+{
+    // A hand-drawn looking path, like a recording at 1000 Hz: a smooth curve sampled at a varying speed, with sub-pixel
+    // jitter, and the cursor resting now and then.
+    std::vector<PointF> MakeTrace(size_t count)
+    {
+        std::mt19937 rng(11);
+        std::uniform_real_distribution<float> jitter(-0.4f, 0.4f);
+        std::uniform_real_distribution<float> turn(-0.08f, 0.08f);
+
+        std::vector<PointF> points(count);
+        float x = 500, y = 500, heading = 0;
+        for (size_t i = 0; i < count; ++i)
+        {
+            heading += turn(rng);
+            float speed = i % 3000 < 500 ? 0.0f : 0.5f + 3.0f * (0.5f + 0.5f * std::sin(static_cast<float>(i) * 0.01f));
+            x += std::cos(heading) * speed;
+            y += std::sin(heading) * speed;
+            points[i] = PointF{ x + jitter(rng), y + jitter(rng) };
+        }
+
+        return points;
+    }
+
+    void Simplify(State& state, float tolerance)
+    {
+        std::vector<PointF> trace = MakeTrace(100'000);
+        PolylineSimplifier simplifier(tolerance);
+
+        size_t kept = 0;
+        while (state.KeepRunning())
+        {
+            kept = 0;
+            auto emit = [&](PointF point) { ++kept; DoNotOptimize(point); };
+
+            simplifier.Reset();
+            for (PointF point : trace) simplifier.Add(point, emit);
+            simplifier.Flush(emit);
+        }
+
+        state.SetItemsProcessed(state.GetIterations() * trace.size());
+        state.SetCounter("pointsIn", static_cast<double>(trace.size()));
+        state.SetCounter("pointsOut", static_cast<double>(kept));
+    }
+}
+
+BENCHMARK(Simplify_Tolerance0)
+{
+    Simplify(state, 0.0f);
+}
+
+BENCHMARK(Simplify_Tolerance0_5)
+{
+    Simplify(state, 0.5f);
+}
+
+BENCHMARK(Simplify_Tolerance1)
+{
+    Simplify(state, 1.0f);
+}
+
+BENCHMARK(Simplify_Tolerance2)
+{
+    Simplify(state, 2.0f);
+}
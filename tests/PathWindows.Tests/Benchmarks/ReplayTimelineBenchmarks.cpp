@@ -0,0 +1,128 @@
+#include "BenchmarkHarness.h"
+#include "ReplayTimeline.h"
+#include <cstdint>
+#include <random>
+#include <vector>
+
+using namespace PathWindows;
+using namespace PathWindows::Benchmarks;
+
+// Finding how far a replay of a long recording got: seeking to any time (e.g. dragging a slider) against stepping
+// frame by frame at 60 Hz, and against walking the delays one by one from the start, which is what replaying without
+// a timeline amounts to.
+
+namespace
+{
+    constexpr int64_t FRAME_NS = 16'666'667;
+
+    // a movement every 1 ms or so, with pauses now and then
+    ReplayTimeline MakeTimeline(size_t count)
+    {
+        std::mt19937 random(1);
+
+        std::vector<Movement> path(count);
+        for (size_t i = 0; i < count; ++i)
+        {
+            int64_t delay = random() % 500 == 0 ? 2'000'000'000 : 500'000 + random() % 1'000'000;
+            path[i] = Movement{ PointI{ static_cast<int32_t>(i % 1920), static_cast<int32_t>(i % 1080) }, delay };
+        }
+
+        ReplayTimeline timeline;
+        timeline.Assign(path.data(), path.size());
+        return timeline;
+    }
+
+    std::vector<int64_t> MakeSeekTimes(const ReplayTimeline& timeline)
+    {
+        std::mt19937_64 random(2);
+
+        std::vector<int64_t> times(1024);
+        for (int64_t& time : times) time = static_cast<int64_t>(random() % static_cast<uint64_t>(timeline.GetDuration()));
+        return times;
+    }
+
+    void Seek(State& state, size_t count)
+    {
+        ReplayTimeline timeline = MakeTimeline(count);
+        std::vector<int64_t> times = MakeSeekTimes(timeline);
+
+        size_t next = 0;
+        while (state.KeepRunning()) DoNotOptimize(timeline.Seek(times[next++ & 1023]));
+
+        state.SetItemsProcessed(state.GetIterations());
+    }
+
+    // a whole replay, a frame at a time
+    void Step(State& state, size_t count)
+    {
+        ReplayTimeline timeline = MakeTimeline(count);
+        uint64_t frames = 0;
+
+        while (state.KeepRunning())
+        {
+            size_t reached = 0;
+            for (int64_t time = 0; reached < timeline.GetCount(); time += FRAME_NS)
+            {
+                reached = timeline.Step(reached, time);
+                ++frames;
+            }
+            DoNotOptimize(reached);
+        }
+
+        state.SetItemsProcessed(frames);
+        state.SetCounter("frames", static_cast<double>(frames) / state.GetIterations());
+    }
+}
+
+BENCHMARK(Seek_10K)
+{
+    Seek(state, 10'000);
+}
+
+BENCHMARK(Seek_10M)
+{
+    Seek(state, 10'000'000);
+}
+
+BENCHMARK(Step_1M)
+{
+    Step(state, 1'000'000);
+}
+
+// seeking every frame instead, from scratch
+BENCHMARK(SeekEveryFrame_1M)
+{
+    ReplayTimeline timeline = MakeTimeline(1'000'000);
+    uint64_t frames = 0;
+
+    while (state.KeepRunning())
+    {
+        size_t reached = 0;
+        for (int64_t time = 0; reached < timeline.GetCount(); time += FRAME_NS)
+        {
+            reached = timeline.Seek(time);
+            ++frames;
+        }
+        DoNotOptimize(reached);
+    }
+
+    state.SetItemsProcessed(frames);
+}
+
+// what finding the same times costs by summing the delays up to them
+BENCHMARK(Seek_LinearScan_1M)
+{
+    ReplayTimeline timeline = MakeTimeline(1'000'000);
+    std::vector<int64_t> times = MakeSeekTimes(timeline);
+
+    size_t next = 0;
+    while (state.KeepRunning())
+    {
+        int64_t time = times[next++ & 1023];
+        size_t reached = 0;
+        while (reached < timeline.GetCount() && timeline.GetTime(reached) <= time) ++reached;
+        DoNotOptimize(reached);
+    }
+
+    state.SetItemsProcessed(state.GetIterations());
+}
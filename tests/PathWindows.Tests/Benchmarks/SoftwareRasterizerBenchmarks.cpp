@@ -0,0 +1,83 @@
+#include "BenchmarkHarness.h"
+#include "SoftwareRasterizer.h"
+#include <cmath>
+#include <vector>
+
+using namespace PathWindows;
+using namespace PathWindows::Benchmarks;
+
+namespace
+{
+    constexpr int32_t WIDTH = 1920;
+    constexpr int32_t HEIGHT = 1080;
+    constexpr float STROKE_WIDTH = 3.0f;
+    constexpr ColorF STROKE_COLOR{ 1.0f, 0.0f, 0.0f, 0.7f };
+
+    // a mouse path with steps of a few pixels, like the ones recorded
+    std::vector<PointF> MakePath(size_t count)
+    {
+        std::vector<PointF> points(count);
+        for (size_t i = 0; i < count; ++i)
+        {
+            float t = static_cast<float>(i) * 0.004f;
+            points[i] = PointF{ 960.0f + 800.0f * std::sin(t * 1.7f), 540.0f + 450.0f * std::sin(t * 2.3f + 1.0f) };
+        }
+
+        return points;
+    }
+
+    void RenderFull(State& state, size_t pointCount)
+    {
+        std::vector<uint32_t> pixels(static_cast<size_t>(WIDTH) * HEIGHT);
+        std::vector<PointF> points = MakePath(pointCount);
+
+        SoftwareRasterizer rasterizer;
+        rasterizer.SetTarget(reinterpret_cast<uint8_t*>(pixels.data()), WIDTH, HEIGHT, WIDTH * 4);
+
+        while (state.KeepRunning())
+        {
+            rasterizer.Clear(ColorF{});
+            rasterizer.AddPolyline(points.data(), points.size(), STROKE_WIDTH);
+            rasterizer.FillStroke(STROKE_COLOR);
+
+            ClobberMemory();
+        }
+
+        state.SetItemsProcessed(state.GetIterations() * pointCount);
+    }
+}
+
+BENCHMARK(RenderFull_Path1K)
+{
+    RenderFull(state, 1'000);
+}
+
+BENCHMARK(RenderFull_Path10K)
+{
+    RenderFull(state, 10'000);
+}
+
+// what a frame costs with the accumulator: the points since the last frame, clipped to their dirty rect
+BENCHMARK(RenderIncremental_16Points)
+{
+    std::vector<uint32_t> pixels(static_cast<size_t>(WIDTH) * HEIGHT);
+    std::vector<PointF> points = MakePath(100'000);
+
+    SoftwareRasterizer rasterizer;
+    rasterizer.SetTarget(reinterpret_cast<uint8_t*>(pixels.data()), WIDTH, HEIGHT, WIDTH * 4);
+    rasterizer.Clear(ColorF{});
+
+    size_t start = 0;
+    while (state.KeepRunning())
+    {
+        if (start + 17 > points.size()) start = 0;
+
+        rasterizer.AddPolyline(points.data() + start, 17, STROKE_WIDTH);
+        rasterizer.FillStroke(STROKE_COLOR);
+        start += 16;
+
+        ClobberMemory();
+    }
+
+    state.SetItemsProcessed(state.GetIterations() * 16);
+}
@@ -0,0 +1,76 @@
+#include "BenchmarkHarness.h"
+#include "SpscQueue.h"
+#include <algorithm>
+#include <cstdint>
+#include <thread>
+
+using namespace PathWindows;
+using namespace PathWindows::Benchmarks;
+
+namespace
+{
+    struct Point
+    {
+        int32_t x;
+        int32_t y;
+    };
+
+    // Moves the items of every iteration from a producer thread to this one, batchSize at a time on both ends.
+    void Transfer(State& state, size_t batchSize)
+    {
+        constexpr size_t ITEMS_PER_ITERATION = 1 << 16;
+
+        SpscQueue<Point> queue(4096);
+        Point batch[256];
+        for (size_t i = 0; i < 256; ++i) batch[i] = Point{ static_cast<int32_t>(i), 0 };
+
+        uint64_t total = ITEMS_PER_ITERATION * state.GetIterations();
+
+        std::thread producer([&]
+        {
+            uint64_t pushed = 0;
+            while (pushed < total)
+            {
+                size_t count = static_cast<size_t>(std::min<uint64_t>(batchSize, total - pushed));
+                size_t done = batchSize == 1 ? (queue.TryPush(batch[0]) ? 1 : 0) : queue.TryPushRange(batch, count);
+
+                if (done == 0) std::this_thread::yield();
+                pushed += done;
+            }
+        });
+
+        Point out[256];
+        while (state.KeepRunning())
+        {
+            size_t popped = 0;
+            while (popped < ITEMS_PER_ITERATION)
+            {
+                size_t count = queue.PopBatch(out, std::min(batchSize, ITEMS_PER_ITERATION - popped));
+                if (count == 0) std::this_thread::yield();
+                popped += count;
+            }
+
+            DoNotOptimize(out[0]);
+        }
+
+        producer.join();
+
+        state.SetItemsProcessed(total);
+        state.SetBytesProcessed(total * sizeof(Point));
+    }
+}
+
+BENCHMARK(Transfer_SingleItems)
+{
+    Transfer(state, 1);
+}
+
+BENCHMARK(Transfer_Batches64)
+{
+    Transfer(state, 64);
+}
+
+BENCHMARK(Transfer_Batches256)
+{
+    Transfer(state, 256);
+}
@@ -0,0 +1,70 @@
+#include "BenchmarkHarness.h"
+#include "StrokeAccumulator.h"
+
+using namespace PathWindows;
+using namespace PathWindows::Benchmarks;
+
+namespace
+{
+    // Reads every point that would be stroked, in place of stroking it.
+    float StrokePending(const StrokeAccumulator& accumulator)
+    {
+        float sum = 0;
+        accumulator.ForEachPendingRun([&](const PointF* points, size_t count)
+        {
+            for (size_t i = 0; i < count; ++i) sum += points[i].x;
+        });
+
+        return sum;
+    }
+
+    // One frame of a growing path: appends a few points, visits the runs that have to be stroked and commits them.
+    // The time per frame should not depend on how long the path already is.
+    void AppendFrames(State& state, size_t pathLength)
+    {
+        constexpr size_t POINTS_PER_FRAME = 16;
+
+        StrokeAccumulator accumulator;
+        for (size_t i = 0; i < pathLength; ++i) accumulator.Append(PointF{ static_cast<float>(i % 1920), static_cast<float>(i / 1920) }, i == 0);
+        accumulator.Commit();
+
+        float x = 0;
+        while (state.KeepRunning())
+        {
+            for (size_t i = 0; i < POINTS_PER_FRAME; ++i, ++x) accumulator.Append(PointF{ x, 0 }, false);
+
+            DoNotOptimize(StrokePending(accumulator));
+            accumulator.Commit();
+        }
+
+        state.SetItemsProcessed(state.GetIterations() * POINTS_PER_FRAME);
+        state.SetCounter("pathLength", static_cast<double>(pathLength));
+    }
+}
+
+BENCHMARK(AppendFrame_Path1K)
+{
+    AppendFrames(state, 1'000);
+}
+
+BENCHMARK(AppendFrame_Path1M)
+{
+    AppendFrames(state, 1'000'000);
+}
+
+// what a full redraw visits, for comparison
+BENCHMARK(FullRedraw_Path1M)
+{
+    StrokeAccumulator accumulator;
+    for (size_t i = 0; i < 1'000'000; ++i) accumulator.Append(PointF{ static_cast<float>(i % 1920), static_cast<float>(i / 1920) }, i % 1000 == 0);
+
+    while (state.KeepRunning())
+    {
+        accumulator.Invalidate();
+
+        DoNotOptimize(StrokePending(accumulator));
+        accumulator.Commit();
+    }
+
+    state.SetItemsProcessed(state.GetIterations() * 1'000'000);
+}
@@ -0,0 +1,113 @@
+#include "BenchmarkHarness.h"
+#include "StrokeLog.h"
+#include <cstdint>
+#include <vector>
+
+using namespace PathWindows;
+using namespace PathWindows::Benchmarks;
+
+// Undoing and redoing only moves the cursor of the log, so a step has to cost the same at the start of a history of
+// 100k strokes as at the end of it, and as in a history of 1k strokes.
+
+namespace
+{
+    constexpr size_t POINTS_PER_STROKE = 20;
+
+    void Record(StrokeLog& log, size_t strokeCount)
+    {
+        log.Reset(nullptr, 0);
+
+        for (size_t stroke = 0; stroke < strokeCount; ++stroke)
+        {
+            log.BeginStroke();
+            for (size_t i = 0; i < POINTS_PER_STROKE; ++i)
+            {
+                int32_t x = static_cast<int32_t>((stroke * 7 + i) % 1920);
+                int32_t y = static_cast<int32_t>((stroke * 3 + i) % 1080);
+                log.Append(Movement{ PointI{ x, y }, i == 0 ? 0 : 8'000'000 });
+            }
+
+            // every tenth step erases a few segments of the stroke before
+            if (stroke % 10 == 9)
+            {
+                std::vector<uint32_t> segments = { static_cast<uint32_t>(log.GetSize() - 3), static_cast<uint32_t>(log.GetSize() - 2) };
+                std::vector<uint32_t> points;
+                log.Erase(segments, points, false);
+            }
+        }
+    }
+
+    // undoes the whole history, then redoes it, in every iteration
+    void UndoRedoAll(State& state, size_t strokeCount)
+    {
+        StrokeLog log;
+        Record(log, strokeCount);
+        size_t steps = log.GetUndoCount();
+
+        StrokeLog::Change change;
+        size_t changed = 0;
+        while (state.KeepRunning())
+        {
+            while (log.Undo(change)) changed += change.strokeEnd - change.strokeBegin + change.segmentRangeCount;
+            while (log.Redo(change)) changed += change.strokeEnd - change.strokeBegin + change.segmentRangeCount;
+        }
+
+        DoNotOptimize(changed);
+        state.SetItemsProcessed(state.GetIterations() * steps * 2);
+        state.SetCounter("steps", static_cast<double>(steps));
+    }
+}
+
+BENCHMARK(UndoRedoAll_1kStrokes)
+{
+    UndoRedoAll(state, 1'000);
+}
+
+BENCHMARK(UndoRedoAll_100kStrokes)
+{
+    UndoRedoAll(state, 100'000);
+}
+
+// one undo and one redo at the end of a long history, as when the keys are pressed
+BENCHMARK(UndoRedoOne_100kStrokes)
+{
+    StrokeLog log;
+    Record(log, 100'000);
+
+    StrokeLog::Change change;
+    while (state.KeepRunning())
+    {
+        log.Undo(change);
+        log.Redo(change);
+        DoNotOptimize(change.strokeEnd);
+    }
+
+    state.SetItemsProcessed(state.GetIterations() * 2);
+}
+
+// undoing then drawing again drops the redo, which only shrinks the buffer
+BENCHMARK(UndoThenDraw_100kStrokes)
+{
+    StrokeLog log;
+    Record(log, 100'000);
+
+    StrokeLog::Change change;
+    while (state.KeepRunning())
+    {
+        log.Undo(change);
+        log.BeginStroke();
+        for (size_t i = 0; i < POINTS_PER_STROKE; ++i) log.Append(Movement{ PointI{ int32_t(i), 0 }, i == 0 ? 0 : 8'000'000 });
+    }
+
+    DoNotOptimize(log.GetSize());
+    state.SetItemsProcessed(state.GetIterations());
+}
+
+BENCHMARK(Record_100kStrokes)
+{
+    StrokeLog log;
+
+    while (state.KeepRunning()) Record(log, 100'000);
+
+    state.SetItemsProcessed(state.GetIterations() * 100'000 * POINTS_PER_STROKE);
+}
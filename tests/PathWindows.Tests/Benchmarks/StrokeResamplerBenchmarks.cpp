@@ -0,0 +1,70 @@
+#include "BenchmarkHarness.h"
+#include "StrokeResampler.h"
+#include <random>
+#include <vector>
+
+using namespace PathWindows;
+using namespace PathWindows::Benchmarks;
+
+namespace
+{
+    // 100k mouse samples in strokes of 1000, about 20 pixels apart, which densify into millions of steps
+    std::vector<Movement> MakeStrokes()
+    {
+        std::mt19937 random(1);
+        std::uniform_int_distribution<int32_t> step(-20, 20);
+
+        std::vector<Movement> path;
+        for (size_t stroke = 0; stroke < 100; ++stroke)
+        {
+            PointI position{ 960, 540 };
+            path.push_back(Movement{ position, 0 });
+
+            for (size_t i = 1; i < 1000; ++i)
+            {
+                position.x += step(random);
+                position.y += step(random);
+                path.push_back(Movement{ position, 1 });
+            }
+        }
+
+        return path;
+    }
+
+    void Resample(State& state, Interpolation interpolation, Easing easing)
+    {
+        std::vector<Movement> path = MakeStrokes();
+        std::vector<Movement> out;
+        StrokeResampler resampler(ResampleOptions{ 1.0f, 1'000'000.0, interpolation, easing });
+
+        while (state.KeepRunning())
+        {
+            out.clear();
+            resampler.Resample(path.data(), path.size(), nullptr, out);
+            DoNotOptimize(out.data());
+        }
+
+        state.SetItemsProcessed(state.GetIterations() * out.size());
+        state.SetCounter("steps", static_cast<double>(out.size()));
+    }
+}
+
+BENCHMARK(Resample_Linear_Constant)
+{
+    Resample(state, Interpolation::LINEAR, Easing::CONSTANT);
+}
+
+BENCHMARK(Resample_Linear_EaseInOut)
+{
+    Resample(state, Interpolation::LINEAR, Easing::EASE_IN_OUT);
+}
+
+BENCHMARK(Resample_CatmullRom_Constant)
+{
+    Resample(state, Interpolation::CATMULL_ROM, Easing::CONSTANT);
+}
+
+BENCHMARK(Resample_CatmullRom_EaseInOut)
+{
+    Resample(state, Interpolation::CATMULL_ROM, Easing::EASE_IN_OUT);
+}
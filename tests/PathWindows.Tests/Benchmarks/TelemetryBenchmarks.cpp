@@ -0,0 +1,84 @@
+#include "BenchmarkHarness.h"
+#include "Telemetry.h"
+#include <atomic>
+#include <chrono>
+#include <thread>
+
+using namespace PathWindows;
+using namespace PathWindows::Benchmarks;
+
+// what recording one event costs on the thread that records it
+
+BENCHMARK(Counter_Add)
+{
+    Counter counter;
+    while (state.KeepRunning()) counter.Add(1);
+
+    DoNotOptimize(counter.Get());
+    state.SetItemsProcessed(state.GetIterations());
+}
+
+BENCHMARK(Gauge_Set)
+{
+    Gauge gauge;
+    uint64_t value = 0;
+    while (state.KeepRunning()) gauge.Set(++value & 0xFF);
+
+    DoNotOptimize(gauge.Get());
+    state.SetItemsProcessed(state.GetIterations());
+}
+
+BENCHMARK(Histogram_Record)
+{
+    Histogram histogram;
+    int64_t ns = 0;
+    while (state.KeepRunning()) histogram.Record(ns += 977);
+
+    HistogramSnapshot snapshot;
+    histogram.CopyTo(snapshot);
+    DoNotOptimize(snapshot.count);
+    state.SetItemsProcessed(state.GetIterations());
+}
+
+// the two clock reads around a timed section, which cost more than recording it
+BENCHMARK(Histogram_RecordTimed)
+{
+    Histogram histogram;
+    while (state.KeepRunning())
+    {
+        auto start = std::chrono::steady_clock::now();
+        histogram.Record(std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now() - start).count());
+    }
+
+    state.SetItemsProcessed(state.GetIterations());
+}
+
+// while another thread records into the same histogram, as the window thread and an export can
+BENCHMARK(Histogram_RecordContended)
+{
+    Histogram histogram;
+    std::atomic<bool> stop(false);
+    std::thread other([&histogram, &stop]
+    {
+        while (!stop.load(std::memory_order_relaxed)) histogram.Record(500);
+    });
+
+    int64_t ns = 0;
+    while (state.KeepRunning()) histogram.Record(ns += 977);
+
+    stop = true;
+    other.join();
+    state.SetItemsProcessed(state.GetIterations());
+}
+
+BENCHMARK(Snapshot)
+{
+    Telemetry telemetry;
+    StatsSnapshot snapshot;
+
+    while (state.KeepRunning())
+    {
+        telemetry.CopyTo(snapshot);
+        DoNotOptimize(snapshot.frameTime.count);
+    }
+}
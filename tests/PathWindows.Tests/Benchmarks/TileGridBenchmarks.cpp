@@ -0,0 +1,101 @@
+#include "BenchmarkHarness.h"
+#include "TileGrid.h"
+#include <cmath>
+#include <cstring>
+#include <vector>
+
+using namespace PathWindows;
+using namespace PathWindows::Benchmarks;
+
+namespace
+{
+    // three 1920x1080 monitors side by side
+    constexpr int32_t DESKTOP_WIDTH = 3 * 1920;
+    constexpr int32_t DESKTOP_HEIGHT = 1080;
+    constexpr int32_t TILE_SIZE = 256;
+    constexpr size_t BYTES_PER_PIXEL = 4;
+
+    // a wandering path that stays in the top left 400x300 of the first monitor
+    std::vector<PointF> MakeCornerPath(size_t count)
+    {
+        std::vector<PointF> points(count);
+        for (size_t i = 0; i < count; ++i)
+        {
+            float t = static_cast<float>(i) * 0.01f;
+            points[i] = PointF{ 200.0f + 180.0f * std::sin(t * 1.3f), 150.0f + 130.0f * std::cos(t * 0.7f) };
+        }
+
+        return points;
+    }
+}
+
+BENCHMARK(MarkSegments_CornerPath10K)
+{
+    std::vector<PointF> points = MakeCornerPath(10'000);
+    TileGrid grid(DESKTOP_WIDTH, DESKTOP_HEIGHT, TILE_SIZE);
+
+    while (state.KeepRunning())
+    {
+        grid.Clear();
+        for (size_t i = 1; i < points.size(); ++i) grid.MarkSegment(points[i - 1], points[i], 2.0f);
+
+        DoNotOptimize(grid.GetOccupiedCount());
+    }
+
+    // the window still draws into one surface covering the desktop, so the grid saves no memory, only the area a
+    // full redraw clears and presents: the occupied spans instead of the whole surface
+    int64_t spanArea = 0;
+    grid.ForEachOccupiedSpan([&spanArea](RectI rect)
+    {
+        spanArea += static_cast<int64_t>(rect.right - rect.left) * (rect.bottom - rect.top);
+    });
+    int64_t surfaceArea = static_cast<int64_t>(DESKTOP_WIDTH) * DESKTOP_HEIGHT;
+
+    state.SetItemsProcessed(state.GetIterations() * (points.size() - 1));
+    state.SetCounter("tiles", static_cast<double>(grid.GetOccupiedCount()));
+    state.SetCounter("clearedPixels", static_cast<double>(spanArea));
+    state.SetCounter("surfacePixels", static_cast<double>(surfaceArea));
+    state.SetCounter("clearedFraction", static_cast<double>(spanArea) / surfaceArea);
+}
+
+BENCHMARK(ClearSurface_Full)
+{
+    std::vector<uint8_t> surface(static_cast<size_t>(DESKTOP_WIDTH) * DESKTOP_HEIGHT * BYTES_PER_PIXEL);
+
+    while (state.KeepRunning())
+    {
+        std::memset(surface.data(), 0, surface.size());
+        ClobberMemory();
+    }
+
+    state.SetBytesProcessed(state.GetIterations() * surface.size());
+}
+
+BENCHMARK(ClearSurface_OccupiedTiles)
+{
+    std::vector<uint8_t> surface(static_cast<size_t>(DESKTOP_WIDTH) * DESKTOP_HEIGHT * BYTES_PER_PIXEL);
+    std::vector<PointF> points = MakeCornerPath(10'000);
+
+    TileGrid grid(DESKTOP_WIDTH, DESKTOP_HEIGHT, TILE_SIZE);
+    for (size_t i = 1; i < points.size(); ++i) grid.MarkSegment(points[i - 1], points[i], 2.0f);
+
+    size_t bytes = 0;
+    while (state.KeepRunning())
+    {
+        bytes = 0;
+        grid.ForEachOccupiedSpan([&surface, &bytes](RectI rect)
+        {
+            size_t rowBytes = static_cast<size_t>(rect.right - rect.left) * BYTES_PER_PIXEL;
+            for (int32_t y = rect.top; y < rect.bottom; ++y)
+            {
+                std::memset(surface.data() + (static_cast<size_t>(y) * DESKTOP_WIDTH + rect.left) * BYTES_PER_PIXEL, 0, rowBytes);
+            }
+
+            bytes += rowBytes * (rect.bottom - rect.top);
+        });
+
+        ClobberMemory();
+    }
+
+    state.SetBytesProcessed(state.GetIterations() * bytes);
+}
@@ -0,0 +1,90 @@
+#include "BenchmarkHarness.h"
+#include "TrailBuffer.h"
+#include <chrono>
+#include <cstdint>
+
+using namespace PathWindows;
+using namespace PathWindows::Benchmarks;
+
+// A recording session streamed through the trail the way the overlay does: points at 1 kHz, evicted every 8 ms, and
+// every ten seconds a frame is timed that walks the runs in fade buckets. Once the trail is full, neither the time per
+// point nor the time per frame may depend on how many points went through, so "firstFrameNS" is the mean of the frames in
+// the first and "lastFrameNS" of those in the last million points of the stream.
+
+namespace
+{
+    constexpr size_t STREAM_POINTS = 10'000'000;
+    constexpr size_t POINTS_PER_EVICT = 8;
+    constexpr size_t POINTS_PER_FRAME = 10'000;
+    constexpr size_t WINDOW_POINTS = 1'000'000;
+    constexpr int64_t POINT_INTERVAL_NS = 1'000'000;
+    constexpr size_t BUCKET_COUNT = 8;
+
+    PointF GetPoint(size_t i)
+    {
+        return PointF{ static_cast<float>(i % 1920), static_cast<float>((i / 7) % 1080) };
+    }
+
+    uint64_t RenderFrame(TrailBuffer& trail, int64_t nowNS)
+    {
+        uint64_t pointCount = 0;
+        trail.ForEachRun(nowNS, BUCKET_COUNT, [&pointCount](size_t, const PointF*, size_t count)
+        {
+            pointCount += count;
+        });
+
+        return pointCount;
+    }
+
+    void Stream(State& state, size_t maxPoints, int64_t maxAgeNS)
+    {
+        TrailBuffer trail;
+        double firstNS = 0, lastNS = 0;
+
+        while (state.KeepRunning())
+        {
+            trail.Configure(maxPoints, maxAgeNS);
+            firstNS = lastNS = 0;
+
+            uint64_t pointCount = 0;
+            for (size_t i = 1; i <= STREAM_POINTS; ++i)
+            {
+                int64_t nowNS = static_cast<int64_t>(i) * POINT_INTERVAL_NS;
+                trail.Append(GetPoint(i), i % 5000 == 0, nowNS);
+
+                if (i % POINTS_PER_EVICT == 0) trail.Evict(nowNS);
+                if (i % POINTS_PER_FRAME != 0) continue;
+
+                auto start = std::chrono::steady_clock::now();
+                pointCount += RenderFrame(trail, nowNS);
+                double frameNS = static_cast<double>(std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now() - start).count());
+
+                if (i <= WINDOW_POINTS) firstNS += frameNS;
+                else if (i > STREAM_POINTS - WINDOW_POINTS) lastNS += frameNS;
+            }
+
+            DoNotOptimize(pointCount);
+        }
+
+        state.SetItemsProcessed(state.GetIterations() * STREAM_POINTS);
+        state.SetCounter("firstFrameNS", firstNS / (WINDOW_POINTS / POINTS_PER_FRAME));
+        state.SetCounter("lastFrameNS", lastNS / (WINDOW_POINTS / POINTS_PER_FRAME));
+        state.SetCounter("trailPoints", static_cast<double>(trail.GetCount()));
+    }
+}
+
+BENCHMARK(Stream10M_Last1000Points)
+{
+    Stream(state, 1000, 0);
+}
+
+BENCHMARK(Stream10M_Last10000Points)
+{
+    Stream(state, 10'000, 0);
+}
+
+// the age drops points before the count does
+BENCHMARK(Stream10M_Last2Seconds)
+{
+    Stream(state, 10'000, 2'000'000'000);
+}
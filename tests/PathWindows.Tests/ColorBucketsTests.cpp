@@ -0,0 +1,224 @@
+#include "TestHarness.h"
+#include "ColorBuckets.h"
+#include <algorithm>
+#include <cstdint>
+#include <random>
+#include <vector>
+
+using namespace PathWindows;
+
+namespace
+{
+    struct Segment
+    {
+        size_t end;
+        size_t bucket;
+    };
+
+    // The segments of the runs Build sorted, by the index of the point they end at, checking that the runs come bucket by
+    // bucket and in path order within a bucket. The runs point into the copy the buckets keep, so the points have to be
+    // different from each other to be found in points.
+    std::vector<Segment> GetSegments(const ColorBuckets& buckets, const std::vector<PointF>& points)
+    {
+        std::vector<Segment> segments;
+        size_t lastBucket = 0;
+        size_t lastFirst = 0;
+
+        buckets.ForEachRun([&](size_t bucket, const PointF* runPoints, size_t count)
+        {
+            CHECK(bucket >= lastBucket);
+            CHECK(bucket < buckets.GetBucketCount());
+            CHECK(count >= 2);
+
+            auto it = std::find_if(points.begin(), points.end(), [runPoints](PointF point) { return point.x == runPoints->x && point.y == runPoints->y; });
+            REQUIRE(it != points.end());
+            size_t first = static_cast<size_t>(it - points.begin());
+            if (!segments.empty() && bucket == lastBucket) CHECK(first > lastFirst);
+            lastBucket = bucket;
+            lastFirst = first;
+
+            for (size_t i = 1; i < count; ++i) segments.push_back(Segment{ first + i, bucket });
+        });
+
+        return segments;
+    }
+}
+
+TEST_CASE(GetBucket_Speed_GrowsWithTheSpeed)
+{
+    ColorBuckets buckets(ColorBuckets::Scale::SPEED, 8);
+
+    // 1 pixel per ms, then ever faster, with the last one faster than the scale
+    buckets.Append(PointF{ 0, 0 }, 0, true);
+    float x = 0;
+    for (float pixels : { 1.0f, 2.0f, 4.0f, 8.0f, 100.0f })
+    {
+        x += pixels;
+        buckets.Append(PointF{ x, 0 }, 1'000'000, false);
+    }
+
+    for (size_t i = 2; i <= 5; ++i) CHECK(buckets.GetBucket(i) >= buckets.GetBucket(i - 1));
+    CHECK(buckets.GetBucket(1) < buckets.GetBucket(4));
+    CHECK(buckets.GetBucket(5) == 7);
+}
+
+TEST_CASE(GetBucket_NoDelay_IsInstantOrStill)
+{
+    ColorBuckets buckets(ColorBuckets::Scale::SPEED, 4);
+    buckets.Append(PointF{ 0, 0 }, 0, true);
+    buckets.Append(PointF{ 10, 0 }, 0, false);
+    buckets.Append(PointF{ 10, 0 }, 0, false);
+    buckets.Append(PointF{ 10, 0 }, 5'000'000, false);
+
+    CHECK(buckets.GetBucket(1) == 3);
+    CHECK(buckets.GetBucket(2) == 0);
+    CHECK(buckets.GetBucket(3) == 0);
+}
+
+TEST_CASE(GetBucket_ElapsedTime_DoublesTheScaleWhenPassed)
+{
+    ColorBuckets buckets(ColorBuckets::Scale::ELAPSED_TIME, 4);
+    buckets.Append(PointF{ 0, 0 }, 0, true);
+    buckets.Append(PointF{ 1, 0 }, 300'000'000, false);
+    buckets.Append(PointF{ 2, 0 }, 300'000'000, false);
+
+    CHECK(buckets.GetTimeScale() == ColorBuckets::INITIAL_TIME_SCALE_NS);
+    CHECK(buckets.GetBucket(1) == 1);
+    CHECK(buckets.GetBucket(2) == 2);
+
+    buckets.Build();
+    buckets.Commit();
+    CHECK(!buckets.NeedsFullRedraw());
+
+    // 1.6 s is past the 1 s scale, which doubles to 2 s and recolors everything
+    buckets.Append(PointF{ 3, 0 }, 1'000'000'000, false);
+    CHECK(buckets.GetTimeScale() == 2 * ColorBuckets::INITIAL_TIME_SCALE_NS);
+    CHECK(buckets.NeedsFullRedraw());
+    CHECK(buckets.GetBucket(1) == 0);
+    CHECK(buckets.GetBucket(3) == 3);
+}
+
+TEST_CASE(Build_RandomPath_SortsEverySegmentIntoItsBucketOnce)
+{
+    std::mt19937 random(1);
+
+    for (auto scale : { ColorBuckets::Scale::SPEED, ColorBuckets::Scale::ELAPSED_TIME })
+    {
+        ColorBuckets buckets(scale, 6);
+        std::vector<PointF> points;
+        std::vector<bool> figureStarts;
+
+        for (int i = 0; i < 5000; ++i)
+        {
+            PointF point{ float(i), float(random() % 1080) };
+            bool newFigure = i == 0 || random() % 50 == 0;
+
+            buckets.Append(point, 1'000'000 + random() % 50'000'000, newFigure);
+            points.push_back(point);
+            figureStarts.push_back(newFigure);
+        }
+
+        buckets.Build();
+        std::vector<Segment> segments = GetSegments(buckets, points);
+
+        std::vector<size_t> found(points.size(), 0);
+        std::vector<bool> used(6, false);
+        for (const Segment& segment : segments)
+        {
+            CHECK(segment.bucket == buckets.GetBucket(segment.end));
+            ++found[segment.end];
+            used[segment.bucket] = true;
+        }
+
+        // every segment once, and none ending where a figure starts
+        for (size_t i = 0; i < points.size(); ++i) CHECK(found[i] == (figureStarts[i] ? 0u : 1u));
+
+        CHECK(buckets.GetBatchCount() == static_cast<size_t>(std::count(used.begin(), used.end(), true)));
+        CHECK(buckets.GetRunCount() >= buckets.GetBatchCount());
+    }
+}
+
+TEST_CASE(Build_FigureStarts_AreNotJoined)
+{
+    ColorBuckets buckets(ColorBuckets::Scale::SPEED, 1);
+    std::vector<PointF> points = { { 0, 0 }, { 1, 0 }, { 2, 0 }, { 100, 0 }, { 101, 0 } };
+
+    buckets.Append(points[0], 0, true);
+    buckets.Append(points[1], 1000, false);
+    buckets.Append(points[2], 1000, false);
+    buckets.Append(points[3], 1000, true);
+    buckets.Append(points[4], 1000, false);
+    buckets.Build();
+
+    std::vector<Segment> segments = GetSegments(buckets, points);
+    REQUIRE(segments.size() == 3);
+    CHECK(segments[0].end == 1 && segments[1].end == 2 && segments[2].end == 4);
+    CHECK(buckets.GetRunCount() == 2);
+    CHECK(buckets.GetBatchCount() == 1);
+}
+
+TEST_CASE(Build_AfterCommit_OnlySortsNewSegments)
+{
+    ColorBuckets buckets(ColorBuckets::Scale::SPEED, 4);
+    std::vector<PointF> points;
+    for (int i = 0; i < 10; ++i)
+    {
+        points.push_back(PointF{ float(i * 5), 0 });
+        buckets.Append(points.back(), 1'000'000, i == 0);
+    }
+
+    buckets.Build();
+    buckets.Commit();
+    CHECK(!buckets.HasPending());
+
+    points.push_back(PointF{ 50, 0 });
+    buckets.Append(points.back(), 1'000'000, false);
+    CHECK(buckets.HasPending());
+    buckets.Build();
+
+    // the new segment starts at the last drawn point
+    std::vector<Segment> segments = GetSegments(buckets, points);
+    REQUIRE(segments.size() == 1);
+    CHECK(segments[0].end == 10);
+
+    // until the surface is lost
+    buckets.Commit();
+    buckets.Invalidate();
+    buckets.Build();
+    CHECK(GetSegments(buckets, points).size() == 10);
+}
+
+TEST_CASE(GetColor_Ends_AreBlueAndRed)
+{
+    ColorBuckets buckets(ColorBuckets::Scale::SPEED, 8);
+
+    ColorF slow = buckets.GetColor(0);
+    ColorF fast = buckets.GetColor(7);
+    CHECK(slow.b == 1.0f && slow.r == 0.0f);
+    CHECK(fast.r == 1.0f && fast.g == 0.0f && fast.b == 0.0f);
+    CHECK(slow.a == 0.7f && fast.a == 0.7f);
+
+    ColorBuckets one(ColorBuckets::Scale::SPEED, 1);
+    CHECK(one.GetColor(0).r == 1.0f);
+}
+
+TEST_CASE(Clear_Path_StartsOver)
+{
+    ColorBuckets buckets(ColorBuckets::Scale::ELAPSED_TIME, 4);
+    buckets.Append(PointF{ 0, 0 }, 0, true);
+    buckets.Append(PointF{ 1, 0 }, 5'000'000'000, false);
+    buckets.Build();
+    buckets.Commit();
+
+    buckets.Clear();
+    CHECK(buckets.GetPointCount() == 0);
+    CHECK(buckets.GetTimeScale() == ColorBuckets::INITIAL_TIME_SCALE_NS);
+    CHECK(buckets.NeedsFullRedraw());
+    CHECK(buckets.GetRunCount() == 0 && buckets.GetBatchCount() == 0);
+
+    // the first point after clearing starts a figure even if it says otherwise
+    buckets.Append(PointF{ 5, 5 }, 1000, false);
+    buckets.Append(PointF{ 6, 5 }, 1000, false);
+    buckets.Build();
+    CHECK(buckets.GetRunCount() == 1);
+}
@@ -0,0 +1,261 @@
+#include "TestHarness.h"
+#include "CursorPath.h"
+#include <cstdint>
+#include <random>
+#include <vector>
+
+using namespace PathWindows;
+
+namespace
+{
+    // a 1920x1080 primary monitor, a 1280x1024 one to its right that sits lower, and one above the primary with a gap
+    // between, all with their right and bottom edges included like SystemInformation.MonitorRects
+    const RectI MONITORS[] = {
+        RectI{ 0, 0, 1919, 1079 },
+        RectI{ 1920, 200, 3199, 1223 },
+        RectI{ 300, -1200, 1899, -301 },
+    };
+    constexpr size_t MONITOR_COUNT = sizeof(MONITORS) / sizeof(MONITORS[0]);
+
+    bool ContainsInclusive(const RectI& rect, int32_t x, int32_t y)
+    {
+        return x >= rect.left && x <= rect.right && y >= rect.top && y <= rect.bottom;
+    }
+
+    bool AnyContains(int32_t x, int32_t y)
+    {
+        for (const RectI& monitor : MONITORS)
+        {
+            if (ContainsInclusive(monitor, x, y)) return true;
+        }
+
+        return false;
+    }
+
+    // MouseMovement.OffsetPointWithinScreens line by line, false where First throws
+    bool OffsetPointWithinScreens(PointI point, PointI offset, PointI& result)
+    {
+        const RectI* pOgMonitor = nullptr;
+        for (const RectI& monitor : MONITORS)
+        {
+            if (ContainsInclusive(monitor, point.x, point.y))
+            {
+                pOgMonitor = &monitor;
+                break;
+            }
+        }
+
+        if (!pOgMonitor) return false;
+
+        point.x = static_cast<int32_t>(static_cast<uint32_t>(point.x) + static_cast<uint32_t>(offset.x));
+        if (!AnyContains(point.x, point.y))
+        {
+            point.x = offset.x < 0 ? pOgMonitor->left : pOgMonitor->right;
+        }
+
+        point.y = static_cast<int32_t>(static_cast<uint32_t>(point.y) + static_cast<uint32_t>(offset.y));
+        if (!AnyContains(point.x, point.y))
+        {
+            point.y = offset.y < 0 ? pOgMonitor->top : pOgMonitor->bottom;
+        }
+
+        result = point;
+        return true;
+    }
+
+    // A walk of the cursor from start over every monitor, with steps that run into the edges and some that do not move
+    // at all. Clamping to the first monitor can leave every monitor when they are not aligned (and C# would throw on the
+    // next step), so those steps are left out.
+    std::vector<Movement> MakeDeltas(PointI start, size_t count, uint32_t seed)
+    {
+        std::mt19937 random(seed);
+        std::uniform_int_distribution<int32_t> step(-40, 40);
+
+        std::vector<Movement> deltas;
+        PointI position = start;
+        while (deltas.size() < count)
+        {
+            int32_t scale = random() % 50 == 0 ? 100 : 1;
+            PointI delta = random() % 10 == 0 ? PointI{ 0, 0 } : PointI{ step(random) * scale, step(random) * scale };
+
+            PointI next;
+            if (!OffsetPointWithinScreens(position, delta, next) || !AnyContains(next.x, next.y)) continue;
+
+            deltas.push_back(Movement{ delta, static_cast<int64_t>(1000 + random() % 1000) });
+            position = next;
+        }
+
+        return deltas;
+    }
+
+    bool Equals(PointI a, PointI b)
+    {
+        return a.x == b.x && a.y == b.y;
+    }
+}
+
+TEST_CASE(OffsetWithinMonitors_StaysOnTheMonitor_JustAddsTheOffset)
+{
+    PointI result;
+    REQUIRE(CursorPath::OffsetWithinMonitors(PointI{ 100, 100 }, PointI{ 50, -20 }, MONITORS, MONITOR_COUNT, result) == CursorPath::Result::OK);
+
+    CHECK(Equals(result, PointI{ 150, 80 }));
+}
+
+TEST_CASE(OffsetWithinMonitors_LeavesEveryMonitor_SnapsToTheEdgeItMovedTowards)
+{
+    PointI result;
+
+    CursorPath::OffsetWithinMonitors(PointI{ 100, 100 }, PointI{ -500, 0 }, MONITORS, MONITOR_COUNT, result);
+    CHECK(Equals(result, PointI{ 0, 100 }));
+
+    CursorPath::OffsetWithinMonitors(PointI{ 100, 1000 }, PointI{ 0, 500 }, MONITORS, MONITOR_COUNT, result);
+    CHECK(Equals(result, PointI{ 100, 1079 }));
+
+    // into the gap between the primary monitor and the one above it
+    CursorPath::OffsetWithinMonitors(PointI{ 500, 10 }, PointI{ 0, -100 }, MONITORS, MONITOR_COUNT, result);
+    CHECK(Equals(result, PointI{ 500, 0 }));
+}
+
+TEST_CASE(OffsetWithinMonitors_OntoAnotherMonitor_CrossesOver)
+{
+    PointI result;
+    CursorPath::OffsetWithinMonitors(PointI{ 1900, 500 }, PointI{ 100, 0 }, MONITORS, MONITOR_COUNT, result);
+
+    CHECK(Equals(result, PointI{ 2000, 500 }));
+}
+
+TEST_CASE(OffsetWithinMonitors_OffScreenStart_IsAnError)
+{
+    PointI result;
+    CHECK(CursorPath::OffsetWithinMonitors(PointI{ 1950, 100 }, PointI{ 1, 1 }, MONITORS, MONITOR_COUNT, result) == CursorPath::Result::OFF_SCREEN);
+}
+
+TEST_CASE(OffsetWithinMonitors_RandomPointsAndOffsets_MatchTheCSharpCode)
+{
+    std::mt19937 random(13);
+    std::uniform_int_distribution<int32_t> coordinate(-1500, 3500);
+    std::uniform_int_distribution<int32_t> offset(-2500, 2500);
+
+    size_t onScreen = 0;
+    for (int i = 0; i < 200000; ++i)
+    {
+        PointI point{ coordinate(random), coordinate(random) };
+        PointI delta{ offset(random), offset(random) };
+        if (i % 4 == 0) delta.x = INT32_MAX - i;
+
+        PointI expected{};
+        bool expectedOk = OffsetPointWithinScreens(point, delta, expected);
+
+        PointI actual{};
+        CursorPath::Result result = CursorPath::OffsetWithinMonitors(point, delta, MONITORS, MONITOR_COUNT, actual);
+
+        CHECK(expectedOk == (result == CursorPath::Result::OK));
+        if (expectedOk)
+        {
+            CHECK(Equals(actual, expected));
+            ++onScreen;
+        }
+    }
+
+    CHECK(onScreen > 10000);
+}
+
+TEST_CASE(ToAbsolute_RandomWalk_MatchesGetAbsoluteCursorPath)
+{
+    Movement start{ PointI{ 960, 540 }, 0 };
+    std::vector<Movement> deltas = MakeDeltas(start.delta, 50000, 17);
+
+    std::vector<Movement> absolute(deltas.size() + 1);
+    size_t count = 0;
+    REQUIRE(CursorPath::ToAbsolute(start, deltas.data(), deltas.size(), MONITORS, MONITOR_COUNT, PointI{}, absolute.data(), count) == CursorPath::Result::OK);
+
+    // the positions ActionCollection.GetAbsoluteCursorPath yields, and the delays with those of the skipped steps added
+    std::vector<Movement> expected{ start };
+    for (const Movement& delta : deltas)
+    {
+        PointI next;
+        REQUIRE(OffsetPointWithinScreens(expected.back().delta, delta.delta, next));
+
+        if (Equals(next, expected.back().delta)) expected.back().delayDurationNS += delta.delayDurationNS;
+        else expected.push_back(Movement{ next, delta.delayDurationNS });
+    }
+
+    REQUIRE(count == expected.size());
+    bool visited[MONITOR_COUNT] = {};
+    for (size_t i = 0; i < count; ++i)
+    {
+        CHECK(Equals(absolute[i].delta, expected[i].delta));
+        CHECK(absolute[i].delayDurationNS == expected[i].delayDurationNS);
+
+        for (size_t m = 0; m < MONITOR_COUNT; ++m) visited[m] |= ContainsInclusive(MONITORS[m], absolute[i].delta.x, absolute[i].delta.y);
+    }
+
+    for (bool monitorVisited : visited) CHECK(monitorVisited);
+}
+
+TEST_CASE(ToAbsolute_ZeroDeltas_AddTheirDelayToTheMovementBefore)
+{
+    const Movement deltas[] = { Movement{ PointI{ 5, 0 }, 10 }, Movement{ PointI{ 0, 0 }, 20 }, Movement{ PointI{ -500, 0 }, 30 } };
+
+    // the last one runs into the left edge it is already at
+    Movement absolute[4];
+    size_t count = 0;
+    CursorPath::ToAbsolute(Movement{ PointI{ 0, 10 }, 1 }, deltas, 1, MONITORS, MONITOR_COUNT, PointI{}, absolute, count);
+    REQUIRE(count == 2);
+
+    CursorPath::ToAbsolute(Movement{ PointI{ 0, 10 }, 1 }, deltas + 1, 2, MONITORS, MONITOR_COUNT, PointI{}, absolute, count);
+    REQUIRE(count == 1);
+    CHECK(Equals(absolute[0].delta, PointI{ 0, 10 }));
+    CHECK(absolute[0].delayDurationNS == 51);
+}
+
+TEST_CASE(ToAbsolute_Origin_IsAddedAfterClamping)
+{
+    const Movement deltas[] = { Movement{ PointI{ -50, 0 }, 10 } };
+
+    Movement absolute[2];
+    size_t count = 0;
+    CursorPath::ToAbsolute(Movement{ PointI{ 10, 10 }, 0 }, deltas, 1, MONITORS, MONITOR_COUNT, PointI{ 300, 1200 }, absolute, count);
+
+    REQUIRE(count == 2);
+    CHECK(Equals(absolute[0].delta, PointI{ 310, 1210 }));
+    CHECK(Equals(absolute[1].delta, PointI{ 300, 1210 }));
+}
+
+TEST_CASE(ToAbsolute_OffScreenStart_WritesNothing)
+{
+    const Movement deltas[] = { Movement{ PointI{ 1, 1 }, 10 } };
+
+    Movement absolute[2];
+    size_t count = 5;
+    CursorPath::Result result = CursorPath::ToAbsolute(Movement{ PointI{ -10, -10 }, 0 }, deltas, 1, MONITORS, MONITOR_COUNT, PointI{}, absolute, count);
+
+    CHECK(result == CursorPath::Result::OFF_SCREEN);
+    CHECK(count == 0);
+}
+
+TEST_CASE(ToRelative_AbsolutePath_GivesBackTheDeltasThatMoved)
+{
+    Movement start{ PointI{ 2500, 700 }, 0 };
+    std::vector<Movement> deltas = MakeDeltas(start.delta, 10000, 19);
+    PointI origin{ 300, 1200 };
+
+    std::vector<Movement> path(deltas.size() + 1);
+    size_t count = 0;
+    REQUIRE(CursorPath::ToAbsolute(start, deltas.data(), deltas.size(), MONITORS, MONITOR_COUNT, origin, path.data(), count) == CursorPath::Result::OK);
+    std::vector<Movement> absolute(path.begin(), path.begin() + count);
+
+    CursorPath::ToRelative(path.data(), count, origin);
+
+    // summing the deltas up again gives the same positions
+    CHECK(Equals(path[0].delta, start.delta));
+    PointI position{ origin.x, origin.y };
+    for (size_t i = 0; i < count; ++i)
+    {
+        position.x += path[i].delta.x;
+        position.y += path[i].delta.y;
+        CHECK(Equals(position, absolute[i].delta));
+        CHECK(i == 0 || !Equals(path[i].delta, PointI{ 0, 0 }));
+    }
+}
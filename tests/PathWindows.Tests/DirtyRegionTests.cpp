@@ -0,0 +1,174 @@
+#include "TestHarness.h"
+#include "DirtyRegion.h"
+#include <random>
+#include <vector>
+
+using namespace PathWindows;
+
+namespace
+{
+    bool Equals(RectI a, RectI b)
+    {
+        return a.left == b.left && a.top == b.top && a.right == b.right && a.bottom == b.bottom;
+    }
+
+    bool Covers(const DirtyRegion& region, int32_t x, int32_t y)
+    {
+        for (size_t i = 0; i < region.GetCount(); ++i)
+        {
+            const RectI& r = region.GetRects()[i];
+            if (x >= r.left && x < r.right && y >= r.top && y < r.bottom) return true;
+        }
+
+        return false;
+    }
+}
+
+TEST_CASE(Add_EmptyRect_IsIgnored)
+{
+    DirtyRegion region;
+    region.Add(RectI{ 5, 5, 5, 10 });
+    region.Add(RectI{ 5, 5, 10, 4 });
+
+    CHECK(region.IsEmpty());
+    CHECK(Equals(region.GetBounds(), RectI{}));
+}
+
+TEST_CASE(Add_TouchingRects_AreCoalesced)
+{
+    DirtyRegion region;
+    region.Add(RectI{ 0, 0, 10, 10 });
+    region.Add(RectI{ 10, 0, 20, 10 });
+
+    REQUIRE(region.GetCount() == 1);
+    CHECK(Equals(region.GetRects()[0], RectI{ 0, 0, 20, 10 }));
+}
+
+TEST_CASE(Add_RectThatBridgesTwo_CoalescesAllThree)
+{
+    DirtyRegion region;
+    region.Add(RectI{ 0, 0, 10, 10 });
+    region.Add(RectI{ 30, 0, 40, 10 });
+    CHECK(region.GetCount() == 2);
+
+    region.Add(RectI{ 5, 2, 35, 8 });
+
+    REQUIRE(region.GetCount() == 1);
+    CHECK(Equals(region.GetRects()[0], RectI{ 0, 0, 40, 10 }));
+}
+
+TEST_CASE(Add_ContainedRect_ChangesNothing)
+{
+    DirtyRegion region;
+    region.Add(RectI{ 0, 0, 10, 10 });
+    region.Add(RectI{ 2, 2, 8, 8 });
+
+    REQUIRE(region.GetCount() == 1);
+    CHECK(Equals(region.GetRects()[0], RectI{ 0, 0, 10, 10 }));
+}
+
+TEST_CASE(Add_MoreThanMaxRects_MergesTheCheapestPair)
+{
+    DirtyRegion region(2);
+    region.Add(RectI{ 0, 0, 10, 10 });
+    region.Add(RectI{ 12, 0, 22, 10 });
+    region.Add(RectI{ 500, 500, 510, 510 });
+
+    REQUIRE(region.GetCount() == 2);
+
+    bool mergedNear = Equals(region.GetRects()[0], RectI{ 0, 0, 22, 10 }) || Equals(region.GetRects()[1], RectI{ 0, 0, 22, 10 });
+    bool keptFar = Equals(region.GetRects()[0], RectI{ 500, 500, 510, 510 }) || Equals(region.GetRects()[1], RectI{ 500, 500, 510, 510 });
+    CHECK(mergedNear);
+    CHECK(keptFar);
+}
+
+TEST_CASE(AddSegment_FractionalEnds_CoversTheInflatedBoundingBox)
+{
+    DirtyRegion region;
+    region.AddSegment(PointF{ 10.5f, 20.25f }, PointF{ 4.0f, 30.0f }, 1.5f);
+
+    REQUIRE(region.GetCount() == 1);
+    CHECK(Equals(region.GetRects()[0], RectI{ 2, 18, 12, 32 }));
+}
+
+TEST_CASE(ClipTo_Bounds_ClipsPartialRectsAndDropsOutsideOnes)
+{
+    DirtyRegion region;
+    region.Add(RectI{ -10, -10, 10, 10 });
+    region.Add(RectI{ 200, 200, 220, 220 });
+
+    region.ClipTo(RectI{ 0, 0, 100, 100 });
+
+    REQUIRE(region.GetCount() == 1);
+    CHECK(Equals(region.GetRects()[0], RectI{ 0, 0, 10, 10 }));
+}
+
+TEST_CASE(Clear_AfterAdding_IsEmpty)
+{
+    DirtyRegion region;
+    region.Add(RectI{ 0, 0, 10, 10 });
+    region.Clear();
+
+    CHECK(region.IsEmpty());
+    CHECK(region.GetCount() == 0);
+}
+
+TEST_CASE(Add_RandomSegments_CoversEverySegmentWithinMaxDisjointRects)
+{
+    constexpr int32_t SIZE = 128;
+
+    std::mt19937 rng(2);
+    std::uniform_real_distribution<float> position(0.0f, static_cast<float>(SIZE - 8));
+    std::uniform_real_distribution<float> step(-12.0f, 12.0f);
+
+    for (size_t maxRects : { 1, 3, 8 })
+    {
+        for (int round = 0; round < 50; ++round)
+        {
+            DirtyRegion region(maxRects);
+            std::vector<bool> dirty(SIZE * SIZE, false);
+
+            PointF a{ position(rng), position(rng) };
+            for (int i = 0; i < 20; ++i)
+            {
+                PointF b{ a.x + step(rng), a.y + step(rng) };
+                if (i % 7 == 6) b = PointF{ position(rng), position(rng) };
+
+                region.AddSegment(a, b, 2.0f);
+
+                DirtyRegion single;
+                single.AddSegment(a, b, 2.0f);
+                RectI r = single.GetRects()[0];
+                for (int32_t y = std::max(r.top, 0); y < std::min(r.bottom, SIZE); ++y)
+                {
+                    for (int32_t x = std::max(r.left, 0); x < std::min(r.right, SIZE); ++x) dirty[y * SIZE + x] = true;
+                }
+
+                a = b;
+            }
+
+            CHECK(region.GetCount() <= maxRects);
+
+            bool covered = true;
+            for (int32_t y = 0; y < SIZE; ++y)
+            {
+                for (int32_t x = 0; x < SIZE; ++x)
+                {
+                    if (dirty[y * SIZE + x] && !Covers(region, x, y)) covered = false;
+                }
+            }
+            CHECK(covered);
+
+            // anything that touched would have been coalesced
+            for (size_t i = 0; i < region.GetCount(); ++i)
+            {
+                for (size_t j = i + 1; j < region.GetCount(); ++j)
+                {
+                    const RectI& p = region.GetRects()[i];
+                    const RectI& q = region.GetRects()[j];
+                    CHECK(!(p.left <= q.right && q.left <= p.right && p.top <= q.bottom && q.top <= p.bottom));
+                }
+            }
+        }
+    }
+}
@@ -0,0 +1,269 @@
+#include "TestHarness.h"
+#include "ErasablePath.h"
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <random>
+#include <vector>
+
+using namespace PathWindows;
+
+namespace
+{
+    constexpr int64_t DELAY = 8'000'000;
+
+    Movement At(int32_t x, int32_t y, int64_t delay = DELAY)
+    {
+        return Movement{ PointI{ x, y }, delay };
+    }
+
+    bool Equal(const std::vector<Movement>& a, const std::vector<Movement>& b)
+    {
+        if (a.size() != b.size()) return false;
+
+        for (size_t i = 0; i < a.size(); ++i)
+        {
+            if (a[i].delta.x != b[i].delta.x || a[i].delta.y != b[i].delta.y || a[i].delayDurationNS != b[i].delayDurationNS) return false;
+        }
+
+        return true;
+    }
+
+    std::vector<Movement> Copy(const ErasablePath& path)
+    {
+        std::vector<Movement> out;
+        path.CopyTo(out);
+        return out;
+    }
+
+    double DistanceSq(double px, double py, double ax, double ay, double bx, double by)
+    {
+        double dx = bx - ax, dy = by - ay;
+        double lengthSq = dx * dx + dy * dy;
+        double t = lengthSq > 0 ? std::clamp(((px - ax) * dx + (py - ay) * dy) / lengthSq, 0.0, 1.0) : 0.0;
+
+        double ex = ax + dx * t - px, ey = ay + dy * t - py;
+        return ex * ex + ey * ey;
+    }
+
+    // the distance from the segment a-b to the point p, the eraser in the tests being a point
+    double Distance(const Movement& a, const Movement& b, PointF p)
+    {
+        return std::sqrt(DistanceSq(p.x, p.y, a.delta.x, a.delta.y, b.delta.x, b.delta.y));
+    }
+
+    // a random walk over 640x480, with a new figure now and then
+    std::vector<Movement> MakePath(size_t count, uint32_t seed)
+    {
+        std::mt19937 random(seed);
+        std::uniform_int_distribution<int32_t> step(-12, 12);
+
+        std::vector<Movement> path;
+        int32_t x = 320, y = 240;
+        for (size_t i = 0; i < count; ++i)
+        {
+            x = std::clamp(x + step(random), 0, 639);
+            y = std::clamp(y + step(random), 0, 479);
+            path.push_back(At(x, y, i == 0 || random() % 40 == 0 ? 0 : DELAY));
+        }
+
+        return path;
+    }
+}
+
+TEST_CASE(Append_Delays_StartAndContinueFigures)
+{
+    ErasablePath path(640, 480);
+
+    CHECK(!path.Append(At(0, 0)));
+    CHECK(path.Append(At(10, 0)));
+    CHECK(!path.Append(At(20, 0, 0)));
+    CHECK(path.Append(At(30, 0)));
+
+    CHECK(path.GetSize() == 4);
+    CHECK(path.GetSegmentCount() == 2);
+    CHECK(path.IsIntactBefore(4));
+    CHECK(path.CountLeftBefore(4) == 4);
+
+    std::vector<Movement> out = Copy(path);
+    REQUIRE(out.size() == 4);
+    CHECK(out[0].delayDurationNS == 0 && out[1].delayDurationNS == DELAY && out[2].delayDurationNS == 0);
+}
+
+TEST_CASE(Erase_MiddleOfAStroke_SplitsTheFigure)
+{
+    ErasablePath path(640, 480);
+    for (int32_t i = 0; i < 5; ++i) path.Append(At(i * 100, 100, i == 0 ? 0 : DELAY));
+
+    std::vector<uint32_t> segments, points;
+    CHECK(path.Erase(PointF{ 250, 100 }, PointF{ 250, 100 }, 5, segments, points) == 1);
+    CHECK(segments == std::vector<uint32_t>{ 3 });
+    CHECK(points.empty());
+
+    std::vector<Movement> out = Copy(path);
+    REQUIRE(out.size() == 5);
+    CHECK(out[3].delayDurationNS == 0);
+    CHECK(!path.IsIntactBefore(5));
+    CHECK(path.IsIntactBefore(3));
+}
+
+TEST_CASE(Erase_LastSegmentOfAFigure_DropsTheLonePoint)
+{
+    ErasablePath path(640, 480);
+    path.Append(At(0, 0, 0));
+    path.Append(At(100, 0));
+    path.Append(At(200, 0));
+
+    std::vector<uint32_t> segments, points;
+    path.Erase(PointF{ 180, 0 }, PointF{ 180, 0 }, 5, segments, points);
+    CHECK(segments == std::vector<uint32_t>{ 2 });
+    CHECK(points == std::vector<uint32_t>{ 2 });
+
+    CHECK(path.CountLeftBefore(3) == 2);
+    CHECK(path.GetSegmentCount() == 1);
+
+    // a figure that continues from the dropped point starts a new one
+    CHECK(!path.Append(At(300, 0)));
+}
+
+TEST_CASE(Erase_LonePoint_DropsIt)
+{
+    ErasablePath path(640, 480);
+    path.Append(At(50, 50, 0));
+    path.Append(At(400, 400, 0));
+
+    std::vector<uint32_t> segments, points;
+    CHECK(path.Erase(PointF{ 40, 40 }, PointF{ 60, 60 }, 3, segments, points) == 1);
+    CHECK(segments.empty());
+    CHECK(points == std::vector<uint32_t>{ 0 });
+    CHECK(Copy(path).size() == 1);
+}
+
+TEST_CASE(Erase_Sweep_ErasesWhatTheLinePassesNear)
+{
+    ErasablePath path(640, 480);
+    path.Append(At(100, 0, 0));
+    path.Append(At(100, 400));
+
+    // the eraser moved across the segment in one step, ending far from it on both sides
+    std::vector<uint32_t> segments, points;
+    CHECK(path.Erase(PointF{ 0, 200 }, PointF{ 300, 200 }, 1, segments, points) == 1);
+    CHECK(path.GetSegmentCount() == 0);
+    CHECK(Copy(path).empty());
+}
+
+// Erases at random places of a random path, and checks that exactly the segments within the radius are gone and that
+// the figures left are split where they were cut.
+TEST_CASE(Erase_Random_MatchesBruteForce)
+{
+    std::vector<Movement> original = MakePath(3000, 1);
+    ErasablePath path(640, 480);
+    for (const Movement& movement : original) path.Append(movement);
+
+    std::vector<bool> hasSegment(original.size());
+    for (size_t i = 1; i < original.size(); ++i) hasSegment[i] = original[i].delayDurationNS != 0;
+
+    std::mt19937 random(2);
+    for (int round = 0; round < 200; ++round)
+    {
+        PointF at{ float(random() % 640), float(random() % 480) };
+        float radius = float(1 + random() % 20);
+
+        std::vector<uint32_t> segments, points;
+        path.Erase(at, at, radius, segments, points);
+
+        for (uint32_t index : segments)
+        {
+            CHECK(hasSegment[index]);
+            CHECK(Distance(original[index - 1], original[index], at) <= radius + 1e-3);
+            hasSegment[index] = false;
+        }
+
+        for (size_t i = 1; i < original.size(); ++i)
+        {
+            if (hasSegment[i]) CHECK(Distance(original[i - 1], original[i], at) > radius - 1e-3);
+        }
+    }
+
+    size_t segmentCount = static_cast<size_t>(std::count(hasSegment.begin(), hasSegment.end(), true));
+    CHECK(path.GetSegmentCount() == segmentCount);
+
+    // every movement left either ends a segment or starts a figure (a lone point, or one a segment starts at)
+    size_t continued = 0;
+    for (const Movement& movement : Copy(path)) continued += movement.delayDurationNS != 0;
+    CHECK(continued == segmentCount);
+}
+
+TEST_CASE(Restore_AfterErase_PutsBackThePath)
+{
+    std::vector<Movement> original = MakePath(2000, 3);
+    ErasablePath path(640, 480);
+    for (const Movement& movement : original) path.Append(movement);
+
+    std::vector<Movement> before = Copy(path);
+
+    std::vector<uint32_t> segments, points;
+    path.Erase(PointF{ 200, 200 }, PointF{ 400, 300 }, 15, segments, points);
+    REQUIRE(!segments.empty());
+    std::vector<Movement> after = Copy(path);
+
+    path.Restore(segments.data(), segments.size(), points.data(), points.size());
+    CHECK(Equal(Copy(path), before));
+    CHECK(path.IsIntactBefore(path.GetSize()));
+
+    path.Remove(segments.data(), segments.size(), points.data(), points.size());
+    CHECK(Equal(Copy(path), after));
+
+    // and what was put back can be erased again
+    path.Restore(segments.data(), segments.size(), points.data(), points.size());
+    std::vector<uint32_t> segmentsAgain, pointsAgain;
+    path.Erase(PointF{ 200, 200 }, PointF{ 400, 300 }, 15, segmentsAgain, pointsAgain);
+    CHECK(Equal(Copy(path), after));
+}
+
+TEST_CASE(EraseAll_ThenRestore_PutsBackThePath)
+{
+    std::vector<Movement> original = MakePath(500, 4);
+    ErasablePath path(640, 480);
+    for (const Movement& movement : original) path.Append(movement);
+    std::vector<Movement> before = Copy(path);
+
+    std::vector<uint32_t> segments, points;
+    path.EraseAll(segments, points);
+    CHECK(Copy(path).empty());
+    CHECK(path.GetSegmentCount() == 0);
+    CHECK(points.size() == original.size());
+
+    path.Restore(segments.data(), segments.size(), points.data(), points.size());
+    CHECK(Equal(Copy(path), before));
+
+    // nothing is left behind in the index once it is all gone
+    path.EraseAll(segments, points);
+    std::vector<uint32_t> segmentsAgain, pointsAgain;
+    CHECK(path.Erase(PointF{ 320, 240 }, PointF{ 320, 240 }, 1000, segmentsAgain, pointsAgain) == 0);
+}
+
+TEST_CASE(Truncate_AfterAppending_IsLikeBefore)
+{
+    ErasablePath path(640, 480);
+    path.Append(At(0, 0, 0));
+    path.Append(At(10, 10));
+    std::vector<Movement> before = Copy(path);
+
+    path.Append(At(20, 20));
+    path.Append(At(30, 30));
+    path.Truncate(2);
+    CHECK(Equal(Copy(path), before));
+    CHECK(path.GetSegmentCount() == 1);
+
+    // the point the truncated segment started at is found by itself again once its segment is gone
+    std::vector<uint32_t> segments, points;
+    path.Erase(PointF{ 5, 5 }, PointF{ 5, 5 }, 2, segments, points);
+    CHECK(segments.size() == 1 && points.size() == 2);
+
+    path.Append(At(500, 500, 0));
+    path.Truncate(3);
+    path.Truncate(0);
+    CHECK(path.GetSize() == 0);
+    CHECK(Copy(path).empty());
+}
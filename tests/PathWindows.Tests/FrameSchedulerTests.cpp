@@ -0,0 +1,147 @@
+#include "TestHarness.h"
+#include "FrameScheduler.h"
+#include <cstdint>
+#include <vector>
+
+using namespace PathWindows;
+
+namespace
+{
+    constexpr int64_t MS = 1'000'000;
+
+    // Drives a scheduler like the window thread does, with a fake clock: wakes up at every event and whenever the
+    // scheduler asks to, and renders when a frame is due. Returns when the frames were rendered.
+    std::vector<int64_t> Run(FrameScheduler& scheduler, const std::vector<int64_t>& invalidations, int64_t endNS)
+    {
+        std::vector<int64_t> frames;
+        size_t next = 0;
+        int64_t now = 0;
+
+        while (now <= endNS)
+        {
+            while (next < invalidations.size() && invalidations[next] <= now)
+            {
+                scheduler.Invalidate();
+                ++next;
+            }
+
+            if (scheduler.IsDue(now))
+            {
+                scheduler.OnFrameRendered(now);
+                frames.push_back(now);
+            }
+
+            // sleeps until the next invalidation or the deadline, whichever comes first
+            int64_t wake = next < invalidations.size() ? invalidations[next] : endNS + 1;
+            int64_t wait = scheduler.GetTimeUntilDeadline(now);
+            if (wait != FrameScheduler::NO_DEADLINE && now + wait < wake) wake = now + wait;
+
+            now = wake > now ? wake : now + 1;
+        }
+
+        return frames;
+    }
+}
+
+TEST_CASE(GetDeadline_NothingInvalidated_HasNoDeadline)
+{
+    FrameScheduler scheduler(60);
+
+    CHECK(scheduler.GetDeadline() == FrameScheduler::NO_DEADLINE);
+    CHECK(scheduler.GetTimeUntilDeadline(123) == FrameScheduler::NO_DEADLINE);
+    CHECK(!scheduler.IsDue(0));
+    CHECK(!scheduler.IsDue(1'000'000 * MS));
+}
+
+TEST_CASE(IsDue_FirstInvalidation_IsDueAtOnce)
+{
+    FrameScheduler scheduler(60);
+    scheduler.Invalidate();
+
+    CHECK(scheduler.IsInvalidated());
+    CHECK(scheduler.IsDue(0));
+    CHECK(scheduler.GetTimeUntilDeadline(0) == 0);
+}
+
+TEST_CASE(GetTimeUntilDeadline_InvalidatedRightAfterAFrame_WaitsForTheRestOfTheInterval)
+{
+    FrameScheduler scheduler(100);
+    CHECK(scheduler.GetFrameInterval() == 10 * MS);
+
+    scheduler.Invalidate();
+    scheduler.OnFrameRendered(0);
+    CHECK(!scheduler.IsInvalidated());
+
+    scheduler.Invalidate();
+    scheduler.Invalidate();
+
+    CHECK(!scheduler.IsDue(5 * MS));
+    CHECK(scheduler.GetTimeUntilDeadline(5 * MS) == 5 * MS);
+    CHECK(scheduler.IsDue(10 * MS));
+    CHECK(scheduler.GetTimeUntilDeadline(12 * MS) == 0);
+}
+
+TEST_CASE(OnFrameRendered_LateFrame_CountsTheIntervalFromWhenItRendered)
+{
+    FrameScheduler scheduler(100);
+    scheduler.Invalidate();
+    scheduler.OnFrameRendered(0);
+
+    scheduler.Invalidate();
+    scheduler.OnFrameRendered(37 * MS);
+
+    scheduler.Invalidate();
+    CHECK(scheduler.GetDeadline() == 47 * MS);
+}
+
+TEST_CASE(SetMaxFps_ZeroOrLess_RendersEveryInvalidationAtOnce)
+{
+    FrameScheduler scheduler(0);
+    CHECK(scheduler.GetFrameInterval() == 0);
+
+    scheduler.Invalidate();
+    scheduler.OnFrameRendered(5 * MS);
+    scheduler.Invalidate();
+    CHECK(scheduler.IsDue(5 * MS));
+
+    scheduler.SetMaxFps(-1);
+    CHECK(scheduler.GetFrameInterval() == 0);
+}
+
+TEST_CASE(Run_InvalidatedEveryMillisecond_RendersAtMostMaxFpsFramesAnInterval)
+{
+    FrameScheduler scheduler(100);
+
+    std::vector<int64_t> invalidations;
+    for (int64_t t = 0; t < 1000 * MS; t += MS) invalidations.push_back(t);
+
+    std::vector<int64_t> frames = Run(scheduler, invalidations, 1000 * MS);
+
+    // the first frame is at once, then one every 10 ms, the last invalidation is rendered at 1000 ms
+    REQUIRE(frames.size() == 101);
+    CHECK(frames.front() == 0);
+    CHECK(frames.back() == 1000 * MS);
+
+    bool spaced = true;
+    for (size_t i = 1; i < frames.size(); ++i)
+    {
+        if (frames[i] - frames[i - 1] != 10 * MS) spaced = false;
+    }
+    CHECK(spaced);
+}
+
+TEST_CASE(Run_BurstThenIdle_RendersTheBurstOnceAndThenNothing)
+{
+    FrameScheduler scheduler(60);
+
+    std::vector<int64_t> invalidations;
+    for (int i = 0; i < 50; ++i) invalidations.push_back(100 * MS + i * 10'000);
+
+    std::vector<int64_t> frames = Run(scheduler, invalidations, 5000 * MS);
+
+    // the first invalidation renders at once, the rest of the burst in one frame an interval later
+    REQUIRE(frames.size() == 2);
+    CHECK(frames[0] == 100 * MS);
+    CHECK(frames[1] == 100 * MS + scheduler.GetFrameInterval());
+    CHECK(!scheduler.IsInvalidated());
+}
@@ -0,0 +1,109 @@
+#pragma once
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <string>
+#include <vector>
+
+// Premultiplied BGRA bitmaps compared against golden images in Golden/, for the suites that draw on the CPU.
+// The suite's target defines PATHWINDOWS_GOLDEN_DIR (see CMakeLists.txt).
+// Run with PATHWINDOWS_UPDATE_GOLDEN=1 to write the images instead of comparing against them.
+
+namespace PathWindows::Tests
+{
+    // rounding may differ by one between compilers and SIMD paths
+    constexpr int GOLDEN_TOLERANCE = 1;
+
+    struct Bitmap
+    {
+        int32_t width;
+        int32_t height;
+        std::vector<uint32_t> pixels;
+
+        Bitmap(int32_t width, int32_t height) : width(width), height(height), pixels(static_cast<size_t>(width) * height, 0xDEADBEEF) {}
+
+        uint8_t* GetBytes() { return reinterpret_cast<uint8_t*>(pixels.data()); }
+
+        uint32_t At(int32_t x, int32_t y) const { return pixels[static_cast<size_t>(y) * width + x]; }
+    };
+
+    inline uint32_t Channel(uint32_t pixel, int shift)
+    {
+        return (pixel >> shift) & 0xFF;
+    }
+
+    inline std::string GetGoldenPath(const char* name)
+    {
+        return std::string(PATHWINDOWS_GOLDEN_DIR) + "/" + name + ".pam";
+    }
+
+    // PAM with premultiplied RGBA tuples, which most image viewers open
+    inline bool WritePam(const std::string& path, const Bitmap& bitmap)
+    {
+        FILE* pFile = std::fopen(path.c_str(), "wb");
+        if (!pFile) return false;
+
+        std::fprintf(pFile, "P7\nWIDTH %d\nHEIGHT %d\nDEPTH 4\nMAXVAL 255\nTUPLTYPE RGB_ALPHA\nENDHDR\n", bitmap.width, bitmap.height);
+        for (uint32_t pixel : bitmap.pixels)
+        {
+            uint8_t tuple[4] = { static_cast<uint8_t>(Channel(pixel, 16)), static_cast<uint8_t>(Channel(pixel, 8)), static_cast<uint8_t>(Channel(pixel, 0)), static_cast<uint8_t>(Channel(pixel, 24)) };
+            std::fwrite(tuple, 1, 4, pFile);
+        }
+
+        return std::fclose(pFile) == 0;
+    }
+
+    inline bool ReadPam(const std::string& path, Bitmap& bitmap)
+    {
+        FILE* pFile = std::fopen(path.c_str(), "rb");
+        if (!pFile) return false;
+
+        int width = 0;
+        int height = 0;
+        bool read = std::fscanf(pFile, "P7\nWIDTH %d\nHEIGHT %d\nDEPTH 4\nMAXVAL 255\nTUPLTYPE RGB_ALPHA\nENDHDR", &width, &height) == 2
+            && std::fgetc(pFile) == '\n'
+            && width == bitmap.width && height == bitmap.height;
+
+        for (size_t i = 0; read && i < bitmap.pixels.size(); ++i)
+        {
+            uint8_t tuple[4];
+            read = std::fread(tuple, 1, 4, pFile) == 4;
+            bitmap.pixels[i] = tuple[2] | (tuple[1] << 8) | (tuple[0] << 16) | (static_cast<uint32_t>(tuple[3]) << 24);
+        }
+
+        std::fclose(pFile);
+        return read;
+    }
+
+    // Compares bitmap against the golden image of the name, or writes it if asked to.
+    inline bool MatchesGolden(const char* name, const Bitmap& bitmap)
+    {
+        std::string path = GetGoldenPath(name);
+
+        const char* pUpdate = std::getenv("PATHWINDOWS_UPDATE_GOLDEN");
+        if (pUpdate && std::strcmp(pUpdate, "1") == 0) return WritePam(path, bitmap);
+
+        Bitmap golden(bitmap.width, bitmap.height);
+        if (!ReadPam(path, golden))
+        {
+            std::printf("could not read %s\n", path.c_str());
+            return false;
+        }
+
+        size_t mismatches = 0;
+        for (size_t i = 0; i < bitmap.pixels.size(); ++i)
+        {
+            for (int shift = 0; shift < 32; shift += 8)
+            {
+                if (std::abs(static_cast<int>(Channel(bitmap.pixels[i], shift)) - static_cast<int>(Channel(golden.pixels[i], shift))) > GOLDEN_TOLERANCE)
+                {
+                    if (mismatches++ == 0) std::printf("%s: first mismatch at (%d, %d)\n", name, static_cast<int>(i % bitmap.width), static_cast<int>(i / bitmap.width));
+                    break;
+                }
+            }
+        }
+
+        return mismatches == 0;
+    }
+}
@@ -0,0 +1,235 @@
+#include "TestHarness.h"
+#include "HeatmapGrid.h"
+#include <cmath>
+#include <cstdint>
+#include <random>
+#include <vector>
+
+using namespace PathWindows;
+
+namespace
+{
+    constexpr ColorF BACKGROUND = { 0.0f, 0.0f, 0.0f, 0.0f };
+
+    uint32_t GetTotal(const HeatmapGrid& grid, int32_t columns, int32_t rows)
+    {
+        uint32_t total = 0;
+        for (int32_t row = 0; row < rows; ++row)
+        {
+            for (int32_t column = 0; column < columns; ++column) total += grid.GetCount(column, row);
+        }
+
+        return total;
+    }
+
+    std::vector<RectI> GetChangedBlocks(const HeatmapGrid& grid)
+    {
+        std::vector<RectI> rects;
+        grid.ForEachChangedBlock([&rects](RectI rect) { rects.push_back(rect); });
+        return rects;
+    }
+}
+
+TEST_CASE(Append_Point_CountsItsCell)
+{
+    HeatmapGrid grid(640, 480, 4, BACKGROUND);
+    grid.Append(PointF{ 10, 21 }, true);
+
+    CHECK(grid.GetCount(2, 5) == 1);
+    CHECK(grid.GetMaxCount() == 1);
+    CHECK(GetTotal(grid, 160, 120) == 1);
+}
+
+TEST_CASE(Append_PointOffTheSurface_CountsNothing)
+{
+    HeatmapGrid grid(640, 480, 4, BACKGROUND);
+    grid.Append(PointF{ -1, 10 }, true);
+    grid.Append(PointF{ 640, 10 }, true);
+    grid.Append(PointF{ 1e30f, 1e30f }, true);
+
+    CHECK(GetTotal(grid, 160, 120) == 0);
+    CHECK(GetChangedBlocks(grid).empty());
+}
+
+TEST_CASE(Append_Segment_CountsEveryCellOnce)
+{
+    HeatmapGrid grid(640, 480, 4, BACKGROUND);
+    grid.Append(PointF{ 2, 2 }, true);
+    grid.Append(PointF{ 41, 2 }, false);
+
+    // the cell of the first point is not counted again by the segment
+    for (int32_t column = 0; column <= 10; ++column) CHECK(grid.GetCount(column, 0) == 1);
+    CHECK(GetTotal(grid, 160, 120) == 11);
+}
+
+// A random segment walks from the cell of its start to the cell of its end in steps to neighbouring cells, and passes
+// through every cell it is counted in.
+TEST_CASE(Append_RandomSegments_WalkTheCellsTheyPassThrough)
+{
+    std::mt19937 random(1);
+    std::uniform_real_distribution<float> coordinate(0.0f, 479.9f);
+
+    for (int round = 0; round < 500; ++round)
+    {
+        HeatmapGrid grid(480, 480, 8, BACKGROUND);
+        PointF a{ coordinate(random), coordinate(random) };
+        PointF b{ coordinate(random), coordinate(random) };
+        grid.Append(a, true);
+        grid.Append(b, false);
+
+        int32_t firstColumn = static_cast<int32_t>(a.x / 8), firstRow = static_cast<int32_t>(a.y / 8);
+        int32_t lastColumn = static_cast<int32_t>(b.x / 8), lastRow = static_cast<int32_t>(b.y / 8);
+
+        CHECK(grid.GetCount(firstColumn, firstRow) == 1);
+        CHECK(grid.GetCount(lastColumn, lastRow) == 1);
+        CHECK(GetTotal(grid, 60, 60) == static_cast<uint32_t>(std::abs(lastColumn - firstColumn) + std::abs(lastRow - firstRow) + 1));
+
+        // points along the segment away from the cell borders are in counted cells
+        for (int i = 0; i <= 200; ++i)
+        {
+            float t = i / 200.0f;
+            float x = (a.x + (b.x - a.x) * t) / 8;
+            float y = (a.y + (b.y - a.y) * t) / 8;
+
+            float fx = x - std::floor(x), fy = y - std::floor(y);
+            if (fx < 0.01f || fx > 0.99f || fy < 0.01f || fy > 0.99f) continue;
+
+            CHECK(grid.GetCount(static_cast<int32_t>(x), static_cast<int32_t>(y)) == 1);
+        }
+    }
+}
+
+TEST_CASE(Append_SegmentLeavingTheSurface_CountsOnlyTheCellsOnIt)
+{
+    HeatmapGrid grid(64, 64, 8, BACKGROUND);
+    grid.Append(PointF{ -100, 4 }, true);
+    grid.Append(PointF{ 100, 4 }, false);
+
+    for (int32_t column = 0; column < 8; ++column) CHECK(grid.GetCount(column, 0) == 1);
+    CHECK(GetTotal(grid, 8, 8) == 8);
+
+    // and one that only passes by counts nothing
+    grid.Append(PointF{ -10, -10 }, true);
+    grid.Append(PointF{ 100, -5 }, false);
+    CHECK(GetTotal(grid, 8, 8) == 8);
+}
+
+TEST_CASE(Append_SameCellOften_SaturatesTheCount)
+{
+    HeatmapGrid grid(64, 64, 8, BACKGROUND);
+    for (int i = 0; i < 70'000; ++i) grid.Append(PointF{ 1, 1 }, true);
+
+    CHECK(grid.GetCount(0, 0) == UINT16_MAX);
+    CHECK(grid.GetMaxCount() == UINT16_MAX);
+}
+
+TEST_CASE(Commit_MaxCountDoubles_NeedsAFullRedraw)
+{
+    HeatmapGrid grid(640, 480, 4, BACKGROUND);
+    CHECK(grid.NeedsFullRedraw());
+
+    grid.Append(PointF{ 1, 1 }, true);
+    grid.Commit();
+    CHECK(!grid.NeedsFullRedraw());
+    CHECK(!grid.HasChanges());
+
+    // 2 and 4 change the bit length of the highest count, 3 does not
+    grid.Append(PointF{ 1, 1 }, true);
+    CHECK(grid.NeedsFullRedraw());
+    grid.Commit();
+
+    grid.Append(PointF{ 1, 1 }, true);
+    CHECK(!grid.NeedsFullRedraw());
+    CHECK(grid.HasChanges());
+    grid.Commit();
+
+    grid.Append(PointF{ 1, 1 }, true);
+    CHECK(grid.NeedsFullRedraw());
+}
+
+TEST_CASE(ForEachChangedBlock_AfterCommit_IsOnlyWhatChanged)
+{
+    HeatmapGrid grid(1000, 480, 4, BACKGROUND);
+    int32_t blockSize = grid.GetBlockSize();
+    CHECK(blockSize == 64);
+
+    grid.Append(PointF{ 10, 10 }, true);
+    grid.Append(PointF{ 990, 470 }, true);
+    grid.Commit();
+
+    // two counts in the middle of a block, which do not change the scale
+    grid.Append(PointF{ 130, 70 }, true);
+    grid.Append(PointF{ 131, 71 }, false);
+
+    std::vector<RectI> rects = GetChangedBlocks(grid);
+    REQUIRE(rects.size() == 1);
+    CHECK(rects[0].left == 128 && rects[0].top == 64 && rects[0].right == 192 && rects[0].bottom == 128);
+
+    // everything that was ever passed through, the last block clipped to the surface
+    grid.Invalidate();
+    rects = GetChangedBlocks(grid);
+    CHECK(rects.size() == 3);
+    CHECK(rects.back().right == 1000 && rects.back().bottom == 480);
+}
+
+TEST_CASE(Colorize_Cells_AreSquaresOfOneColor)
+{
+    HeatmapGrid grid(64, 64, 4, ColorF{ 0.0f, 0.0f, 1.0f, 0.5f });
+    grid.Append(PointF{ 5, 5 }, true);
+    for (int i = 0; i < 9; ++i) grid.Append(PointF{ 9, 5 }, true);
+
+    std::vector<uint32_t> pixels(64 * 64, 0xDEADBEEF);
+    grid.Colorize(RectI{ 0, 0, 64, 64 }, pixels.data(), 64);
+
+    for (int32_t y = 0; y < 64; ++y)
+    {
+        for (int32_t x = 0; x < 64; ++x) CHECK(pixels[y * 64 + x] == pixels[(y / 4 * 4) * 64 + x / 4 * 4]);
+    }
+
+    // the background premultiplied, and the heat over it growing more opaque with the count
+    uint32_t background = pixels[0];
+    CHECK(background == (0x80u << 24 | 0x80u));
+
+    uint32_t cold = pixels[4 * 64 + 4];
+    uint32_t hot = pixels[4 * 64 + 8];
+    CHECK(cold != background && hot != background && hot != cold);
+    CHECK((hot >> 24) > (cold >> 24));
+}
+
+TEST_CASE(Colorize_PartOfTheSurface_MatchesTheWholeOne)
+{
+    HeatmapGrid grid(100, 70, 3, BACKGROUND);
+    std::mt19937 random(2);
+    for (int i = 0; i < 300; ++i) grid.Append(PointF{ float(random() % 100), float(random() % 70) }, i % 20 == 0);
+
+    std::vector<uint32_t> whole(100 * 70);
+    grid.Colorize(RectI{ 0, 0, 100, 70 }, whole.data(), 100);
+
+    // a rect that does not start at a cell border, written with a stride wider than it
+    RectI rect{ 17, 5, 62, 69 };
+    std::vector<uint32_t> part(64 * 64);
+    grid.Colorize(rect, part.data(), 64);
+
+    for (int32_t y = rect.top; y < rect.bottom; ++y)
+    {
+        for (int32_t x = rect.left; x < rect.right; ++x) CHECK(part[(y - rect.top) * 64 + x - rect.left] == whole[y * 100 + x]);
+    }
+}
+
+TEST_CASE(Clear_Counted_StartsOver)
+{
+    HeatmapGrid grid(640, 480, 4, BACKGROUND);
+    grid.Append(PointF{ 1, 1 }, true);
+    grid.Append(PointF{ 300, 300 }, false);
+    grid.Commit();
+
+    grid.Clear();
+    CHECK(GetTotal(grid, 160, 120) == 0);
+    CHECK(grid.GetMaxCount() == 0);
+    CHECK(grid.NeedsFullRedraw());
+    CHECK(GetChangedBlocks(grid).empty());
+
+    // the next point starts a figure of its own
+    grid.Append(PointF{ 300, 1 }, false);
+    CHECK(GetTotal(grid, 160, 120) == 1);
+}
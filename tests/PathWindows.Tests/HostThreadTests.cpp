@@ -0,0 +1,218 @@
+#include "TestHarness.h"
+#include "HostThread.h"
+#include "OverlayLifetime.h"
+#include <condition_variable>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+using namespace PathWindows;
+
+namespace
+{
+    // A message loop without windows: Wake is a posted message, Quit is PostQuitMessage.
+    class FakePlatform
+    {
+    public:
+        bool enterSucceeds = true;
+        int enters = 0;
+        int leaves = 0;
+        std::thread::id threadId;
+
+        bool Enter(WorkDispatcher& dispatcher)
+        {
+            m_pDispatcher = &dispatcher;
+            threadId = std::this_thread::get_id();
+            ++enters;
+
+            // not in Run, the first work it runs may already quit
+            std::lock_guard<std::mutex> lock(m_mutex);
+            m_quit = false;
+
+            return enterSucceeds;
+        }
+
+        void Run()
+        {
+            m_pDispatcher->RunPending();
+
+            std::unique_lock<std::mutex> lock(m_mutex);
+            while (!m_quit)
+            {
+                m_woken.wait(lock, [this] { return m_wake; });
+                m_wake = false;
+
+                lock.unlock();
+                m_pDispatcher->RunPending();
+                lock.lock();
+            }
+        }
+
+        void Wake()
+        {
+            std::lock_guard<std::mutex> lock(m_mutex);
+            m_wake = true;
+            m_woken.notify_one();
+        }
+
+        // only called from work on the thread, so the lock is not held
+        void Quit()
+        {
+            std::lock_guard<std::mutex> lock(m_mutex);
+            m_quit = true;
+        }
+
+        void Leave()
+        {
+            ++leaves;
+        }
+
+    private:
+        WorkDispatcher* m_pDispatcher = nullptr;
+
+        std::mutex m_mutex;
+        std::condition_variable m_woken;
+        bool m_wake = false;
+        bool m_quit = false;
+    };
+
+    // An overlay window as far as its lifetime goes, created and destroyed on the host thread.
+    struct FakeWindow
+    {
+        OverlayLifetime lifetime;
+        bool created = false;
+
+        explicit FakeWindow(int64_t requestedNS) : lifetime(requestedNS) {}
+    };
+}
+
+TEST_CASE(Start_EnterSucceeds_RunsWorkOnTheThread)
+{
+    FakePlatform platform;
+    HostThread<FakePlatform> host(platform);
+
+    REQUIRE(host.Start());
+    CHECK(host.IsRunning());
+    CHECK(!host.IsHostThread());
+
+    std::thread::id ranOn = host.Invoke([] { return std::this_thread::get_id(); });
+    CHECK(ranOn == platform.threadId);
+    CHECK(ranOn != std::this_thread::get_id());
+
+    host.Stop();
+    CHECK(!host.IsRunning());
+    CHECK(platform.enters == 1 && platform.leaves == 1);
+}
+
+TEST_CASE(Start_EnterFails_ReturnsFalseAndDoesNotRun)
+{
+    FakePlatform platform;
+    platform.enterSucceeds = false;
+    HostThread<FakePlatform> host(platform);
+
+    CHECK(!host.Start());
+    CHECK(!host.IsRunning());
+    CHECK(platform.leaves == 0);
+
+    // it can be tried again
+    platform.enterSucceeds = true;
+    CHECK(host.Start());
+}
+
+TEST_CASE(Start_Twice_KeepsTheOneThread)
+{
+    FakePlatform platform;
+    HostThread<FakePlatform> host(platform);
+
+    host.Start();
+    host.Start();
+
+    CHECK(platform.enters == 1);
+}
+
+TEST_CASE(Stop_PendingWork_RunsItFirst)
+{
+    FakePlatform platform;
+    HostThread<FakePlatform> host(platform);
+    host.Start();
+
+    int ran = 0;
+    for (int i = 0; i < 100; ++i) host.Post([&ran] { ++ran; });
+    host.Stop();
+
+    CHECK(ran == 100);
+}
+
+TEST_CASE(Invoke_OnTheHostThread_RunsRightAway)
+{
+    FakePlatform platform;
+    HostThread<FakePlatform> host(platform);
+    host.Start();
+
+    int result = host.Invoke([&host] { return host.IsHostThread() ? host.Invoke([] { return 3; }) : 0; });
+
+    CHECK(result == 3);
+}
+
+TEST_CASE(StartAfterStop_SameHost_StartsAFreshThread)
+{
+    FakePlatform platform;
+    HostThread<FakePlatform> host(platform);
+
+    for (int i = 0; i < 3; ++i)
+    {
+        REQUIRE(host.Start());
+        CHECK(host.Invoke([] { return 1; }) == 1);
+        host.Stop();
+    }
+
+    CHECK(platform.enters == 3 && platform.leaves == 3);
+}
+
+TEST_CASE(SeveralWindows_OneHost_OpenAndCloseOnItsThread)
+{
+    FakePlatform platform;
+    HostThread<FakePlatform> host(platform);
+    host.Start();
+
+    // what CreatePathWindow and Close post, with the request times standing in for the clock
+    std::vector<std::unique_ptr<FakeWindow>> windows;
+    for (int i = 0; i < 3; ++i)
+    {
+        windows.push_back(std::make_unique<FakeWindow>(i * 100));
+        FakeWindow* pWindow = windows.back().get();
+
+        host.Post([pWindow, &host, i]
+        {
+            pWindow->created = host.IsHostThread();
+            pWindow->lifetime.OnCreated(true, i * 100 + 10 + i);
+        });
+    }
+
+    for (auto& window : windows) CHECK(window->lifetime.WaitWhileCreating() == OverlayState::OPEN);
+    for (int i = 0; i < 3; ++i) CHECK(windows[i]->lifetime.GetOpenLatency() == 10 + i);
+
+    for (auto& window : windows)
+    {
+        FakeWindow* pWindow = window.get();
+        CHECK(pWindow->lifetime.BeginClose([pWindow, &host]
+        {
+            host.Post([pWindow]
+            {
+                pWindow->lifetime.OnDestroying();
+                pWindow->lifetime.OnClosed();
+            });
+        }));
+    }
+
+    for (auto& window : windows)
+    {
+        window->lifetime.WaitUntilClosed();
+        CHECK(window->created);
+    }
+
+    // the thread outlives them, for the next window
+    CHECK(host.IsRunning());
+    CHECK(platform.enters == 1);
+}
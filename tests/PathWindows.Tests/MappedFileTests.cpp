@@ -0,0 +1,213 @@
+#include "TestHarness.h"
+#include "MappedFile.h"
+#include "PathCodec.h"
+#include <cstdint>
+#include <filesystem>
+#include <fstream>
+#include <vector>
+
+using namespace PathWindows;
+
+namespace
+{
+    // A file in the temporary directory that is deleted again at the end of the test case.
+    class TempFile
+    {
+    public:
+        TempFile(const char* name, const std::vector<uint8_t>& content) :
+            m_path(std::filesystem::temp_directory_path() / name)
+        {
+            std::ofstream stream(m_path, std::ios::binary | std::ios::trunc);
+            stream.write(reinterpret_cast<const char*>(content.data()), static_cast<std::streamsize>(content.size()));
+        }
+
+        ~TempFile()
+        {
+            std::error_code error;
+            std::filesystem::remove(m_path, error);
+        }
+
+        const FileNameChar* GetName() const
+        {
+            return m_path.c_str();
+        }
+
+    private:
+        std::filesystem::path m_path;
+    };
+
+    std::vector<uint8_t> EncodePath(size_t movementCount)
+    {
+        std::vector<Movement> path(movementCount);
+        for (size_t i = 0; i < movementCount; ++i) path[i] = Movement{ PointI{ static_cast<int32_t>(i % 9) - 4, static_cast<int32_t>(i * 7 % 11) - 5 }, static_cast<int64_t>(i % 8) * 1'000'000 };
+
+        PathEncoder encoder(false);
+        encoder.Append(path.data(), path.size());
+        encoder.Flush();
+
+        std::vector<uint8_t> bytes(encoder.GetOutputSize());
+        encoder.ReadOutput(bytes.data(), bytes.size());
+        return bytes;
+    }
+
+    std::vector<uint8_t> MakeContent(size_t size)
+    {
+        std::vector<uint8_t> content(size);
+        for (size_t i = 0; i < size; ++i) content[i] = static_cast<uint8_t>(i * 31 + (i >> 12));
+        return content;
+    }
+
+    // Reads the file through views of viewSize, and checks that none is larger than asked for (rounded up).
+    std::vector<uint8_t> ReadViews(MappedFile& file, size_t viewSize, size_t& viewCount)
+    {
+        size_t granularity = MappedFile::GetGranularity();
+        size_t limit = viewSize == 0 ? granularity : (viewSize + granularity - 1) / granularity * granularity;
+
+        std::vector<uint8_t> read;
+        viewCount = 0;
+        CHECK(file.ForEachView(viewSize, [&](const uint8_t* data, size_t size)
+        {
+            CHECK(size > 0 && size <= limit);
+            read.insert(read.end(), data, data + size);
+            ++viewCount;
+            return true;
+        }));
+
+        return read;
+    }
+}
+
+TEST_CASE(GetGranularity_Always_IsAPowerOfTwo)
+{
+    size_t granularity = MappedFile::GetGranularity();
+    CHECK(granularity >= 4096);
+    CHECK((granularity & (granularity - 1)) == 0);
+}
+
+TEST_CASE(ForEachView_AnyViewSize_ReadsTheWholeFileInOrder)
+{
+    size_t granularity = MappedFile::GetGranularity();
+    std::vector<uint8_t> content = MakeContent(granularity * 5 + 123);
+    TempFile temp("PathWindowsMappedFileTests.bin", content);
+
+    MappedFile file;
+    REQUIRE(file.Open(temp.GetName()));
+    CHECK(file.GetSize() == content.size());
+
+    for (size_t viewSize : { size_t(0), size_t(1), granularity, granularity + 1, granularity * 2, content.size() * 2 })
+    {
+        size_t viewCount;
+        CHECK(ReadViews(file, viewSize, viewCount) == content);
+
+        size_t rounded = viewSize == 0 ? granularity : (viewSize + granularity - 1) / granularity * granularity;
+        CHECK(viewCount == (content.size() + rounded - 1) / rounded);
+    }
+}
+
+TEST_CASE(ForEachView_FnReturnsFalse_Stops)
+{
+    size_t granularity = MappedFile::GetGranularity();
+    TempFile temp("PathWindowsMappedFileTests.bin", MakeContent(granularity * 4));
+
+    MappedFile file;
+    REQUIRE(file.Open(temp.GetName()));
+
+    int calls = 0;
+    CHECK(file.ForEachView(granularity, [&calls](const uint8_t*, size_t)
+    {
+        return ++calls < 2;
+    }));
+    CHECK(calls == 2);
+}
+
+TEST_CASE(Open_EmptyFile_HasNoViews)
+{
+    TempFile temp("PathWindowsMappedFileTests.bin", {});
+
+    MappedFile file;
+    REQUIRE(file.Open(temp.GetName()));
+    CHECK(file.GetSize() == 0);
+
+    bool called = false;
+    CHECK(file.ForEachView(4096, [&called](const uint8_t*, size_t)
+    {
+        called = true;
+        return true;
+    }));
+    CHECK(!called);
+}
+
+TEST_CASE(Open_MissingFile_FailsWithTheError)
+{
+    std::filesystem::path path = std::filesystem::temp_directory_path() / "PathWindowsMappedFileTests.missing";
+
+    MappedFile file;
+    CHECK(!file.Open(path.c_str()));
+    // ENOENT and ERROR_FILE_NOT_FOUND
+    CHECK(file.GetError() == 2);
+    CHECK(file.GetSize() == 0);
+}
+
+TEST_CASE(Open_Again_ReplacesTheFirstFile)
+{
+    std::vector<uint8_t> first = MakeContent(10'000);
+    std::vector<uint8_t> second = MakeContent(300);
+    TempFile firstTemp("PathWindowsMappedFileTests.first", first);
+    TempFile secondTemp("PathWindowsMappedFileTests.second", second);
+
+    MappedFile file;
+    REQUIRE(file.Open(firstTemp.GetName()));
+    REQUIRE(file.Open(secondTemp.GetName()));
+    CHECK(file.GetSize() == second.size());
+
+    size_t viewCount;
+    CHECK(ReadViews(file, 1 << 20, viewCount) == second);
+
+    file.Close();
+    CHECK(file.GetSize() == 0);
+}
+
+TEST_CASE(FeedFile_SmallViews_DecodesTheWholePath)
+{
+    size_t granularity = MappedFile::GetGranularity();
+    std::vector<uint8_t> bytes = EncodePath(20'000);
+    REQUIRE(bytes.size() > granularity * 5);
+    TempFile temp("PathWindowsMappedFileTests.path", bytes);
+
+    MappedFile file;
+    REQUIRE(file.Open(temp.GetName()));
+
+    PathDecoder decoder;
+    size_t decoded = 0;
+    int64_t lastDelay = -1;
+    PathCodec::Result result;
+    CHECK(decoder.FeedFile(file, granularity, [&decoded, &lastDelay](const Movement* movements, size_t count)
+    {
+        decoded += count;
+        lastDelay = movements[count - 1].delayDurationNS;
+    }, []() { return true; }, result));
+
+    CHECK(result == PathCodec::Result::OK);
+    CHECK(decoded == 20'000);
+    CHECK(lastDelay == 7'000'000);
+}
+
+TEST_CASE(FeedFile_KeepGoingReturnsFalse_StopsAfterThatView)
+{
+    size_t granularity = MappedFile::GetGranularity();
+    TempFile temp("PathWindowsMappedFileTests.path", EncodePath(20'000));
+
+    MappedFile file;
+    REQUIRE(file.Open(temp.GetName()));
+
+    PathDecoder decoder;
+    size_t decoded = 0;
+    int views = 0;
+    PathCodec::Result result;
+    CHECK(decoder.FeedFile(file, granularity, [&decoded](const Movement*, size_t count) { decoded += count; }, [&views]() { return ++views < 5; }, result));
+
+    // not finished, so not TRUNCATED either
+    CHECK(result == PathCodec::Result::OK);
+    CHECK(views == 5);
+    CHECK(decoded > 0 && decoded < 20'000);
+}
@@ -0,0 +1,112 @@
+#include "TestHarness.h"
+#include "OverlayLifetime.h"
+#include <thread>
+
+using namespace PathWindows;
+
+TEST_CASE(OnCreated_Succeeded_OpensAndMeasuresTheLatency)
+{
+    OverlayLifetime lifetime(1000);
+    CHECK(lifetime.GetState() == OverlayState::CREATING);
+    CHECK(lifetime.GetOpenLatency() == -1);
+
+    CHECK(lifetime.OnCreated(true, 1750));
+
+    CHECK(lifetime.GetState() == OverlayState::OPEN);
+    CHECK(lifetime.GetOpenLatency() == 750);
+}
+
+TEST_CASE(OnCreated_Failed_ClosesWithoutALatency)
+{
+    OverlayLifetime lifetime(1000);
+    CHECK(lifetime.OnCreated(false, 1750));
+
+    CHECK(lifetime.GetState() == OverlayState::CLOSED);
+    CHECK(lifetime.GetOpenLatency() == -1);
+}
+
+TEST_CASE(OnCreated_Twice_OnlyTheFirstCounts)
+{
+    OverlayLifetime lifetime(0);
+    lifetime.OnCreated(true, 10);
+
+    CHECK(!lifetime.OnCreated(true, 20));
+    CHECK(lifetime.GetOpenLatency() == 10);
+}
+
+TEST_CASE(BeginClose_Open_ClosesOnceUnderTheLock)
+{
+    OverlayLifetime lifetime(0);
+    lifetime.OnCreated(true, 10);
+
+    int closes = 0;
+    CHECK(lifetime.BeginClose([&closes] { ++closes; }));
+    CHECK(lifetime.GetState() == OverlayState::CLOSING);
+
+    CHECK(!lifetime.BeginClose([&closes] { ++closes; }));
+    CHECK(closes == 1);
+
+    lifetime.OnDestroying();
+    lifetime.OnClosed();
+    CHECK(lifetime.GetState() == OverlayState::CLOSED);
+}
+
+TEST_CASE(BeginClose_NotOpen_DoesNothing)
+{
+    OverlayLifetime creating(0);
+    bool closed = false;
+    CHECK(!creating.BeginClose([&closed] { closed = true; }));
+
+    OverlayLifetime failed(0);
+    failed.OnCreated(false, 0);
+    CHECK(!failed.BeginClose([&closed] { closed = true; }));
+
+    CHECK(!closed);
+}
+
+TEST_CASE(OnDestroying_ClosedOnItsOwn_BeginCloseNoLongerCloses)
+{
+    OverlayLifetime lifetime(0);
+    lifetime.OnCreated(true, 10);
+
+    lifetime.OnDestroying();
+
+    bool closed = false;
+    CHECK(!lifetime.BeginClose([&closed] { closed = true; }));
+    CHECK(!closed);
+}
+
+TEST_CASE(WaitWhileCreating_CreatedOnAnotherThread_ReturnsTheNewState)
+{
+    OverlayLifetime lifetime(0);
+
+    std::thread window([&lifetime]
+    {
+        std::this_thread::sleep_for(std::chrono::milliseconds(5));
+        lifetime.OnCreated(true, 5);
+    });
+
+    CHECK(lifetime.WaitWhileCreating() == OverlayState::OPEN);
+    window.join();
+}
+
+TEST_CASE(WaitUntilClosed_ClosedOnAnotherThread_Returns)
+{
+    OverlayLifetime lifetime(0);
+    lifetime.OnCreated(true, 5);
+
+    std::thread window;
+    lifetime.BeginClose([&lifetime, &window]
+    {
+        // what a posted WM_CLOSE does once the window thread gets to it
+        window = std::thread([&lifetime]
+        {
+            lifetime.OnDestroying();
+            lifetime.OnClosed();
+        });
+    });
+
+    lifetime.WaitUntilClosed();
+    CHECK(lifetime.GetState() == OverlayState::CLOSED);
+    window.join();
+}
@@ -0,0 +1,115 @@
+#include "TestHarness.h"
+#include "PathBatch.h"
+#include <cstdint>
+#include <memory>
+#include <vector>
+
+using namespace PathWindows;
+
+namespace
+{
+    struct Run
+    {
+        size_t first;
+        size_t count;
+        bool newFigure;
+
+        bool operator==(const Run& other) const
+        {
+            return first == other.first && count == other.count && newFigure == other.newFigure;
+        }
+    };
+
+    std::vector<Run> GetRuns(size_t pointCount, const std::vector<int32_t>& figureStarts)
+    {
+        std::vector<Run> runs;
+        PathBatch::ForEachRun(pointCount, figureStarts.data(), figureStarts.size(), [&runs](size_t first, size_t count, bool newFigure)
+        {
+            runs.push_back(Run{ first, count, newFigure });
+        });
+
+        return runs;
+    }
+}
+
+TEST_CASE(IsValid_AscendingStartsWithinThePoints_IsTrue)
+{
+    const int32_t starts[] = { 0, 3, 9 };
+
+    CHECK(PathBatch::IsValid(10, starts, 3));
+    CHECK(PathBatch::IsValid(10, nullptr, 0));
+}
+
+TEST_CASE(IsValid_BadStarts_IsFalse)
+{
+    const int32_t descending[] = { 3, 2 };
+    const int32_t repeated[] = { 3, 3 };
+    const int32_t negative[] = { -1 };
+    const int32_t pastTheEnd[] = { 10 };
+
+    CHECK(!PathBatch::IsValid(10, descending, 2));
+    CHECK(!PathBatch::IsValid(10, repeated, 2));
+    CHECK(!PathBatch::IsValid(10, negative, 1));
+    CHECK(!PathBatch::IsValid(10, pastTheEnd, 1));
+    CHECK(!PathBatch::IsValid(10, nullptr, 1));
+}
+
+TEST_CASE(ForEachRun_NoFigureStarts_ContinuesTheLastFigure)
+{
+    CHECK((GetRuns(5, {}) == std::vector<Run>{ Run{ 0, 5, false } }));
+}
+
+TEST_CASE(ForEachRun_StartAtZero_StartsAFigureRightAway)
+{
+    CHECK((GetRuns(5, { 0, 2 }) == std::vector<Run>{ Run{ 0, 2, true }, Run{ 2, 3, true } }));
+}
+
+TEST_CASE(ForEachRun_StartsInTheMiddle_SplitsTheRuns)
+{
+    std::vector<Run> runs = GetRuns(10, { 3, 4, 9 });
+
+    CHECK((runs == std::vector<Run>{ Run{ 0, 3, false }, Run{ 3, 1, true }, Run{ 4, 5, true }, Run{ 9, 1, true } }));
+}
+
+TEST_CASE(ForEachRun_AnyBatch_CoversEveryPointOnce)
+{
+    std::vector<int32_t> starts;
+    for (int32_t i = 1; i < 1000; i += 1 + i % 7) starts.push_back(i);
+
+    size_t next = 0;
+    PathBatch::ForEachRun(1000, starts.data(), starts.size(), [&next](size_t first, size_t count, bool)
+    {
+        CHECK(first == next);
+        CHECK(count > 0);
+        next = first + count;
+    });
+
+    CHECK(next == 1000);
+}
+
+TEST_CASE(MakeRun_Batch_ConvertsEveryPointAndKeepsTheStarts)
+{
+    const int32_t xy[] = { 1, 2, -3, 4, 2147483647, -2147483647 - 1 };
+    const int32_t starts[] = { 1 };
+
+    std::unique_ptr<PathBatch::Run> pRun = PathBatch::MakeRun(xy, 3, starts, 1);
+
+    REQUIRE(pRun->points.size() == 3);
+    CHECK(pRun->points[0].x == 1.0f && pRun->points[0].y == 2.0f);
+    CHECK(pRun->points[1].x == -3.0f && pRun->points[1].y == 4.0f);
+    CHECK(pRun->points[2].x == 2147483647.0f && pRun->points[2].y == -2147483648.0f);
+    CHECK(pRun->delaysNS.empty());
+    CHECK((pRun->figureStarts == std::vector<int32_t>{ 1 }));
+}
+
+TEST_CASE(MakeTimedRun_Movements_KeepsTheDelays)
+{
+    const Movement movements[] = { { PointI{ 5, 6 }, 0 }, { PointI{ 7, 8 }, 16'000'000 } };
+
+    std::unique_ptr<PathBatch::Run> pRun = PathBatch::MakeTimedRun(movements, 2, nullptr, 0);
+
+    REQUIRE(pRun->points.size() == 2);
+    CHECK(pRun->points[1].x == 7.0f && pRun->points[1].y == 8.0f);
+    CHECK((pRun->delaysNS == std::vector<int64_t>{ 0, 16'000'000 }));
+    CHECK(pRun->figureStarts.empty());
+}
@@ -0,0 +1,291 @@
+#include "TestHarness.h"
+#include "PathCodec.h"
+#include <algorithm>
+#include <cstdint>
+#include <random>
+#include <vector>
+
+using namespace PathWindows;
+using PathCodec::Result;
+
+namespace
+{
+    // a recorded drag: small steps at the polling rate, with a few pauses and the odd jump
+    std::vector<Movement> MakePath(size_t count, uint32_t seed)
+    {
+        std::mt19937 random(seed);
+        std::uniform_int_distribution<int32_t> step(-4, 4);
+
+        std::vector<Movement> path(count);
+        for (size_t i = 0; i < count; ++i)
+        {
+            path[i].delta = PointI{ step(random), step(random) };
+            path[i].delayDurationNS = random() % 50 == 0 ? 1'000'000 + random() % 100'000'000 : 8'000'000;
+            if (random() % 200 == 0) path[i].delta = PointI{ static_cast<int32_t>(random() % 4000) - 2000, static_cast<int32_t>(random() % 4000) - 2000 };
+        }
+
+        return path;
+    }
+
+    // the running sum of a path, as CursorPath::ToAbsolute makes it
+    std::vector<Movement> ToPositions(const std::vector<Movement>& path)
+    {
+        std::vector<Movement> positions(path);
+        PointI position{ 960, 540 };
+        for (Movement& movement : positions)
+        {
+            position.x += movement.delta.x;
+            position.y += movement.delta.y;
+            movement.delta = position;
+        }
+
+        return positions;
+    }
+
+    std::vector<uint8_t> Encode(const std::vector<Movement>& path, bool absolute, size_t pieceSize = SIZE_MAX)
+    {
+        PathEncoder encoder(absolute);
+        for (size_t i = 0; i < path.size(); i += pieceSize) encoder.Append(path.data() + i, (std::min)(pieceSize, path.size() - i));
+        encoder.Flush();
+
+        std::vector<uint8_t> bytes(encoder.GetOutputSize());
+        encoder.ReadOutput(bytes.data(), bytes.size());
+        return bytes;
+    }
+
+    Result Decode(const std::vector<uint8_t>& bytes, std::vector<Movement>& path, size_t pieceSize = SIZE_MAX)
+    {
+        path.clear();
+        PathDecoder decoder;
+
+        for (size_t i = 0; i < bytes.size(); i += pieceSize)
+        {
+            Result result = decoder.Feed(bytes.data() + i, (std::min)(pieceSize, bytes.size() - i), [&path](const Movement* movements, size_t count)
+            {
+                path.insert(path.end(), movements, movements + count);
+            });
+            if (result != Result::OK) return result;
+        }
+
+        return decoder.Finish();
+    }
+
+    bool Equal(const std::vector<Movement>& a, const std::vector<Movement>& b)
+    {
+        if (a.size() != b.size()) return false;
+
+        for (size_t i = 0; i < a.size(); ++i)
+        {
+            if (a[i].delta.x != b[i].delta.x || a[i].delta.y != b[i].delta.y || a[i].delayDurationNS != b[i].delayDurationNS) return false;
+        }
+
+        return true;
+    }
+}
+
+TEST_CASE(Crc32_CheckValue_MatchesTheStandard)
+{
+    const char* text = "123456789";
+    CHECK(PathCodec::Crc32(reinterpret_cast<const uint8_t*>(text), 9) == 0xCBF43926u);
+    CHECK(PathCodec::Crc32(nullptr, 0) == 0);
+}
+
+TEST_CASE(RoundTrip_Deltas_DecodesWhatWasEncoded)
+{
+    for (size_t count : { size_t(0), size_t(1), size_t(2), PathCodec::MAX_BLOCK_MOVEMENTS - 1, PathCodec::MAX_BLOCK_MOVEMENTS, PathCodec::MAX_BLOCK_MOVEMENTS + 1, size_t(50'000) })
+    {
+        std::vector<Movement> path = MakePath(count, static_cast<uint32_t>(count));
+        std::vector<Movement> decoded;
+
+        CHECK(Decode(Encode(path, false), decoded) == Result::OK);
+        CHECK(Equal(path, decoded));
+    }
+}
+
+TEST_CASE(RoundTrip_Positions_DecodesWhatWasEncoded)
+{
+    std::vector<Movement> positions = ToPositions(MakePath(20'000, 1));
+    std::vector<uint8_t> bytes = Encode(positions, true);
+
+    std::vector<Movement> decoded;
+    CHECK(Decode(bytes, decoded) == Result::OK);
+    CHECK(Equal(positions, decoded));
+    CHECK(bytes[5] == PathCodec::FLAG_ABSOLUTE);
+
+    // differences keep positions about as small as deltas
+    CHECK(bytes.size() < Encode(positions, false).size());
+}
+
+TEST_CASE(RoundTrip_ExtremeValues_Survive)
+{
+    std::vector<Movement> path = {
+        Movement{ PointI{ INT32_MIN, INT32_MAX }, INT64_MIN },
+        Movement{ PointI{ INT32_MAX, INT32_MIN }, INT64_MAX },
+        Movement{ PointI{ 0, 0 }, 0 },
+        Movement{ PointI{ INT32_MIN, INT32_MIN }, -1 },
+    };
+
+    for (bool absolute : { false, true })
+    {
+        std::vector<Movement> decoded;
+        CHECK(Decode(Encode(path, absolute), decoded) == Result::OK);
+        CHECK(Equal(path, decoded));
+    }
+}
+
+TEST_CASE(RoundTrip_MoreDelaysThanTheDictionary_StoresTheRestAsLiterals)
+{
+    std::vector<Movement> path;
+    for (int i = 0; i < 200; ++i) path.push_back(Movement{ PointI{ 1, -1 }, (i % 40) * 1000 });
+
+    std::vector<Movement> decoded;
+    CHECK(Decode(Encode(path, false), decoded) == Result::OK);
+    CHECK(Equal(path, decoded));
+}
+
+TEST_CASE(RoundTrip_AnyPieceSizes_DecodesTheSame)
+{
+    std::vector<Movement> path = MakePath(10'000, 2);
+
+    for (size_t encodePiece : { size_t(1), size_t(7), size_t(4096) })
+    {
+        std::vector<uint8_t> bytes = Encode(path, false, encodePiece);
+
+        for (size_t decodePiece : { size_t(1), size_t(5), size_t(12), size_t(1000) })
+        {
+            std::vector<Movement> decoded;
+            CHECK(Decode(bytes, decoded, decodePiece) == Result::OK);
+            CHECK(Equal(path, decoded));
+        }
+    }
+}
+
+TEST_CASE(ReadOutput_WhileAppending_HandsOutFinishedBlocks)
+{
+    std::vector<Movement> path = MakePath(3 * PathCodec::MAX_BLOCK_MOVEMENTS + 10, 3);
+    PathEncoder encoder(false);
+
+    std::vector<uint8_t> bytes;
+    uint8_t buffer[1000];
+    for (size_t i = 0; i < path.size(); i += 100)
+    {
+        encoder.Append(path.data() + i, (std::min)(size_t(100), path.size() - i));
+        size_t read = encoder.ReadOutput(buffer, sizeof(buffer));
+        bytes.insert(bytes.end(), buffer, buffer + read);
+    }
+
+    encoder.Flush();
+    while (size_t read = encoder.ReadOutput(buffer, sizeof(buffer))) bytes.insert(bytes.end(), buffer, buffer + read);
+    CHECK(encoder.GetOutputSize() == 0);
+
+    std::vector<Movement> decoded;
+    CHECK(Decode(bytes, decoded) == Result::OK);
+    CHECK(Equal(path, decoded));
+
+    size_t count;
+    CHECK(PathDecoder::CountMovements(bytes.data(), bytes.size(), count) == Result::OK);
+    CHECK(count == path.size());
+}
+
+TEST_CASE(Decode_EndsEarly_IsTruncated)
+{
+    std::vector<uint8_t> bytes = Encode(MakePath(5000, 4), false);
+
+    for (size_t size : { size_t(0), size_t(3), PathCodec::HEADER_SIZE + 5, PathCodec::HEADER_SIZE + PathCodec::BLOCK_HEADER_SIZE + 1, bytes.size() - 1 })
+    {
+        std::vector<Movement> decoded;
+        CHECK(Decode(std::vector<uint8_t>(bytes.begin(), bytes.begin() + size), decoded) == Result::TRUNCATED);
+
+        size_t count;
+        if (size >= PathCodec::HEADER_SIZE) CHECK(PathDecoder::CountMovements(bytes.data(), size, count) == Result::TRUNCATED);
+    }
+}
+
+TEST_CASE(Decode_BadHeader_IsRejected)
+{
+    std::vector<uint8_t> bytes = Encode(MakePath(10, 5), false);
+    std::vector<Movement> decoded;
+
+    std::vector<uint8_t> version(bytes);
+    version[4] = PathCodec::VERSION + 1;
+    CHECK(Decode(version, decoded) == Result::UNSUPPORTED_VERSION);
+
+    std::vector<uint8_t> magic(bytes);
+    magic[0] = 'X';
+    CHECK(Decode(magic, decoded) == Result::CORRUPT);
+
+    std::vector<uint8_t> flags(bytes);
+    flags[5] = 0x80;
+    CHECK(Decode(flags, decoded) == Result::CORRUPT);
+}
+
+TEST_CASE(Decode_AnyFlippedPayloadBit_IsCorrupt)
+{
+    std::vector<uint8_t> bytes = Encode(MakePath(300, 6), false);
+    size_t payload = PathCodec::HEADER_SIZE + PathCodec::BLOCK_HEADER_SIZE;
+
+    for (size_t i = payload; i < bytes.size(); ++i)
+    {
+        std::vector<uint8_t> flipped(bytes);
+        flipped[i] ^= static_cast<uint8_t>(1 << (i % 8));
+
+        std::vector<Movement> decoded;
+        CHECK(Decode(flipped, decoded) == Result::CORRUPT);
+        CHECK(decoded.empty());
+    }
+}
+
+TEST_CASE(Feed_AfterFailing_StaysFailed)
+{
+    std::vector<uint8_t> bytes = Encode(MakePath(10, 7), false);
+    bytes[0] = 0;
+
+    PathDecoder decoder;
+    auto sink = [](const Movement*, size_t) {};
+    CHECK(decoder.Feed(bytes.data(), bytes.size(), sink) == Result::CORRUPT);
+
+    std::vector<uint8_t> good = Encode(MakePath(10, 7), false);
+    CHECK(decoder.Feed(good.data(), good.size(), sink) == Result::CORRUPT);
+    CHECK(decoder.Finish() == Result::CORRUPT);
+}
+
+// Random garbage and mutated streams must come back as an error or as movements, never crash or hang. With a valid
+// checksum put back, mutated payloads also reach the block decoder.
+TEST_CASE(Decode_Fuzzed_NeverMisbehaves)
+{
+    std::mt19937 random(8);
+    std::vector<uint8_t> valid = Encode(MakePath(2000, 8), false);
+    size_t payload = PathCodec::HEADER_SIZE + PathCodec::BLOCK_HEADER_SIZE;
+
+    for (int round = 0; round < 2000; ++round)
+    {
+        std::vector<uint8_t> bytes(valid.begin(), valid.begin() + payload + (round % 2 ? 0 : random() % 64));
+        if (round % 2)
+        {
+            // a payload of garbage behind a block header that matches it
+            size_t payloadSize = 1 + random() % 200;
+            for (size_t i = 0; i < payloadSize; ++i) bytes.push_back(static_cast<uint8_t>(random()));
+
+            uint32_t blockCount = 1 + random() % 100;
+            uint32_t checksum = PathCodec::Crc32(bytes.data() + payload, payloadSize);
+            for (int i = 0; i < 4; ++i)
+            {
+                bytes[PathCodec::HEADER_SIZE + i] = static_cast<uint8_t>(blockCount >> (i * 8));
+                bytes[PathCodec::HEADER_SIZE + 4 + i] = static_cast<uint8_t>(payloadSize >> (i * 8));
+                bytes[PathCodec::HEADER_SIZE + 8 + i] = static_cast<uint8_t>(checksum >> (i * 8));
+            }
+        }
+        else
+        {
+            for (uint8_t& byte : bytes) if (random() % 20 == 0) byte = static_cast<uint8_t>(random());
+        }
+
+        std::vector<Movement> decoded;
+        Result result = Decode(bytes, decoded, 1 + random() % 50);
+        CHECK(result == Result::OK || result == Result::CORRUPT || result == Result::TRUNCATED || result == Result::UNSUPPORTED_VERSION);
+        CHECK(decoded.size() <= PathCodec::MAX_BLOCK_MOVEMENTS);
+
+        size_t count;
+        PathDecoder::CountMovements(bytes.data(), bytes.size(), count);
+    }
+}
@@ -0,0 +1,284 @@
+#include "TestHarness.h"
+#include "PathHandoff.h"
+#include <atomic>
+#include <cstdlib>
+#include <new>
+#include <thread>
+#include <vector>
+
+using namespace PathWindows;
+
+// Every allocation through new in this executable is counted. MovementBuffer allocates with realloc, its allocations
+// show up as changes of its capacity instead.
+namespace
+{
+    std::atomic<size_t> g_newCount(0);
+}
+
+void* operator new(size_t size)
+{
+    ++g_newCount;
+    if (void* p = std::malloc(size ? size : 1)) return p;
+    throw std::bad_alloc();
+}
+
+void operator delete(void* p) noexcept
+{
+    std::free(p);
+}
+
+void operator delete(void* p, size_t) noexcept
+{
+    std::free(p);
+}
+
+namespace
+{
+    Movement MakeMovement(size_t i)
+    {
+        return Movement{ PointI{ static_cast<int32_t>(i), -static_cast<int32_t>(i) }, static_cast<int64_t>(i) * 1000 };
+    }
+
+    bool Equals(const Movement& a, const Movement& b)
+    {
+        return a.delta.x == b.delta.x && a.delta.y == b.delta.y && a.delayDurationNS == b.delayDurationNS;
+    }
+
+    // How many times the buffer had to grow for count appends.
+    size_t CountGrowths(MovementBuffer& buffer, size_t count)
+    {
+        size_t growths = 0;
+        for (size_t i = 0; i < count; ++i)
+        {
+            size_t capacity = buffer.GetCapacity();
+            buffer.PushBack(MakeMovement(i));
+            growths += buffer.GetCapacity() != capacity;
+        }
+
+        return growths;
+    }
+}
+
+TEST_CASE(MovementBuffer_PushBack_GrowsGeometrically)
+{
+    MovementBuffer buffer;
+
+    // 64, 128, ... 2^20
+    CHECK(CountGrowths(buffer, 1 << 20) == 15);
+    CHECK(buffer.GetSize() == 1 << 20);
+}
+
+TEST_CASE(MovementBuffer_Reserved_PushBackNeverGrows)
+{
+    MovementBuffer buffer;
+    buffer.Reserve(100000);
+    const Movement* data = buffer.GetData();
+
+    CHECK(CountGrowths(buffer, 100000) == 0);
+    CHECK(buffer.GetData() == data);
+}
+
+TEST_CASE(MovementBuffer_ClearAndTruncate_KeepTheStorage)
+{
+    MovementBuffer buffer;
+    CountGrowths(buffer, 1000);
+    size_t capacity = buffer.GetCapacity();
+
+    buffer.Truncate(10);
+    CHECK(buffer.GetSize() == 10);
+    buffer.Truncate(20);
+    CHECK(buffer.GetSize() == 10);
+
+    buffer.Clear();
+    CHECK(buffer.GetSize() == 0);
+    CHECK(CountGrowths(buffer, 1000) == 0);
+    CHECK(buffer.GetCapacity() == capacity);
+}
+
+TEST_CASE(MovementBuffer_Detach_HandsOverTheStorageWithoutCopying)
+{
+    MovementBuffer buffer;
+    CountGrowths(buffer, 500);
+    const Movement* data = buffer.GetData();
+
+    size_t size = 0;
+    Movement* detached = buffer.Detach(size);
+
+    CHECK(detached == data);
+    CHECK(size == 500);
+    CHECK(Equals(detached[499], MakeMovement(499)));
+    CHECK(buffer.GetData() == nullptr && buffer.GetSize() == 0 && buffer.GetCapacity() == 0);
+
+    MovementBuffer::Release(detached);
+
+    // and it can be used again
+    buffer.PushBack(MakeMovement(1));
+    CHECK(buffer.GetSize() == 1);
+}
+
+TEST_CASE(MovementBuffer_NothingReserved_DetachesNullptr)
+{
+    MovementBuffer buffer;
+    size_t size = 1;
+
+    CHECK(buffer.Detach(size) == nullptr);
+    CHECK(size == 0);
+}
+
+TEST_CASE(PathHandoff_AppendPullAndDetach_NeverAllocateWithNew)
+{
+    PathHandoff handoff;
+    handoff.Reserve(10000);
+    std::vector<Movement> pulled(10000);
+
+    size_t before = g_newCount;
+
+    size_t pulledCount = 0;
+    for (size_t i = 0; i < 10000; ++i)
+    {
+        handoff.Append(MakeMovement(i));
+        if (i % 100 == 99)
+        {
+            handoff.FinishStroke();
+
+            bool cleared;
+            pulledCount += handoff.PullFinished(pulled.data() + pulledCount, pulled.size() - pulledCount, cleared);
+        }
+    }
+
+    size_t size = 0;
+    Movement* path = handoff.Detach(size);
+
+    CHECK(g_newCount == before);
+    CHECK(pulledCount == 10000);
+    CHECK(size == 10000);
+
+    MovementBuffer::Release(path);
+}
+
+TEST_CASE(PathHandoff_PullFinished_OnlyReturnsFinishedStrokesOnce)
+{
+    PathHandoff handoff;
+    Movement pulled[16];
+    bool cleared = true;
+
+    for (size_t i = 0; i < 3; ++i) handoff.Append(MakeMovement(i));
+    CHECK(handoff.PullFinished(pulled, 16, cleared) == 0);
+    CHECK(!cleared);
+
+    handoff.FinishStroke();
+    handoff.Append(MakeMovement(3));
+
+    REQUIRE(handoff.PullFinished(pulled, 2, cleared) == 2);
+    REQUIRE(handoff.PullFinished(pulled + 2, 16, cleared) == 1);
+    CHECK(handoff.PullFinished(pulled, 16, cleared) == 0);
+
+    for (size_t i = 0; i < 3; ++i) CHECK(Equals(pulled[i], MakeMovement(i)));
+}
+
+TEST_CASE(PathHandoff_ClearAfterAPull_IsReportedOnce)
+{
+    PathHandoff handoff;
+    Movement pulled[16];
+    bool cleared = false;
+
+    handoff.Append(MakeMovement(0));
+    handoff.FinishStroke();
+    handoff.PullFinished(pulled, 16, cleared);
+
+    handoff.Clear();
+    handoff.Append(MakeMovement(7));
+    handoff.FinishStroke();
+
+    REQUIRE(handoff.PullFinished(pulled, 16, cleared) == 1);
+    CHECK(cleared);
+    CHECK(Equals(pulled[0], MakeMovement(7)));
+
+    handoff.PullFinished(pulled, 16, cleared);
+    CHECK(!cleared);
+}
+
+TEST_CASE(PathHandoff_ReplaceTailOfPulledMovements_StartsThePullOver)
+{
+    PathHandoff handoff;
+    Movement pulled[16];
+    bool cleared = false;
+
+    for (size_t i = 0; i < 5; ++i) handoff.Append(MakeMovement(i));
+    handoff.FinishStroke();
+    handoff.PullFinished(pulled, 16, cleared);
+
+    const Movement replacement[] = { MakeMovement(10), MakeMovement(11) };
+    handoff.ReplaceTail(3, replacement, 2);
+    CHECK(handoff.GetSize() == 5);
+
+    // what is left of the finished strokes comes again, the replaced tail is not finished
+    REQUIRE(handoff.PullFinished(pulled, 16, cleared) == 3);
+    CHECK(cleared);
+    CHECK(Equals(pulled[2], MakeMovement(2)));
+
+    handoff.FinishStroke();
+    REQUIRE(handoff.PullFinished(pulled, 16, cleared) == 2);
+    CHECK(Equals(pulled[1], MakeMovement(11)));
+}
+
+TEST_CASE(PathHandoff_MarkAllPulled_PreloadedPathIsNotPulledAgain)
+{
+    PathHandoff handoff;
+    std::vector<Movement> preloaded;
+    for (size_t i = 0; i < 50; ++i) preloaded.push_back(MakeMovement(i));
+
+    handoff.ReplaceAll(preloaded.data(), preloaded.size());
+    handoff.MarkAllPulled();
+    handoff.Append(MakeMovement(50));
+    handoff.FinishStroke();
+
+    Movement pulled[64];
+    bool cleared = true;
+    REQUIRE(handoff.PullFinished(pulled, 64, cleared) == 1);
+    CHECK(!cleared);
+    CHECK(Equals(pulled[0], MakeMovement(50)));
+}
+
+TEST_CASE(PathHandoff_PullWhileDrawing_GetsEveryMovementInOrder)
+{
+    constexpr size_t COUNT = 200000;
+
+    PathHandoff handoff;
+    std::vector<Movement> pulled(COUNT);
+    std::atomic<bool> done(false);
+
+    std::thread drawing([&handoff, &done]()
+    {
+        for (size_t i = 0; i < COUNT; ++i)
+        {
+            handoff.Append(MakeMovement(i));
+            if (i % 37 == 36) handoff.FinishStroke();
+        }
+
+        handoff.FinishStroke();
+        done = true;
+    });
+
+    size_t pulledCount = 0;
+    bool cleared = false;
+    while (!done || pulledCount < COUNT)
+    {
+        size_t count = handoff.PullFinished(pulled.data() + pulledCount, COUNT - pulledCount, cleared);
+        CHECK(!cleared);
+        pulledCount += count;
+        if (count == 0) std::this_thread::yield();
+    }
+
+    drawing.join();
+
+    REQUIRE(pulledCount == COUNT);
+    for (size_t i = 0; i < COUNT; ++i)
+    {
+        if (!Equals(pulled[i], MakeMovement(i)))
+        {
+            CHECK(Equals(pulled[i], MakeMovement(i)));
+            break;
+        }
+    }
+}
@@ -0,0 +1,148 @@
+#include "TestHarness.h"
+#include "PathStore.h"
+#include <cstdint>
+#include <vector>
+
+using namespace PathWindows;
+
+namespace
+{
+    // figures of the given lengths, point i at (i, figure)
+    PathStore MakeStore(const std::vector<size_t>& figureLengths)
+    {
+        PathStore store;
+        float x = 0;
+        for (size_t figure = 0; figure < figureLengths.size(); ++figure)
+        {
+            for (size_t i = 0; i < figureLengths[figure]; ++i, ++x) store.Append(PointF{ x, static_cast<float>(figure) }, i == 0);
+        }
+
+        return store;
+    }
+
+    std::vector<size_t> GetFigureStarts(const PathStore& store)
+    {
+        std::vector<size_t> starts;
+        for (size_t i = 0; i < store.GetFigureCount(); ++i) starts.push_back(store.GetFigureStart(i));
+        return starts;
+    }
+}
+
+TEST_CASE(Append_FirstPointWithoutNewFigure_StillStartsAFigure)
+{
+    PathStore store;
+    CHECK(store.IsEmpty());
+
+    store.Append(PointF{ 1, 2 }, false);
+    store.Append(PointF{ 3, 4 }, false);
+
+    CHECK(!store.IsEmpty());
+    CHECK(store.GetFigureCount() == 1);
+    CHECK(store.GetPointCount() == 2);
+}
+
+TEST_CASE(AppendRange_Runs_MatchAppendingPointByPoint)
+{
+    const PointF points[] = { { 0, 0 }, { 1, 0 }, { 2, 0 }, { 3, 0 }, { 4, 0 }, { 5, 0 } };
+
+    PathStore bulk;
+    bulk.AppendRange(points, 2, false);
+    bulk.AppendRange(points + 2, 1, false);
+    bulk.AppendRange(points + 3, 0, true);
+    bulk.AppendRange(points + 3, 3, true);
+
+    PathStore single;
+    single.Append(points[0], false);
+    single.Append(points[1], false);
+    single.Append(points[2], false);
+    for (size_t i = 3; i < 6; ++i) single.Append(points[i], i == 3);
+
+    CHECK(GetFigureStarts(bulk) == GetFigureStarts(single));
+    CHECK(GetFigureStarts(bulk) == (std::vector<size_t>{ 0, 3 }));
+    REQUIRE(bulk.GetPointCount() == 6);
+    for (size_t i = 0; i < 6; ++i) CHECK(bulk.GetPoints()[i].x == points[i].x);
+}
+
+TEST_CASE(GetFigure_SeveralFigures_ViewsTheirPointsContiguously)
+{
+    PathStore store = MakeStore({ 3, 1, 4 });
+
+    REQUIRE(store.GetFigureCount() == 3);
+
+    FigureView last = store.GetFigure(2);
+    REQUIRE(last.count == 4);
+    CHECK(last.points == store.GetPoints() + 4);
+    CHECK(last.points[0].x == 4 && last.points[3].x == 7 && last.points[0].y == 2);
+
+    CHECK(store.GetFigure(1).count == 1);
+    CHECK(store.GetFigureEnd(0) == 3);
+    CHECK(store.GetFigureEnd(2) == 8);
+}
+
+TEST_CASE(SplitFigures_SortedIndices_StartsFiguresThere)
+{
+    PathStore store = MakeStore({ 10 });
+
+    const uint32_t indices[] = { 2, 5, 9 };
+    store.SplitFigures(indices, 3);
+
+    CHECK((GetFigureStarts(store) == std::vector<size_t>{ 0, 2, 5, 9 }));
+    CHECK(store.StartsFigure(5));
+    CHECK(!store.StartsFigure(6));
+    CHECK(store.GetPointCount() == 10);
+}
+
+TEST_CASE(JoinFigures_SplitIndices_RestoresTheFigures)
+{
+    PathStore store = MakeStore({ 4, 6 });
+
+    const uint32_t indices[] = { 2, 7 };
+    store.SplitFigures(indices, 2);
+    CHECK((GetFigureStarts(store) == std::vector<size_t>{ 0, 2, 4, 7 }));
+
+    store.JoinFigures(indices, 2);
+    CHECK((GetFigureStarts(store) == std::vector<size_t>{ 0, 4 }));
+}
+
+TEST_CASE(FindFigure_AnyPoint_ReturnsTheFigureItIsIn)
+{
+    PathStore store = MakeStore({ 3, 1, 4 });
+
+    CHECK(store.FindFigure(0) == 0);
+    CHECK(store.FindFigure(2) == 0);
+    CHECK(store.FindFigure(3) == 1);
+    CHECK(store.FindFigure(4) == 2);
+    CHECK(store.FindFigure(7) == 2);
+}
+
+TEST_CASE(Truncate_WithinAFigure_DropsTheFiguresAfterIt)
+{
+    PathStore store = MakeStore({ 3, 3, 3 });
+
+    store.Truncate(4);
+    CHECK(store.GetPointCount() == 4);
+    CHECK((GetFigureStarts(store) == std::vector<size_t>{ 0, 3 }));
+
+    store.Truncate(3);
+    CHECK((GetFigureStarts(store) == std::vector<size_t>{ 0 }));
+
+    // past the end changes nothing
+    store.Truncate(100);
+    CHECK(store.GetPointCount() == 3);
+}
+
+TEST_CASE(Clear_FilledStore_KeepsTheCapacity)
+{
+    PathStore store;
+    store.Reserve(1000);
+    for (int i = 0; i < 1000; ++i) store.Append(PointF{ static_cast<float>(i), 0 }, i % 10 == 0);
+
+    const PointF* before = store.GetPoints();
+    store.Clear();
+
+    CHECK(store.IsEmpty());
+    CHECK(store.GetFigureCount() == 0);
+
+    store.Append(PointF{ 1, 1 }, true);
+    CHECK(store.GetPoints() == before);
+}
@@ -0,0 +1,174 @@
+#include "TestHarness.h"
+#include "GoldenImage.h"
+#include "PathThumbnail.h"
+#include <cmath>
+#include <cstdint>
+#include <vector>
+
+using namespace PathWindows;
+using namespace PathWindows::Tests;
+
+// The golden images are drawn with the stroke RenderPathThumbnail uses.
+
+namespace
+{
+    constexpr float STROKE_WIDTH = 1.5f;
+    constexpr ColorF STROKE_COLOR{ 1.0f, 0.0f, 0.0f, 0.9f };
+
+    std::vector<PointI> MakeSpiral(size_t count, double turns, int32_t radius)
+    {
+        std::vector<PointI> points;
+        for (size_t i = 0; i < count; ++i)
+        {
+            double t = static_cast<double>(i) / count;
+            double angle = t * turns * 2 * 3.14159265358979;
+            points.push_back(PointI{ static_cast<int32_t>(std::lround(1000 + std::cos(angle) * radius * t)), static_cast<int32_t>(std::lround(500 + std::sin(angle) * radius * t)) });
+        }
+
+        return points;
+    }
+
+    // the bounds of the pixels that were drawn on
+    RectI GetInkBounds(const Bitmap& bitmap)
+    {
+        RectI bounds{ bitmap.width, bitmap.height, -1, -1 };
+        for (int32_t y = 0; y < bitmap.height; ++y)
+        {
+            for (int32_t x = 0; x < bitmap.width; ++x)
+            {
+                if (Channel(bitmap.At(x, y), 24) == 0) continue;
+
+                bounds.left = std::min(bounds.left, x);
+                bounds.top = std::min(bounds.top, y);
+                bounds.right = std::max(bounds.right, x);
+                bounds.bottom = std::max(bounds.bottom, y);
+            }
+        }
+
+        return bounds;
+    }
+}
+
+TEST_CASE(Fit_WideBox_FillsTheWidthAndCentersVertically)
+{
+    PathThumbnail::Transform transform = PathThumbnail::Fit(PointF{ 100, 100 }, PointF{ 300, 150 }, 64, 64, 2);
+
+    CHECK(std::abs(transform.scale - 60.0f / 200.0f) < 1e-6f);
+    CHECK(std::abs(100 * transform.scale + transform.offset.x - 2) < 1e-4f);
+    CHECK(std::abs(300 * transform.scale + transform.offset.x - 62) < 1e-4f);
+
+    float top = 100 * transform.scale + transform.offset.y;
+    float bottom = 150 * transform.scale + transform.offset.y;
+    CHECK(std::abs(top - (64 - bottom)) < 1e-4f);
+}
+
+TEST_CASE(Fit_SinglePoint_IsCentered)
+{
+    PathThumbnail::Transform transform = PathThumbnail::Fit(PointF{ 7, 9 }, PointF{ 7, 9 }, 40, 20, 2);
+
+    CHECK(std::abs(7 * transform.scale + transform.offset.x - 20) < 1e-4f);
+    CHECK(std::abs(9 * transform.scale + transform.offset.y - 10) < 1e-4f);
+}
+
+TEST_CASE(Render_EmptyPath_ClearsTheBitmap)
+{
+    PathThumbnail thumbnail(STROKE_WIDTH, STROKE_COLOR);
+    Bitmap bitmap(16, 16);
+    thumbnail.Render(static_cast<const PointI*>(nullptr), 0, bitmap.pixels.data(), bitmap.width, bitmap.height);
+
+    for (uint32_t pixel : bitmap.pixels) CHECK(pixel == 0);
+    CHECK(thumbnail.GetDrawnCount() == 0);
+}
+
+TEST_CASE(Render_Path_FitsInsideTheMargin)
+{
+    std::vector<PointI> points = MakeSpiral(2000, 3, 400);
+
+    PathThumbnail thumbnail(STROKE_WIDTH, STROKE_COLOR);
+    Bitmap bitmap(96, 64);
+    thumbnail.Render(points.data(), points.size(), bitmap.pixels.data(), bitmap.width, bitmap.height);
+
+    // the spiral is about round, so it fills the height and sits in the middle of the width
+    RectI ink = GetInkBounds(bitmap);
+    CHECK(ink.top >= 0 && ink.top <= 2);
+    CHECK(ink.bottom <= 63 && ink.bottom >= 61);
+    CHECK(std::abs(ink.left - (95 - ink.right)) <= 3);
+}
+
+TEST_CASE(Render_Movements_BreakWhereFiguresStart)
+{
+    // two horizontal strokes with a gap between them
+    const Movement movements[] = {
+        { PointI{ 0, 0 }, 0 }, { PointI{ 40, 0 }, 1000 },
+        { PointI{ 60, 0 }, 0 }, { PointI{ 100, 0 }, 1000 },
+    };
+
+    PathThumbnail thumbnail(STROKE_WIDTH, STROKE_COLOR);
+    Bitmap bitmap(100, 10);
+    thumbnail.Render(movements, 4, bitmap.pixels.data(), bitmap.width, bitmap.height);
+
+    CHECK(Channel(bitmap.At(25, 5), 24) > 0);
+    CHECK(Channel(bitmap.At(50, 5), 24) == 0);
+    CHECK(Channel(bitmap.At(75, 5), 24) > 0);
+}
+
+TEST_CASE(Render_PointsAndMovements_DrawTheSame)
+{
+    std::vector<PointI> points = MakeSpiral(500, 2, 300);
+    std::vector<Movement> movements;
+    for (const PointI& point : points) movements.push_back(Movement{ point, 1000 });
+
+    PathThumbnail thumbnail(STROKE_WIDTH, STROKE_COLOR);
+    Bitmap fromPoints(48, 48), fromMovements(48, 48);
+    thumbnail.Render(points.data(), points.size(), fromPoints.pixels.data(), 48, 48);
+    thumbnail.Render(movements.data(), movements.size(), fromMovements.pixels.data(), 48, 48);
+
+    CHECK(fromPoints.pixels == fromMovements.pixels);
+}
+
+// A path that goes over the same few pixels a million times draws hardly more than once.
+TEST_CASE(Render_LongPath_SkipsWhatAddsNothing)
+{
+    std::vector<PointI> points = MakeSpiral(1'000'000, 2000, 500);
+
+    PathThumbnail thumbnail(STROKE_WIDTH, STROKE_COLOR);
+    Bitmap bitmap(64, 64);
+    thumbnail.Render(points.data(), points.size(), bitmap.pixels.data(), bitmap.width, bitmap.height);
+
+    CHECK(thumbnail.GetDrawnCount() > 0);
+    CHECK(thumbnail.GetDrawnCount() < points.size() / 20);
+
+    RectI ink = GetInkBounds(bitmap);
+    CHECK(ink.left <= 2 && ink.right >= 61);
+}
+
+TEST_CASE(Render_Spiral_MatchesGolden)
+{
+    std::vector<PointI> points = MakeSpiral(3000, 4, 500);
+
+    PathThumbnail thumbnail(STROKE_WIDTH, STROKE_COLOR);
+    Bitmap bitmap(64, 48);
+    thumbnail.Render(points.data(), points.size(), bitmap.pixels.data(), bitmap.width, bitmap.height);
+
+    CHECK(MatchesGolden("ThumbnailSpiral", bitmap));
+}
+
+TEST_CASE(Render_SeveralFigures_MatchesGolden)
+{
+    std::vector<Movement> movements;
+    for (int32_t figure = 0; figure < 5; ++figure)
+    {
+        for (int32_t i = 0; i <= 20; ++i)
+        {
+            int32_t x = figure * 220 + i * 10;
+            int32_t y = 300 + static_cast<int32_t>(std::lround(std::sin(i / 3.0 + figure) * 120));
+            movements.push_back(Movement{ PointI{ x, y }, i == 0 ? 0 : 8'000'000 });
+        }
+    }
+
+    PathThumbnail thumbnail(STROKE_WIDTH, STROKE_COLOR);
+    Bitmap bitmap(80, 40);
+    thumbnail.Render(movements.data(), movements.size(), bitmap.pixels.data(), bitmap.width, bitmap.height);
+
+    CHECK(MatchesGolden("ThumbnailSeveralFigures", bitmap));
+}
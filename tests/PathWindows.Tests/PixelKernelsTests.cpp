@@ -0,0 +1,211 @@
+#include "TestHarness.h"
+#include "PixelKernels.h"
+#include <algorithm>
+#include <cmath>
+#include <random>
+#include <vector>
+
+using namespace PathWindows;
+
+namespace
+{
+    const PixelKernels::SimdLevel LEVELS[] = { PixelKernels::SimdLevel::SCALAR, PixelKernels::SimdLevel::SSE2, PixelKernels::SimdLevel::AVX2 };
+
+    // spans of every length up to a few vectors, at every offset within one
+    constexpr size_t MAX_COUNT = 67;
+    constexpr size_t MAX_OFFSET = 8;
+
+    // Runs fn at every level the CPU has, and puts back the level the kernels had.
+    template<class Fn>
+    void ForEachSupportedLevel(Fn&& fn)
+    {
+        PixelKernels::SimdLevel before = PixelKernels::GetLevel();
+        for (PixelKernels::SimdLevel level : LEVELS)
+        {
+            if (level > PixelKernels::GetSupportedLevel()) continue;
+
+            PixelKernels::SetLevel(level);
+            fn(level);
+        }
+
+        PixelKernels::SetLevel(before);
+    }
+
+    // premultiplied, so no channel above alpha
+    uint32_t RandomPremultiplied(std::mt19937& random)
+    {
+        uint32_t alpha = random() & 0xFF;
+        uint32_t pixel = alpha << 24;
+        for (int shift = 0; shift < 24; shift += 8) pixel |= (alpha == 0 ? 0 : random() % (alpha + 1)) << shift;
+        return pixel;
+    }
+
+    // coverage like the rasterizer's, mostly 0 or 255 with antialiased edges between
+    uint8_t RandomCoverage(std::mt19937& random)
+    {
+        switch (random() % 4)
+        {
+        case 0: return 0;
+        case 1: return 255;
+        default: return static_cast<uint8_t>(random());
+        }
+    }
+}
+
+TEST_CASE(SetLevel_AboveSupported_IsLimitedToIt)
+{
+    PixelKernels::SimdLevel before = PixelKernels::GetLevel();
+
+    PixelKernels::SetLevel(PixelKernels::SimdLevel::AVX2);
+    CHECK(PixelKernels::GetLevel() == PixelKernels::GetSupportedLevel());
+
+    PixelKernels::SetLevel(PixelKernels::SimdLevel::SCALAR);
+    CHECK(PixelKernels::GetLevel() == PixelKernels::SimdLevel::SCALAR);
+
+    PixelKernels::SetLevel(before);
+}
+
+TEST_CASE(FillSpan_EveryLevel_FillsExactlyTheSpan)
+{
+    ForEachSupportedLevel([](PixelKernels::SimdLevel)
+    {
+        for (size_t offset = 0; offset < MAX_OFFSET; ++offset)
+        {
+            for (size_t count = 0; count <= MAX_COUNT; ++count)
+            {
+                std::vector<uint32_t> pixels(offset + count + 1, 7);
+                PixelKernels::FillSpan(pixels.data() + offset, count, 0x80402010);
+
+                CHECK(std::all_of(pixels.begin(), pixels.begin() + offset, [](uint32_t p) { return p == 7; }));
+                CHECK(std::all_of(pixels.begin() + offset, pixels.end() - 1, [](uint32_t p) { return p == 0x80402010; }));
+                CHECK(pixels.back() == 7);
+            }
+        }
+    });
+}
+
+TEST_CASE(BlendSpan_Scalar_IsCloseToSourceOver)
+{
+    PixelKernels::SetLevel(PixelKernels::SimdLevel::SCALAR);
+
+    std::mt19937 random(3);
+    for (int i = 0; i < 10000; ++i)
+    {
+        uint32_t dst = RandomPremultiplied(random);
+        uint32_t src = RandomPremultiplied(random);
+        uint8_t coverage = static_cast<uint8_t>(random());
+
+        uint32_t result = dst;
+        PixelKernels::BlendSpan(&result, &coverage, 1, src);
+
+        float srcA = (src >> 24) / 255.0f * coverage / 255.0f;
+        for (int shift = 0; shift < 32; shift += 8)
+        {
+            float expected = ((src >> shift) & 0xFF) * (coverage / 255.0f) + ((dst >> shift) & 0xFF) * (1.0f - srcA);
+            // the source, its alpha and the destination are each rounded once, half a step every time
+            CHECK(std::fabs(static_cast<float>((result >> shift) & 0xFF) - expected) <= 1.5f);
+        }
+    }
+
+    PixelKernels::SetLevel(PixelKernels::GetSupportedLevel());
+}
+
+TEST_CASE(BlendSpan_FullAndNoCoverage_ReplaceOrKeepTheDestination)
+{
+    ForEachSupportedLevel([](PixelKernels::SimdLevel)
+    {
+        std::vector<uint32_t> pixels(16, 0x40102030);
+        std::vector<uint8_t> coverage(16, 0);
+        for (size_t i = 0; i < 16; i += 2) coverage[i] = 255;
+
+        PixelKernels::BlendSpan(pixels.data(), coverage.data(), pixels.size(), 0xFF00FF00);
+
+        for (size_t i = 0; i < 16; ++i) CHECK(pixels[i] == (i % 2 ? 0x40102030 : 0xFF00FF00));
+    });
+}
+
+TEST_CASE(BlendSpan_EveryLevel_MatchesScalar)
+{
+    std::mt19937 random(5);
+
+    for (size_t offset = 0; offset < MAX_OFFSET; ++offset)
+    {
+        for (size_t count = 0; count <= MAX_COUNT; ++count)
+        {
+            std::vector<uint32_t> pixels(offset + count);
+            std::vector<uint8_t> coverage(offset + count);
+            for (uint32_t& pixel : pixels) pixel = RandomPremultiplied(random);
+            for (uint8_t& value : coverage) value = RandomCoverage(random);
+            uint32_t src = RandomPremultiplied(random);
+
+            PixelKernels::SetLevel(PixelKernels::SimdLevel::SCALAR);
+            std::vector<uint32_t> expected = pixels;
+            PixelKernels::BlendSpan(expected.data() + offset, coverage.data() + offset, count, src);
+
+            ForEachSupportedLevel([&](PixelKernels::SimdLevel)
+            {
+                std::vector<uint32_t> actual = pixels;
+                PixelKernels::BlendSpan(actual.data() + offset, coverage.data() + offset, count, src);
+                CHECK(actual == expected);
+            });
+        }
+    }
+
+    PixelKernels::SetLevel(PixelKernels::GetSupportedLevel());
+}
+
+TEST_CASE(ConvertPoints_EveryLevel_MatchesScalar)
+{
+    std::mt19937 random(7);
+    std::uniform_int_distribution<int32_t> coordinate(-40000, 40000);
+
+    for (size_t count = 0; count <= MAX_COUNT; ++count)
+    {
+        std::vector<int32_t> xy(count * 2 + 1);
+        for (int32_t& value : xy) value = coordinate(random);
+        PointF offset{ 0.5f, -1920.0f };
+
+        ForEachSupportedLevel([&](PixelKernels::SimdLevel)
+        {
+            // odd offset into xy, so the loads are not aligned
+            std::vector<PointF> points(count);
+            PixelKernels::ConvertPoints(xy.data() + 1, points.data(), count, offset);
+
+            for (size_t i = 0; i < count; ++i)
+            {
+                CHECK(points[i].x == static_cast<float>(xy[1 + i * 2]) + offset.x);
+                CHECK(points[i].y == static_cast<float>(xy[2 + i * 2]) + offset.y);
+            }
+        });
+    }
+}
+
+TEST_CASE(MapCounts_EveryLevel_MatchesScalar)
+{
+    std::mt19937 random(9);
+
+    std::vector<uint32_t> palette(256);
+    for (size_t i = 0; i < palette.size(); ++i) palette[i] = static_cast<uint32_t>(i * 0x01010101);
+
+    for (uint32_t shift : { 0u, 4u, 8u, 12u, 16u })
+    {
+        for (size_t count = 0; count <= MAX_COUNT; ++count)
+        {
+            std::vector<uint16_t> counts(count);
+            for (uint16_t& value : counts) value = random() % 3 == 0 ? 0 : static_cast<uint16_t>(random() >> (random() % 16));
+
+            PixelKernels::SetLevel(PixelKernels::SimdLevel::SCALAR);
+            std::vector<uint32_t> expected(count);
+            PixelKernels::MapCounts(counts.data(), expected.data(), count, palette.data(), shift);
+
+            ForEachSupportedLevel([&](PixelKernels::SimdLevel)
+            {
+                std::vector<uint32_t> actual(count);
+                PixelKernels::MapCounts(counts.data(), actual.data(), count, palette.data(), shift);
+                CHECK(actual == expected);
+            });
+        }
+    }
+
+    PixelKernels::SetLevel(PixelKernels::GetSupportedLevel());
+}
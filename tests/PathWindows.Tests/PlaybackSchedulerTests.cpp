@@ -0,0 +1,295 @@
+#include "TestHarness.h"
+#include "PlaybackScheduler.h"
+#include <cstdint>
+#include <vector>
+
+using namespace PathWindows;
+
+namespace
+{
+    constexpr int64_t US = 1'000;
+    constexpr int64_t MS = 1'000'000;
+    constexpr int64_t PAUSE_NS = 1 * US;
+
+    // Time only moves when the scheduler sleeps or spins. Sleeps wake up late by oversleepNS, and by lateOnceNS on
+    // the next one.
+    class FakeClock : public PlaybackClock
+    {
+    public:
+        int64_t now = 5 * MS;
+        int64_t oversleepNS = 0;
+        int64_t lateOnceNS = 0;
+        int64_t longestSleepNS = 0;
+        size_t sleepCount = 0;
+        bool threadStarted = false;
+
+        int64_t Now() override
+        {
+            return now;
+        }
+
+        void Sleep(int64_t durationNS) override
+        {
+            if (durationNS > longestSleepNS) longestSleepNS = durationNS;
+            ++sleepCount;
+
+            now += durationNS + oversleepNS + lateOnceNS;
+            lateOnceNS = 0;
+        }
+
+        void Pause() override
+        {
+            now += PAUSE_NS;
+        }
+
+        void OnThreadStarted() override
+        {
+            threadStarted = true;
+        }
+    };
+
+    struct Batch
+    {
+        size_t first;
+        size_t count;
+        int64_t deadlineNS;
+        int64_t emittedNS;
+    };
+
+    class RecordingSink : public PlaybackSink
+    {
+    public:
+        explicit RecordingSink(FakeClock& clock) :
+            m_clock(clock)
+        {}
+
+        std::vector<Batch> batches;
+        std::vector<Movement> movements;
+
+        void Emit(const Movement* emitted, size_t count, int64_t deadlineNS) override
+        {
+            batches.push_back(Batch{ movements.size(), count, deadlineNS, m_clock.Now() });
+            movements.insert(movements.end(), emitted, emitted + count);
+        }
+
+    private:
+        FakeClock& m_clock;
+    };
+
+    std::vector<Movement> MakePath(size_t count, int64_t delayNS)
+    {
+        std::vector<Movement> path(count);
+        for (size_t i = 0; i < count; ++i) path[i] = Movement{ PointI{ static_cast<int32_t>(i), 0 }, delayNS };
+        return path;
+    }
+}
+
+TEST_CASE(Play_Empty_EmitsNothing)
+{
+    FakeClock clock;
+    RecordingSink sink(clock);
+    PlaybackScheduler scheduler(clock, sink);
+
+    CHECK(scheduler.Play(nullptr, 0));
+    CHECK(sink.batches.empty());
+    CHECK(!scheduler.IsPlaying());
+}
+
+TEST_CASE(Play_EvenDelays_EmitsEachAtItsDeadline)
+{
+    FakeClock clock;
+    RecordingSink sink(clock);
+    PlaybackScheduler scheduler(clock, sink);
+    int64_t start = clock.now;
+
+    std::vector<Movement> path = MakePath(20, 1 * MS);
+    CHECK(scheduler.Play(path.data(), path.size()));
+
+    REQUIRE(sink.batches.size() == 20);
+    for (size_t i = 0; i < 20; ++i)
+    {
+        const Batch& batch = sink.batches[i];
+        CHECK(batch.count == 1 && sink.movements[batch.first].delta.x == static_cast<int32_t>(i));
+        CHECK(batch.deadlineNS == start + static_cast<int64_t>(i + 1) * MS);
+        CHECK(batch.emittedNS >= batch.deadlineNS && batch.emittedNS < batch.deadlineNS + PAUSE_NS);
+    }
+
+    // it slept for most of every wait
+    CHECK(clock.sleepCount >= 20);
+}
+
+// Deadlines are counted from the start, so waking up late once delays one movement, not all that follow.
+TEST_CASE(Play_LateWakeUp_DoesNotShiftLaterDeadlines)
+{
+    FakeClock clock;
+    RecordingSink sink(clock);
+    PlaybackScheduler scheduler(clock, sink);
+    int64_t start = clock.now;
+
+    // it spins for longer than the first sleep wakes up late
+    int64_t spin = scheduler.GetSpinDuration();
+    clock.lateOnceNS = 700 * US;
+    std::vector<Movement> path = MakePath(10, 5 * MS);
+    CHECK(scheduler.Play(path.data(), path.size()));
+
+    REQUIRE(sink.batches.size() == 10);
+    CHECK(sink.batches[0].emittedNS == sink.batches[0].deadlineNS + 700 * US - spin);
+    for (size_t i = 1; i < 10; ++i)
+    {
+        CHECK(sink.batches[i].deadlineNS == start + static_cast<int64_t>(i + 1) * 5 * MS);
+        CHECK(sink.batches[i].emittedNS < sink.batches[i].deadlineNS + PAUSE_NS);
+    }
+}
+
+TEST_CASE(Play_SleepsWakingUpLate_SpinsLonger)
+{
+    FakeClock clock;
+    RecordingSink sink(clock);
+    PlaybackScheduler::Options options = PlaybackScheduler::DEFAULT_OPTIONS;
+    PlaybackScheduler scheduler(clock, sink, options);
+
+    // with a quarter to spare, like for any late wake up
+    CHECK(scheduler.GetSpinDuration() == options.minSpinNS + options.minSpinNS / 4);
+
+    clock.oversleepNS = 1 * MS;
+    std::vector<Movement> path = MakePath(10, 4 * MS);
+    scheduler.Play(path.data(), path.size());
+
+    // one late wake up is enough to spin for it
+    CHECK(scheduler.GetSpinDuration() == 1 * MS + 250 * US);
+    for (size_t i = 1; i < sink.batches.size(); ++i) CHECK(sink.batches[i].emittedNS < sink.batches[i].deadlineNS + PAUSE_NS);
+
+    // once sleeps are on time again it goes back down, sleeping a little closer to the deadline every time
+    clock.oversleepNS = 0;
+    size_t sleepCount = clock.sleepCount;
+    path = MakePath(2, 4 * MS);
+    scheduler.Play(path.data(), path.size());
+    CHECK(scheduler.GetSpinDuration() == options.minSpinNS);
+    CHECK(clock.sleepCount - sleepCount > 2);
+    for (size_t i = 10; i < sink.batches.size(); ++i) CHECK(sink.batches[i].emittedNS == sink.batches[i].deadlineNS);
+
+    clock.oversleepNS = 100 * MS;
+    scheduler.Play(path.data(), path.size());
+    CHECK(scheduler.GetSpinDuration() == options.maxSpinNS);
+}
+
+TEST_CASE(Play_CloseDelays_AreBatched)
+{
+    FakeClock clock;
+    RecordingSink sink(clock);
+    PlaybackScheduler scheduler(clock, sink);
+    int64_t start = clock.now;
+
+    const Movement path[] = {
+        { PointI{ 0, 0 }, 0 },
+        { PointI{ 1, 0 }, 40 * US },
+        { PointI{ 2, 0 }, 40 * US },
+        { PointI{ 3, 0 }, 1 * MS },
+        { PointI{ 4, 0 }, -5 * MS },
+        { PointI{ 5, 0 }, 300 * US },
+    };
+    CHECK(scheduler.Play(path, 6));
+
+    // a negative delay counts as none
+    REQUIRE(sink.batches.size() == 3);
+    CHECK(sink.batches[0].count == 3 && sink.batches[0].deadlineNS == start);
+    CHECK(sink.batches[1].count == 2 && sink.batches[1].deadlineNS == start + 1080 * US);
+    CHECK(sink.batches[2].count == 1 && sink.batches[2].deadlineNS == start + 1380 * US);
+    CHECK(sink.movements.size() == 6 && sink.movements[4].delta.x == 4);
+}
+
+TEST_CASE(Play_Overdue_CatchesUpInOneBatch)
+{
+    FakeClock clock;
+    RecordingSink sink(clock);
+    PlaybackScheduler scheduler(clock, sink);
+
+    clock.lateOnceNS = 5 * MS + 500 * US;
+    std::vector<Movement> path = MakePath(20, 1 * MS);
+    CHECK(scheduler.Play(path.data(), path.size()));
+
+    // the first sleep wakes up past the deadlines of 6 movements
+    REQUIRE(sink.batches.size() == 15);
+    CHECK(sink.batches[0].count == 6);
+    CHECK(sink.batches[1].count == 1);
+    CHECK(sink.movements.size() == 20);
+}
+
+TEST_CASE(Play_LongDelay_SleepsInPieces)
+{
+    FakeClock clock;
+    RecordingSink sink(clock);
+    PlaybackScheduler::Options options = PlaybackScheduler::DEFAULT_OPTIONS;
+    PlaybackScheduler scheduler(clock, sink, options);
+
+    std::vector<Movement> path = MakePath(1, 1'000 * MS);
+    CHECK(scheduler.Play(path.data(), path.size()));
+
+    CHECK(clock.longestSleepNS == options.maxSleepNS);
+    CHECK(clock.sleepCount >= 99);
+    CHECK(sink.batches.size() == 1);
+}
+
+TEST_CASE(Cancel_FromTheSink_StopsPlaying)
+{
+    FakeClock clock;
+
+    struct CancellingSink : RecordingSink
+    {
+        using RecordingSink::RecordingSink;
+        PlaybackScheduler* scheduler = nullptr;
+
+        void Emit(const Movement* emitted, size_t count, int64_t deadlineNS) override
+        {
+            RecordingSink::Emit(emitted, count, deadlineNS);
+            if (batches.size() == 3) scheduler->Cancel();
+        }
+    } sink(clock);
+
+    PlaybackScheduler scheduler(clock, sink);
+    sink.scheduler = &scheduler;
+
+    std::vector<Movement> path = MakePath(10, 1 * MS);
+    CHECK(!scheduler.Play(path.data(), path.size()));
+    CHECK(sink.batches.size() == 3);
+    CHECK(!scheduler.IsPlaying());
+
+    // and playing again starts over
+    CHECK(scheduler.Play(path.data(), path.size()));
+    CHECK(sink.batches.size() == 13);
+}
+
+TEST_CASE(Start_Path_PlaysOnItsOwnThread)
+{
+    FakeClock clock;
+
+    struct ReplayingSink : RecordingSink
+    {
+        using RecordingSink::RecordingSink;
+        PlaybackScheduler* scheduler = nullptr;
+        bool playedAgain = false;
+
+        void Emit(const Movement* emitted, size_t count, int64_t deadlineNS) override
+        {
+            RecordingSink::Emit(emitted, count, deadlineNS);
+            playedAgain |= scheduler->Play(emitted, count) || scheduler->Start(emitted, count);
+        }
+    } sink(clock);
+
+    PlaybackScheduler scheduler(clock, sink);
+    sink.scheduler = &scheduler;
+
+    std::vector<Movement> path = MakePath(10, 1 * MS);
+    REQUIRE(scheduler.Start(path.data(), path.size()));
+    // the path was copied
+    path.clear();
+
+    CHECK(scheduler.Wait());
+    CHECK(clock.threadStarted);
+    CHECK(sink.batches.size() == 10 && sink.movements[9].delta.x == 9);
+    CHECK(!sink.playedAgain);
+    CHECK(!scheduler.IsPlaying());
+
+    // waiting again returns the same
+    CHECK(scheduler.Wait());
+}
@@ -0,0 +1,199 @@
+#include "TestHarness.h"
+#include "PolylineSimplifier.h"
+#include <algorithm>
+#include <cmath>
+#include <random>
+#include <vector>
+
+using namespace PathWindows;
+
+namespace
+{
+    // the simplifier measures in floats, which are off by about 1e-4 px at 1000 px from the origin
+    constexpr float EPSILON = 1e-3f;
+
+    std::vector<PointF> Simplify(PolylineSimplifier& simplifier, const std::vector<PointF>& points)
+    {
+        std::vector<PointF> out;
+        auto emit = [&](PointF point) { out.push_back(point); };
+
+        for (PointF point : points) simplifier.Add(point, emit);
+        simplifier.Flush(emit);
+
+        return out;
+    }
+
+    float DistanceToSegment(PointF p, PointF a, PointF b)
+    {
+        double dx = b.x - a.x;
+        double dy = b.y - a.y;
+        double lengthSq = dx * dx + dy * dy;
+
+        double t = lengthSq > 0 ? ((p.x - a.x) * dx + (p.y - a.y) * dy) / lengthSq : 0;
+        t = t < 0 ? 0 : (t > 1 ? 1 : t);
+
+        return static_cast<float>(std::hypot(a.x + t * dx - p.x, a.y + t * dy - p.y));
+    }
+
+    bool SamePoint(PointF a, PointF b)
+    {
+        return a.x == b.x && a.y == b.y;
+    }
+
+    // The output is a subsequence of the input, finds where each of its points came from.
+    // Returns false if it is not.
+    bool MatchOutput(const std::vector<PointF>& in, const std::vector<PointF>& out, std::vector<size_t>& indices)
+    {
+        indices.clear();
+        size_t i = 0;
+        for (PointF point : out)
+        {
+            while (i < in.size() && !SamePoint(in[i], point)) ++i;
+            if (i == in.size()) return false;
+
+            indices.push_back(i++);
+        }
+
+        return true;
+    }
+
+    // The largest distance of a dropped point from the segment that replaced it.
+    float GetMaxError(const std::vector<PointF>& in, const std::vector<PointF>& out, const std::vector<size_t>& indices)
+    {
+        float maxError = 0;
+        for (size_t k = 1; k < indices.size(); ++k)
+        {
+            for (size_t i = indices[k - 1] + 1; i < indices[k]; ++i)
+            {
+                maxError = std::max(maxError, DistanceToSegment(in[i], out[k - 1], out[k]));
+            }
+        }
+
+        return maxError;
+    }
+
+    // A hand-drawn looking path: a smooth curve sampled at a varying speed, with sub-pixel jitter.
+    std::vector<PointF> MakeTrace(size_t count, unsigned seed)
+    {
+        std::mt19937 rng(seed);
+        std::uniform_real_distribution<float> jitter(-0.4f, 0.4f);
+        std::uniform_real_distribution<float> turn(-0.08f, 0.08f);
+
+        std::vector<PointF> points(count);
+        float x = 500, y = 500, heading = 0, speed = 2;
+        for (size_t i = 0; i < count; ++i)
+        {
+            heading += turn(rng);
+            speed = 0.5f + 3.0f * (0.5f + 0.5f * std::sin(static_cast<float>(i) * 0.01f));
+            x += std::cos(heading) * speed;
+            y += std::sin(heading) * speed;
+            points[i] = PointF{ x + jitter(rng), y + jitter(rng) };
+        }
+
+        return points;
+    }
+}
+
+TEST_CASE(Add_ZeroTolerance_EmitsEveryPoint)
+{
+    PolylineSimplifier simplifier(0.0f);
+    std::vector<PointF> in = MakeTrace(500, 1);
+
+    std::vector<PointF> out = Simplify(simplifier, in);
+
+    REQUIRE(out.size() == in.size());
+    bool same = true;
+    for (size_t i = 0; i < in.size(); ++i) same = same && SamePoint(in[i], out[i]);
+    CHECK(same);
+}
+
+TEST_CASE(Add_StraightLine_KeepsOnlyTheEndsOfEachRun)
+{
+    PolylineSimplifier simplifier(0.5f);
+    std::vector<PointF> in;
+    for (int i = 0; i < 1000; ++i) in.push_back(PointF{ static_cast<float>(i), static_cast<float>(i) * 0.5f });
+
+    std::vector<PointF> out = Simplify(simplifier, in);
+
+    // runs are cut after 64 points to bound the work per point, even when they still fit
+    CHECK(out.size() <= 1000 / 64 + 2);
+    REQUIRE(out.size() >= 2);
+    CHECK(SamePoint(out.front(), in.front()));
+    CHECK(SamePoint(out.back(), in.back()));
+}
+
+TEST_CASE(Add_RecordedLikeTraces_StaysWithinTheTolerance)
+{
+    for (float tolerance : { 0.25f, 0.5f, 1.0f, 2.0f, 5.0f })
+    {
+        for (unsigned seed = 0; seed < 10; ++seed)
+        {
+            PolylineSimplifier simplifier(tolerance);
+            std::vector<PointF> in = MakeTrace(5000, seed);
+
+            std::vector<PointF> out = Simplify(simplifier, in);
+
+            std::vector<size_t> indices;
+            REQUIRE(MatchOutput(in, out, indices));
+            CHECK(indices.front() == 0);
+            CHECK(indices.back() == in.size() - 1);
+            CHECK(GetMaxError(in, out, indices) <= tolerance + EPSILON);
+            CHECK(out.size() < in.size());
+        }
+    }
+}
+
+TEST_CASE(Add_RandomJumps_StaysWithinTheTolerance)
+{
+    std::mt19937 rng(3);
+    std::uniform_real_distribution<float> coordinate(0.0f, 100.0f);
+
+    std::vector<PointF> in(2000);
+    for (PointF& point : in) point = PointF{ coordinate(rng), coordinate(rng) };
+
+    PolylineSimplifier simplifier(3.0f);
+    std::vector<PointF> out = Simplify(simplifier, in);
+
+    std::vector<size_t> indices;
+    REQUIRE(MatchOutput(in, out, indices));
+    CHECK(GetMaxError(in, out, indices) <= 3.0f + EPSILON);
+}
+
+TEST_CASE(GetPendingSegment_HeldBackRun_EndsAtTheLastPointAdded)
+{
+    PolylineSimplifier simplifier(1.0f);
+    auto ignore = [](PointF) {};
+
+    PointF from, to;
+    CHECK(!simplifier.GetPendingSegment(from, to));
+
+    simplifier.Add(PointF{ 0, 0 }, ignore);
+    CHECK(!simplifier.GetPendingSegment(from, to));
+
+    simplifier.Add(PointF{ 1, 0 }, ignore);
+    simplifier.Add(PointF{ 2, 0.1f }, ignore);
+    REQUIRE(simplifier.GetPendingSegment(from, to));
+    CHECK(SamePoint(from, PointF{ 0, 0 }));
+    CHECK(SamePoint(to, PointF{ 2, 0.1f }));
+
+    simplifier.Flush(ignore);
+    CHECK(!simplifier.GetPendingSegment(from, to));
+}
+
+TEST_CASE(Reset_HeldBackRun_IsDiscardedAndTheNextPointStartsAPolyline)
+{
+    PolylineSimplifier simplifier(1.0f);
+    std::vector<PointF> out;
+    auto emit = [&](PointF point) { out.push_back(point); };
+
+    simplifier.Add(PointF{ 0, 0 }, emit);
+    simplifier.Add(PointF{ 1, 0 }, emit);
+    simplifier.Reset();
+
+    simplifier.Add(PointF{ 50, 50 }, emit);
+    simplifier.Flush(emit);
+
+    REQUIRE(out.size() == 2);
+    CHECK(SamePoint(out[0], PointF{ 0, 0 }));
+    CHECK(SamePoint(out[1], PointF{ 50, 50 }));
+}
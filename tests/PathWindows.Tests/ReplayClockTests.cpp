@@ -0,0 +1,65 @@
+#include "TestHarness.h"
+#include "ReplayClock.h"
+
+using namespace PathWindows;
+
+TEST_CASE(GetTime_Paused_StaysPut)
+{
+    ReplayClock clock;
+
+    CHECK(!clock.IsPlaying());
+    CHECK(clock.GetTime(1'000) == 0);
+    CHECK(clock.GetTime(5'000'000) == 0);
+}
+
+TEST_CASE(GetTime_Playing_MovesWithTheClock)
+{
+    ReplayClock clock;
+    clock.Play(1'000);
+
+    CHECK(clock.IsPlaying());
+    CHECK(clock.GetTime(1'000) == 0);
+    CHECK(clock.GetTime(11'000) == 10'000);
+
+    // playing again does not restart it
+    clock.Play(11'000);
+    CHECK(clock.GetTime(21'000) == 20'000);
+}
+
+TEST_CASE(Pause_ThenPlay_GoesOnFromWhereItWas)
+{
+    ReplayClock clock;
+    clock.Play(0);
+    clock.Pause(300);
+    CHECK(clock.GetTime(10'000) == 300);
+
+    clock.Play(10'000);
+    CHECK(clock.GetTime(10'100) == 400);
+}
+
+TEST_CASE(SetSpeed_WhilePlaying_DoesNotJump)
+{
+    ReplayClock clock;
+    clock.Play(0);
+
+    clock.SetSpeed(4.0, 1'000);
+    CHECK(clock.GetTime(1'000) == 1'000);
+    CHECK(clock.GetTime(2'000) == 5'000);
+
+    clock.SetSpeed(0.5, 2'000);
+    CHECK(clock.GetTime(2'000) == 5'000);
+    CHECK(clock.GetTime(4'000) == 6'000);
+    CHECK(clock.GetSpeed() == 0.5);
+}
+
+TEST_CASE(Seek_PlayingOrPaused_JumpsThere)
+{
+    ReplayClock clock;
+    clock.Seek(7'000, 100);
+    CHECK(clock.GetTime(9'999) == 7'000);
+
+    clock.Play(200);
+    clock.Seek(50, 1'000);
+    CHECK(clock.GetTime(1'000) == 50);
+    CHECK(clock.GetTime(1'500) == 550);
+}
@@ -0,0 +1,155 @@
+#include "TestHarness.h"
+#include "ReplayTimeline.h"
+#include <cstdint>
+#include <random>
+#include <vector>
+
+using namespace PathWindows;
+
+namespace
+{
+    std::vector<Movement> MakePath(size_t count, uint32_t seed)
+    {
+        std::mt19937 random(seed);
+
+        std::vector<Movement> path(count);
+        for (size_t i = 0; i < count; ++i)
+        {
+            int64_t delay = random() % 20 == 0 ? 0 : static_cast<int64_t>(random() % 20'000'000);
+            path[i] = Movement{ PointI{ static_cast<int32_t>(i), static_cast<int32_t>(random() % 1080) }, delay };
+        }
+
+        return path;
+    }
+
+    // how many movements are made by timeNS, counted one by one
+    size_t CountMade(const std::vector<Movement>& path, int64_t timeNS)
+    {
+        int64_t time = 0;
+        for (size_t i = 0; i < path.size(); ++i)
+        {
+            time += path[i].delayDurationNS > 0 ? path[i].delayDurationNS : 0;
+            if (time > timeNS) return i;
+        }
+
+        return path.size();
+    }
+}
+
+TEST_CASE(Seek_Empty_FindsNothing)
+{
+    ReplayTimeline timeline;
+
+    CHECK(timeline.GetCount() == 0);
+    CHECK(timeline.GetDuration() == 0);
+    CHECK(timeline.Seek(0) == 0);
+    CHECK(timeline.Step(0, 1'000'000) == 0);
+}
+
+TEST_CASE(Assign_Delays_AreSummed)
+{
+    const Movement path[] = {
+        { PointI{ 1, 1 }, 0 },
+        { PointI{ 2, 2 }, 100 },
+        { PointI{ 3, 3 }, -50 },
+        { PointI{ 4, 4 }, 200 },
+    };
+
+    ReplayTimeline timeline;
+    timeline.Assign(path, 4);
+
+    CHECK(timeline.GetCount() == 4);
+    CHECK(timeline.GetTime(0) == 0 && timeline.GetTime(1) == 100 && timeline.GetTime(2) == 100 && timeline.GetTime(3) == 300);
+    CHECK(timeline.GetDuration() == 300);
+    CHECK(timeline.GetPosition(3).x == 4);
+
+    // a negative delay counts as none, so it starts a figure too
+    CHECK(timeline.StartsFigure(0));
+    CHECK(!timeline.StartsFigure(1));
+    CHECK(timeline.StartsFigure(2));
+    CHECK(!timeline.StartsFigure(3));
+}
+
+TEST_CASE(Seek_Times_CountsWhatWasMadeByThen)
+{
+    const Movement path[] = {
+        { PointI{}, 0 },
+        { PointI{}, 100 },
+        { PointI{}, 100 },
+        { PointI{}, 0 },
+        { PointI{}, 100 },
+    };
+
+    ReplayTimeline timeline;
+    timeline.Assign(path, 5);
+
+    CHECK(timeline.Seek(-1) == 0);
+    CHECK(timeline.Seek(0) == 1);
+    CHECK(timeline.Seek(99) == 1);
+    CHECK(timeline.Seek(100) == 2);
+    // the movement without a delay is made together with the one before it
+    CHECK(timeline.Seek(200) == 4);
+    CHECK(timeline.Seek(300) == 5);
+    CHECK(timeline.Seek(INT64_MAX) == 5);
+}
+
+TEST_CASE(Seek_Random_MatchesCountingOneByOne)
+{
+    std::vector<Movement> path = MakePath(5000, 1);
+    ReplayTimeline timeline;
+    timeline.Assign(path.data(), path.size());
+
+    std::mt19937 random(2);
+    for (int i = 0; i < 2000; ++i)
+    {
+        int64_t time = static_cast<int64_t>(random() % static_cast<uint64_t>(timeline.GetDuration() + 1000));
+        CHECK(timeline.Seek(time) == CountMade(path, time));
+    }
+}
+
+// Frames of any length, forwards, with the odd jump back, must find what Seek finds.
+TEST_CASE(Step_FramesAndJumps_MatchesSeek)
+{
+    std::vector<Movement> path = MakePath(5000, 3);
+    ReplayTimeline timeline;
+    timeline.Assign(path.data(), path.size());
+
+    std::mt19937 random(4);
+    int64_t time = -1000;
+    size_t reached = 0;
+
+    while (time <= timeline.GetDuration() + 1'000'000)
+    {
+        uint32_t kind = random() % 20;
+        if (kind == 0) time -= static_cast<int64_t>(random() % 500'000'000);
+        else if (kind == 1) time += static_cast<int64_t>(random() % 2'000'000'000);
+        else time += static_cast<int64_t>(random() % 16'000'000);
+
+        reached = timeline.Step(reached, time);
+        REQUIRE(reached == timeline.Seek(time));
+    }
+
+    CHECK(reached == timeline.GetCount());
+}
+
+TEST_CASE(Step_ReachedPastTheEnd_SeeksFromScratch)
+{
+    std::vector<Movement> path = MakePath(100, 5);
+    ReplayTimeline timeline;
+    timeline.Assign(path.data(), path.size());
+
+    // e.g. after the path was replaced by a shorter one
+    CHECK(timeline.Step(1000, timeline.GetTime(50)) == timeline.Seek(timeline.GetTime(50)));
+}
+
+TEST_CASE(Clear_Assigned_IsEmpty)
+{
+    std::vector<Movement> path = MakePath(100, 6);
+    ReplayTimeline timeline;
+    timeline.Assign(path.data(), path.size());
+    timeline.Clear();
+
+    CHECK(timeline.GetCount() == 0);
+    CHECK(timeline.GetDuration() == 0);
+    CHECK(timeline.Seek(INT64_MAX) == 0);
+}
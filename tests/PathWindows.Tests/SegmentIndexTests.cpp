@@ -0,0 +1,150 @@
+#include "TestHarness.h"
+#include "SegmentIndex.h"
+#include <algorithm>
+#include <cstdint>
+#include <random>
+#include <vector>
+
+using namespace PathWindows;
+
+namespace
+{
+    struct Segment
+    {
+        PointF a;
+        PointF b;
+    };
+
+    // Whether the segment passes through the box, by clipping it to the box (Liang-Barsky).
+    bool Intersects(const Segment& segment, PointF min, PointF max)
+    {
+        double t0 = 0.0, t1 = 1.0;
+        double dx = segment.b.x - segment.a.x;
+        double dy = segment.b.y - segment.a.y;
+
+        const double p[4] = { -dx, dx, -dy, dy };
+        const double q[4] = { segment.a.x - min.x, max.x - segment.a.x, segment.a.y - min.y, max.y - segment.a.y };
+
+        for (int i = 0; i < 4; ++i)
+        {
+            if (p[i] == 0.0)
+            {
+                if (q[i] < 0.0) return false;
+                continue;
+            }
+
+            double t = q[i] / p[i];
+            if (p[i] < 0.0) t0 = (std::max)(t0, t);
+            else t1 = (std::min)(t1, t);
+        }
+
+        return t0 <= t1;
+    }
+
+    std::vector<uint32_t> GetCandidates(const SegmentIndex& index, PointF min, PointF max)
+    {
+        std::vector<uint32_t> ids;
+        index.ForEachCandidate(min, max, [&ids](uint32_t id) { ids.push_back(id); });
+
+        std::sort(ids.begin(), ids.end());
+        ids.erase(std::unique(ids.begin(), ids.end()), ids.end());
+        return ids;
+    }
+
+    bool Contains(const std::vector<uint32_t>& ids, uint32_t id)
+    {
+        return std::binary_search(ids.begin(), ids.end(), id);
+    }
+}
+
+TEST_CASE(ForEachCandidate_Empty_FindsNothing)
+{
+    SegmentIndex index(640, 480);
+    CHECK(GetCandidates(index, PointF{ -1e9f, -1e9f }, PointF{ 1e9f, 1e9f }).empty());
+    CHECK(index.GetCount() == 0);
+}
+
+TEST_CASE(ForEachCandidate_FarAwayBox_SkipsTheSegment)
+{
+    SegmentIndex index(640, 480, 32);
+    index.Insert(7, PointF{ 10, 10 }, PointF{ 20, 12 });
+
+    CHECK(Contains(GetCandidates(index, PointF{ 15, 5 }, PointF{ 16, 20 }), 7));
+    CHECK(!Contains(GetCandidates(index, PointF{ 300, 300 }, PointF{ 310, 310 }), 7));
+}
+
+TEST_CASE(Insert_PointSegment_IsFoundWhereItIs)
+{
+    SegmentIndex index(640, 480, 32);
+    index.Insert(3, PointF{ 100, 200 }, PointF{ 100, 200 });
+
+    CHECK(Contains(GetCandidates(index, PointF{ 99, 199 }, PointF{ 101, 201 }), 3));
+    CHECK(index.GetCount() == 1);
+}
+
+TEST_CASE(Insert_OffTheSurface_LandsInTheBorderCells)
+{
+    SegmentIndex index(640, 480, 32);
+    index.Insert(1, PointF{ -5000, -5000 }, PointF{ -4000, -4990 });
+    index.Insert(2, PointF{ 1e20f, 240 }, PointF{ 1e20f, 250 });
+
+    CHECK(Contains(GetCandidates(index, PointF{ -4500, -5000 }, PointF{ -4490, -4990 }), 1));
+    CHECK(Contains(GetCandidates(index, PointF{ 1e20f, 240 }, PointF{ 1e20f, 245 }), 2));
+}
+
+TEST_CASE(Remove_Inserted_IsNoLongerACandidate)
+{
+    SegmentIndex index(640, 480, 32);
+    index.Insert(1, PointF{ 0, 0 }, PointF{ 639, 479 });
+    index.Insert(2, PointF{ 639, 0 }, PointF{ 0, 479 });
+
+    index.Remove(1, PointF{ 0, 0 }, PointF{ 639, 479 });
+    CHECK(index.GetCount() == 1);
+
+    std::vector<uint32_t> ids = GetCandidates(index, PointF{ -1, -1 }, PointF{ 640, 480 });
+    CHECK(ids.size() == 1 && ids[0] == 2);
+
+    index.Clear();
+    CHECK(index.GetCount() == 0);
+    CHECK(GetCandidates(index, PointF{ -1, -1 }, PointF{ 640, 480 }).empty());
+}
+
+// Every segment that passes through a box has to be a candidate, for segments of every length and direction, some
+// of them reaching off the surface, and boxes of every size.
+TEST_CASE(ForEachCandidate_RandomSegments_FindsEveryOneThatPassesThrough)
+{
+    std::mt19937 random(1);
+    std::uniform_real_distribution<float> coordinate(-100.0f, 740.0f);
+    std::uniform_real_distribution<float> size(0.0f, 60.0f);
+
+    for (int32_t cellSize : { 1, 7, 32, 100 })
+    {
+        SegmentIndex index(640, 480, cellSize);
+
+        std::vector<Segment> segments;
+        for (uint32_t id = 0; id < 500; ++id)
+        {
+            PointF a{ coordinate(random), coordinate(random) };
+            PointF b = random() % 3 == 0 ? a : PointF{ a.x + size(random) * 4 - 120, a.y + size(random) * 4 - 120 };
+            segments.push_back(Segment{ a, b });
+            index.Insert(id, a, b);
+        }
+
+        // removing some of them again must leave the others alone
+        for (uint32_t id = 0; id < 500; id += 5) index.Remove(id, segments[id].a, segments[id].b);
+        CHECK(index.GetCount() == 400);
+
+        for (int query = 0; query < 500; ++query)
+        {
+            PointF min{ coordinate(random), coordinate(random) };
+            PointF max{ min.x + size(random), min.y + size(random) };
+            std::vector<uint32_t> ids = GetCandidates(index, min, max);
+
+            for (uint32_t id = 0; id < 500; ++id)
+            {
+                if (id % 5 == 0) CHECK(!Contains(ids, id));
+                else if (Intersects(segments[id], min, max)) CHECK(Contains(ids, id));
+            }
+        }
+    }
+}
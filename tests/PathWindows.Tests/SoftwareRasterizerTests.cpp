@@ -0,0 +1,201 @@
+#include "TestHarness.h"
+#include "GoldenImage.h"
+#include "SoftwareRasterizer.h"
+#include <vector>
+
+using namespace PathWindows;
+using namespace PathWindows::Tests;
+
+// The golden images are drawn with the calls SoftwareRenderBackend makes for a frame (which needs GDI for its bitmap
+// itself): Clear, SetClip for a pushed clip, AddPolyline with the stroke width and FillStroke with the stroke color for
+// every stroke, and DiscardStroke and SetClip back to the bitmap at the end of the frame.
+
+namespace
+{
+    // what PathWindow draws with
+    constexpr float STROKE_WIDTH = 3.0f;
+    constexpr ColorF STROKE_COLOR{ 1.0f, 0.0f, 0.0f, 0.7f };
+    constexpr ColorF TRANSPARENT{ 0.0f, 0.0f, 0.0f, 0.0f };
+
+    // the frame starts like PathWindow's, a transparent bitmap
+    void BeginFrame(SoftwareRasterizer& rasterizer, Bitmap& bitmap)
+    {
+        rasterizer.SetTarget(bitmap.GetBytes(), bitmap.width, bitmap.height, bitmap.width * 4);
+        rasterizer.Clear(TRANSPARENT);
+    }
+
+    void DrawStroke(SoftwareRasterizer& rasterizer, const std::vector<PointF>& points, ColorF color = STROKE_COLOR)
+    {
+        rasterizer.AddPolyline(points.data(), points.size(), STROKE_WIDTH);
+        rasterizer.FillStroke(color);
+    }
+
+    void EndFrame(SoftwareRasterizer& rasterizer)
+    {
+        rasterizer.DiscardStroke();
+        rasterizer.SetClip(RectI{ 0, 0, rasterizer.GetWidth(), rasterizer.GetHeight() });
+    }
+}
+
+TEST_CASE(Clear_Transparent_ZeroesEveryPixel)
+{
+    SoftwareRasterizer rasterizer;
+    Bitmap bitmap(8, 4);
+    BeginFrame(rasterizer, bitmap);
+
+    for (uint32_t pixel : bitmap.pixels) CHECK(pixel == 0);
+}
+
+TEST_CASE(Clear_Rect_OnlyFillsTheRectWithPremultipliedColor)
+{
+    SoftwareRasterizer rasterizer;
+    Bitmap bitmap(8, 4);
+    BeginFrame(rasterizer, bitmap);
+
+    rasterizer.Clear(RectI{ 2, 1, 4, 3 }, ColorF{ 1.0f, 0.0f, 0.0f, 0.5f });
+
+    CHECK(bitmap.At(2, 1) == 0x80800000);
+    CHECK(bitmap.At(3, 2) == 0x80800000);
+    CHECK(bitmap.At(4, 2) == 0);
+    CHECK(bitmap.At(2, 0) == 0);
+}
+
+TEST_CASE(FillStroke_HorizontalLine_IsOpaqueAlongItsMiddleAndSymmetric)
+{
+    SoftwareRasterizer rasterizer;
+    Bitmap bitmap(32, 16);
+    BeginFrame(rasterizer, bitmap);
+
+    DrawStroke(rasterizer, { PointF{ 4, 8 }, PointF{ 28, 8 } }, ColorF{ 1.0f, 0.0f, 0.0f, 1.0f });
+
+    // the line covers y 6.5 to 9.5
+    CHECK(bitmap.At(16, 7) == 0xFFFF0000);
+    CHECK(bitmap.At(16, 8) == 0xFFFF0000);
+    CHECK(Channel(bitmap.At(16, 6), 24) == Channel(bitmap.At(16, 9), 24));
+    CHECK(Channel(bitmap.At(16, 6), 24) > 0 && Channel(bitmap.At(16, 6), 24) < 255);
+    CHECK(bitmap.At(16, 4) == 0);
+    CHECK(bitmap.At(16, 11) == 0);
+}
+
+TEST_CASE(FillStroke_OverlappingSegments_AreBlendedOnce)
+{
+    SoftwareRasterizer rasterizer;
+    Bitmap bitmap(32, 32);
+    BeginFrame(rasterizer, bitmap);
+
+    // crosses itself at (16, 16), and goes back over its first segment
+    DrawStroke(rasterizer, { PointF{ 4, 4 }, PointF{ 28, 28 }, PointF{ 28, 4 }, PointF{ 4, 28 }, PointF{ 4, 4 }, PointF{ 28, 28 } });
+
+    uint32_t crossing = bitmap.At(16, 16);
+    uint32_t single = bitmap.At(28, 16);
+    CHECK(crossing == single);
+    CHECK(Channel(single, 24) == 179);
+}
+
+TEST_CASE(FillStroke_SecondStroke_BlendsOverTheFirst)
+{
+    SoftwareRasterizer rasterizer;
+    Bitmap bitmap(32, 16);
+    BeginFrame(rasterizer, bitmap);
+
+    DrawStroke(rasterizer, { PointF{ 4, 8 }, PointF{ 28, 8 } });
+    uint32_t once = bitmap.At(16, 8);
+    DrawStroke(rasterizer, { PointF{ 4, 8 }, PointF{ 28, 8 } });
+    uint32_t twice = bitmap.At(16, 8);
+
+    // 0.7 over 0.7 is 0.91
+    CHECK(Channel(once, 24) == 179);
+    CHECK(Channel(twice, 24) >= 231 && Channel(twice, 24) <= 233);
+}
+
+TEST_CASE(SetClip_Rect_StrokesOnlyCoverIt)
+{
+    SoftwareRasterizer rasterizer;
+    Bitmap bitmap(32, 16);
+    BeginFrame(rasterizer, bitmap);
+
+    rasterizer.SetClip(RectI{ 10, 0, 20, 16 });
+    DrawStroke(rasterizer, { PointF{ 0, 8 }, PointF{ 32, 8 } });
+    EndFrame(rasterizer);
+
+    CHECK(bitmap.At(9, 8) == 0);
+    CHECK(bitmap.At(10, 8) != 0);
+    CHECK(bitmap.At(19, 8) != 0);
+    CHECK(bitmap.At(20, 8) == 0);
+}
+
+TEST_CASE(DiscardStroke_AddedPolyline_IsNotBlended)
+{
+    SoftwareRasterizer rasterizer;
+    Bitmap bitmap(32, 16);
+    BeginFrame(rasterizer, bitmap);
+
+    const PointF points[] = { PointF{ 4, 8 }, PointF{ 28, 8 } };
+    rasterizer.AddPolyline(points, 2, STROKE_WIDTH);
+    rasterizer.DiscardStroke();
+    rasterizer.FillStroke(STROKE_COLOR);
+
+    for (uint32_t pixel : bitmap.pixels) CHECK(pixel == 0);
+}
+
+TEST_CASE(CopyPixels_RectPartlyOutside_CopiesWhatIsInside)
+{
+    SoftwareRasterizer rasterizer;
+    Bitmap bitmap(8, 8);
+    BeginFrame(rasterizer, bitmap);
+
+    std::vector<uint32_t> source(4 * 4);
+    for (size_t i = 0; i < source.size(); ++i) source[i] = 0xFF000000 | static_cast<uint32_t>(i);
+
+    rasterizer.CopyPixels(RectI{ -2, 6, 2, 10 }, source.data(), 4);
+
+    CHECK(bitmap.At(0, 6) == (0xFF000000 | 2));
+    CHECK(bitmap.At(1, 7) == (0xFF000000 | 7));
+    CHECK(bitmap.At(2, 6) == 0);
+    CHECK(bitmap.At(0, 5) == 0);
+}
+
+TEST_CASE(Golden_RoundJoins)
+{
+    SoftwareRasterizer rasterizer;
+    Bitmap bitmap(64, 48);
+    BeginFrame(rasterizer, bitmap);
+
+    DrawStroke(rasterizer, { PointF{ 6, 40 }, PointF{ 18, 8 }, PointF{ 30, 40 }, PointF{ 42, 8.5f }, PointF{ 58, 24.25f } });
+    EndFrame(rasterizer);
+
+    CHECK(MatchesGolden("RoundJoins", bitmap));
+}
+
+TEST_CASE(Golden_SeveralStrokesOverlapping)
+{
+    SoftwareRasterizer rasterizer;
+    Bitmap bitmap(64, 48);
+    BeginFrame(rasterizer, bitmap);
+
+    // a loop crossing itself, and a second figure over it
+    DrawStroke(rasterizer, { PointF{ 8, 8 }, PointF{ 56, 40 }, PointF{ 56, 8 }, PointF{ 8, 40 }, PointF{ 8, 8 } });
+    DrawStroke(rasterizer, { PointF{ 32, 2 }, PointF{ 33.5f, 46 } });
+    EndFrame(rasterizer);
+
+    CHECK(MatchesGolden("SeveralStrokesOverlapping", bitmap));
+}
+
+TEST_CASE(Golden_ClippedRedrawOverCopiedBackground)
+{
+    SoftwareRasterizer rasterizer;
+    Bitmap bitmap(64, 48);
+    BeginFrame(rasterizer, bitmap);
+
+    // a partial redraw: the dirty rect gets its background back, then the path is drawn clipped to it
+    std::vector<uint32_t> background(32 * 24);
+    for (size_t i = 0; i < background.size(); ++i) background[i] = (i / 32 + i % 32) % 2 ? 0x40404040 : 0;
+
+    RectI dirty{ 16, 12, 48, 36 };
+    rasterizer.CopyPixels(dirty, background.data(), 32);
+    rasterizer.SetClip(dirty);
+    DrawStroke(rasterizer, { PointF{ 2, 24 }, PointF{ 32.5f, 20 }, PointF{ 62, 30 } });
+    EndFrame(rasterizer);
+
+    CHECK(MatchesGolden("ClippedRedrawOverCopiedBackground", bitmap));
+}
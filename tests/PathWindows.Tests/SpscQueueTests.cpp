@@ -0,0 +1,124 @@
+#include "TestHarness.h"
+#include "SpscQueue.h"
+#include <algorithm>
+#include <cstdint>
+#include <thread>
+#include <vector>
+
+using namespace PathWindows;
+
+TEST_CASE(Constructor_Capacity_IsRoundedUpToAPowerOfTwo)
+{
+    CHECK(SpscQueue<int>(1).GetCapacity() == 1);
+    CHECK(SpscQueue<int>(3).GetCapacity() == 4);
+    CHECK(SpscQueue<int>(1000).GetCapacity() == 1024);
+    CHECK(SpscQueue<int>(1024).GetCapacity() == 1024);
+}
+
+TEST_CASE(TryPush_FullQueue_FailsUntilAnItemIsPopped)
+{
+    SpscQueue<int> queue(4);
+    for (int i = 0; i < 4; ++i) CHECK(queue.TryPush(i));
+
+    CHECK(!queue.TryPush(4));
+    CHECK(queue.GetSizeApprox() == 4);
+
+    int item = -1;
+    CHECK(queue.TryPop(item));
+    CHECK(item == 0);
+    CHECK(queue.TryPush(4));
+}
+
+TEST_CASE(TryPop_EmptyQueue_Fails)
+{
+    SpscQueue<int> queue(4);
+    int item = -1;
+    CHECK(!queue.TryPop(item));
+    CHECK(item == -1);
+
+    queue.TryPush(7);
+    CHECK(queue.TryPop(item));
+    CHECK(item == 7);
+    CHECK(!queue.TryPop(item));
+}
+
+TEST_CASE(TryPushRange_MoreThanFits_PushesWhatFitsAcrossTheWrap)
+{
+    SpscQueue<int> queue(8);
+
+    // moves the ring's start to 5, so the range has to wrap
+    int out[8];
+    const int first[] = { 0, 1, 2, 3, 4 };
+    CHECK(queue.TryPushRange(first, 5) == 5);
+    CHECK(queue.PopBatch(out, 5) == 5);
+
+    int items[10];
+    for (int i = 0; i < 10; ++i) items[i] = 100 + i;
+    CHECK(queue.TryPushRange(items, 10) == 8);
+    CHECK(queue.TryPushRange(items, 1) == 0);
+
+    REQUIRE(queue.PopBatch(out, 8) == 8);
+    for (int i = 0; i < 8; ++i) CHECK(out[i] == 100 + i);
+}
+
+TEST_CASE(PopBatch_FewerQueuedThanAsked_PopsWhatIsThere)
+{
+    SpscQueue<int> queue(16);
+    for (int i = 0; i < 3; ++i) queue.TryPush(i);
+
+    int out[10];
+    REQUIRE(queue.PopBatch(out, 10) == 3);
+    CHECK(out[0] == 0 && out[1] == 1 && out[2] == 2);
+    CHECK(queue.PopBatch(out, 10) == 0);
+}
+
+TEST_CASE(PushAndPop_ConcurrentProducerAndConsumer_KeepEveryItemInOrder)
+{
+    constexpr uint64_t COUNT = 500'000;
+
+    // small, so the ring wraps and fills up all the time
+    SpscQueue<uint64_t> queue(100);
+
+    std::thread producer([&]
+    {
+        uint64_t next = 0;
+        uint64_t batch[37];
+        while (next < COUNT)
+        {
+            size_t pushed;
+            if (next % 3 != 0)
+            {
+                pushed = queue.TryPush(next) ? 1 : 0;
+            }
+            else
+            {
+                uint64_t count = std::min<uint64_t>(37, COUNT - next);
+                for (uint64_t i = 0; i < count; ++i) batch[i] = next + i;
+                pushed = queue.TryPushRange(batch, count);
+            }
+
+            // lets the consumer catch up, even with a single core
+            if (pushed == 0) std::this_thread::yield();
+            next += pushed;
+        }
+    });
+
+    uint64_t expected = 0;
+    bool inOrder = true;
+    uint64_t out[64];
+    while (expected < COUNT)
+    {
+        size_t count = queue.PopBatch(out, (expected % 64) + 1);
+        for (size_t i = 0; i < count; ++i, ++expected)
+        {
+            if (out[i] != expected) inOrder = false;
+        }
+
+        if (count == 0) std::this_thread::yield();
+    }
+
+    producer.join();
+
+    CHECK(inOrder);
+    CHECK(queue.GetSizeApprox() == 0);
+}
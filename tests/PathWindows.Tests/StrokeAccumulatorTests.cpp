@@ -0,0 +1,213 @@
+#include "TestHarness.h"
+#include "StrokeAccumulator.h"
+#include <vector>
+
+using namespace PathWindows;
+
+namespace
+{
+    struct Run
+    {
+        std::vector<PointF> points;
+    };
+
+    std::vector<Run> GetPendingRuns(const StrokeAccumulator& accumulator)
+    {
+        std::vector<Run> runs;
+        accumulator.ForEachPendingRun([&](const PointF* points, size_t count) { runs.push_back(Run{ std::vector<PointF>(points, points + count) }); });
+        return runs;
+    }
+
+    bool IsAt(PointF point, float x, float y)
+    {
+        return point.x == x && point.y == y;
+    }
+
+    // a figure along y == figure, one point per x
+    void AppendFigure(StrokeAccumulator& accumulator, int figure, int firstX, int count)
+    {
+        for (int i = 0; i < count; ++i)
+        {
+            accumulator.Append(PointF{ static_cast<float>(firstX + i), static_cast<float>(figure) }, i == 0);
+        }
+    }
+}
+
+TEST_CASE(ForEachPendingRun_BeforeFirstCommit_DrawsEveryFigureWithASegment)
+{
+    StrokeAccumulator accumulator;
+    AppendFigure(accumulator, 0, 0, 3);
+    AppendFigure(accumulator, 1, 0, 1);
+    AppendFigure(accumulator, 2, 0, 2);
+
+    CHECK(accumulator.NeedsFullRedraw());
+    CHECK(accumulator.HasPending());
+
+    std::vector<Run> runs = GetPendingRuns(accumulator);
+    REQUIRE(runs.size() == 2);
+    CHECK(runs[0].points.size() == 3);
+    CHECK(runs[1].points.size() == 2);
+    CHECK(IsAt(runs[1].points[0], 0, 2));
+}
+
+TEST_CASE(ForEachPendingRun_AfterCommit_ContinuesFromTheLastStrokedPoint)
+{
+    StrokeAccumulator accumulator;
+    AppendFigure(accumulator, 0, 0, 4);
+    accumulator.Commit();
+
+    CHECK(!accumulator.NeedsFullRedraw());
+    CHECK(!accumulator.HasPending());
+    CHECK(GetPendingRuns(accumulator).empty());
+
+    accumulator.Append(PointF{ 4, 0 }, false);
+    accumulator.Append(PointF{ 5, 0 }, false);
+
+    std::vector<Run> runs = GetPendingRuns(accumulator);
+    REQUIRE(runs.size() == 1);
+    REQUIRE(runs[0].points.size() == 3);
+    CHECK(IsAt(runs[0].points[0], 3, 0));
+    CHECK(IsAt(runs[0].points[2], 5, 0));
+}
+
+TEST_CASE(ForEachPendingRun_NewFigureAfterCommit_OnlyDrawsTheNewFigure)
+{
+    StrokeAccumulator accumulator;
+    AppendFigure(accumulator, 0, 0, 4);
+    accumulator.Commit();
+
+    AppendFigure(accumulator, 1, 0, 1);
+    std::vector<Run> runs = GetPendingRuns(accumulator);
+    CHECK(runs.empty());
+    CHECK(accumulator.HasPending());
+
+    accumulator.Append(PointF{ 1, 1 }, false);
+    runs = GetPendingRuns(accumulator);
+    REQUIRE(runs.size() == 1);
+    REQUIRE(runs[0].points.size() == 2);
+    CHECK(IsAt(runs[0].points[0], 0, 1));
+}
+
+TEST_CASE(ForEachPendingRun_LongCommittedPath_OnlyVisitsTheNewTail)
+{
+    StrokeAccumulator accumulator;
+    AppendFigure(accumulator, 0, 0, 100'000);
+    accumulator.Commit();
+
+    for (int i = 0; i < 10; ++i) accumulator.Append(PointF{ static_cast<float>(100'000 + i), 0 }, false);
+
+    size_t pendingPoints = 0;
+    accumulator.ForEachPendingRun([&](const PointF*, size_t count) { pendingPoints += count; });
+
+    // the 10 new points and the last stroked point they join up with
+    CHECK(pendingPoints == 11);
+}
+
+TEST_CASE(Invalidate_AfterCommit_RedrawsEverything)
+{
+    StrokeAccumulator accumulator;
+    AppendFigure(accumulator, 0, 0, 5);
+    AppendFigure(accumulator, 1, 0, 5);
+    accumulator.Commit();
+
+    accumulator.Invalidate();
+
+    CHECK(accumulator.NeedsFullRedraw());
+    CHECK(accumulator.HasPending());
+    CHECK(GetPendingRuns(accumulator).size() == 2);
+}
+
+TEST_CASE(Clear_AfterCommit_StartsOverWithAFullRedraw)
+{
+    StrokeAccumulator accumulator;
+    AppendFigure(accumulator, 0, 0, 5);
+    accumulator.Commit();
+
+    accumulator.Clear();
+
+    CHECK(accumulator.NeedsFullRedraw());
+    CHECK(accumulator.GetFigureCount() == 0);
+    CHECK(accumulator.GetCommittedPointCount() == 0);
+    CHECK(GetPendingRuns(accumulator).empty());
+
+    AppendFigure(accumulator, 3, 0, 2);
+    std::vector<Run> runs = GetPendingRuns(accumulator);
+    REQUIRE(runs.size() == 1);
+    CHECK(IsAt(runs[0].points[0], 0, 3));
+}
+
+TEST_CASE(Split_WithinCommittedFigure_LaterAppendsContinueTheLastPiece)
+{
+    StrokeAccumulator accumulator;
+    AppendFigure(accumulator, 0, 0, 6);
+    accumulator.Commit();
+
+    // cuts the segment from point 2 to 3
+    const uint32_t cut[] = { 3 };
+    accumulator.Split(cut, 1);
+    CHECK(accumulator.GetFigureCount() == 2);
+    CHECK(accumulator.GetStore().StartsFigure(3));
+
+    accumulator.Append(PointF{ 6, 0 }, false);
+
+    std::vector<Run> runs = GetPendingRuns(accumulator);
+    REQUIRE(runs.size() == 1);
+    REQUIRE(runs[0].points.size() == 2);
+    CHECK(IsAt(runs[0].points[0], 5, 0));
+}
+
+TEST_CASE(Join_SplitFigure_PutsTheSegmentBack)
+{
+    StrokeAccumulator accumulator;
+    AppendFigure(accumulator, 0, 0, 6);
+
+    const uint32_t cut[] = { 2, 4 };
+    accumulator.Split(cut, 2);
+    CHECK(accumulator.GetFigureCount() == 3);
+
+    accumulator.Join(cut, 2);
+    CHECK(accumulator.GetFigureCount() == 1);
+
+    std::vector<Run> runs = GetPendingRuns(accumulator);
+    REQUIRE(runs.size() == 1);
+    CHECK(runs[0].points.size() == 6);
+}
+
+TEST_CASE(Truncate_BelowCommittedPoints_ContinuesFromTheNewEnd)
+{
+    StrokeAccumulator accumulator;
+    AppendFigure(accumulator, 0, 0, 4);
+    AppendFigure(accumulator, 1, 0, 4);
+    accumulator.Commit();
+
+    accumulator.Truncate(5);
+    CHECK(accumulator.GetCommittedPointCount() == 5);
+    CHECK(accumulator.GetStore().GetPointCount() == 5);
+    CHECK(!accumulator.HasPending());
+
+    accumulator.Append(PointF{ 1, 1 }, false);
+
+    std::vector<Run> runs = GetPendingRuns(accumulator);
+    REQUIRE(runs.size() == 1);
+    REQUIRE(runs[0].points.size() == 2);
+    CHECK(IsAt(runs[0].points[0], 0, 1));
+    CHECK(IsAt(runs[0].points[1], 1, 1));
+}
+
+TEST_CASE(Truncate_IntoEarlierFigure_DropsTheFiguresAfterIt)
+{
+    StrokeAccumulator accumulator;
+    AppendFigure(accumulator, 0, 0, 4);
+    AppendFigure(accumulator, 1, 0, 4);
+    accumulator.Commit();
+
+    accumulator.Truncate(3);
+    CHECK(accumulator.GetFigureCount() == 1);
+
+    accumulator.Append(PointF{ 3, 0 }, false);
+
+    std::vector<Run> runs = GetPendingRuns(accumulator);
+    REQUIRE(runs.size() == 1);
+    REQUIRE(runs[0].points.size() == 2);
+    CHECK(IsAt(runs[0].points[0], 2, 0));
+}
@@ -0,0 +1,278 @@
+#include "TestHarness.h"
+#include "StrokeLog.h"
+#include "ErasablePath.h"
+#include <cstdint>
+#include <random>
+#include <vector>
+
+using namespace PathWindows;
+
+namespace
+{
+    constexpr int64_t DELAY = 8'000'000;
+
+    Movement At(int32_t x, int32_t y, int64_t delay = DELAY)
+    {
+        return Movement{ PointI{ x, y }, delay };
+    }
+
+    std::vector<StrokeLog::IndexRange> ToVector(const StrokeLog::IndexRange* ranges, size_t count)
+    {
+        return std::vector<StrokeLog::IndexRange>(ranges, ranges + count);
+    }
+
+    bool Equal(const std::vector<StrokeLog::IndexRange>& ranges, std::initializer_list<StrokeLog::IndexRange> expected)
+    {
+        if (ranges.size() != expected.size()) return false;
+
+        size_t i = 0;
+        for (const StrokeLog::IndexRange& range : expected)
+        {
+            if (ranges[i].first != range.first || ranges[i].end != range.end) return false;
+            ++i;
+        }
+
+        return true;
+    }
+
+    bool Equal(const std::vector<Movement>& a, const std::vector<Movement>& b)
+    {
+        if (a.size() != b.size()) return false;
+
+        for (size_t i = 0; i < a.size(); ++i)
+        {
+            if (a[i].delta.x != b[i].delta.x || a[i].delta.y != b[i].delta.y || a[i].delayDurationNS != b[i].delayDurationNS) return false;
+        }
+
+        return true;
+    }
+
+    // Applies a change to the path the way DrawablePathWindow does, taking it back if undo is set.
+    void Apply(ErasablePath& path, const StrokeLog& log, const StrokeLog::Change& change, bool undo)
+    {
+        std::vector<uint32_t> segments, points;
+        for (size_t i = 0; i < change.segmentRangeCount; ++i)
+        {
+            for (uint32_t index = change.segments[i].first; index < change.segments[i].end; ++index) segments.push_back(index);
+        }
+        for (size_t i = 0; i < change.pointRangeCount; ++i)
+        {
+            for (uint32_t index = change.points[i].first; index < change.points[i].end; ++index) points.push_back(index);
+        }
+
+        if (change.strokeEnd > change.strokeBegin)
+        {
+            if (undo) path.Truncate(change.strokeBegin);
+            else for (size_t i = change.strokeBegin; i < change.strokeEnd; ++i) path.Append(log.GetMovements()[i]);
+        }
+        else if (undo) path.Restore(segments.data(), segments.size(), points.data(), points.size());
+        else path.Remove(segments.data(), segments.size(), points.data(), points.size());
+    }
+}
+
+TEST_CASE(Undo_Empty_HasNothingToTakeBack)
+{
+    StrokeLog log;
+    StrokeLog::Change change;
+
+    CHECK(!log.Undo(change));
+    CHECK(!log.Redo(change));
+    CHECK(log.GetSize() == 0);
+    CHECK(log.GetUndoCount() == 0 && log.GetRedoCount() == 0);
+}
+
+TEST_CASE(Reset_Path_CanNotBeUndone)
+{
+    const Movement path[] = { At(0, 0, 0), At(1, 1), At(2, 2) };
+
+    StrokeLog log;
+    log.BeginStroke();
+    log.Append(At(9, 9));
+    log.Reset(path, 3);
+
+    StrokeLog::Change change;
+    CHECK(!log.Undo(change));
+    CHECK(log.GetSize() == 3);
+    CHECK(log.GetMovements()[2].delta.x == 2);
+}
+
+TEST_CASE(Undo_Strokes_TakesThemBackOneAtATime)
+{
+    StrokeLog log;
+    log.BeginStroke();
+    log.Append(At(0, 0, 0));
+    log.Append(At(1, 0));
+    log.BeginStroke();
+    log.Append(At(5, 5, 0));
+
+    CHECK(log.GetUndoCount() == 2);
+    const Movement* movements = log.GetMovements();
+
+    StrokeLog::Change change;
+    REQUIRE(log.Undo(change));
+    CHECK(change.strokeBegin == 2 && change.strokeEnd == 3);
+    CHECK(change.segmentRangeCount == 0 && change.pointRangeCount == 0);
+    CHECK(log.GetSize() == 2);
+
+    REQUIRE(log.Undo(change));
+    CHECK(change.strokeBegin == 0 && change.strokeEnd == 2);
+    CHECK(log.GetSize() == 0);
+    CHECK(!log.Undo(change));
+
+    REQUIRE(log.Redo(change));
+    CHECK(change.strokeBegin == 0 && change.strokeEnd == 2);
+    CHECK(log.GetSize() == 2);
+    CHECK(log.GetRedoCount() == 1);
+
+    // moving the cursor never touches the buffer
+    CHECK(log.GetMovements() == movements);
+}
+
+TEST_CASE(Append_AfterUndo_DropsTheRedo)
+{
+    StrokeLog log;
+    log.Append(At(0, 0, 0));
+    log.Append(At(1, 0));
+
+    StrokeLog::Change change;
+    log.Undo(change);
+    CHECK(log.GetRedoCount() == 1);
+
+    // a stroke of its own, even without BeginStroke
+    log.Append(At(7, 7, 0));
+    CHECK(log.GetRedoCount() == 0);
+    CHECK(log.GetUndoCount() == 1);
+    CHECK(log.GetSize() == 1);
+    CHECK(log.GetMovements()[0].delta.x == 7);
+    CHECK(!log.Redo(change));
+}
+
+TEST_CASE(Erase_Indices_AreSortedIntoRanges)
+{
+    StrokeLog log;
+    for (int32_t i = 0; i < 10; ++i) log.Append(At(i, 0, i == 0 ? 0 : DELAY));
+
+    std::vector<uint32_t> segments = { 5, 3, 4, 8, 4 };
+    std::vector<uint32_t> points = { 9 };
+    log.Erase(segments, points, false);
+    CHECK(log.GetUndoCount() == 2);
+    CHECK(log.GetSize() == 10);
+
+    StrokeLog::Change change;
+    REQUIRE(log.Undo(change));
+    CHECK(change.strokeBegin == change.strokeEnd);
+    CHECK(Equal(ToVector(change.segments, change.segmentRangeCount), { { 3, 6 }, { 8, 9 } }));
+    CHECK(Equal(ToVector(change.points, change.pointRangeCount), { { 9, 10 } }));
+}
+
+TEST_CASE(Erase_Merged_IsUndoneAtOnce)
+{
+    StrokeLog log;
+    for (int32_t i = 0; i < 10; ++i) log.Append(At(i, 0, i == 0 ? 0 : DELAY));
+
+    std::vector<uint32_t> segments = { 2 }, points;
+    log.Erase(segments, points, false);
+    segments = { 3 };
+    log.Erase(segments, points, true);
+    segments = { 7 };
+    log.Erase(segments, points, true);
+    CHECK(log.GetUndoCount() == 2);
+
+    // a drag that starts again is a step of its own, and does not join its ranges with the one before
+    segments = { 8 };
+    log.Erase(segments, points, false);
+    CHECK(log.GetUndoCount() == 3);
+
+    StrokeLog::Change change;
+    REQUIRE(log.Undo(change));
+    CHECK(Equal(ToVector(change.segments, change.segmentRangeCount), { { 8, 9 } }));
+
+    REQUIRE(log.Undo(change));
+    CHECK(Equal(ToVector(change.segments, change.segmentRangeCount), { { 2, 4 }, { 7, 8 } }));
+
+    // merging after an undo starts a new step
+    segments = { 5 };
+    log.Erase(segments, points, true);
+    CHECK(log.GetUndoCount() == 2);
+    CHECK(log.GetRedoCount() == 0);
+}
+
+TEST_CASE(Erase_AfterAStroke_DoesNotMergeIntoIt)
+{
+    StrokeLog log;
+    log.Append(At(0, 0, 0));
+    log.Append(At(1, 0));
+
+    std::vector<uint32_t> segments = { 1 }, points;
+    log.Erase(segments, points, true);
+    CHECK(log.GetUndoCount() == 2);
+
+    // and a stroke after the erase is a new step too
+    log.Append(At(2, 0));
+    CHECK(log.GetUndoCount() == 3);
+}
+
+// Draws and erases at random, undoing and redoing in between, and applies every change to an ErasablePath the way the
+// window does. Whatever the cursor points at, the path has to be what it was when the cursor was last there.
+TEST_CASE(UndoRedo_Random_RestoresEveryState)
+{
+    std::mt19937 random(1);
+
+    StrokeLog log;
+    ErasablePath path(640, 480);
+
+    std::vector<uint32_t> segments, points;
+    std::vector<std::vector<Movement>> states(1);
+    std::vector<Movement> current;
+
+    for (int round = 0; round < 600; ++round)
+    {
+        StrokeLog::Change change;
+        uint32_t action = random() % 10;
+
+        if (action < 4)
+        {
+            log.BeginStroke();
+            int32_t x = random() % 640, y = random() % 480;
+            for (int i = 0, count = 2 + random() % 20; i < count; ++i)
+            {
+                Movement movement = At(x + random() % 40, y + random() % 40, i == 0 ? 0 : DELAY);
+                log.Append(movement);
+                path.Append(movement);
+            }
+        }
+        else if (action < 6)
+        {
+            segments.clear();
+            points.clear();
+            PointF at{ float(random() % 640), float(random() % 480) };
+            path.Erase(at, at, 30, segments, points);
+
+            // a drag that erased nothing is no step, as in the window
+            if (segments.empty() && points.empty()) continue;
+            log.Erase(segments, points, random() % 2 == 0);
+        }
+        else if (action < 8)
+        {
+            if (log.Undo(change)) Apply(path, log, change, true);
+        }
+        else
+        {
+            if (log.Redo(change)) Apply(path, log, change, false);
+        }
+
+        path.CopyTo(current);
+        size_t cursor = log.GetUndoCount();
+
+        // a new step (or one merged into) replaces what could have been redone
+        if (action < 6)
+        {
+            states.resize(cursor + 1);
+            states[cursor] = current;
+        }
+
+        REQUIRE(cursor < states.size());
+        CHECK(Equal(current, states[cursor]));
+        CHECK(log.GetUndoCount() + log.GetRedoCount() + 1 == states.size());
+    }
+}
@@ -0,0 +1,225 @@
+#include "TestHarness.h"
+#include "StrokeResampler.h"
+#include <cmath>
+#include <cstdint>
+#include <random>
+#include <vector>
+
+using namespace PathWindows;
+
+namespace
+{
+    // both ends of a step are rounded to whole pixels, each by up to half a pixel on either axis
+    const float ROUNDING_SLACK = std::sqrt(2.0f);
+
+    ResampleOptions MakeOptions(Interpolation interpolation, Easing easing, float maxStepLength = 2.0f)
+    {
+        return ResampleOptions{ maxStepLength, 1'000'000.0, interpolation, easing };
+    }
+
+    // drawn strokes like the window records them: a start with a delay of 0, then samples up to 40 pixels apart
+    std::vector<Movement> MakeStrokes(size_t strokeCount, size_t pointsPerStroke, uint32_t seed)
+    {
+        std::mt19937 random(seed);
+        std::uniform_int_distribution<int32_t> start(0, 1900);
+        std::uniform_int_distribution<int32_t> step(-40, 40);
+
+        std::vector<Movement> path;
+        for (size_t stroke = 0; stroke < strokeCount; ++stroke)
+        {
+            PointI position{ start(random), start(random) };
+            path.push_back(Movement{ position, 0 });
+
+            for (size_t i = 1; i < pointsPerStroke; ++i)
+            {
+                position.x += step(random);
+                position.y += step(random);
+                path.push_back(Movement{ position, 1 });
+            }
+        }
+
+        return path;
+    }
+
+    float Distance(PointI a, PointI b)
+    {
+        float dx = static_cast<float>(b.x - a.x);
+        float dy = static_cast<float>(b.y - a.y);
+        return std::sqrt(dx * dx + dy * dy);
+    }
+
+    // Checks that no step within a stroke is longer than the max, and that only stroke starts have a delay of 0.
+    void CheckSteps(const std::vector<Movement>& out, float maxStepLength)
+    {
+        for (size_t i = 1; i < out.size(); ++i)
+        {
+            if (out[i].delayDurationNS == 0) continue;
+
+            CHECK(Distance(out[i - 1].delta, out[i].delta) <= maxStepLength + ROUNDING_SLACK);
+            CHECK(out[i].delayDurationNS > 0);
+        }
+    }
+
+    // the sum of the delays of every stroke
+    std::vector<int64_t> GetStrokeDurations(const std::vector<Movement>& path)
+    {
+        std::vector<int64_t> durations;
+        for (const Movement& movement : path)
+        {
+            if (movement.delayDurationNS == 0) durations.push_back(0);
+            else durations.back() += movement.delayDurationNS;
+        }
+
+        return durations;
+    }
+
+    std::vector<double> GetStrokeLengths(const std::vector<Movement>& path)
+    {
+        std::vector<double> lengths;
+        for (size_t i = 0; i < path.size(); ++i)
+        {
+            if (path[i].delayDurationNS == 0) lengths.push_back(0.0);
+            else lengths.back() += Distance(path[i - 1].delta, path[i].delta);
+        }
+
+        return lengths;
+    }
+}
+
+TEST_CASE(Resample_Linear_NoStepIsLongerThanTheMax)
+{
+    for (float maxStepLength : { 1.0f, 2.0f, 5.5f })
+    {
+        std::vector<Movement> path = MakeStrokes(20, 200, 1);
+        std::vector<Movement> out;
+        StrokeResampler(MakeOptions(Interpolation::LINEAR, Easing::CONSTANT, maxStepLength)).Resample(path.data(), path.size(), nullptr, out);
+
+        CheckSteps(out, maxStepLength);
+    }
+}
+
+TEST_CASE(Resample_CatmullRom_NoStepIsLongerThanTheMax)
+{
+    for (float maxStepLength : { 1.0f, 2.0f, 5.5f })
+    {
+        std::vector<Movement> path = MakeStrokes(20, 200, 2);
+        std::vector<Movement> out;
+        StrokeResampler(MakeOptions(Interpolation::CATMULL_ROM, Easing::EASE_IN_OUT, maxStepLength)).Resample(path.data(), path.size(), nullptr, out);
+
+        CheckSteps(out, maxStepLength);
+    }
+}
+
+TEST_CASE(Resample_Linear_PassesThroughEveryDrawnPointInOrder)
+{
+    std::vector<Movement> path = MakeStrokes(5, 100, 3);
+    std::vector<Movement> out;
+    StrokeResampler(MakeOptions(Interpolation::LINEAR, Easing::CONSTANT)).Resample(path.data(), path.size(), nullptr, out);
+
+    size_t next = 0;
+    for (const Movement& movement : out)
+    {
+        if (next < path.size() && movement.delta.x == path[next].delta.x && movement.delta.y == path[next].delta.y) ++next;
+    }
+
+    // drawn points on the same pixel as the one before are merged away, there are none in these strokes by chance
+    CHECK(next == path.size());
+}
+
+TEST_CASE(Resample_SeveralStrokes_KeepsTheirStartsAsJumps)
+{
+    std::vector<Movement> path = MakeStrokes(7, 50, 4);
+    std::vector<Movement> out;
+    StrokeResampler(MakeOptions(Interpolation::CATMULL_ROM, Easing::CONSTANT)).Resample(path.data(), path.size(), nullptr, out);
+
+    std::vector<Movement> starts;
+    for (const Movement& movement : out)
+    {
+        if (movement.delayDurationNS == 0) starts.push_back(movement);
+    }
+
+    REQUIRE(starts.size() == 7);
+    for (size_t i = 0; i < 7; ++i) CHECK(starts[i].delta.x == path[i * 50].delta.x && starts[i].delta.y == path[i * 50].delta.y);
+}
+
+TEST_CASE(Resample_ConstantSpeed_StrokeTakesItsLengthTimesTheSpeed)
+{
+    std::vector<Movement> path = MakeStrokes(10, 300, 5);
+    std::vector<Movement> out;
+    ResampleOptions options = MakeOptions(Interpolation::LINEAR, Easing::CONSTANT);
+    StrokeResampler(options).Resample(path.data(), path.size(), nullptr, out);
+
+    // the densified stroke follows the drawn one, so it is as long, up to float rounding
+    std::vector<double> lengths = GetStrokeLengths(path);
+    std::vector<int64_t> durations = GetStrokeDurations(out);
+
+    REQUIRE(durations.size() == lengths.size());
+    for (size_t i = 0; i < lengths.size(); ++i)
+    {
+        double expected = lengths[i] * options.nsPerPixel;
+        CHECK(std::fabs(static_cast<double>(durations[i]) - expected) <= expected * 1e-5);
+    }
+}
+
+TEST_CASE(Resample_EaseInOut_TakesAsLongAsConstantSpeed)
+{
+    std::vector<Movement> path = MakeStrokes(10, 300, 6);
+
+    for (Interpolation interpolation : { Interpolation::LINEAR, Interpolation::CATMULL_ROM })
+    {
+        std::vector<Movement> constant;
+        std::vector<Movement> eased;
+        StrokeResampler(MakeOptions(interpolation, Easing::CONSTANT)).Resample(path.data(), path.size(), nullptr, constant);
+        StrokeResampler(MakeOptions(interpolation, Easing::EASE_IN_OUT)).Resample(path.data(), path.size(), nullptr, eased);
+
+        std::vector<int64_t> constantDurations = GetStrokeDurations(constant);
+        std::vector<int64_t> easedDurations = GetStrokeDurations(eased);
+
+        REQUIRE(constantDurations.size() == easedDurations.size());
+        for (size_t i = 0; i < constantDurations.size(); ++i)
+        {
+            // delays are timestamps rounded to whole nanoseconds, so both are off by less than one
+            CHECK(std::llabs(constantDurations[i] - easedDurations[i]) <= 1);
+        }
+    }
+}
+
+TEST_CASE(Resample_EaseInOut_IsSlowerAtTheEndsThanInTheMiddle)
+{
+    const Movement path[] = { Movement{ PointI{ 0, 0 }, 0 }, Movement{ PointI{ 1000, 0 }, 1 } };
+    std::vector<Movement> out;
+    StrokeResampler(MakeOptions(Interpolation::LINEAR, Easing::EASE_IN_OUT, 1.0f)).Resample(path, 2, nullptr, out);
+
+    REQUIRE(out.size() == 1001);
+    CHECK(out[1].delayDurationNS > 5 * out[500].delayDurationNS);
+    CHECK(out[1000].delayDurationNS > 5 * out[500].delayDurationNS);
+}
+
+TEST_CASE(Resample_Anchor_ContinuesTheFirstStrokeFromIt)
+{
+    const Movement path[] = { Movement{ PointI{ 10, 0 }, 1 }, Movement{ PointI{ 20, 0 }, 1 } };
+    const PointI anchor{ 0, 0 };
+    std::vector<Movement> out;
+    StrokeResampler(MakeOptions(Interpolation::LINEAR, Easing::CONSTANT, 5.0f)).Resample(path, 2, &anchor, out);
+
+    REQUIRE(out.size() == 4);
+    CHECK(out[0].delta.x == 5 && out[0].delayDurationNS == 5'000'000);
+    CHECK(out[3].delta.x == 20);
+
+    // without one it is a stroke of its own
+    out.clear();
+    StrokeResampler(MakeOptions(Interpolation::LINEAR, Easing::CONSTANT, 5.0f)).Resample(path, 2, nullptr, out);
+    REQUIRE(!out.empty());
+    CHECK(out[0].delta.x == 10 && out[0].delayDurationNS == 0);
+}
+
+TEST_CASE(Resample_StepsWithinOnePixel_AreMergedWithTheirTime)
+{
+    const Movement path[] = { Movement{ PointI{ 0, 0 }, 0 }, Movement{ PointI{ 3, 0 }, 1 } };
+    std::vector<Movement> out;
+    StrokeResampler(MakeOptions(Interpolation::LINEAR, Easing::CONSTANT, 0.25f)).Resample(path, 2, nullptr, out);
+
+    REQUIRE(out.size() == 4);
+    for (size_t i = 1; i < 4; ++i) CHECK(out[i].delta.x == static_cast<int32_t>(i));
+    CHECK(GetStrokeDurations(out)[0] == 3'000'000);
+}
@@ -0,0 +1,159 @@
+#include "TestHarness.h"
+#include "Telemetry.h"
+#include <cstdint>
+#include <thread>
+#include <vector>
+
+using namespace PathWindows;
+
+namespace
+{
+    HistogramSnapshot GetSnapshot(const Histogram& histogram)
+    {
+        HistogramSnapshot snapshot{};
+        histogram.CopyTo(snapshot);
+        return snapshot;
+    }
+}
+
+TEST_CASE(BitWidth_PowersOfTwo_AreTheirExponentPlusOne)
+{
+    CHECK(Histogram::BitWidth(0) == 0);
+    CHECK(Histogram::BitWidth(1) == 1);
+    CHECK(Histogram::BitWidth(2) == 2);
+    CHECK(Histogram::BitWidth(3) == 2);
+    CHECK(Histogram::BitWidth(4) == 3);
+    CHECK(Histogram::BitWidth(1023) == 10);
+    CHECK(Histogram::BitWidth(1024) == 11);
+    CHECK(Histogram::BitWidth(uint64_t(1) << 40) == 41);
+    CHECK(Histogram::BitWidth(UINT64_MAX) == 64);
+}
+
+TEST_CASE(Record_Values_LandInTheirPowerOfTwoBucket)
+{
+    Histogram histogram;
+    histogram.Record(0);
+    histogram.Record(1);
+    histogram.Record(2);
+    histogram.Record(3);
+    histogram.Record(1000);
+
+    HistogramSnapshot snapshot = GetSnapshot(histogram);
+    CHECK(snapshot.buckets[0] == 1);
+    CHECK(snapshot.buckets[1] == 1);
+    CHECK(snapshot.buckets[2] == 2);
+    // 512 to 1023
+    CHECK(snapshot.buckets[10] == 1);
+
+    CHECK(snapshot.count == 5);
+    CHECK(snapshot.sumNS == 1006);
+    CHECK(snapshot.maxNS == 1000);
+}
+
+TEST_CASE(Record_NegativeAndHugeValues_AreClamped)
+{
+    Histogram histogram;
+    histogram.Record(-5);
+    histogram.Record(INT64_MAX);
+
+    HistogramSnapshot snapshot = GetSnapshot(histogram);
+    CHECK(snapshot.buckets[0] == 1);
+    CHECK(snapshot.buckets[HISTOGRAM_BUCKET_COUNT - 1] == 1);
+    CHECK(snapshot.maxNS == static_cast<uint64_t>(INT64_MAX));
+}
+
+TEST_CASE(Reset_Recorded_StartsOver)
+{
+    Histogram histogram;
+    for (int i = 0; i < 100; ++i) histogram.Record(i * 1000);
+    histogram.Reset();
+
+    HistogramSnapshot snapshot = GetSnapshot(histogram);
+    CHECK(snapshot.count == 0 && snapshot.sumNS == 0 && snapshot.maxNS == 0);
+    for (uint64_t bucket : snapshot.buckets) CHECK(bucket == 0);
+}
+
+TEST_CASE(Gauge_Set_KeepsTheLastValueAndTheLargest)
+{
+    Gauge gauge;
+    gauge.Set(5);
+    gauge.Set(50);
+    gauge.Set(7);
+
+    CHECK(gauge.Get() == 7);
+    CHECK(gauge.GetMax() == 50);
+
+    gauge.Reset();
+    CHECK(gauge.Get() == 0 && gauge.GetMax() == 0);
+}
+
+TEST_CASE(Record_FromManyThreads_LosesNothing)
+{
+    constexpr int THREADS = 4;
+    constexpr int PER_THREAD = 100000;
+
+    Counter counter;
+    Gauge gauge;
+    Histogram histogram;
+
+    std::vector<std::thread> threads;
+    for (int t = 0; t < THREADS; ++t)
+    {
+        threads.emplace_back([&, t]
+        {
+            for (int i = 0; i < PER_THREAD; ++i)
+            {
+                counter.Add(2);
+                gauge.Set(static_cast<uint64_t>(t * PER_THREAD + i));
+                histogram.Record(i % 64);
+            }
+        });
+    }
+
+    for (auto& thread : threads) thread.join();
+
+    HistogramSnapshot snapshot = GetSnapshot(histogram);
+    CHECK(counter.Get() == 2ull * THREADS * PER_THREAD);
+    CHECK(gauge.GetMax() == static_cast<uint64_t>(THREADS * PER_THREAD - 1));
+    CHECK(snapshot.count == static_cast<uint64_t>(THREADS) * PER_THREAD);
+    CHECK(snapshot.maxNS == 63);
+
+    uint64_t bucketTotal = 0;
+    for (uint64_t bucket : snapshot.buckets) bucketTotal += bucket;
+    CHECK(bucketTotal == snapshot.count);
+}
+
+TEST_CASE(CopyTo_Telemetry_FillsEveryField)
+{
+    Telemetry& telemetry = Telemetry::Get();
+    telemetry.Reset();
+
+    telemetry.pointsIngested.Add(10);
+    telemetry.framesRendered.Add(3);
+    telemetry.framesSkipped.Add(1);
+    telemetry.bytesPresented.Add(4096);
+    telemetry.queueDepth.Set(9);
+    telemetry.queueDepth.Set(2);
+    telemetry.frameTime.Record(100);
+    telemetry.geometryTime.Record(200);
+    telemetry.presentTime.Record(300);
+    telemetry.openLatency.Record(400);
+
+    StatsSnapshot snapshot{};
+    telemetry.CopyTo(snapshot);
+
+    CHECK(snapshot.size == sizeof(StatsSnapshot));
+    CHECK(snapshot.pointsIngested == 10);
+    CHECK(snapshot.framesRendered == 3);
+    CHECK(snapshot.framesSkipped == 1);
+    CHECK(snapshot.bytesPresented == 4096);
+    CHECK(snapshot.queueDepth == 2 && snapshot.maxQueueDepth == 9);
+    CHECK(snapshot.frameTime.sumNS == 100);
+    CHECK(snapshot.geometryTime.sumNS == 200);
+    CHECK(snapshot.presentTime.sumNS == 300);
+    CHECK(snapshot.openLatency.sumNS == 400);
+
+    telemetry.Reset();
+    telemetry.CopyTo(snapshot);
+    CHECK(snapshot.pointsIngested == 0 && snapshot.openLatency.count == 0);
+}
@@ -0,0 +1,35 @@
+#pragma once
+#include <cstddef>
+
+// A minimal test harness, so the suites build with nothing but the standard library.
+// Every suite is its own executable (see CMakeLists.txt), made of TEST_CASEs that run in the order they are defined.
+// A failed CHECK is reported and the test case goes on, a failed REQUIRE ends it.
+// The executable takes an optional argument, and then only runs the test cases whose names contain it.
+
+namespace PathWindows::Tests
+{
+    typedef void(*TestFunction)();
+
+    // Adds a test case to the suite, TEST_CASE defines one of these for every test case.
+    struct TestRegistrar
+    {
+        TestRegistrar(const char* name, TestFunction function);
+    };
+
+    // Reports a failed check of the running test case, and returns false.
+    bool ReportFailure(const char* file, int line, const char* expression);
+
+    // Thrown by a failed REQUIRE to end the running test case.
+    struct RequireFailed {};
+}
+
+#define TEST_CASE(name) \
+    static void name(); \
+    static const PathWindows::Tests::TestRegistrar name##Registrar(#name, name); \
+    static void name()
+
+#define CHECK(expression) \
+    static_cast<void>((expression) || PathWindows::Tests::ReportFailure(__FILE__, __LINE__, #expression))
+
+#define REQUIRE(expression) \
+    static_cast<void>((expression) || (PathWindows::Tests::ReportFailure(__FILE__, __LINE__, #expression), throw PathWindows::Tests::RequireFailed(), false))
@@ -0,0 +1,79 @@
+#include "TestHarness.h"
+#include <cstdio>
+#include <cstring>
+#include <exception>
+#include <vector>
+
+using namespace PathWindows::Tests;
+
+namespace
+{
+    struct TestCase
+    {
+        const char* name;
+        TestFunction function;
+    };
+
+    // a function local, so it exists before the registrars of the suite run
+    std::vector<TestCase>& GetTestCases()
+    {
+        static std::vector<TestCase> testCases;
+        return testCases;
+    }
+
+    size_t g_failedChecks = 0;
+}
+
+TestRegistrar::TestRegistrar(const char* name, TestFunction function)
+{
+    GetTestCases().push_back(TestCase{ name, function });
+}
+
+bool PathWindows::Tests::ReportFailure(const char* file, int line, const char* expression)
+{
+    std::printf("%s:%d: check failed: %s\n", file, line, expression);
+    ++g_failedChecks;
+
+    return false;
+}
+
+int main(int argc, char** argv)
+{
+    const char* filter = argc > 1 ? argv[1] : nullptr;
+
+    size_t run = 0;
+    size_t failed = 0;
+
+    for (const TestCase& testCase : GetTestCases())
+    {
+        if (filter && !std::strstr(testCase.name, filter)) continue;
+
+        size_t failedChecksBefore = g_failedChecks;
+        bool threw = false;
+
+        try
+        {
+            testCase.function();
+        }
+        catch (const RequireFailed&)
+        {
+            threw = true;
+        }
+        catch (const std::exception& e)
+        {
+            std::printf("unexpected exception: %s\n", e.what());
+            threw = true;
+        }
+
+        ++run;
+        bool passed = !threw && g_failedChecks == failedChecksBefore;
+        if (!passed) ++failed;
+
+        std::printf("[%s] %s\n", passed ? "  OK  " : " FAIL ", testCase.name);
+        std::fflush(stdout);
+    }
+
+    std::printf("%zu of %zu test cases passed\n", run - failed, run);
+
+    return failed == 0 && run > 0 ? 0 : 1;
+}
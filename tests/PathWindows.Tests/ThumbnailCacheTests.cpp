@@ -0,0 +1,168 @@
+#include "TestHarness.h"
+#include "ThumbnailCache.h"
+#include <cstdint>
+#include <set>
+#include <thread>
+#include <vector>
+
+using namespace PathWindows;
+
+namespace
+{
+    std::vector<uint32_t> MakePixels(int32_t width, int32_t height, uint32_t value)
+    {
+        return std::vector<uint32_t>(static_cast<size_t>(width) * height, value);
+    }
+
+    ThumbnailCache::Key MakeKey(uint64_t hash, int32_t width = 8, int32_t height = 8)
+    {
+        return ThumbnailCache::Key{ hash, 100, width, height };
+    }
+}
+
+TEST_CASE(Hash_SameBytes_IsTheSame)
+{
+    std::vector<uint8_t> bytes(1000);
+    for (size_t i = 0; i < bytes.size(); ++i) bytes[i] = static_cast<uint8_t>(i * 7);
+
+    CHECK(ThumbnailCache::Hash(bytes.data(), bytes.size(), 1) == ThumbnailCache::Hash(bytes.data(), bytes.size(), 1));
+    CHECK(ThumbnailCache::Hash(bytes.data(), bytes.size(), 1) != ThumbnailCache::Hash(bytes.data(), bytes.size(), 2));
+}
+
+// Every length, so the 32 byte lanes, the 8 byte steps and the single bytes at the end are all covered.
+TEST_CASE(Hash_AnyChange_ChangesIt)
+{
+    std::vector<uint8_t> bytes(100, 0x5A);
+    std::set<uint64_t> hashes;
+
+    for (size_t size = 0; size <= bytes.size(); ++size)
+    {
+        uint64_t hash = ThumbnailCache::Hash(bytes.data(), size, 0);
+        CHECK(hashes.insert(hash).second);
+
+        for (size_t i = 0; i < size; ++i)
+        {
+            bytes[i] ^= 1;
+            CHECK(ThumbnailCache::Hash(bytes.data(), size, 0) != hash);
+            bytes[i] ^= 1;
+        }
+    }
+}
+
+TEST_CASE(MakeKey_DifferentSizes_AreDifferentKeys)
+{
+    const int32_t path[] = { 1, 2, 3, 4 };
+
+    ThumbnailCache::Key key = ThumbnailCache::MakeKey(path, sizeof(path), 0, 64, 64);
+    CHECK(key == ThumbnailCache::MakeKey(path, sizeof(path), 0, 64, 64));
+    CHECK(!(key == ThumbnailCache::MakeKey(path, sizeof(path), 0, 64, 32)));
+    CHECK(!(key == ThumbnailCache::MakeKey(path, sizeof(path), 1, 64, 64)));
+    CHECK(!(key == ThumbnailCache::MakeKey(path, sizeof(path) - 4, 0, 64, 64)));
+}
+
+TEST_CASE(TryGet_Put_CopiesThePixels)
+{
+    ThumbnailCache cache(1 << 20);
+    std::vector<uint32_t> pixels = MakePixels(8, 8, 0x11223344);
+    cache.Put(MakeKey(1), pixels.data());
+
+    // the cache keeps a copy of its own
+    pixels.assign(pixels.size(), 0);
+
+    std::vector<uint32_t> out = MakePixels(8, 8, 0);
+    CHECK(cache.TryGet(MakeKey(1), out.data()));
+    CHECK(out == MakePixels(8, 8, 0x11223344));
+
+    std::vector<uint32_t> missed = MakePixels(8, 8, 7);
+    CHECK(!cache.TryGet(MakeKey(2), missed.data()));
+    CHECK(missed == MakePixels(8, 8, 7));
+
+    CHECK(cache.GetCount() == 1);
+    CHECK(cache.GetBytes() == 8 * 8 * 4);
+}
+
+TEST_CASE(Put_PastMaxBytes_DropsTheLeastRecentlyUsed)
+{
+    // room for two 8x8 thumbnails
+    ThumbnailCache cache(2 * 8 * 8 * 4);
+    std::vector<uint32_t> pixels = MakePixels(8, 8, 1);
+    std::vector<uint32_t> out = MakePixels(8, 8, 0);
+
+    cache.Put(MakeKey(1), pixels.data());
+    cache.Put(MakeKey(2), pixels.data());
+    CHECK(cache.TryGet(MakeKey(1), out.data()));
+
+    cache.Put(MakeKey(3), pixels.data());
+    CHECK(cache.GetCount() == 2);
+    CHECK(cache.TryGet(MakeKey(1), out.data()));
+    CHECK(!cache.TryGet(MakeKey(2), out.data()));
+    CHECK(cache.TryGet(MakeKey(3), out.data()));
+}
+
+TEST_CASE(Put_SameKey_ReplacesIt)
+{
+    ThumbnailCache cache(1 << 20);
+    std::vector<uint32_t> first = MakePixels(8, 8, 1);
+    std::vector<uint32_t> second = MakePixels(8, 8, 2);
+
+    cache.Put(MakeKey(1), first.data());
+    cache.Put(MakeKey(1), second.data());
+    CHECK(cache.GetCount() == 1);
+    CHECK(cache.GetBytes() == 8 * 8 * 4);
+
+    std::vector<uint32_t> out = MakePixels(8, 8, 0);
+    CHECK(cache.TryGet(MakeKey(1), out.data()));
+    CHECK(out == second);
+}
+
+TEST_CASE(Put_LargerThanTheCache_KeepsTheOthers)
+{
+    ThumbnailCache cache(8 * 8 * 4);
+    std::vector<uint32_t> small = MakePixels(8, 8, 1);
+    std::vector<uint32_t> large = MakePixels(16, 16, 2);
+
+    cache.Put(MakeKey(1), small.data());
+    cache.Put(MakeKey(2, 16, 16), large.data());
+
+    CHECK(cache.GetCount() == 1);
+    CHECK(cache.TryGet(MakeKey(1), small.data()));
+}
+
+TEST_CASE(Clear_Cached_DropsEverything)
+{
+    ThumbnailCache cache(1 << 20);
+    std::vector<uint32_t> pixels = MakePixels(8, 8, 1);
+    cache.Put(MakeKey(1), pixels.data());
+    cache.Put(MakeKey(2), pixels.data());
+
+    cache.Clear();
+    CHECK(cache.GetCount() == 0 && cache.GetBytes() == 0);
+    CHECK(!cache.TryGet(MakeKey(1), pixels.data()));
+}
+
+TEST_CASE(TryGetAndPut_FromManyThreads_StayWithinMaxBytes)
+{
+    constexpr size_t MAX_BYTES = 10 * 8 * 8 * 4;
+    ThumbnailCache cache(MAX_BYTES);
+
+    std::vector<std::thread> threads;
+    for (uint32_t t = 0; t < 4; ++t)
+    {
+        threads.emplace_back([&cache, t]
+        {
+            std::vector<uint32_t> pixels = MakePixels(8, 8, t);
+            std::vector<uint32_t> out = MakePixels(8, 8, 0);
+
+            for (uint64_t i = 0; i < 5000; ++i)
+            {
+                uint64_t hash = (i * 31 + t) % 40;
+                if (!cache.TryGet(MakeKey(hash), out.data())) cache.Put(MakeKey(hash), pixels.data());
+            }
+        });
+    }
+
+    for (auto& thread : threads) thread.join();
+
+    CHECK(cache.GetBytes() <= MAX_BYTES);
+    CHECK(cache.GetBytes() == cache.GetCount() * 8 * 8 * 4);
+}
@@ -0,0 +1,164 @@
+#include "TestHarness.h"
+#include "TileGrid.h"
+#include <algorithm>
+#include <cmath>
+#include <random>
+#include <vector>
+
+using namespace PathWindows;
+
+namespace
+{
+    bool Equals(RectI a, RectI b)
+    {
+        return a.left == b.left && a.top == b.top && a.right == b.right && a.bottom == b.bottom;
+    }
+
+    std::vector<RectI> GetSpans(const TileGrid& grid)
+    {
+        std::vector<RectI> spans;
+        grid.ForEachOccupiedSpan([&spans](RectI rect) { spans.push_back(rect); });
+        return spans;
+    }
+
+    // how far (on the larger axis) the point is from the rect, 0 if it is inside
+    float GetDistance(PointF point, float left, float top, float right, float bottom)
+    {
+        float dx = std::max({ left - point.x, point.x - right, 0.0f });
+        float dy = std::max({ top - point.y, point.y - bottom, 0.0f });
+        return std::max(dx, dy);
+    }
+}
+
+TEST_CASE(Constructor_SizeNotAMultipleOfTheTile_RoundsTheTilesUp)
+{
+    TileGrid grid(1000, 300, 256);
+
+    CHECK(grid.GetTileCount() == 4 * 2);
+    CHECK(grid.IsEmpty());
+}
+
+TEST_CASE(MarkSegment_WithinOneTile_MarksOnlyIt)
+{
+    TileGrid grid(1024, 1024, 256);
+    grid.MarkSegment(PointF{ 300, 300 }, PointF{ 400, 350 }, 2.0f);
+
+    CHECK(grid.GetOccupiedCount() == 1);
+    CHECK(grid.IsOccupied(1, 1));
+}
+
+TEST_CASE(MarkSegment_InflateCrossesATileEdge_MarksTheNeighbour)
+{
+    TileGrid grid(1024, 1024, 256);
+    grid.MarkSegment(PointF{ 300, 254 }, PointF{ 400, 254 }, 3.0f);
+
+    CHECK(grid.GetOccupiedCount() == 2);
+    CHECK(grid.IsOccupied(1, 0));
+    CHECK(grid.IsOccupied(1, 1));
+}
+
+TEST_CASE(MarkSegment_Diagonal_MarksOnlyTheTilesItPassesThrough)
+{
+    TileGrid grid(1024, 1024, 256);
+    grid.MarkSegment(PointF{ 10, 10 }, PointF{ 1010, 1010 }, 1.0f);
+
+    // the diagonal and the tiles it grazes at the corners
+    for (int32_t i = 0; i < 4; ++i) CHECK(grid.IsOccupied(i, i));
+    CHECK(!grid.IsOccupied(3, 0));
+    CHECK(!grid.IsOccupied(0, 3));
+    CHECK(grid.GetOccupiedCount() <= 4 + 2 * 3);
+}
+
+TEST_CASE(MarkSegment_OutsideTheSurface_IsIgnored)
+{
+    TileGrid grid(1024, 1024, 256);
+    grid.MarkSegment(PointF{ -100, -100 }, PointF{ -50, 500 }, 2.0f);
+    grid.MarkSegment(PointF{ 2000, 10 }, PointF{ 3000, 10 }, 2.0f);
+
+    CHECK(grid.IsEmpty());
+}
+
+TEST_CASE(MarkSegment_RandomSegments_MarksEveryTileTheyPassNearAndNoOther)
+{
+    const int32_t width = 500;
+    const int32_t height = 400;
+    const int32_t tileSize = 64;
+    const float inflate = 3.0f;
+    std::mt19937 random(11);
+    std::uniform_real_distribution<float> coordinate(-100.0f, 600.0f);
+
+    for (int trial = 0; trial < 200; ++trial)
+    {
+        TileGrid grid(width, height, tileSize);
+        PointF a{ coordinate(random), coordinate(random) };
+        PointF b{ coordinate(random), coordinate(random) };
+        grid.MarkSegment(a, b, inflate);
+
+        // sample the segment densely and compare against how far each tile is from it
+        const int samples = 2000;
+        for (int32_t row = 0; row < 7; ++row)
+        {
+            for (int32_t column = 0; column < 8; ++column)
+            {
+                float left = static_cast<float>(column * tileSize);
+                float top = static_cast<float>(row * tileSize);
+                float right = left + tileSize;
+                float bottom = top + tileSize;
+
+                // the part of the tile on the surface has to be marked, and tiles may be marked for passing near
+                // their part off the surface
+                float visibleDistance = INFINITY;
+                float distance = INFINITY;
+                for (int i = 0; i <= samples; ++i)
+                {
+                    float t = static_cast<float>(i) / samples;
+                    PointF p{ a.x + (b.x - a.x) * t, a.y + (b.y - a.y) * t };
+                    visibleDistance = std::min(visibleDistance, GetDistance(p, left, top, std::min(right, static_cast<float>(width)), std::min(bottom, static_cast<float>(height))));
+                    distance = std::min(distance, GetDistance(p, left, top, right, bottom));
+                }
+
+                // the sampling and float rounding leave a pixel of slack either way
+                if (visibleDistance < inflate - 1.0f) CHECK(grid.IsOccupied(column, row));
+                if (distance > inflate + 1.0f) CHECK(!grid.IsOccupied(column, row));
+            }
+        }
+    }
+}
+
+TEST_CASE(MarkRect_ClippedToTheSurface_MarksTheTilesItOverlaps)
+{
+    TileGrid grid(1000, 300, 256);
+    grid.MarkRect(RectI{ 200, -50, 600, 257 });
+
+    CHECK(grid.GetOccupiedCount() == 3 * 2);
+    CHECK(grid.IsOccupied(0, 1) && grid.IsOccupied(2, 1));
+    CHECK(!grid.IsOccupied(3, 0));
+
+    grid.MarkRect(RectI{ 10, 10, 10, 50 });
+    CHECK(grid.GetOccupiedCount() == 6);
+}
+
+TEST_CASE(ForEachOccupiedSpan_AdjacentTiles_AreJoinedAndClippedToTheSurface)
+{
+    TileGrid grid(1000, 300, 256);
+    grid.MarkRect(RectI{ 300, 10, 999, 20 });
+    grid.MarkRect(RectI{ 10, 280, 20, 290 });
+
+    std::vector<RectI> spans = GetSpans(grid);
+
+    REQUIRE(spans.size() == 2);
+    CHECK(Equals(spans[0], RectI{ 256, 0, 1000, 256 }));
+    CHECK(Equals(spans[1], RectI{ 0, 256, 256, 300 }));
+}
+
+TEST_CASE(Clear_MarkedTiles_EmptiesTheGrid)
+{
+    TileGrid grid(1024, 1024, 256);
+    grid.MarkRect(RectI{ 0, 0, 1024, 1024 });
+    CHECK(grid.GetOccupiedCount() == 16);
+
+    grid.Clear();
+
+    CHECK(grid.IsEmpty());
+    CHECK(GetSpans(grid).empty());
+}
@@ -0,0 +1,234 @@
+#include "TestHarness.h"
+#include "TrailBuffer.h"
+#include <algorithm>
+#include <cstdint>
+#include <deque>
+#include <random>
+#include <vector>
+
+using namespace PathWindows;
+
+namespace
+{
+    struct TrailPoint
+    {
+        PointF point;
+        int64_t timeNS;
+        bool newFigure;
+    };
+
+    // The trail kept the obvious way, to check the ring against.
+    struct ReferenceTrail
+    {
+        size_t maxPoints;
+        int64_t maxAgeNS;
+        std::deque<TrailPoint> points;
+
+        void Append(PointF point, bool newFigure, int64_t nowNS)
+        {
+            if (points.size() == maxPoints) points.pop_front();
+            if (!points.empty()) nowNS = (std::max)(nowNS, points.back().timeNS);
+            points.push_back(TrailPoint{ point, nowNS, newFigure });
+        }
+
+        void Evict(int64_t nowNS)
+        {
+            while (maxAgeNS > 0 && !points.empty() && nowNS - points.front().timeNS > maxAgeNS) points.pop_front();
+        }
+
+        size_t GetBucket(size_t index, int64_t nowNS, size_t bucketCount) const
+        {
+            if (bucketCount < 2) return 0;
+
+            double fraction = static_cast<double>(points.size() - 1 - index) / static_cast<double>(maxPoints);
+            if (maxAgeNS > 0) fraction = (std::max)(fraction, static_cast<double>(nowNS - points[index].timeNS) / static_cast<double>(maxAgeNS));
+            if (!(fraction > 0.0)) return 0;
+
+            return (std::min)(static_cast<size_t>(fraction * static_cast<double>(bucketCount)), bucketCount - 1);
+        }
+    };
+
+    struct Segment
+    {
+        PointF from;
+        PointF to;
+        size_t bucket;
+
+        bool operator==(const Segment& other) const
+        {
+            return from.x == other.from.x && from.y == other.from.y && to.x == other.to.x && to.y == other.to.y && bucket == other.bucket;
+        }
+    };
+
+    std::vector<Segment> GetSegments(const TrailBuffer& trail, int64_t nowNS, size_t bucketCount, size_t& runCount)
+    {
+        std::vector<Segment> segments;
+        runCount = 0;
+
+        size_t lastBucket = SIZE_MAX;
+        trail.ForEachRun(nowNS, bucketCount, [&](size_t bucket, const PointF* points, size_t count)
+        {
+            // oldest first, so buckets never go up
+            CHECK(lastBucket == SIZE_MAX || bucket <= lastBucket);
+            CHECK(count >= 2);
+            lastBucket = bucket;
+
+            for (size_t i = 1; i < count; ++i) segments.push_back(Segment{ points[i - 1], points[i], bucket });
+            ++runCount;
+        });
+
+        return segments;
+    }
+
+    std::vector<Segment> GetSegments(const ReferenceTrail& trail, int64_t nowNS, size_t bucketCount)
+    {
+        std::vector<Segment> segments;
+        for (size_t i = 1; i < trail.points.size(); ++i)
+        {
+            if (trail.points[i].newFigure) continue;
+            segments.push_back(Segment{ trail.points[i - 1].point, trail.points[i].point, trail.GetBucket(i, nowNS, bucketCount) });
+        }
+
+        return segments;
+    }
+}
+
+TEST_CASE(Append_NotConfigured_KeepsNothing)
+{
+    TrailBuffer trail;
+    trail.Append(PointF{ 1, 2 }, true, 0);
+
+    CHECK(trail.GetCount() == 0);
+    CHECK(!trail.IsAging());
+
+    size_t runCount;
+    CHECK(GetSegments(trail, 0, 4, runCount).empty());
+}
+
+TEST_CASE(Append_PastMaxPoints_DropsTheOldest)
+{
+    TrailBuffer trail;
+    trail.Configure(4, 0);
+
+    for (int i = 0; i < 10; ++i) trail.Append(PointF{ float(i), 0 }, i == 0, i);
+    CHECK(trail.GetCount() == 4);
+    CHECK(trail.GetMaxPoints() == 4);
+
+    size_t runCount;
+    std::vector<Segment> segments = GetSegments(trail, 10, 1, runCount);
+    REQUIRE(segments.size() == 3);
+    CHECK(segments.front().from.x == 6 && segments.back().to.x == 9);
+}
+
+TEST_CASE(Evict_OlderThanMaxAge_DropsThemAndCounts)
+{
+    TrailBuffer trail;
+    trail.Configure(100, 1000);
+
+    for (int i = 0; i < 10; ++i) trail.Append(PointF{ float(i), 0 }, false, i * 200);
+    CHECK(trail.IsAging());
+
+    // the points at 0 to 600 are more than 1000 older than 1700
+    CHECK(trail.Evict(1700) == 4);
+    CHECK(trail.GetCount() == 6);
+    CHECK(trail.Evict(1700) == 0);
+
+    CHECK(trail.Evict(1'000'000) == 6);
+    CHECK(!trail.IsAging());
+}
+
+TEST_CASE(Evict_NoMaxAge_KeepsEverything)
+{
+    TrailBuffer trail;
+    trail.Configure(100, 0);
+
+    for (int i = 0; i < 10; ++i) trail.Append(PointF{ float(i), 0 }, false, i);
+    CHECK(trail.Evict(INT64_MAX / 2) == 0);
+    CHECK(trail.GetCount() == 10);
+    CHECK(!trail.IsAging());
+}
+
+TEST_CASE(Append_TimeGoesBack_IsHeldAtTheNewest)
+{
+    TrailBuffer trail;
+    trail.Configure(10, 100);
+
+    trail.Append(PointF{ 0, 0 }, true, 1000);
+    trail.Append(PointF{ 1, 0 }, false, 500);
+
+    // had it kept 500, it would be evicted here
+    CHECK(trail.Evict(1050) == 0);
+    CHECK(trail.GetCount() == 2);
+}
+
+TEST_CASE(GetBucket_NewestAndOldest_AreTheFirstAndLastBuckets)
+{
+    TrailBuffer trail;
+    trail.Configure(8, 0);
+    for (int i = 0; i < 8; ++i) trail.Append(PointF{ float(i), 0 }, i == 0, 0);
+
+    CHECK(trail.GetBucket(7, 0, 4) == 0);
+    CHECK(trail.GetBucket(0, 0, 4) == 3);
+    CHECK(trail.GetBucket(0, 0, 1) == 0);
+
+    for (size_t i = 1; i < 8; ++i) CHECK(trail.GetBucket(i, 0, 4) <= trail.GetBucket(i - 1, 0, 4));
+}
+
+TEST_CASE(ForEachRun_Configure_ClearsTheTrail)
+{
+    TrailBuffer trail;
+    trail.Configure(4, 0);
+    for (int i = 0; i < 6; ++i) trail.Append(PointF{ float(i), 0 }, false, i);
+
+    trail.Configure(8, 0);
+    CHECK(trail.GetCount() == 0);
+
+    trail.Append(PointF{ 0, 0 }, false, 0);
+    trail.Append(PointF{ 1, 1 }, false, 1);
+
+    size_t runCount;
+    CHECK(GetSegments(trail, 1, 4, runCount).size() == 1);
+}
+
+// Streams random figures through rings of several sizes, with and without a max age, and compares the segments and
+// buckets of every frame with the reference, so runs that cross the end of the ring and figure starts right at it are
+// covered.
+TEST_CASE(ForEachRun_Streaming_MatchesTheReference)
+{
+    std::mt19937 random(1);
+
+    for (size_t maxPoints : { size_t(1), size_t(2), size_t(3), size_t(7), size_t(64) })
+    {
+        for (int64_t maxAgeNS : { int64_t(0), int64_t(5000) })
+        {
+            TrailBuffer trail;
+            trail.Configure(maxPoints, maxAgeNS);
+            ReferenceTrail reference{ maxPoints, maxAgeNS, {} };
+
+            int64_t nowNS = 0;
+            for (int i = 0; i < 2000; ++i)
+            {
+                nowNS += random() % 300;
+                PointF point{ float(random() % 1000), float(random() % 1000) };
+                bool newFigure = random() % 10 == 0;
+
+                trail.Append(point, newFigure, nowNS);
+                reference.Append(point, newFigure, nowNS);
+
+                if (random() % 4 == 0)
+                {
+                    trail.Evict(nowNS);
+                    reference.Evict(nowNS);
+                }
+
+                REQUIRE(trail.GetCount() == reference.points.size());
+
+                for (size_t bucketCount : { size_t(1), size_t(4) })
+                {
+                    size_t runCount;
+                    CHECK(GetSegments(trail, nowNS, bucketCount, runCount) == GetSegments(reference, nowNS, bucketCount));
+                }
+            }
+        }
+    }
+}
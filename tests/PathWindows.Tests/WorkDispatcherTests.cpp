@@ -0,0 +1,115 @@
+#include "TestHarness.h"
+#include "WorkDispatcher.h"
+#include <atomic>
+#include <thread>
+#include <vector>
+
+using namespace PathWindows;
+
+TEST_CASE(RunPending_PostedWork_RunsInOrder)
+{
+    WorkDispatcher dispatcher;
+    std::vector<int> ran;
+
+    for (int i = 0; i < 5; ++i) dispatcher.Post([&ran, i] { ran.push_back(i); });
+
+    CHECK(dispatcher.HasPending());
+    CHECK(dispatcher.RunPending() == 5);
+    CHECK((ran == std::vector<int>{ 0, 1, 2, 3, 4 }));
+    CHECK(!dispatcher.HasPending());
+    CHECK(dispatcher.RunPending() == 0);
+}
+
+TEST_CASE(Post_SeveralBeforeTheyRun_WakesOnce)
+{
+    int wakes = 0;
+    WorkDispatcher dispatcher([&wakes] { ++wakes; });
+
+    dispatcher.Post([] {});
+    dispatcher.Post([] {});
+    dispatcher.Post([] {});
+    CHECK(wakes == 1);
+
+    dispatcher.RunPending();
+    dispatcher.Post([] {});
+    CHECK(wakes == 2);
+}
+
+TEST_CASE(RunPending_WorkPostsMoreWork_ItRunsOnTheNextCall)
+{
+    int wakes = 0;
+    WorkDispatcher dispatcher([&wakes] { ++wakes; });
+    bool innerRan = false;
+
+    dispatcher.Post([&dispatcher, &innerRan] { dispatcher.Post([&innerRan] { innerRan = true; }); });
+
+    CHECK(dispatcher.RunPending() == 1);
+    CHECK(!innerRan);
+    // the inner post had to wake the thread again
+    CHECK(wakes == 2);
+
+    CHECK(dispatcher.RunPending() == 1);
+    CHECK(innerRan);
+}
+
+TEST_CASE(PostForResult_Value_IsReturnedThroughTheFuture)
+{
+    WorkDispatcher dispatcher;
+    std::future<int> result = dispatcher.PostForResult([] { return 42; });
+
+    CHECK(result.wait_for(std::chrono::seconds(0)) == std::future_status::timeout);
+
+    dispatcher.RunPending();
+    CHECK(result.get() == 42);
+}
+
+TEST_CASE(PostForResult_Throws_TheFutureRethrows)
+{
+    WorkDispatcher dispatcher;
+    std::future<int> result = dispatcher.PostForResult([]() -> int { throw 7; });
+    dispatcher.RunPending();
+
+    bool threw = false;
+    try
+    {
+        result.get();
+    }
+    catch (int value)
+    {
+        threw = value == 7;
+    }
+
+    CHECK(threw);
+}
+
+TEST_CASE(Post_FromManyThreads_EveryItemRunsOnce)
+{
+    constexpr int THREADS = 4;
+    constexpr int PER_THREAD = 10000;
+
+    std::atomic<int> wakes(0);
+    WorkDispatcher dispatcher([&wakes] { ++wakes; });
+    int sum = 0;
+
+    std::vector<std::thread> posters;
+    for (int t = 0; t < THREADS; ++t)
+    {
+        posters.emplace_back([&dispatcher, &sum]
+        {
+            for (int i = 0; i < PER_THREAD; ++i) dispatcher.Post([&sum] { ++sum; });
+        });
+    }
+
+    // run while they post, like the window thread would
+    size_t ran = 0;
+    while (ran < THREADS * PER_THREAD)
+    {
+        ran += dispatcher.RunPending();
+        std::this_thread::yield();
+    }
+
+    for (auto& poster : posters) poster.join();
+
+    CHECK(sum == THREADS * PER_THREAD);
+    CHECK(wakes > 0 && wakes <= THREADS * PER_THREAD);
+}